@@ -19,6 +19,12 @@
 #include "ZZ/Generics/OrdSet.hh"
 #include "ParClient.hh"
 
+#if !defined(_MSC_VER)
+  #include <unistd.h>
+  #include <signal.h>
+  #include <sys/wait.h>
+#endif
+
 namespace ZZ {
 using namespace std;
 
@@ -73,6 +79,7 @@ public:
     Wire  insert(int frame, Wire w); // -- frame '-1' means the flopinit netlist; the returned wire is in netlist 'F'
 
     void  extendAbstr(Wire w_flop);
+    void  setAbstr(const Vec<Wire>& flops);     // -- extend with, and shrink to, 'flops'
 
     void  force(Wire f);
     lbool solve(Vec<Wire>& f_assumps_disj);
@@ -272,6 +279,21 @@ void AbsTrace::extendAbstr(Wire w_flop)
 }
 
 
+// Flops removed from the abstraction are simply no longer assumed by 'solve()'.
+void AbsTrace::setAbstr(const Vec<Wire>& flops)
+{
+    WZet keep;
+    for (uind i = 0; i < flops.size(); i++){
+        keep.add(flops[i]);
+        if (!abstr_.has(flops[i]))
+            extendAbstr(flops[i]);
+    }
+    For_Gatetype(N, gate_Flop, w)
+        if (abstr_.has(w) && !keep.has(w))
+            abstr_.exclude(w);
+}
+
+
 void AbsTrace::force(Wire f)
 {
     Lit p = clausify(f);
@@ -477,23 +499,172 @@ bool refineSelectFlops(AbsTrace& T, uint depth, Wire bad, const Vec<Wire>& flops
 }
 
 
-bool refineAbstraction(AbsTrace& T, uint depth, Wire bad, /*in*/Cex* cex0 = NULL)
+#if !defined(_MSC_VER)
+// Worker for parallel refinement (runs in a forked child with its own copy of 'T'): extends the
+// abstraction with 'add' and rechecks 'p_bads' by BMC, refining further with the flop order 'ord'
+// for as long as the abstraction has counterexamples. Once UNSAT, the abstraction is shrunk to the
+// flops of the UNSAT core (repeatedly, until stable) and written to 'fd' as gate IDs prefixed by
+// their count. Nothing is written if the resource limit is hit or a proper counterexample is found.
+// The child never returns.
+static
+void refineCheckChild(int fd, AbsTrace& T, uint depth, Wire bad, Vec<Wire>& p_bads, const Vec<Wire>& ord, const Vec<Wire>& add)
+{
+    Vec<Wire> more;
+    add.copyTo(more);
+    for(;;){
+        for (uind i = 0; i < more.size(); i++)
+            T.extendAbstr(more[i]);
+
+        lbool result = T.solve(p_bads);
+        if (result == l_Undef)
+            _exit(0);
+        else if (result == l_False)
+            break;
+
+        more.clear();
+        if (!refineSelectFlops(T, depth, bad, ord, more, NULL))
+            _exit(0);
+    }
+
+    // Shrink abstraction further by re-solving until the UNSAT core is stable:
+    for(;;){
+        uint sz = T.abstr().size();
+        if (T.solve(p_bads) != l_False || T.abstr().size() == sz) break;
+    }
+
+    Vec<uint> data;
+    data.push(0);
+    For_Gatetype(T.design(), gate_Flop, w){
+        if (T.abstr().has(w)){
+            data.push(id(w));
+            data[0]++; }
+    }
+
+    const char* p = (const char*)data.base();
+    size_t      n = data.size() * sizeof(uint);
+    while (n > 0){
+        ssize_t m = write(fd, p, n);
+        if (m <= 0) break;
+        p += m; n -= m;
+    }
+    _exit(0);
+}
+
+
+// Returns FALSE if the child died before reporting.
+static
+bool readSelectChild(int fd, NetlistRef N, Vec<Wire>& add)
+{
+    Vec<char> bytes;
+    char buf[4096];
+    for(;;){
+        ssize_t m = read(fd, buf, sizeof(buf));
+        if (m <= 0) break;
+        for (ssize_t i = 0; i < m; i++)
+            bytes.push(buf[i]);
+    }
+    Vec<uint> data(bytes.size() / sizeof(uint));
+    memcpy(data.base(), bytes.base(), data.size() * sizeof(uint));
+    if (data.size() == 0 || data.size() != data[0] + 1) return false;
+
+    for (uind i = 1; i < data.size(); i++)
+        add.push(N[data[i]]);
+    return true;
+}
+#endif
+
+
+// Candidate flop orders for refinement: 0 = netlist order, 1 = reverse order, 2.. = random.
+static
+void refineOrder(NetlistRef N, uint k, uint64& seed, Vec<Wire>& ord)
+{
+    For_Gatetype(N, gate_Flop, w)
+        ord.push(w);
+    if (k == 1)
+        reverse(ord);
+    else if (k > 1)
+        shuffle(seed, ord);
+}
+
+
+// Each of the 'n_orders' flop orders yields a set of flops that removes the current counterexample
+// (selected greedily by X-simulation); the smallest set is added to the abstraction. If 'fork_orders'
+// is set (and 'n_orders > 1'), every order is instead handed to a forked worker which also performs
+// the expensive part: rechecking 'p_bads' by BMC on the refined abstraction (see
+// 'refineCheckChild()'). The smallest abstraction proved UNSAT by a worker then replaces the current
+// one and 'proved' is set, so the caller need not solve this depth again. Returns FALSE if the
+// counterexample is proper (cannot be refined).
+bool refineAbstraction(AbsTrace& T, uint depth, Wire bad, Vec<Wire>& p_bads, uint n_orders, bool fork_orders, uint64& seed, /*out*/bool& proved, /*in*/Cex* cex0 = NULL)
 {
+    proved = false;
+
     // Create orders:
-    const uint n_orders = 1;        // (wasn't useful to have multiple orders, just keep one)
-    Vec<Wire> ord[n_orders], add[n_orders];
+    Vec<Vec<Wire> > ord(n_orders), add(n_orders);
+    for (uint k = 0; k < n_orders; k++)
+        refineOrder(T.design(), k, seed, ord[k]);
+
+    Cex cex;
+    if (cex0) cex0->copyTo(cex);
+    else      T.getCex(depth, cex);
 
-    For_Gatetype(T.design(), gate_Flop, w)
-        ord[0].push(w);
+    // Greedy selection by X-simulation (cheap) for every order:
+    if (!refineSelectFlops(T, depth, bad, ord[0], add[0], &cex))
+        return false;   // -- proper counterexample; no order can refine it
 
-    bool ret = refineSelectFlops(T, depth, bad, ord[0], add[0], cex0);
     uint best_i = 0;
+    for (uint k = 1; k < n_orders; k++){
+        bool changed ___unused = refineSelectFlops(T, depth, bad, ord[k], add[k], &cex);
+        assert(changed);
+        if (add[k].size() < add[best_i].size())
+            best_i = k;
+    }
+
+  #if !defined(_MSC_VER)
+    if (fork_orders && n_orders > 1){
+        Vec<int>   fds(n_orders, -1);
+        Vec<pid_t> pids(n_orders, -1);
+        fflush(stdout);
+        for (uint k = 0; k < n_orders; k++){
+            int fd[2];
+            if (pipe(fd) != 0) continue;
+            pid_t pid = fork();
+            if (pid == 0){
+                close(fd[0]);
+                refineCheckChild(fd[1], T, depth, bad, p_bads, ord[k], add[k]);
+            }
+            close(fd[1]);
+            if (pid < 0){ close(fd[0]); continue; }
+            fds[k]  = fd[0];
+            pids[k] = pid;
+        }
+
+        Vec<Wire> best;
+        bool      found = false;
+        for (uint k = 0; k < n_orders; k++){
+            if (pids[k] < 0) continue;
+            Vec<Wire> abstr;
+            if (readSelectChild(fds[k], T.design(), abstr) && (!found || abstr.size() < best.size())){
+                abstr.copyTo(best);
+                found = true;
+            }
+            close(fds[k]);
+            waitpid(pids[k], NULL, 0);
+        }
 
-    // Extend abstraction:
+        if (found){
+            T.setAbstr(best);
+            proved = true;
+            return true;
+        }
+        // -- no worker completed; fall back to the smallest greedy selection
+    }
+  #endif
+
+    // Extend abstraction with the smallest set:
     for (uind i = 0; i < add[best_i].size(); i++)
         T.extendAbstr(add[best_i][i]);
 
-    return ret;
+    return true;
 }
 
 
@@ -662,7 +833,9 @@ void localAbstr(NetlistRef N0, Vec<Wire>& props, const Params_LocalAbstr& P, /*i
     bool abstr_sent = false;
     uint sent_size = UINT_MAX;
     bool dwr = (P.dump_prefix != "");
+    uint64 seed = DEFAULT_SEED;
     uint dwr_counter = 1;
+    bool proved = false;    // -- set if parallel refinement already proved the current depth UNSAT
 
     if (!P.quiet) writeAbstrProgressHeader();
     Write_Progress(false);
@@ -686,12 +859,13 @@ void localAbstr(NetlistRef N0, Vec<Wire>& props, const Params_LocalAbstr& P, /*i
 
         Wire  p_bad  = T.insert(depth, bad);
         if (p_bads.size() == 0 || p_bads.last() != p_bad) p_bads.push(p_bad);
-        lbool result = T.solve(p_bads);
+        lbool result = proved ? l_False : T.solve(p_bads);
+        proved = false;
 
         if (result == l_True){
             n_stable = 0;
             n_cex++;
-            if (!refineAbstraction(T, depth, bad)){
+            if (!refineAbstraction(T, depth, bad, p_bads, P.ref_orders, P.ref_fork, seed, proved)){
                 Write_Final_Progress;
                 if (!P.quiet){ WriteLn "Abstraction stable. Proper counterexample found!"; }
 
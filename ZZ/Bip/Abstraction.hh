@@ -34,6 +34,10 @@ struct Params_LocalAbstr {
     bool    renumber;       // Renumber PIs and FFs in AIGER file (otherwise dummy PIs/FFs are tied to zero).
     String  dump_prefix;    // If non-empty, AIGER files of abstract models are written while running
 
+    // Refinement:
+    uint    ref_orders;     // Number of flop orders tried for each refinement; the smallest resulting set of flops is used
+    bool    ref_fork;       // Evaluate refinement orders in parallel (forked processes, POSIX only)
+
     // Experimental:
     bool    randomize;
 
@@ -50,6 +54,8 @@ struct Params_LocalAbstr {
         cpu_timeout  (DBL_MAX),
         renumber     (false),
         dump_prefix  (""),
+        ref_orders   (1),
+        ref_fork     (true),
         randomize    (false),
         quiet        (false),
         sat_verbosity(0)
@@ -18,6 +18,13 @@
 
 #include "ParClient.hh"
 
+#if !defined(_MSC_VER)
+  #include <unistd.h>
+  #include <poll.h>
+  #include <signal.h>
+  #include <sys/wait.h>
+#endif
+
 //#define USE_COMPACT_MAPS
 
 namespace ZZ {
@@ -42,6 +49,10 @@ class BmcTrace {
     WZet                keep_f;     // Gates in 'F' that we hypothesize are best kept as SAT variables
     Clausify<MetaSat>   C;
     Vec<MemUnroll>      memu;
+    Vec<lbool>          ext_model;  // -- model reported by a cube worker; overrides 'S' if non-empty
+
+    lbool val(Lit p) const { return (ext_model.size() > 0) ? ext_model[p.id] ^ sign(p) : S.value(p); }
+    void  cubeCands(Vec<Wire>& cands) const;
 
 public:
     BmcTrace(NetlistRef N, EffortCB* cb);
@@ -52,6 +63,11 @@ public:
     bool  force(Wire f);
     lbool solve(const Vec<Wire>& assumps, uint64 timeout = UINT64_MAX);
     lbool solve(Wire p, uint64 timeout = UINT64_MAX) { Vec<Wire> tmp; tmp.push(p); return solve(tmp, timeout); }
+    lbool solveCubes(Wire p, const Params_Bmc& P, uint64 confl_lim = UINT64_MAX);
+        // -- Like 'solve(p)', but if 'P.cube_workers > 0' and 'p' is not decided within 'P.cube_confl'
+        // conflicts, the problem is split into cubes solved by parallel worker processes. If
+        // 'confl_lim' is given, every worker gets that many conflicts; when a worker runs out,
+        // 'l_Undef' is returned.
 
     void  addClause(const Vec<GLit>& clause, uint frame);   // -- GLits are in terms of 'N'.
 
@@ -172,11 +188,12 @@ lbool BmcTrace::solve(const Vec<Wire>& assumps, uint64 timeout)
         for (uind i = 0; i < assumps.size(); i++)
             lits.push(C.clausify(assumps[i]));
         if (timeout != UINT64_MAX){
-            WriteLn "WARNING! Virtual timeout no longer supported.";
-          #if 0
-            S.timeout = timeout;
-          #endif
+            if (S.type != sat_Zz)
+                S.setConflictLim(timeout);      // -- (timeout is now counted in conflicts)
+            else
+                WriteLn "WARNING! Virtual timeout no longer supported.";
         }
+        ext_model.clear();
         return S.solve(lits);
     }catch (Excp_Clausify_Abort){
         return l_Undef;
@@ -198,7 +215,7 @@ void BmcTrace::getModel(Vec<Vec<lbool> >& pi, Vec<Vec<lbool> >& ff) const
             else{
                 Lit p = f2s[x] ^ sign(x);
                 if (+p == lit_Undef) pi[d](num) = l_False;
-                else                 pi[d](num) = S.value(p);
+                else                 pi[d](num) = val(p);
             }
         }
 
@@ -212,7 +229,7 @@ void BmcTrace::getModel(Vec<Vec<lbool> >& pi, Vec<Vec<lbool> >& ff) const
                 else{
                     Lit p = f2s[x] ^ sign(x);
                     if (+p == lit_Undef) ff[d](num) = l_Undef;
-                    else                 ff[d](num) = S.value(p);
+                    else                 ff[d](num) = val(p);
                 }
             }
         }
@@ -241,6 +258,421 @@ void BmcTrace::addClause(const Vec<GLit>& clause, uint frame)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Cube-and-conquer:
+
+
+// Look-ahead splitter working on the fanin cone of 'bad' in the unrolled design. Each candidate
+// is probed in both polarities by forward ternary propagation; the candidate maximizing the product
+// of implied nodes is branched on. A probe that makes 'bad' false (or conflicts with an assumption)
+// is a failed literal: the opposite polarity is added to the cube instead of branching on it.
+class CubeSplitter {
+    Vec<Wire>   cone;       // -- fanin cone of 'bad' in topological order
+    WMap<uint>  pos;        // -- gate -> index in 'cone'
+    Vec<uint>   fo_idx;     // }- fanouts of 'cone[i]' (as indices into 'cone') are
+    Vec<uint>   fo_data;    // }  'fo_data[fo_idx[i]]' .. 'fo_data[fo_idx[i+1] - 1]'
+    Vec<lbool>  val;        // -- ternary value of each node in 'cone'
+    Vec<uint>   trail;      // -- assigned nodes, in assignment order
+    Vec<uint>   cands;      // -- split candidates (indices into 'cone')
+    Vec<uint>   Q;
+    uint        bad_i;
+    bool        bad_sgn;
+    bool        conflict;
+
+    enum { max_cands = 256 };   // -- candidates with the most fanouts in the cone are kept
+
+    lbool eval(uint i) const;
+    void  assign(uint i, lbool v);
+    void  undo(uint n);
+    bool  failed() const { return conflict || (val[bad_i] ^ bad_sgn) == l_False; }
+    void  probe(uint c, bool v, bool& fail, uint& n_implied);
+    void  split(Vec<Wire>& cube, uint depth, Vec<Vec<Wire> >& out);
+
+public:
+    CubeSplitter(Wire bad, const Vec<Wire>& cand_wires);
+    void cubes(uint n_vars, Vec<Vec<Wire> >& out) { Vec<Wire> cube; split(cube, n_vars, out); }
+        // -- At most '2^n_vars' cubes, each a list of wires assumed TRUE. Pruned cubes are left out,
+        // so an empty result means 'bad' is unsatisfiable.
+};
+
+
+CubeSplitter::CubeSplitter(Wire bad, const Vec<Wire>& cand_wires) :
+    pos(UINT_MAX),
+    conflict(false)
+{
+    NetlistRef F = netlist(bad);
+    Vec<gate_id> order;
+    Vec<Wire>    sinks;
+    sinks.push(+bad);
+    upOrder(sinks, order);
+    for (uind i = 0; i < order.size(); i++){
+        cone.push(F[order[i]]);
+        pos(cone[i]) = i;
+    }
+    bad_i   = pos[+bad];
+    bad_sgn = sign(bad);
+
+    // Fanouts within the cone:
+    fo_idx.setSize(cone.size() + 1, 0);
+    for (uint i = 0; i < cone.size(); i++){
+        if (type(cone[i]) != gate_And) continue;
+        fo_idx[pos[+cone[i][0]] + 1]++;
+        fo_idx[pos[+cone[i][1]] + 1]++;
+    }
+    for (uint i = 0; i < cone.size(); i++)
+        fo_idx[i + 1] += fo_idx[i];
+    fo_data.setSize(fo_idx.last());
+    Vec<uint> fill(copy_, fo_idx);
+    for (uint i = 0; i < cone.size(); i++){
+        if (type(cone[i]) != gate_And) continue;
+        fo_data[fill[pos[+cone[i][0]]]++] = i;
+        fo_data[fill[pos[+cone[i][1]]]++] = i;
+    }
+
+    // Constants:
+    val.setSize(cone.size(), l_Undef);
+    for (uint i = 0; i < cone.size(); i++)
+        if (type(cone[i]) == gate_Const)
+            assign(i, (+cone[i] == glit_True) ? l_True : l_False);
+    trail.clear();
+
+    // Candidates:
+    Vec<char> seen(cone.size(), false);
+    Vec<Pair<uint,uint> > cs;
+    for (uint i = 0; i < cand_wires.size(); i++){
+        uint j = pos[+cand_wires[i]];
+        if (j == UINT_MAX || seen[j] || val[j] != l_Undef) continue;
+        seen[j] = true;
+        cs.push(make_tuple(fo_idx[j + 1] - fo_idx[j], j));
+    }
+    sort(cs);
+    reverse(cs);
+    for (uint i = 0; i < cs.size() && i < (uint)max_cands; i++)
+        cands.push(cs[i].snd);
+}
+
+
+lbool CubeSplitter::eval(uint i) const
+{
+    Wire w = cone[i];
+    if (type(w) != gate_And) return l_Undef;
+
+    lbool a = val[pos[+w[0]]] ^ sign(w[0]);
+    lbool b = val[pos[+w[1]]] ^ sign(w[1]);
+    if (a == l_False || b == l_False) return l_False;
+    if (a == l_True  && b == l_True ) return l_True;
+    return l_Undef;
+}
+
+
+// Assign 'cone[i]' and propagate forward. Assigned nodes are not re-derived from their fanins, so
+// an assumed internal node acts as a cut-point (a disagreeing fanin value sets 'conflict').
+void CubeSplitter::assign(uint i, lbool v)
+{
+    assert(val[i] == l_Undef);
+    val[i] = v;
+    trail.push(i);
+    Q.clear();
+    Q.push(i);
+    for (uint q = 0; q < Q.size(); q++){
+        uint j = Q[q];
+        for (uint k = fo_idx[j]; k < fo_idx[j + 1]; k++){
+            uint  f = fo_data[k];
+            lbool u = eval(f);
+            if (u == l_Undef) continue;
+            if (val[f] == l_Undef){
+                val[f] = u;
+                trail.push(f);
+                Q.push(f);
+            }else if (val[f] != u)
+                conflict = true;
+        }
+    }
+}
+
+
+void CubeSplitter::undo(uint n)
+{
+    while (trail.size() > n)
+        val[trail.popC()] = l_Undef;
+    conflict = false;
+}
+
+
+void CubeSplitter::probe(uint c, bool v, bool& fail, uint& n_implied)
+{
+    uint n0 = trail.size();
+    assign(c, lbool_lift(v));
+    fail      = failed();
+    n_implied = trail.size() - n0;
+    undo(n0);
+}
+
+
+void CubeSplitter::split(Vec<Wire>& cube, uint depth, Vec<Vec<Wire> >& out)
+{
+    uint n0  = trail.size();
+    uint sz0 = cube.size();
+
+    // Probe candidates (failed literals are asserted on the spot):
+    bool   pruned = false;
+    uint   best = UINT_MAX;
+    uint64 best_score = 0;
+    for (uint i = 0; i < cands.size(); i++){
+        uint c = cands[i];
+        if (val[c] != l_Undef) continue;
+
+        bool f0, f1;
+        uint n_0, n_1;
+        probe(c, false, f0, n_0);
+        probe(c, true , f1, n_1);
+        if (f0 || f1){
+            if (f0 && f1){ pruned = true; break; }
+            cube.push(cone[c] ^ f1);
+            assign(c, lbool_lift(f0));
+            if (failed()){ pruned = true; break; }
+            continue;
+        }
+
+        uint64 score = uint64(n_0 + 1) * (n_1 + 1);
+        if (score > best_score){
+            best = c;
+            best_score = score; }
+    }
+
+    if (!pruned){
+        if (depth == 0 || best == UINT_MAX || val[best] != l_Undef || (val[bad_i] ^ bad_sgn) == l_True){
+            out.push();
+            cube.copyTo(out.last());
+        }else{
+            for (uint v = 0; v < 2; v++){
+                uint n = trail.size();
+                cube.push(cone[best] ^ (v == 0));
+                assign(best, lbool_lift(v == 1));
+                if (!failed())
+                    split(cube, depth - 1, out);
+                undo(n);
+                cube.pop();
+            }
+        }
+    }
+
+    undo(n0);
+    cube.shrinkTo(sz0);
+}
+
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+
+// Split candidates: primary inputs and flop outputs of all unrolled frames that are SAT variables.
+void BmcTrace::cubeCands(Vec<Wire>& cands) const
+{
+    for (uint d = 0; d < n2f.size(); d++){
+        For_Gatetype(N, gate_PI, w){
+            Wire x = n2f[d][w];
+            if (x && type(x) != gate_Const && f2s[+x] != lit_Undef)
+                cands.push(+x);
+        }
+        For_Gatetype(N, gate_Flop, w){
+            Wire x = n2f[d][w];
+            if (x && type(x) != gate_Const && f2s[+x] != lit_Undef)
+                cands.push(+x);
+        }
+    }
+}
+
+
+#if !defined(_MSC_VER)
+// Worker process: solves the cubes whose indices it reads from 'job_fd' and reports each result to
+// 'out_fd' as one byte ('u'nsat, 'x' = undetermined). A satisfiable cube is reported as 's' followed
+// by the model (one 'lbool' per SAT variable), after which the worker exits. So does a worker that
+// has spent its 'confl_lim' conflicts. Never returns.
+static
+void cubeWorker(MetaSat& S, int job_fd, int out_fd, Lit bad, const Vec<Vec<Lit> >& cubes, uint64 confl_lim)
+{
+    Vec<Lit>   assumps;
+    Vec<lbool> model;
+    Vec<uchar> msg;
+    uint       i;
+    uint64     confl0 = S.nConflicts();
+    while (read(job_fd, &i, sizeof(uint)) == sizeof(uint)){
+        assumps.clear();
+        assumps.push(bad);
+        append(assumps, cubes[i]);
+        if (confl_lim != UINT64_MAX){
+            uint64 used = S.nConflicts() - confl0;
+            S.setConflictLim((used < confl_lim) ? confl_lim - used : 1);
+        }
+        lbool result = S.solve(assumps);
+
+        msg.clear();
+        if (result == l_True){
+            msg.push('s');
+            S.getModel(model);
+            for (uint x = 0; x < model.size(); x++)
+                msg.push(model[x].value);
+        }else
+            msg.push((result == l_False) ? 'u' : 'x');
+
+        const uchar* p = msg.base();
+        size_t       n = msg.size();
+        while (n > 0){
+            ssize_t m = write(out_fd, p, n);
+            if (m <= 0) _exit(1);
+            p += m; n -= m;
+        }
+        if (result != l_False) break;
+    }
+    _exit(0);
+}
+#endif
+
+
+lbool BmcTrace::solveCubes(Wire p, const Params_Bmc& P, uint64 confl_lim)
+{
+    if (P.cube_workers == 0)
+        return solve(p, confl_lim);
+
+    if (S.type == sat_Zz)
+        confl_lim = UINT64_MAX;     // -- (ZzSat has no conflict limit)
+
+    // Give the main solver a chance first:
+    uint64 confl_first = min_(P.cube_confl, confl_lim);
+    if (confl_first != UINT64_MAX && S.type != sat_Zz){
+        lbool result = solve(p, confl_first);
+        if (result != l_Undef || confl_first == confl_lim) return result;
+    }
+
+  #if defined(_MSC_VER)
+    return solve(p, confl_lim);
+  #else
+    Lit bad;
+    try{
+        bad = C.clausify(p);
+    }catch (Excp_Clausify_Abort){
+        return l_Undef;
+    }
+
+    // Split:
+    Vec<Wire> cands;
+    cubeCands(cands);
+    Vec<Vec<Wire> > w_cubes;
+    {
+        CubeSplitter split(p, cands);
+        split.cubes(min_(P.cube_vars, 12u), w_cubes);     // -- (all cube indices must fit in the job pipe)
+    }
+    if (w_cubes.size() == 0)
+        return l_False;
+    else if (w_cubes.size() == 1)
+        return solve(p, confl_lim);     // -- nothing to split on
+    if (!P.quiet) WriteLn "  -- cube-and-conquer: %_ cubes from %_ candidates", w_cubes.size(), cands.size();
+
+    Vec<Vec<Lit> > cubes(w_cubes.size());
+    for (uint i = 0; i < w_cubes.size(); i++)
+        for (uint j = 0; j < w_cubes[i].size(); j++)
+            cubes[i].push(f2s[+w_cubes[i][j]] ^ sign(w_cubes[i][j]));
+
+    // Queue all cubes in a job pipe shared by the workers:
+    int job[2];
+    if (pipe(job) != 0)
+        return solve(p, confl_lim);
+    for (uint i = 0; i < cubes.size(); i++)
+        if (write(job[1], &i, sizeof(uint)) != sizeof(uint)){
+            close(job[0]); close(job[1]);
+            return solve(p, confl_lim); }
+    close(job[1]);
+
+    // Fork workers (each gets a private copy of the solver, learned clauses included):
+    Vec<int>   fds;
+    Vec<pid_t> pids;
+    std_out.flush();
+    for (uint k = 0; k < P.cube_workers; k++){
+        int fd[2];
+        if (pipe(fd) != 0) break;
+        pid_t pid = fork();
+        if (pid == 0){
+            close(fd[0]);
+            cubeWorker(S, job[0], fd[1], bad, cubes, confl_lim);
+        }
+        close(fd[1]);
+        if (pid < 0){ close(fd[0]); break; }
+        fds.push(fd[0]);
+        pids.push(pid);
+    }
+    close(job[0]);
+
+    // Collect results until a cube is SAT or all workers are done:
+    uint n_unsat = 0;
+    bool sat = false;
+    Vec<Vec<uchar> > buf(fds.size());
+    Vec<char>        alive(fds.size(), true);
+    uint             n_alive = fds.size();
+    Vec<pollfd>      pfds;
+    Vec<uint>        which;
+    char             tmp[4096];
+    while (n_alive > 0 && !sat){
+        pfds.clear();
+        which.clear();
+        for (uint k = 0; k < fds.size(); k++){
+            if (!alive[k]) continue;
+            pollfd x;
+            x.fd = fds[k];
+            x.events = POLLIN;
+            x.revents = 0;
+            pfds.push(x);
+            which.push(k);
+        }
+        if (poll(pfds.base(), pfds.size(), -1) < 0){
+            if (errno == EINTR) continue;
+            break; }
+
+        for (uint i = 0; i < pfds.size(); i++){
+            if (pfds[i].revents == 0) continue;
+            uint    k = which[i];
+            ssize_t m = read(fds[k], tmp, sizeof(tmp));
+            if (m > 0){
+                for (ssize_t j = 0; j < m; j++)
+                    buf[k].push(tmp[j]);
+                continue; }
+
+            // Worker finished:
+            alive[k] = false;
+            n_alive--;
+            for (uint j = 0; j < buf[k].size(); j++){
+                if (buf[k][j] == 'u')
+                    n_unsat++;
+                else if (buf[k][j] == 's' && buf[k].size() == j + 1 + nVars()){
+                    ext_model.setSize(nVars());
+                    for (uint x = 0; x < nVars(); x++)
+                        ext_model[x] = lbool_new(buf[k][j + 1 + x]);
+                    sat = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (uint k = 0; k < fds.size(); k++){
+        if (alive[k]) kill(pids[k], SIGKILL);
+        close(fds[k]);
+        waitpid(pids[k], NULL, 0);
+    }
+
+    if (sat)
+        return l_True;
+    else if (n_unsat == cubes.size())
+        return l_False;
+    else if (confl_lim != UINT64_MAX)
+        return l_Undef;     // -- budget exhausted; let the caller decide what to do next
+    else{
+        WriteLn "WARNING! Cube workers did not complete; solving frame sequentially.";
+        return solve(p, confl_lim);
+    }
+  #endif
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Look-ahead BMC:
 
@@ -269,7 +701,7 @@ lbool lookaheadBmc(BmcTrace& T, const Params_Bmc& P, Cex* cex, int* bf_depth, Ne
 
             Write " %_\f", d + step;
             Wire  w_bad  = T.insert(init_bad[1], d + step);
-            lbool result = T.solve(w_bad, uint64(pow(P.la_decay, (double)step)* timeout_base));
+            lbool result = T.solveCubes(w_bad, P, uint64(pow(P.la_decay, (double)step)* timeout_base));
 
             if (result == l_True){
                 NewLine;
@@ -404,7 +836,7 @@ lbool bmc_(NetlistRef N0, const Vec<Wire>& props, const Params_Bmc& P, Cex* cex,
             if (!(*cb)())
                 return l_Undef;
         }
-        lbool result = T.solve(w_bad);
+        lbool result = T.solveCubes(w_bad, P);
 
         if (result == l_True){
             if (!P.quiet) WriteLn "\a/|\a/ Done!  \a/|\a/  %>5%'D  %>5%'D  %>5%'D  \a/|\a/  %>6%^DB  %>8%t  \a/|\a/",
@@ -30,6 +30,9 @@ struct Params_Bmc {
     bool    quant_claus;
     uint    la_steps;           // -- look-ahead frames
     double  la_decay;           // -- relative focus between step k and k+1 (< 1 means less focus on k+1)
+    uint    cube_workers;       // -- if non-zero, hard frames are split into cubes solved by this many processes
+    uint    cube_vars;          // -- split depth (at most '2^cube_vars' cubes per frame)
+    uint64  cube_confl;         // -- conflicts spent on a frame before splitting it ('UINT64_MAX' = split at once)
     bool    quiet;
     bool    par_send_result;
 
@@ -39,6 +42,9 @@ struct Params_Bmc {
         quant_claus    (false),
         la_steps       (1),
         la_decay       (0.8),
+        cube_workers   (0),
+        cube_vars      (6),
+        cube_confl     (10000),
         quiet          (false),
         par_send_result(true)
     {}
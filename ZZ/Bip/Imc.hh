@@ -36,6 +36,8 @@ struct Params_ImcStd {
     bool    spin;
     bool    quiet;
     bool    par_send_result;
+    uint    spill_mb;           // -- if non-zero, keep proof-log on disk with this much in memory
+    bool    compact_itp;        // -- resynthesize interpolants (SAT-sweeping, support reduction, balancing)
 
     Params_ImcStd() :
         fwd            (true),
@@ -46,7 +48,9 @@ struct Params_ImcStd {
         quant_claus    (false),
         spin           (false),
         quiet          (false),
-        par_send_result(true)
+        par_send_result(true),
+        spill_mb       (0),
+        compact_itp    (false)
     {}
 };
 
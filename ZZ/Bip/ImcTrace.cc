@@ -17,6 +17,7 @@
 #include "ZZ_Netlist.hh"
 #include "ZZ/Generics/Sort.hh"
 #include "ZZ_Bip.Common.hh"
+#include "ItpCompact.hh"
 
 namespace ZZ {
 using namespace std;
@@ -29,7 +30,8 @@ using namespace std;
 
 
 ImcTrace::ImcTrace(NetlistRef N0_, const Vec<Wire>& props_, bool forward, EffortCB* cb,
-                   bool simplify_itp_, bool simple_tseitin, bool quant_claus, bool prune_itp_) :
+                   bool simplify_itp_, bool simple_tseitin, bool quant_claus, bool prune_itp_, uint spill_mb,
+                   bool compact_itp_) :
     N0(N0_),
     props(copy_, props_),
     fwd(forward),
@@ -41,7 +43,8 @@ ImcTrace::ImcTrace(NetlistRef N0_, const Vec<Wire>& props_, bool forward, Effort
     CB(S, B, b2s, keep_B, &cb_CB),
     prune(N, ff),
     simplify_itp(simplify_itp_),
-    prune_itp(prune_itp_)
+    prune_itp(prune_itp_),
+    compact_itp(compact_itp_)
 {
     Add_Pob0(H, strash);
     Add_Pob0(B, strash);
@@ -51,6 +54,12 @@ ImcTrace::ImcTrace(NetlistRef N0_, const Vec<Wire>& props_, bool forward, Effort
     CH.quant_claus    = quant_claus;
     CB.quant_claus    = quant_claus;
 
+    if (spill_mb > 0){
+        uint64 n_chunks = ((uint64)spill_mb << 20) >> PfStore_ChunkBits;
+        if (!S.proofSpill((uint)max_(n_chunks, (uint64)1)))
+            WriteLn "WARNING! Proof spilling not supported on this platform.";
+    }
+
     initNetlist();
     if (cb){
         S.timeout         = VIRT_TIME_QUANTA;
@@ -162,6 +171,19 @@ Wire ImcTrace::insertI(Wire s, WMap<Wire>& s2i)
 }
 
 
+// Resynthesize interpolant 'itp' into 'T' (which may be where 'itp' currently lives).
+Wire ImcTrace::compact(Wire itp)
+{
+    Netlist N_tmp;
+    Add_Pob0(N_tmp, strash);
+    Wire w = copyFormula(itp, N_tmp);
+
+    T.clear();
+    Add_Pob0(T, strash);
+    return compactItp(w, T);
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Public interface:
 
@@ -404,6 +426,8 @@ Wire ImcTrace::approxImage(Wire s, uint k)
             //**/ShoutLn "%_ -> %_ -> %_   (%.1f %% vs. %.1f %%)", sz0, sz1, sz2, double(sz1) / sz0 * 100, double(sz2) / sz0 * 100;
             //ZZ_PTimer_End(SimplifyItp);
         }
+        if (compact_itp)
+            ret = compact(ret);
         if (prune_itp && fwd){
             ret = prune.prune(init, ret, k); }
 
@@ -509,6 +533,8 @@ Wire ImcTrace::spinImage(Wire s, uint k)
             //**/uind sz2 = dagSize(ret);
             //**/ShoutLn "%_ -> %_ -> %_   (%.1f %% vs. %.1f %%)", sz0, sz1, sz2, double(sz1) / sz0 * 100, double(sz2) / sz0 * 100;
         }
+        if (compact_itp)
+            ret = compact(ret);
 
     }else if (result == l_True){
         ret = Wire_NULL;
@@ -89,6 +89,7 @@ class ImcTrace {
 
     bool             simplify_itp;
     bool             prune_itp;
+    bool             compact_itp;
 
   //________________________________________
   //  Helpers:
@@ -97,13 +98,18 @@ class ImcTrace {
     Wire insertH(Wire w);
     Wire insertB(Wire w, uint d);
     Wire insertI(Wire s, WMap<Wire>& s2i);
+    Wire compact(Wire itp);
 
 public:
   //________________________________________
   //  Public interface:
 
     ImcTrace(NetlistRef N0_, const Vec<Wire>& props_, bool forward, EffortCB* cb = NULL,
-             bool simplify_itp_ = false, bool simple_tseitin = false, bool quant_claus = false, bool prune_itp = false);
+             bool simplify_itp_ = false, bool simple_tseitin = false, bool quant_claus = false, bool prune_itp = false,
+             uint spill_mb = 0, bool compact_itp = false);
+        // -- If 'spill_mb' is non-zero, the proof-log of the SAT solver is kept in a memory-mapped
+        // temporary file, with roughly that many megabytes in the working set. If 'compact_itp' is
+        // set, interpolants are resynthesized by 'compactItp()' before being returned.
 
     NetlistRef design() const { return N; }
         // -- Returns the simplified version of 'N0' (with pobs: strash, fanout_count, init_bad)
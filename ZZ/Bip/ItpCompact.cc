@@ -0,0 +1,557 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : ItpCompact.cc
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Resynthesis of interpolants (SAT-sweeping, support reduction, balancing).
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Interpolants extracted from resolution proofs contain a lot of functional redundancy (the
+//| same sub-function derived along many different proof paths). The interpolant is first copied
+//| into a working netlist 'F' while being "fraiged": every new AND node is simulated and, if its
+//| signature matches an existing node, a SAT check is made to merge the two. Then inputs that the
+//| function does not depend on are removed (co-factor equivalence check). Finally the result is
+//| copied to the destination netlist with AND-trees rebuilt in a depth balanced fashion.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "ItpCompact.hh"
+#include "ZZ_MiniSat.hh"
+#include "ZZ/Generics/Map.hh"
+#include "ZZ/Generics/Sort.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helpers:
+
+
+static
+uind coneSize(Wire w0)
+{
+    if (type(w0) != gate_And) return 0;
+    WZet seen;
+    seen.add(+w0);
+    uind n = 0;
+    for (uind i = 0; i < seen.size(); i++){
+        Wire w = seen.list()[i];
+        if (type(w) == gate_And){
+            n++;
+            seen.add(+w[0]);
+            seen.add(+w[1]);
+        }
+    }
+    return n;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'ItpCompact':
+
+
+class ItpCompact {
+    const Params_ItpCompact& P;
+    Info_ItpCompact&         info;
+
+    Netlist         F;          // Working netlist (strashed)
+    uint            n_words;    // 'sim_words + cex_words'
+    Vec<uint64>     sim;        // Simulation vectors: 'sim[id * n_words + j]'
+    Vec<uchar>      has_sim;    // Indexed on gate ID
+    Vec<gate_id>    order;      // Nodes of 'F' in creation (= topological) order
+    uint64          seed;
+    uint            cex_slot;   // Next bit to use for counterexample patterns
+
+    // Equivalence candidates:
+    Map<uint64, gate_id> bucket;    // Hash of normalized signature -> first representative
+    Vec<gate_id>    next_rep;   // Chaining of representatives with the same hash
+    Vec<gate_id>    reps;
+    WMap<Wire>      repr;       // Merged node -> representative (with sign), or 'Wire_NULL'
+
+    // SAT:
+    SatStd          S;
+    WMap<Lit>       f2s;
+    uint64          pair_work;  // Propagation work spent on the current equivalence check
+
+    uint64*  simOf  (Wire w) { return &sim[id(w) * n_words]; }
+    void     simulate(Wire w);
+    uint64   sigHash(Wire w, bool& phase);
+    bool     sigEqual(Wire w, Wire v, bool phase);
+    void     addRep(gate_id g);
+    void     rehashReps();
+    void     addCex();
+
+    Lit      satLit(Wire w);
+    static bool pairBudgetCB(uint64 work, void* data);
+    lbool    checkEquiv(Wire w, Wire v);    // -- 'l_True' = equivalent, 'l_False' = cex stored, 'l_Undef' = budget exceeded
+
+    Wire     mkSource(Wire w_src);
+    Wire     mkAnd(Wire x, Wire y);
+    Wire     sweep(Wire w);
+    Wire     cofactor(Wire w, Wire x, bool value, WMap<Wire>& memo);
+
+    Vec<Wire>       pi, ff;     // Sources of destination netlist (by number)
+    Wire     copyOut(Wire w, NetlistRef M, WMap<Wire>& memo, WMap<uint>& level, const WMap<uint>& n_fanouts);
+
+public:
+    ItpCompact(const Params_ItpCompact& P_, Info_ItpCompact& info_);
+
+    Wire copyIn(Wire w_itp);
+    Wire reduceSupport(Wire f);
+    Wire copyOut(Wire f, NetlistRef M);
+};
+
+
+ItpCompact::ItpCompact(const Params_ItpCompact& P_, Info_ItpCompact& info_) :
+    P(P_),
+    info(info_),
+    n_words(P_.sim_words + max_(P_.cex_words, 1u)),
+    seed(P_.seed),
+    cex_slot(0),
+    pair_work(0)
+{
+    Add_Pob0(F, strash);
+    S.timeout_cb      = pairBudgetCB;   // -- budget is per equivalence check (see 'checkEquiv()')
+    S.timeout_cb_data = this;
+
+    Wire t = F.True();
+    has_sim(id(t), 0) = 1;
+    sim.growTo((id(t) + 1) * n_words, 0);
+    for (uint j = 0; j < n_words; j++)
+        simOf(t)[j] = ~0ull;
+    f2s(t) = S.True();
+    addRep(id(t));
+}
+
+
+//=================================================================================================
+// -- Simulation:
+
+
+void ItpCompact::simulate(Wire w)
+{
+    has_sim(id(w), 0) = 1;
+    sim.growTo((id(w) + 1) * n_words, 0);
+    uint64* s = simOf(w);
+
+    if (type(w) == gate_And){
+        uint64* s0 = simOf(w[0]); uint64 m0 = sign(w[0]) ? ~0ull : 0ull;
+        uint64* s1 = simOf(w[1]); uint64 m1 = sign(w[1]) ? ~0ull : 0ull;
+        for (uint j = 0; j < n_words; j++)
+            s[j] = (s0[j] ^ m0) & (s1[j] ^ m1);
+    }else{
+        for (uint j = 0; j < n_words; j++)
+            s[j] = irandl(seed);
+    }
+}
+
+
+// Signatures are normalized so that the first pattern is 0; 'phase' tells if 'w' was negated.
+uint64 ItpCompact::sigHash(Wire w, bool& phase)
+{
+    const uint64* s = simOf(w);
+    phase = (s[0] & 1);
+    uint64 m = phase ? ~0ull : 0ull;
+    uint64 h = 0;
+    for (uint j = 0; j < n_words; j++)
+        h = (h ^ (s[j] ^ m)) * 0x9E3779B97F4A7C15ull;
+    return h;
+}
+
+
+bool ItpCompact::sigEqual(Wire w, Wire v, bool phase)
+{
+    const uint64* s = simOf(w);
+    const uint64* t = simOf(v);
+    uint64 m = phase ? ~0ull : 0ull;
+    for (uint j = 0; j < n_words; j++)
+        if (s[j] != (t[j] ^ m)) return false;
+    return true;
+}
+
+
+void ItpCompact::addRep(gate_id g)
+{
+    bool     phase;
+    uint64   h = sigHash(F[g], phase);
+    gate_id* head;
+    if (!bucket.get(h, head))
+        *head = gid_NULL;
+    next_rep(g, gid_NULL) = *head;
+    *head = g;
+    reps.push(g);
+}
+
+
+void ItpCompact::rehashReps()
+{
+    bucket.clear();
+    Vec<gate_id> rs;
+    reps.moveTo(rs);
+    for (uind i = 0; i < rs.size(); i++)
+        addRep(rs[i]);
+}
+
+
+// Store the current SAT model as a new simulation pattern and re-simulate.
+void ItpCompact::addCex()
+{
+    uint   word = P.sim_words + (cex_slot >> 6) % max_(P.cex_words, 1u);
+    uint64 bit  = 1ull << (cex_slot & 63);
+    cex_slot++;
+
+    for (uind i = 0; i < order.size(); i++){
+        Wire w = F[order[i]];
+        uint64& s = simOf(w)[word];
+        if (type(w) == gate_And){
+            bool v = (((simOf(w[0])[word] & bit) != 0) ^ sign(w[0]))
+                  && (((simOf(w[1])[word] & bit) != 0) ^ sign(w[1]));
+            if (v) s |= bit; else s &= ~bit;
+        }else{
+            Lit  p = f2s[w];
+            bool v = (p != lit_Undef && S.value(p) != l_Undef) ? (S.value(p) == l_True) : (irandl(seed) & 1);
+            if (v) s |= bit; else s &= ~bit;
+        }
+    }
+    rehashReps();
+}
+
+
+//=================================================================================================
+// -- SAT:
+
+
+Lit ItpCompact::satLit(Wire w)
+{
+    Lit p = f2s[w];
+    if (p == lit_Undef){
+        if (type(w) == gate_And){
+            Lit a = satLit(w[0]);
+            Lit b = satLit(w[1]);
+            p = S.addLit();
+            S.addClause(~p, a);
+            S.addClause(~p, b);
+            S.addClause(p, ~a, ~b);
+        }else
+            p = S.addLit();
+        f2s(w) = p;
+    }
+    return p ^ sign(w);
+}
+
+
+// The solver reports its work at time-outs and at the end of each 'solve()' (after which its
+// virtual time starts over); solving continues while the current pair is within its budget.
+bool ItpCompact::pairBudgetCB(uint64 work, void* data)
+{
+    ItpCompact& C = *(ItpCompact*)data;
+    C.pair_work += work;
+    return C.pair_work < C.P.pair_budget;
+}
+
+
+lbool ItpCompact::checkEquiv(Wire w, Wire v)
+{
+    Lit p = satLit(w);
+    Lit q = satLit(v);
+
+    pair_work = 0;
+    for (uint dir = 0; dir < 2; dir++){
+        info.sat_calls++;
+        S.timeout = P.pair_budget - pair_work;
+        lbool result = dir == 0 ? S.solve(p, ~q) : S.solve(~p, q);
+        if (result == l_True){
+            addCex();
+            return l_False;
+        }else if (result == l_Undef){
+            info.sat_undef++;
+            return l_Undef;
+        }
+    }
+    return l_True;
+}
+
+
+//=================================================================================================
+// -- Building 'F':
+
+
+Wire ItpCompact::mkSource(Wire w_src)
+{
+    int  num = (type(w_src) == gate_PI) ? attr_PI(w_src).number : attr_Flop(w_src).number;
+    Wire w = (type(w_src) == gate_PI) ? (num == num_NULL ? F.add(PI_()) : F.add(PI_(num)))
+                                      : F.add(Flop_(num));
+    simulate(w);
+    order.push(id(w));
+    return w;
+}
+
+
+Wire ItpCompact::mkAnd(Wire x, Wire y)
+{
+    Wire w = s_And(x, y);
+    if (!has_sim(id(w), 0)){
+        simulate(+w);
+        order.push(id(w));
+        if (P.sweep)
+            return sweep(+w) ^ sign(w);
+        addRep(id(w));
+
+    }else if (repr[w]){
+        // -- strash returned a node that was already merged into a representative:
+        return repr[w] ^ sign(w);
+    }
+    return w;
+}
+
+
+// Try to merge 'w' (a new node) with an existing representative. Returns the node to use.
+Wire ItpCompact::sweep(Wire w)
+{
+    for(;;){
+        bool     phase;
+        uint64   h = sigHash(w, phase);
+        gate_id* head;
+        if (!bucket.peek(h, head)) break;
+
+        bool refined = false;
+        for (gate_id g = *head; g != gid_NULL; g = next_rep[g]){
+            Wire r = F[g];
+            bool r_phase;
+            sigHash(r, r_phase);
+            if (!sigEqual(w, r, phase ^ r_phase)) continue;
+
+            Wire v = r ^ (phase ^ r_phase);
+            lbool result = checkEquiv(w, v);
+            if (result == l_True){
+                info.merged++;
+                repr(w) = v;
+                return v;
+            }else if (result == l_False){
+                refined = true;     // -- signatures have changed; start over
+                break;
+            }
+        }
+        if (!refined) break;
+    }
+
+    addRep(id(w));
+    return w;
+}
+
+
+Wire ItpCompact::copyIn(Wire w_itp)
+{
+    if (type(w_itp) == gate_Const){
+        assert(+w_itp == glit_True);
+        return F.True() ^ sign(w_itp); }
+
+    NetlistRef   N = netlist(w_itp);
+    Vec<gate_id> topo;
+    Vec<Wire>    sinks(1, w_itp);
+    upOrder(sinks, topo);
+
+    WMap<Wire> xlat;
+    xlat(N.True()) = F.True();
+    for (uind i = 0; i < topo.size(); i++){
+        Wire w = N[topo[i]];
+        switch (type(w)){
+        case gate_PI:
+        case gate_Flop:
+            xlat(w) = mkSource(w);
+            break;
+        case gate_And:
+            xlat(w) = mkAnd(xlat[w[0]] ^ sign(w[0]), xlat[w[1]] ^ sign(w[1]));
+            break;
+        default: assert(false); }
+    }
+
+    return xlat[w_itp] ^ sign(w_itp);
+}
+
+
+//=================================================================================================
+// -- Support reduction:
+
+
+Wire ItpCompact::cofactor(Wire w, Wire x, bool value, WMap<Wire>& memo)
+{
+    if (+w == +x) return F.True() ^ !value ^ sign(w);
+    if (type(w) != gate_And) return w;
+
+    Wire ret = memo[w];
+    if (!ret){
+        ret = mkAnd(cofactor(w[0], x, value, memo), cofactor(w[1], x, value, memo));
+        memo(+w) = ret;
+    }
+    return ret ^ sign(w);
+}
+
+
+Wire ItpCompact::reduceSupport(Wire f)
+{
+    // Collect support:
+    Vec<Wire> sup;
+    WZet seen;
+    seen.add(+f);
+    for (uind i = 0; i < seen.size(); i++){
+        Wire w = seen.list()[i];
+        if (type(w) == gate_And){
+            seen.add(+w[0]);
+            seen.add(+w[1]);
+        }else if (type(w) == gate_PI || type(w) == gate_Flop)
+            sup.push(w);
+    }
+
+    uint n_checks = 0;
+    for (uind i = 0; i < sup.size() && n_checks < P.max_sup_checks; i++){
+        if (type(f) != gate_And) break;
+
+        WMap<Wire> memo0, memo1;
+        Wire f0 = cofactor(f, sup[i], false, memo0);
+        Wire f1 = cofactor(f, sup[i], true , memo1);
+        if (f0 == f1){
+            info.sup_removed++;
+            f = f0;
+            continue; }
+
+        // Quick simulation check (co-factors differ on some pattern => depends on input):
+        if (!sigEqual(+f0, +f1, sign(f0) ^ sign(f1))) continue;
+
+        n_checks++;
+        if (checkEquiv(f0, f1) == l_True){
+            info.sup_removed++;
+            f = f0; }
+    }
+
+    return f;
+}
+
+
+//=================================================================================================
+// -- Copy out with balancing:
+
+
+struct ItpLevel_lt {
+    const WMap<uint>& level;
+    ItpLevel_lt(const WMap<uint>& level_) : level(level_) {}
+    bool operator()(Wire x, Wire y) const { return level[x] < level[y]; }
+};
+
+
+Wire ItpCompact::copyOut(Wire w, NetlistRef M, WMap<Wire>& memo, WMap<uint>& level, const WMap<uint>& n_fanouts)
+{
+    Wire ret = memo[w];
+    if (!ret){
+        switch (type(w)){
+        case gate_Const: ret = M.True(); assert(+w == glit_True); break;
+        case gate_PI:{
+            int num = attr_PI(w).number;
+            if (num == num_NULL)
+                ret = M.add(PI_());
+            else{
+                if (pi(num, Wire_NULL) == Wire_NULL) pi[num] = M.add(PI_(num));
+                ret = pi[num];
+            }
+            break;}
+        case gate_Flop:{
+            int num = attr_Flop(w).number;
+            if (ff(num, Wire_NULL) == Wire_NULL) ff[num] = M.add(Flop_(num));
+            ret = ff[num];
+            break;}
+
+        case gate_And:{
+            if (!P.balance){
+                Wire x = copyOut(w[0], M, memo, level, n_fanouts);
+                Wire y = copyOut(w[1], M, memo, level, n_fanouts);
+                ret = s_And(x, y);
+                if (level[ret] == 0) level(ret) = max_(level[x], level[y]) + 1;
+                break; }
+
+            Vec<Wire> conj;
+            WZetS     seen;
+            if (!collectConjunction(w, n_fanouts, seen, conj)){
+                ret = ~M.True();
+                break; }
+
+            // Huffman style pairing on level (two-queue method; combined levels are non-decreasing):
+            Vec<Wire> q1(reserve_, conj.size());
+            for (uind i = 0; i < conj.size(); i++)
+                q1.push(copyOut(conj[i], M, memo, level, n_fanouts));
+            sobSort(sob(q1, ItpLevel_lt(level)));
+
+            Vec<Wire> q2;
+            uind i1 = 0, i2 = 0;
+            while ((q1.size() - i1) + (q2.size() - i2) > 1){
+                Wire a[2];
+                for (uint k = 0; k < 2; k++){
+                    if (i2 == q2.size() || (i1 < q1.size() && level[q1[i1]] <= level[q2[i2]]))
+                        a[k] = q1[i1++];
+                    else
+                        a[k] = q2[i2++];
+                }
+                Wire u = s_And(a[0], a[1]);
+                if (type(u) == gate_And && level[u] == 0)
+                    level(u) = max_(level[a[0]], level[a[1]]) + 1;
+                q2.push(u);
+            }
+            ret = (i1 < q1.size()) ? q1[i1] : q2[i2];
+            break;}
+
+        default: assert(false); }
+
+        memo(+w) = ret;
+    }
+    return ret ^ sign(w);
+}
+
+
+Wire ItpCompact::copyOut(Wire f, NetlistRef M)
+{
+    assert(Has_Pob(M, strash));
+
+    // Reuse existing sources of 'M':
+    pi.clear();
+    ff.clear();
+    For_Gatetype(M, gate_PI, w){
+        int num = attr_PI(w).number;
+        if (num != num_NULL) pi(num, Wire_NULL) = w; }
+    For_Gatetype(M, gate_Flop, w){
+        int num = attr_Flop(w).number;
+        if (num != num_NULL) ff(num, Wire_NULL) = w; }
+
+    WMap<uint> n_fanouts;
+    countFanouts(f, n_fanouts);
+
+    WMap<Wire> memo;
+    WMap<uint> level;
+    return copyOut(f, M, memo, level, n_fanouts);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main:
+
+
+Wire compactItp(Wire w_itp, NetlistRef M, const Params_ItpCompact& P, Info_ItpCompact* info_)
+{
+    Info_ItpCompact info;
+    info.size_in = coneSize(w_itp);
+
+    ItpCompact C(P, info);
+    Wire f = C.copyIn(w_itp);
+    if (P.reduce_support)
+        f = C.reduceSupport(f);
+    Wire ret = C.copyOut(f, M);
+
+    info.size_out = coneSize(ret);
+    if (info_) *info_ = info;
+    return ret;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,70 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : ItpCompact.hh
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Resynthesis of interpolants (SAT-sweeping, support reduction, balancing).
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__ItpCompact_hh
+#define ZZ__Bip__ItpCompact_hh
+
+#include "ZZ_Netlist.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Interpolant compaction:
+
+
+struct Params_ItpCompact {
+    bool    sweep;              // -- Merge equivalent nodes (simulation + SAT).
+    bool    reduce_support;     // -- Remove inputs the interpolant does not functionally depend on.
+    bool    balance;            // -- Rebuild AND-trees to minimize depth.
+    uint    sim_words;          // -- Number of 64-bit words of random simulation.
+    uint    cex_words;          // -- Number of 64-bit words reserved for counterexample patterns.
+    uint64  pair_budget;        // -- SAT effort (propagation "virtual time") per equivalence check.
+    uint    max_sup_checks;     // -- At most this many inputs are tried for removal.
+    uint64  seed;
+
+    Params_ItpCompact() :
+        sweep         (true),
+        reduce_support(true),
+        balance       (true),
+        sim_words     (4),
+        cex_words     (4),
+        pair_budget   (200000),
+        max_sup_checks(1000),
+        seed          (0)
+    {}
+};
+
+
+struct Info_ItpCompact {
+    uind    size_in;            // -- DAG size of interpolant before compaction
+    uind    size_out;           // -- DAG size after compaction
+    uint    merged;             // -- nodes merged by SAT-sweeping (including constants)
+    uint    sup_removed;        // -- inputs removed by support reduction
+    uint    sat_calls;
+    uint    sat_undef;          // -- checks that ran out of budget
+
+    Info_ItpCompact() : size_in(0), size_out(0), merged(0), sup_removed(0), sat_calls(0), sat_undef(0) {}
+};
+
+
+Wire compactItp(Wire w_itp, NetlistRef M, const Params_ItpCompact& P = Params_ItpCompact(), Info_ItpCompact* info = NULL);
+    // -- 'w_itp' must only contain gate types: Const, And, PI, Flop (as produced by the interpolator).
+    // The compacted, functionally equivalent formula is built in 'M', which must be strashed.
+    // PIs and Flops are matched on their numbers (as in 'copyFormula()').
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
@@ -0,0 +1,528 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Kind.cc
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : k-induction with base case and inductive step in separate solvers.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| In parallel mode, the step case is run in a child process (so that the two SAT solvers do not
+//| share any memory). The child reports each 'k' for which the step case holds through a pipe;
+//| the parent (running the base case) declares the property proved as soon as it has shown the
+//| absence of counterexamples of length less than 'k'.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "Kind.hh"
+#include "ZZ_Netlist.hh"
+#include "ZZ_MiniSat.hh"
+
+#if !defined(_MSC_VER)
+  #include <unistd.h>
+  #include <fcntl.h>
+  #include <signal.h>
+  #include <sys/wait.h>
+#endif
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Unrolling + SAT:
+
+
+class KindTrace {
+    NetlistRef          N;
+    Netlist             F;
+    SatStd              S;
+    Vec<WMap<Wire> >    n2f;
+    WMap<Lit>           f2s;
+    WZet                keep_f;
+    Clausify<SatStd>    C;
+    Vec<MemUnroll>      memu;
+    Params_Unroll       PU;
+
+public:
+    KindTrace(NetlistRef N_, bool uninit);
+
+    Wire  insert(Wire w, uint d) { return insertUnrolled(w, d, F, n2f, PU); }
+    Lit   clausify(Wire f)       { return C.clausify(f); }
+    void  force(Wire f)          { S.addClause(C.clausify(f)); }
+    lbool solve(const Vec<Lit>& assumps) { return S.solve(assumps); }
+    lbool value(Wire f) const;
+    Lit   addLit()               { return S.addLit(); }
+    void  addClause(const Vec<Lit>& c) { S.addClause(c); }
+
+    NetlistRef trace() const     { return F; }
+    uint       depth() const     { return n2f.size(); }
+    const SatStd& solver() const { return S; }
+
+    void  getModel(Vec<Vec<lbool> >& pi, Vec<Vec<lbool> >& ff) const;
+        // -- For initialized traces (base case).
+};
+
+
+KindTrace::KindTrace(NetlistRef N_, bool uninit) :
+    N(N_),
+    C(S, F, f2s, keep_f)
+{
+    Add_Pob0(F, strash);
+    initMemu(N, memu);
+    PU = Params_Unroll(&keep_f, &memu, uninit);
+}
+
+
+lbool KindTrace::value(Wire f) const
+{
+    if (type(f) == gate_Const) return lbool_lift(+f == f);
+    Lit p = f2s[f];
+    if (p == Lit_NULL) return l_Undef;
+    return S.value(p ^ sign(f));
+}
+
+
+void KindTrace::getModel(Vec<Vec<lbool> >& pi, Vec<Vec<lbool> >& ff) const
+{
+    pi.clear(); pi.setSize(n2f.size());
+    ff.clear(); ff.setSize(1);
+
+    for (uint d = 0; d < pi.size(); d++){
+        For_Gatetype(N, gate_PI, w){
+            int num = attr_PI(w).number;
+            if (num == num_NULL) continue;      // -- free input introduced by an invariant
+            Wire x = n2f[d][w];
+            lbool v = x ? value(x) : l_Undef;
+            pi[d](num) = (v == l_Undef) ? l_False : v;
+        }
+    }
+
+    Get_Pob(N, flop_init);
+    For_Gatetype(N, gate_Flop, w){
+        int num = attr_Flop(w).number;
+        if (num == num_NULL) continue;
+        Wire x = n2f[0][w];
+        lbool v = x ? value(x) : l_Undef;
+        ff[0](num) = (v == l_Undef) ? flop_init[w] : v;
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Step case:
+
+
+class KindStep {
+    const Params_Kind& P;
+    NetlistRef      N;
+    Vec<Wire>       ffs;        // Flops of 'N'
+    Wire            bad;        // In 'N'
+    Wire            inv;        // In 'N'; invariant asserted in every frame
+    KindTrace       T;
+    uint            k;          // Next depth to check
+    uint            n_unique;   // Number of uniqueness constraints added
+
+    void addFrame(uint d);
+    bool addUniqueness();
+
+public:
+    KindStep(const Params_Kind& P_, NetlistRef N_, Wire inv_);
+    lbool step(uint& out_k);
+        // -- Check the next 'k' (returned through 'out_k'). Returns 'l_True' if the property is
+        // k-inductive, 'l_False' if not.
+
+    const SatStd& solver() const { return T.solver(); }
+    uint nUnique() const { return n_unique; }
+};
+
+
+KindStep::KindStep(const Params_Kind& P_, NetlistRef N_, Wire inv_) :
+    P(P_),
+    N(N_),
+    inv(inv_),
+    T(N_, true),
+    k(0),
+    n_unique(0)
+{
+    Get_Pob(N, init_bad);
+    bad = init_bad[1];
+    For_Gatetype(N, gate_Flop, w)
+        ffs.push(w);
+}
+
+
+void KindStep::addFrame(uint d)
+{
+    if (inv != N.True())
+        T.force(T.insert(inv, d));
+
+    if (P.simple_path){
+        for (uind i = 0; i < ffs.size(); i++)
+            T.clausify(T.insert(ffs[i], d));    // -- make state readable from model
+    }
+}
+
+
+// Look for two identical states in the current model. If found, constrain them to be distinct
+// and return TRUE.
+bool KindStep::addUniqueness()
+{
+    Vec<Pair<uint64,uint> > sig;
+    for (uint d = 0; d <= k; d++){
+        uint64 h = 0;
+        for (uind i = 0; i < ffs.size(); i++)
+            h = (h * 3 + (uint64)T.value(T.insert(ffs[i], d)).value) * 0x9E3779B97F4A7C15ull;
+        sig.push(make_tuple(h, d));
+    }
+    sort(sig);
+
+    for (uind n = 1; n < sig.size(); n++){
+        if (sig[n-1].fst != sig[n].fst) continue;
+
+        uint i = sig[n-1].snd;
+        uint j = sig[n].snd;
+        bool equal = true;
+        for (uind m = 0; m < ffs.size(); m++){
+            if (T.value(T.insert(ffs[m], i)) != T.value(T.insert(ffs[m], j))){
+                equal = false; break; }
+        }
+        if (!equal) continue;
+
+        Wire diff = ~T.trace().True();
+        for (uind m = 0; m < ffs.size(); m++)
+            diff = s_Or(diff, s_Xor(T.insert(ffs[m], i), T.insert(ffs[m], j)));
+        T.force(diff);
+        n_unique++;
+        return true;
+    }
+    return false;
+}
+
+
+lbool KindStep::step(uint& out_k)
+{
+    if (k == 0)
+        addFrame(0);
+    else{
+        T.force(~T.insert(bad, k-1));
+        addFrame(k);
+    }
+
+    Vec<Lit> assumps;
+    assumps.push(T.clausify(T.insert(bad, k)));
+    for(;;){
+        lbool result = T.solve(assumps);
+        if (result == l_False){
+            out_k = k;
+            k++;
+            return l_True;
+        }
+        assert(result == l_True);
+        if (!P.simple_path || !addUniqueness())
+            break;
+    }
+
+    out_k = k;
+    k++;
+    return l_False;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Strengthening:
+
+
+// Copy the invariant 'N_invar' (single PO over numbered flops) into 'N'. Flops not present in 'N'
+// (outside the cone-of-influence) are replaced by free inputs, which weakens but preserves it.
+static
+Wire copyInvariant(NetlistRef N_invar, NetlistRef N)
+{
+    Vec<Wire> ff;
+    For_Gatetype(N, gate_Flop, w)
+        ff(attr_Flop(w).number, Wire_NULL) = w;
+
+    Wire top;
+    For_Gatetype(N_invar, gate_PO, w)
+        top = w;
+    if (!top) return N.True();
+
+    Vec<gate_id> order;
+    Vec<Wire>    sinks(1, top[0]);
+    upOrder(sinks, order);
+
+    WMap<Wire> xlat;
+    xlat(N_invar.True()) = N.True();
+    for (uind i = 0; i < order.size(); i++){
+        Wire w = N_invar[order[i]];
+        switch (type(w)){
+        case gate_Flop:{
+            int num = attr_Flop(w).number;
+            xlat(w) = (num != num_NULL && ff(num, Wire_NULL) != Wire_NULL) ? ff[num] : N.add(PI_());
+            break;}
+        case gate_PI:
+            xlat(w) = N.add(PI_());
+            break;
+        case gate_And:
+            xlat(w) = s_And(xlat[w[0]] ^ sign(w[0]), xlat[w[1]] ^ sign(w[1]));
+            break;
+        default: assert(false); }
+    }
+
+    return xlat[top[0]] ^ sign(top[0]);
+}
+
+
+// Houdini style sifting of flop literals: start with every flop fixed at its initial value and
+// remove literals that are not preserved by one transition (under the remaining literals) until
+// the set is inductive. Returns the conjunction of the surviving literals.
+static
+Wire siftLiterals(NetlistRef N, Wire inv, bool quiet)
+{
+    Get_Pob(N, flop_init);
+    Vec<Wire> cand;
+    For_Gatetype(N, gate_Flop, w){
+        if (flop_init[w] == l_True || flop_init[w] == l_False)
+            cand.push(w ^ (flop_init[w] == l_False));
+    }
+
+    KindTrace T(N, true);
+    if (inv != N.True())
+        T.force(T.insert(inv, 0));
+
+    uint rounds = 0;
+    while (cand.size() > 0){
+        rounds++;
+        Vec<Lit> assumps;
+        Vec<Lit> clause;
+        Lit r = T.addLit();
+        clause.push(~r);
+        for (uind i = 0; i < cand.size(); i++){
+            assumps.push(T.clausify(T.insert(cand[i], 0)));
+            clause.push(~T.clausify(T.insert(cand[i], 1)));
+        }
+        T.addClause(clause);
+        assumps.push(r);
+
+        lbool result = T.solve(assumps);
+        if (result == l_False)
+            break;
+        assert(result == l_True);
+
+        uind j = 0;
+        for (uind i = 0; i < cand.size(); i++)
+            if (T.value(T.insert(cand[i], 1)) != l_False)
+                cand[j++] = cand[i];
+        assert(j < cand.size());
+        cand.shrinkTo(j);
+    }
+
+    if (!quiet) WriteLn "Sifted \a*%_\a* invariant flop literals (%_ rounds).", cand.size(), rounds;
+
+    Wire ret = N.True();
+    for (uind i = 0; i < cand.size(); i++)
+        ret = s_And(ret, cand[i]);
+    return ret;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Step process (parallel mode):
+
+
+#if !defined(_MSC_VER)
+// Runs the step case and writes 'k' to 'fd' for the first 'k' that holds (or 'UINT_MAX' if it
+// never will). Never returns.
+static
+void runStepChild(const Params_Kind& P, NetlistRef N, Wire inv, int fd)
+{
+    KindStep step(P, N, inv);
+    uint k = UINT_MAX;
+    for(;;){
+        uint  step_k;
+        lbool result = step.step(step_k);
+        if (result == l_True){
+            k = step_k;
+            break;
+        }else if (step_k >= P.max_k)
+            break;
+    }
+
+    ssize_t ret ___unused = write(fd, &k, sizeof(k));
+    close(fd);
+    _exit(0);
+}
+#endif
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main:
+
+
+lbool kind(NetlistRef N0, const Vec<Wire>& props, const Params_Kind& P, Cex* cex, int* bf_depth, EffortCB* cb, NetlistRef N_invar)
+{
+    if (cex && (!checkNumberingPIs(N0) || !checkNumberingFlops(N0))){
+        ShoutLn "INTERNAL ERROR! Ran k-induction without proper numbering of external elements!";
+        exit(255); }
+
+    double cpu_time0 = cpuTime();
+    if (bf_depth) *bf_depth = -1;
+
+    Netlist N;
+    initBmcNetlist(N0, props, N, true);
+    Get_Pob(N, init_bad);
+
+    Info_Kind info;
+    if (cb) cb->info = &info;
+
+    if (!P.quiet) writeHeader("k-Induction", 64);
+
+    // Strengthening invariant for step case:
+    Wire inv = N.True();
+    if (!N_invar.null() && !N_invar.empty()){
+        Vec<Wire> no_props;
+        if (verifyInvariant(N0, no_props, N_invar))
+            inv = copyInvariant(N_invar, N);
+        else
+            WriteLn "WARNING! Supplied invariant is not inductive; ignoring it.";
+    }
+
+    // Start step case:
+    bool par = false;
+  #if !defined(_MSC_VER)
+    int  fd  = -1;
+    pid_t pid = 0;
+    if (P.par){
+        int fds[2];
+        if (pipe(fds) == 0){
+            std_out.flush();
+            pid = fork();
+            if (pid == 0){
+                close(fds[0]);
+                if (P.sift) inv = s_And(inv, siftLiterals(N, inv, true));
+                runStepChild(P, N, inv, fds[1]);
+            }
+            close(fds[1]);
+            if (pid == -1)
+                close(fds[0]);
+            else{
+                fd = fds[0];
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                par = true;
+            }
+        }
+        if (!par) WriteLn "WARNING! Could not fork step process; running sequentially.";
+    }
+  #endif
+
+    KindStep* step = NULL;      // -- sequential mode only
+    bool step_done = false;
+    if (!par){
+        if (P.sift) inv = s_And(inv, siftLiterals(N, inv, P.quiet));
+        step = new KindStep(P, N, inv);
+    }
+
+    // Base case (incremental BMC):
+    KindTrace B(N, false);
+    lbool ret = l_Undef;
+
+    if (!P.quiet) WriteLn "\a/================================================================\a/";
+    if (!P.quiet) WriteLn "\a/|\a/ \a*Depth\a*  \a/|\a/  \a*Claus   Vars  Confl\a*  \a/|\a/  \a*Step k\a*  \a/|\a/  \a*Memory   CPU Time\a*  \a/|\a/";
+    if (!P.quiet) WriteLn "\a/================================================================\a/";
+
+    for (uint d = 0;; d++){
+        info.depth = d;
+
+        // Proved?
+        if (info.step_k != UINT_MAX && d >= info.step_k){
+            if (!P.quiet) WriteLn "\a/================================================================\a/";
+            if (!P.quiet){
+                if (step) WriteLn "Property is %_-inductive (%_ uniqueness constraints).", info.step_k, step->nUnique();
+                else      WriteLn "Property is %_-inductive.", info.step_k;
+            }
+            ret = l_True;
+            break;
+        }
+
+        if (!P.quiet) WriteLn "\a/|\a/ %>5%d  \a/|\a/  %>5%'D  %>5%'D  %>5%'D  \a/|\a/  %>6%_  \a/|\a/  %>6%^DB  %>8%t  \a/|\a/",
+                              d, B.solver().nClauses(), B.solver().nVars(), (uint)B.solver().statistics().conflicts,
+                              (info.step_k == UINT_MAX) ? String("-") : String((FMT "%_", info.step_k)),
+                              memUsed(), cpuTime() - cpu_time0;
+
+        if (cb){
+            cb->virt_time += uint64(P.quiet ? 1 : 33) * SEC_TO_VIRT_TIME / 1000000;
+            if (!(*cb)())
+                break;
+        }
+
+        // Base case at depth 'd':
+        Wire  w_bad = B.insert(init_bad[1], d);
+        Vec<Lit> assumps(1, B.clausify(w_bad));
+        lbool result = B.solve(assumps);
+        if (result == l_True){
+            if (!P.quiet) WriteLn "\a/================================================================\a/";
+            if (!P.quiet) WriteLn "Counterexample found.";
+            if (cex){
+                Vec<Vec<lbool> > pi, ff;
+                B.getModel(pi, ff);
+                translateCex(pi, ff, N0, *cex);
+            }
+            ret = l_False;
+            break;
+        }
+        assert(result == l_False);
+        B.force(~w_bad);
+        if (bf_depth) *bf_depth = d;
+
+        // Step case:
+        if (par){
+          #if !defined(_MSC_VER)
+            uint k;
+            if (!step_done && read(fd, &k, sizeof(k)) == sizeof(k)){
+                step_done = true;
+                info.step_k = k;
+            }
+          #endif
+        }else if (!step_done){
+            uint  k;
+            lbool result = step->step(k);
+            if (result == l_True)
+                info.step_k = k;
+            if (result == l_True || k >= P.max_k)
+                step_done = true;
+        }
+
+        if (d + 1 >= P.max_k && info.step_k == UINT_MAX){
+          #if !defined(_MSC_VER)
+            if (par && !step_done){
+                // Base case is done; wait for the step process to finish its last 'k':
+                uint k;
+                fcntl(fd, F_SETFL, 0);
+                step_done = true;
+                if (read(fd, &k, sizeof(k)) == sizeof(k) && k != UINT_MAX){
+                    info.step_k = k;
+                    continue; }
+            }
+          #endif
+            if (!P.quiet) WriteLn "Reached maximum k: %_", P.max_k;
+            break;
+        }
+    }
+
+    delete step;
+
+  #if !defined(_MSC_VER)
+    if (par){
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        close(fd);
+    }
+  #endif
+
+    return ret;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,75 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Kind.hh
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : k-induction with base case and inductive step in separate solvers.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| The base case is an incremental BMC. The step case assumes the property in 'k' consecutive
+//| frames of an uninitialized unrolling and checks it in frame 'k'. Uniqueness of states (simple
+//| path) is enforced lazily; two states are only constrained to be distinct once a step
+//| counterexample has visited the same state twice. The step unrolling can be strengthened by
+//| invariants (from a file or sifted from the initial state).
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__Kind_hh
+#define ZZ__Bip__Kind_hh
+
+#include "ZZ_Bip.Common.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Parameters:
+
+
+struct Params_Kind {
+    uint    max_k;              // -- give up after this many steps of induction
+    bool    simple_path;        // -- add uniqueness constraints (lazily) to the step case
+    bool    sift;               // -- strengthen step case with inductive flop literals sifted from the initial state
+    bool    par;                // -- run step case in a forked child process (POSIX only)
+    bool    quiet;
+
+    Params_Kind() :
+        max_k      (UINT_MAX),
+        simple_path(true),
+        sift       (true),
+        par        (true),
+        quiet      (false)
+    {}
+};
+
+
+struct Info_Kind {
+    uint    depth;              // -- current depth of base case
+    uint    step_k;             // -- smallest 'k' for which the step case holds ('UINT_MAX' if none yet)
+
+    Info_Kind() : depth(0), step_k(UINT_MAX) {}
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Functions:
+
+
+lbool kind(NetlistRef        N0,
+           const Vec<Wire>&  props,
+           const Params_Kind& P         = Params_Kind(),
+           Cex*              cex        = NULL,
+           int*              bf_depth   = NULL,
+           EffortCB*         cb         = NULL,     // -- info will be of type 'Info_Kind*'
+           NetlistRef        N_invar    = Netlist_NULL
+          );
+    // -- Returns 'l_True' if all properties were proved, 'l_False' if a counterexample was found and
+    // 'l_Undef' if resources ran out. 'N_invar' may hold a known invariant as a single PO over
+    // numbered flops of 'N0' (as read by 'readInvariant()'); it is used to strengthen the step case.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
@@ -37,6 +37,12 @@
 #include "Imc.hh"
 #include "ParClient.hh"
 
+#if !defined(_MSC_VER)
+  #include <unistd.h>
+  #include <signal.h>
+  #include <sys/wait.h>
+#endif
+
 namespace ZZ {
 using namespace std;
 
@@ -178,7 +184,10 @@ void liveToSafe(NetlistRef N, const Params_Liveness& P, int n_orig_flops, Wire f
 }
 
 
-lbool kLive(NetlistRef N, const Params_Liveness& P, Wire fair_mon, uint k, bool incremental)
+// Replace the property by "fairness has been seen 'k+1' times" ('init_bad[1]' toggles every time
+// all fairness signals have been seen). Each increment of 'k' costs one counter flop.
+static
+void kLive(NetlistRef N, Wire fair_mon, uint k)
 {
     assert(!Has_Pob(N, constraints));       // -- should have been folded into fairness monitor already
 
@@ -204,30 +213,178 @@ lbool kLive(NetlistRef N, const Params_Liveness& P, Wire fair_mon, uint k, bool
     properties.push(N.add(PO_(), ~ts[k]));
 
     tidyUp(N);
+}
+
 
-    // Incremental:
-    if (incremental){
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Safety engine dispatch:
+
+
+static
+lbool runEngine(NetlistRef N, const Vec<Wire>& props, const Params_Liveness& P, Cex& cex)
+{
+    int bug_free_depth;
+
+    Params_Treb   P_treb;
+    Params_Pdr2   P_pdr2;
+    Params_Bmc    P_bmc;
+    Params_ImcStd P_imc;
+    P_treb.par_send_result = false;
+    P_pdr2.par_send_result = false;
+    P_bmc .par_send_result = false;
+    P_imc .par_send_result = false;
+
+    lbool ret;
+    switch (P.eng){
+    case Params_Liveness::eng_NULL:
+        ret = l_Undef;
+        break;
+
+    case Params_Liveness::eng_Bmc:
+        ret = bmc(N, props, P_bmc, &cex, &bug_free_depth, NULL, P.bmc_max_depth);
+        break;
+
+    case Params_Liveness::eng_Treb:
+        ret = treb(N, props, P_treb, &cex, Netlist_NULL, &bug_free_depth, NULL);
+        break;
+
+    case Params_Liveness::eng_TrebAbs:
+        P_treb.use_abstr = true;
+        P_treb.restart_lim = 100;
+        ret = treb(N, props, P_treb, &cex, Netlist_NULL, &bug_free_depth, NULL);
+        break;
+
+    case Params_Liveness::eng_Pdr2:
+        /**/P_pdr2.prop_init = true;
+        ret = lbool_lift(pdr2(N, props, P_pdr2, &cex, Netlist_NULL));     // <<== need to add bug-free-depth and invariant to Pdr2
+        break;
+
+    case Params_Liveness::eng_Imc:
+        ret = imcStd(N, props, P_imc, &cex, Netlist_NULL, &bug_free_depth);
+        break;
+
+    default: assert(false); }
+
+    return ret;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Incremental k-liveness:
+
+
+// Try 'k = k0, k0+1, ..., P.max_k' until the safety property of 'kLive()' holds for the fairness
+// signals 'fairs' of 'N0'. Returns 'l_True' if no fair witness exists, 'l_Undef' if inconclusive.
+// With PDR2, a single run is used for all 'k'; it adds counter flops lazily and keeps its trace
+// (see 'check_klive' in 'Pdr2.cc'). Other proof-engines are rerun from scratch on a fresh
+// translation for each 'k' (they may modify the netlist they are given). Engines that cannot prove
+// properties ('none' and 'bmc') are replaced by PDR2.
+static
+lbool kLiveInc(NetlistRef N0, const Vec<Wire>& fairs, const Params_Liveness& P, uint k0)
+{
+    bool use_pdr2 = (P.eng == Params_Liveness::eng_NULL || P.eng == Params_Liveness::eng_Bmc || P.eng == Params_Liveness::eng_Pdr2);
+
+    for (uint k = k0;; k++){
+        Netlist    N;
+        WMap<Wire> xlat;
+        Wire       fair_mon;
+        initBmcNetlist(N0, fairs, N, true, xlat, &fair_mon, true);
+        kLive(N, fair_mon, k);
+
+        Get_Pob(N, properties);
         Vec<Wire> props(1, properties[0]);
-        Params_Pdr2 P;
-        P.check_klive = true;
-        //P.sat_solver = sat_Msc;
-        //P.pob_internals = true;
-        P.restarts = true;
-        /**/P.prop_init = true;
 
+        if (use_pdr2){
+            Params_Pdr2 P_pdr2;
+            P_pdr2.check_klive = true;
+            P_pdr2.klive_max = (P.max_k == UINT_MAX) ? UINT_MAX : P.max_k - k;
+            P_pdr2.restarts = true;
+            P_pdr2.par_send_result = false;
+
+            Cex cex;
+            Netlist N_invar;
+            bool result = pdr2(N, props, P_pdr2, &cex, N_invar);
+
+            WriteLn "K-live result: %_", result;
+            return result ? l_True : l_Undef;
+        }
+
+        WriteLn "           \a*\a/==>> k-liveness with\a/ k \a/=\a/ %_ \a/<<==\a/\a*", k;
         Cex cex;
-        Netlist N_invar;
-        bool result = pdr2(N, props, P, &cex, N_invar);
+        lbool ret = runEngine(N, props, P, cex);
+        if (ret != l_False || k >= P.max_k)
+            return (ret == l_True) ? l_True : l_Undef;
+    }
+}
 
-        WriteLn "K-live result: %_", result;
 
-        return lbool_lift(result);
+// Run 'P.jobs' forked instances of 'kLiveInc()' with initial 'k' of 0, 1, 2, 4, 8... The first
+// process to prove the property ends the race; if none does, the result is inconclusive.
+static
+lbool kLivePar(NetlistRef N0, const Vec<Wire>& fairs, const Params_Liveness& P)
+{
+  #if !defined(_MSC_VER)
+    Vec<pid_t> pids;
+    Vec<uint>  k0s;
+    std_out.flush();
+    for (uint i = 0; i < P.jobs; i++){
+        uint k0 = (i == 0) ? 0 : 1u << (i-1);
+        if (k0 > P.max_k || i > 31) break;
+
+        pid_t pid = fork();
+        if (pid == 0){
+            lbool ret = kLiveInc(N0, fairs, P, k0);
+            std_out.flush();
+            _exit((ret == l_True) ? 10 : 20);
+        }
+        if (pid < 0) break;
+        pids.push(pid);
+        k0s.push(k0);
     }
 
-    return l_Undef;
+    if (pids.size() == 0){
+        WriteLn "WARNING! Could not fork k-liveness processes; running sequentially.";
+        return kLiveInc(N0, fairs, P, 0);
+    }
+
+    // Wait for first proof (or for all processes to give up):
+    lbool ret = l_Undef;
+    uint  n_alive = pids.size();
+    while (n_alive > 0 && ret == l_Undef){
+        int   status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0){
+            if (errno == EINTR) continue;
+            break; }
+
+        for (uint i = 0; i < pids.size(); i++){
+            if (pids[i] != pid) continue;
+            pids[i] = 0;
+            n_alive--;
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 10){
+                WriteLn "K-liveness process starting at k = %_ proved the property.", k0s[i];
+                ret = l_True; }
+        }
+    }
+
+    for (uint i = 0; i < pids.size(); i++){
+        if (pids[i] == 0) continue;
+        kill(pids[i], SIGKILL);
+        waitpid(pids[i], NULL, 0);
+    }
+
+    return ret;
+
+  #else
+    return kLiveInc(N0, fairs, P, 0);
+  #endif
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main:
+
+
 lbool liveness(NetlistRef N0, uint fair_prop_no, const Params_Liveness& P, Cex* out_cex, uint* out_loop)
 {
     Get_Pob(N0, fair_properties);
@@ -238,6 +395,20 @@ lbool liveness(NetlistRef N0, uint fair_prop_no, const Params_Liveness& P, Cex*
     append(fairs, fair_properties[fair_prop_no]);
     append(fairs, fair_constraints);
 
+    if (P.k == Params_Liveness::INC){
+        // Incremental:
+        lbool ret = (P.jobs > 1) ? kLivePar(N0, fairs, P) : kLiveInc(N0, fairs, P, 0);
+        if (ret == l_Undef){
+            WriteLn "LIVENESS: \a*Inconclusive.\a*";
+            if (par) sendMsg_Result_unknown(par_props, 2/*liveness property*/);
+
+        }else{ assert(ret == l_True);
+            WriteLn "LIVENESS: \a*No witness exists.\a*";
+            if (par) sendMsg_Result_holds(par_props, 2/*liveness property*/);
+        }
+        return ret;         // -- EXIT POINT!
+    }
+
     WMap<Wire> xlat;
     Netlist N;
     int     n_orig_flops ___unused = nextNum_Flop(N0); // -- don't introduce shadow registers for liveness monitor flops
@@ -251,26 +422,10 @@ lbool liveness(NetlistRef N0, uint fair_prop_no, const Params_Liveness& P, Cex*
     initBmcNetlist(N0, fairs, N, true, xlat, &fair_mon, true);
 #endif
 
-    if (P.k == Params_Liveness::L2S){
+    if (P.k == Params_Liveness::L2S)
         liveToSafe(N, P, n_orig_flops, fair_mon, /*out*/loop_start);
-
-    }else{
-        if (P.k == Params_Liveness::INC){
-            // Incremental:
-            lbool ret = kLive(N, P, fair_mon, 0, true);      // <<== use 'eng' parameter here
-            if (ret == l_Undef){
-                WriteLn "LIVENESS: \a*Inconclusive.\a*";
-                if (par) sendMsg_Result_unknown(par_props, 2/*liveness property*/);
-
-            }else{ assert(ret == l_True);
-                WriteLn "LIVENESS: \a*No witness exists.\a*";
-                if (par) sendMsg_Result_holds(par_props, 2/*liveness property*/);
-            }
-            return ret;         // -- EXIT POINT!
-
-        }else
-            kLive(N, P, fair_mon, P.k, false);
-    }
+    else
+        kLive(N, fair_mon, P.k);
 
     if (P.gig_output != ""){
         N.write(P.gig_output);
@@ -286,48 +441,8 @@ lbool liveness(NetlistRef N0, uint fair_prop_no, const Params_Liveness& P, Cex*
     Get_Pob(N, properties);
     Vec<Wire> props(1, properties[0]);
 
-    Cex     cex;
-    int     bug_free_depth;
-
-    Params_Treb   P_treb;
-    Params_Pdr2   P_pdr2;
-    Params_Bmc    P_bmc;
-    Params_ImcStd P_imc;
-    P_treb.par_send_result = false;
-    P_pdr2.par_send_result = false;
-    P_bmc .par_send_result = false;
-    P_imc .par_send_result = false;
-
-    lbool ret;
-    switch (P.eng){
-    case Params_Liveness::eng_NULL:
-        ret = l_Undef;
-        break;
-
-    case Params_Liveness::eng_Bmc:
-        ret = bmc(N, props, P_bmc, &cex, &bug_free_depth, NULL, P.bmc_max_depth);
-        break;
-
-    case Params_Liveness::eng_Treb:
-        ret = treb(N, props, P_treb, &cex, Netlist_NULL, &bug_free_depth, NULL);
-        break;
-
-    case Params_Liveness::eng_TrebAbs:
-        P_treb.use_abstr = true;
-        P_treb.restart_lim = 100;
-        ret = treb(N, props, P_treb, &cex, Netlist_NULL, &bug_free_depth, NULL);
-        break;
-
-    case Params_Liveness::eng_Pdr2:
-        /**/P_pdr2.prop_init = true;
-        ret = lbool_lift(pdr2(N, props, P_pdr2, &cex, Netlist_NULL));     // <<== need to add bug-free-depth and invariant to Pdr2
-        break;
-
-    case Params_Liveness::eng_Imc:
-        imcStd(N, props, P_imc, &cex, Netlist_NULL, &bug_free_depth);
-        break;
-
-    default: assert(false); }
+    Cex   cex;
+    lbool ret = runEngine(N, props, P, cex);
 
     // Report result:
     if (out_loop) *out_loop = UINT_MAX;
@@ -40,6 +40,8 @@ struct Params_Liveness {
     uint   k;       // k-liveness is default unless 'k == L2S'
     Engine eng;
     uint   bmc_max_depth;
+    uint   max_k;   // -- for 'k == INC': give up if the property fails for this 'k'
+    uint   jobs;    // -- for 'k == INC': number of processes to run in parallel (with different initial 'k')
 
     String aig_output;
     String gig_output;
@@ -48,7 +50,9 @@ struct Params_Liveness {
     Params_Liveness() :
         k(L2S),
         eng(eng_Treb),
-        bmc_max_depth(UINT_MAX)
+        bmc_max_depth(UINT_MAX),
+        max_k(UINT_MAX),
+        jobs(1)
     {}
 };
 
@@ -29,10 +29,137 @@ typedef Trip<GLit,GLit,char> LtlKey;   // -- left, right, op
 typedef Map<LtlKey, GLit> LtlStrash;
 
 
+// Returns 'l_True'/'l_False' if 'w' is the constant TRUE/FALSE, otherwise 'l_Undef'.
 static
-Wire mkLtl(NetlistRef NS, const LtlKey& key, LtlStrash& strash)
+lbool ltlConst(Wire w)
 {
-    // <<== simple rules go here
+    if (!w) return l_Undef;
+    char op = attr_Ltl(w).op;
+    return (op == '1') ? l_True  ^ sign(w) :
+           (op == '0') ? l_False ^ sign(w) : l_Undef;
+}
+
+
+// Operator of 'w' (or 0 for atoms, including negated ones).
+static
+char ltlOp(Wire w)
+{
+    return (!w || sign(w)) ? 0 : attr_Ltl(w).op;
+}
+
+
+// Build a node in the normalized (negation-free, except for atoms) LTL netlist 'NS', applying
+// simple rewrite rules to keep the monitor small: constant propagation, idempotence, absorption
+// of nested temporal operators ('FFp = Fp', 'GFGp = FGp', 'XYp = p' etc.) and merging of
+// conjunctions/disjunctions of the same temporal operator ('Gp & Gq = G(p & q)' etc.).
+static
+Wire mkLtl(NetlistRef NS, LtlKey key, LtlStrash& strash)
+{
+    #define INF(op, arg0, arg1) mkLtl(NS, make_tuple((arg0).lit(), (arg1).lit(), op), strash)
+    #define PRE(op, arg) mkLtl(NS, make_tuple(glit_NULL, (arg).lit(), op), strash)
+    #define CNS(op) mkLtl(NS, make_tuple(glit_NULL, glit_NULL, op), strash)
+
+    char op = key.trd;
+    Wire a = key.fst + NS;
+    Wire b = key.snd + NS;
+    lbool ca = ltlConst(a);
+    lbool cb = ltlConst(b);
+
+    switch (op){
+    // Logic operators:
+    case '&':
+        if (ca == l_False || cb == l_False || a == ~b) return CNS('0');
+        if (ca == l_True || a == b) return b;
+        if (cb == l_True)           return a;
+        if (ltlOp(a) == ltlOp(b) && (ltlOp(a) == 'G' || ltlOp(a) == 'X' || ltlOp(a) == 'H' || ltlOp(a) == 'Y' || ltlOp(a) == 'Z'))
+            return PRE(ltlOp(a), INF('&', a[1], b[1]));
+        if (key.snd < key.fst) swp(key.fst, key.snd);
+        break;
+
+    case '|':
+        if (ca == l_True || cb == l_True || a == ~b) return CNS('1');
+        if (ca == l_False || a == b) return b;
+        if (cb == l_False)           return a;
+        if (ltlOp(a) == ltlOp(b) && (ltlOp(a) == 'F' || ltlOp(a) == 'X' || ltlOp(a) == 'P' || ltlOp(a) == 'Y' || ltlOp(a) == 'Z'))
+            return PRE(ltlOp(a), INF('|', a[1], b[1]));
+        if (key.snd < key.fst) swp(key.fst, key.snd);
+        break;
+
+    // Unary temporal operators (argument is 'b'):
+    case 'X':
+        if (cb != l_Undef) return b;
+        if (ltlOp(b) == 'Y' || ltlOp(b) == 'Z') return b[1];
+        break;
+
+    case 'F':
+        if (cb != l_Undef) return b;
+        if (ltlOp(b) == 'F') return b;
+        if (ltlOp(b) == 'G' && ltlOp(b[1]) == 'F') return b;
+        break;
+
+    case 'G':
+        if (cb != l_Undef) return b;
+        if (ltlOp(b) == 'G') return b;
+        if (ltlOp(b) == 'F' && ltlOp(b[1]) == 'G') return b;
+        break;
+
+    case 'Y':
+        if (cb == l_False) return b;
+        break;
+
+    case 'Z':
+        if (cb == l_True) return b;
+        break;
+
+    case 'H':
+        if (cb != l_Undef || ltlOp(b) == 'H') return b;
+        break;
+
+    case 'P':
+        if (cb != l_Undef || ltlOp(b) == 'P') return b;
+        break;
+
+    // Binary temporal operators:
+    case 'U':
+        if (cb != l_Undef || a == b) return b;
+        if (ca == l_False) return b;
+        if (ca == l_True)  return PRE('F', b);
+        break;
+
+    case 'R':
+        if (cb != l_Undef || a == b) return b;
+        if (ca == l_True)  return b;
+        if (ca == l_False) return PRE('G', b);
+        break;
+
+    case 'W':
+        if (cb == l_True || ca == l_True) return CNS('1');
+        if (ca == l_False || a == b) return b;
+        if (cb == l_False) return PRE('G', a);
+        break;
+
+    case 'S':
+        if (cb != l_Undef || a == b) return b;
+        if (ca == l_False) return b;
+        if (ca == l_True)  return PRE('P', b);
+        break;
+
+    case 'T':
+        if (cb != l_Undef || a == b) return b;
+        if (ca == l_True)  return b;
+        if (ca == l_False) return PRE('H', b);
+        break;
+
+    case 'M':
+        if (cb == l_True || ca == l_True) return CNS('1');
+        if (ca == l_False || a == b) return b;
+        if (cb == l_False) return PRE('H', a);
+        break;
+    }
+
+    #undef INF
+    #undef PRE
+    #undef CNS
 
     GLit* val;
     if (!strash.get(key, val))
@@ -65,8 +192,9 @@ macro Wire operator^(Wire u, Wire v) { return mk_Xor(u, v); }
 
 
 // memo skall nog vara WMap, delay Map<sig, reset, init> -> GLit
+// Outputs are stored as pairs '(LTL node, signal in M)'.
 Wire monitorSynth(NetlistRef M, Wire w, WMapS<GLit>& delay_memo, WWMap& memo,
-                  Vec<GLit>& all_pending, Vec<GLit>& all_failed, Vec<GLit>& all_accept,
+                  Vec<Pair<GLit,GLit> >& all_pending, Vec<Pair<GLit,GLit> >& all_failed, Vec<Pair<GLit,GLit> >& all_accept,
                   bool debug_names)
 {
     if (memo[+w])
@@ -124,9 +252,9 @@ Wire monitorSynth(NetlistRef M, Wire w, WMapS<GLit>& delay_memo, WWMap& memo,
             break;
 
         case 'F':
-            accept = BUF;
-            pending = (z | Y(pending)) & ~a;
-            accept <<= ~pending;
+            pending = BUF;
+            pending <<= (z | Y(pending)) & ~a;
+            accept = ~pending;
             break;
 
         case 'G':
@@ -180,7 +308,10 @@ Wire monitorSynth(NetlistRef M, Wire w, WMapS<GLit>& delay_memo, WWMap& memo,
             break;
 
         case 'M':   // 'a' held since the cycle after 'b' last held OR 'a' held since the first cycle
-            assert(false);  // <<== LATER
+            tmp = BUF;
+            tmp <<= b | (Z(tmp) & a);
+            failed = z & ~tmp;
+            break;
 
         // Logic operators:
         case '!':
@@ -217,9 +348,9 @@ Wire monitorSynth(NetlistRef M, Wire w, WMapS<GLit>& delay_memo, WWMap& memo,
         if (accept) { String nam; FWrite(nam) "accp%_", all_accept .size(); M.names().add(accept , nam.c_str()); WriteLn "  %_", nam; }
       #endif
 
-        if (pending) all_pending += pending;
-        if (failed)  all_failed  += failed;
-        if (accept)  all_accept  += accept;
+        if (pending) all_pending += make_tuple(w.lit(), pending.lit());
+        if (failed)  all_failed  += make_tuple(w.lit(), failed .lit());
+        if (accept)  all_accept  += make_tuple(w.lit(), accept .lit());
     }
 
     assert(!sign(w));
@@ -228,20 +359,9 @@ Wire monitorSynth(NetlistRef M, Wire w, WMapS<GLit>& delay_memo, WWMap& memo,
 }
 
 
-/*
-TODO:
-    GGp = Gp
-    FFp = Fp
-    FGFp = GFp
-    GFGp = FGp
-
-    XY f = f
-    XZ f = f
-    YX f = reset | f    (reset taken from 'scope' somehow...)
-    ZX f = !reset & f
-
-+ simple rules (constant propagation; "a & a = a" etc.)
-*/
+// Push negations down to the atoms and express 'W', 'M' and the logic operators '>', '=', '^' in
+// terms of the remaining operators. Nodes are built by 'mkLtl()', so the result is also strashed
+// and simplified by its rewrite rules.
 Wire ltlNormalize(Wire w, WMapS<GLit>& memo, LtlStrash& strash)
 {
     char op = attr_Ltl(w).op;
@@ -283,11 +403,11 @@ Wire ltlNormalize(Wire w, WMapS<GLit>& memo, LtlStrash& strash)
     case 'P': ret = PRE(s ? 'H' : 'P', N(a ^ s)); break;
 
     // Until operators:
-    case 'W': assert(false);    // <<== later
+    case 'W': ret = !s ? INF('W', N(a), N(b)) : INF('U', N(~b), INF('&', N(~a), N(~b))); break;
     case 'U': ret = !s ? INF('U', N(a), N(b)) : INF('R', N(~a), N(~b)); break;
     case 'R': ret = !s ? INF('R', N(a), N(b)) : INF('U', N(~a), N(~b)); break;
 
-    case 'M': assert(false);    // <<== later
+    case 'M': ret = !s ? INF('M', N(a), N(b)) : INF('S', N(~b), INF('&', N(~a), N(~b))); break;
     case 'S': ret = !s ? INF('S', N(a), N(b)) : INF('T', N(~a), N(~b)); break;
     case 'T': ret = !s ? INF('T', N(a), N(b)) : INF('S', N(~a), N(~b)); break;
 
@@ -299,25 +419,420 @@ Wire ltlNormalize(Wire w, WMapS<GLit>& memo, LtlStrash& strash)
         WriteLn "INTERNAL ERROR! Unhandled LTL operator: %_", op;
         assert(false); }
 
+    #undef N
+    #undef INF
+    #undef PRE
+    #undef CNS
+
     memo(w) = ret;
     return ret;
 }
 
 
-lbool ltlCheck(NetlistRef N, Wire spec, const Params_LtlCheck& P)
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Monitor simplification:
+
+
+// Optimistic register merging: flops with the same initial value start out in the same class
+// (which is also assumed equal to that constant), and classes are split on their next-state
+// functions (computed with the current classes substituted in) until nothing changes. The result is
+// an inductive invariant, so every flop is replaced by the representative of its class (a flop or
+// a constant). Returns the number of flops removed.
+static
+uint mergeMonitorFlops(NetlistRef M)
 {
-    if (P.inv)
-        spec = ~spec;
+    Get_Pob(M, flop_init);
+    Auto_Pob(M, up_order);
+
+    Vec<GLit> ffs;
+    WMap<uint> ff_idx;
+    Vec<uint>  cls;             // -- class 0 and 1 are the constants '0' and '1'
+    uint n_classes = 2;
+    For_Gatetype(M, gate_Flop, w){
+        ff_idx(w) = ffs.size();
+        ffs.push(w);
+        cls.push((flop_init[w] == l_False) ? 0 : (flop_init[w] == l_True) ? 1 : n_classes++);
+    }
+
+    for(;;){
+        // Build next-state functions under current partition:
+        Netlist T;
+        Add_Pob0(T, strash);
+        WWMap xlat;
+        xlat(M.True()) = T.True();
+        Vec<GLit> cls_ff(n_classes, glit_NULL);
+
+        For_UpOrder(M, w){
+            switch (type(w)){
+            case gate_PI:
+                xlat(w) = T.add(PI_());
+                break;
+            case gate_Flop:{
+                uint c = cls[ff_idx[w]];
+                if (c < 2)
+                    xlat(w) = T.True() ^ (c == 0);
+                else{
+                    if (!cls_ff[c]) cls_ff[c] = T.add(Flop_());
+                    xlat(w) = cls_ff[c] + T;
+                }
+                break;}
+            case gate_And:
+                xlat(w) = s_And(xlat[w[0]] + T, xlat[w[1]] + T);
+                break;
+            case gate_PO:
+            case gate_Buf:
+                xlat(w) = xlat[w[0]];
+                break;
+            default: assert(false); }
+        }
+
+        // Refine:
+        Map<Pair<uint,GLit>, uint> key2cls;
+        key2cls.set(make_tuple(0u, ~glit_True), 0);
+        key2cls.set(make_tuple(1u,  glit_True), 1);
+        uint n = 2;
+        for (uint i = 0; i < ffs.size(); i++){
+            Wire w = ffs[i] + M;
+            uint* c;
+            if (!key2cls.get(make_tuple(cls[i], xlat[w[0]]), c))
+                *c = n++;
+            cls[i] = *c;
+        }
 
-    // Normalize specification:
-    NetlistRef NS = netlist(spec);
-    Wire nnf;
+        if (n == n_classes) break;
+        n_classes = n;
+    }
+
+    // Replace flops by their representatives:
+    Vec<GLit> cls_rep(n_classes, glit_NULL);
+    cls_rep[0] = ~glit_True;
+    cls_rep[1] =  glit_True;
+    WMap<GLit> rep;
+    uint n_merged = 0;
+    for (uint i = 0; i < ffs.size(); i++){
+        if (!cls_rep[cls[i]]) cls_rep[cls[i]] = ffs[i];
+        rep(ffs[i] + M) = cls_rep[cls[i]];
+        if (cls_rep[cls[i]] != ffs[i]) n_merged++;
+    }
+
+    if (n_merged > 0){
+        For_Gates(M, w){
+            for (uint i = 0; i < w.size(); i++){
+                Wire v = w[i];
+                if (v && type(v) == gate_Flop && rep[v] != v.lit())
+                    w.set(i, (rep[v] + M) ^ sign(v));
+            }
+        }
+        for (uint i = 0; i < ffs.size(); i++)
+            if (rep[ffs[i] + M] != ffs[i])
+                remove(ffs[i] + M);
+        removeAllUnreach(M);
+    }
+
+    return n_merged;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Monitor analysis:
+
+
+struct MonAnalysis {
+    Vec<GLit> ffs;          // -- flops of 'M' spanning the state space
+    Vec<uint> reach;        // -- reachable states (bit 'k' is the value of 'ffs[k]')
+    Vec<char> fair;         // -- 'fair[i]' is TRUE if a witness may pass through 'reach[i]'
+    Vec<char> implied;      // -- 'implied[j]' is TRUE if accept signal 'j' holds on every fair transition
+    bool      fair_init;    // -- some initial state is fair
+};
+
+
+// Topological order of the combinational fanin of 'w' (flops are leaves).
+static
+void topoOrder(Wire w, WZet& done, Vec<GLit>& order)
+{
+    if (done.has(w)) return;
+    done.add(w);
+    if (type(w) != gate_Flop)
+        For_Inputs(w, v)
+            topoOrder(+v, done, order);
+    order.push(w);
+}
+
+
+// Explicit-state analysis of the part of the monitor 'M' that feeds the constraints 'constrs' and
+// the accept signals 'accs' of one property. The inputs of 'M' are left free, which over-approximates
+// any design the monitor is attached to:
+//
+//   - Reach:    the states reachable by transitions satisfying the constraints are enumerated
+//               (together with the accept signals of each transition) by a SAT solver.
+//   - Deadlock: a state from which no such path visits every accept signal infinitely often can
+//               never be part of a witness. The remaining states are marked 'fair'.
+//   - Accept:   an accept signal that holds on every transition between fair states is implied by
+//               the constraints once the monitor is restricted to its fair states.
+//
+// Returns FALSE (no analysis) if the cone has more than 'max_flops' (or 32) flops or the transition
+// relation is too big to enumerate.
+static
+bool analyzeMonitor(NetlistRef M, const Vec<GLit>& constrs, const Vec<GLit>& accs, uint max_flops, /*out*/MonAnalysis& A)
+{
+    const uint max_edges = 100000;
+    if (accs.size() > 32) return false;
+
+    // Sequential cone:
+    WZet      cone;
+    Vec<GLit> Q;
+    Vec<GLit>& ffs = A.ffs;
+    ffs.clear();
+    for (uint i = 0; i < constrs.size(); i++) Q.push(+constrs[i]);
+    for (uint i = 0; i < accs   .size(); i++) Q.push(+accs[i]);
+    while (Q.size() > 0){
+        Wire w = Q.popC() + M;
+        if (cone.has(w)) continue;
+        cone.add(w);
+        if (type(w) == gate_Flop) ffs.push(w);
+        For_Inputs(w, v)
+            Q.push(+v);
+    }
+    if (ffs.size() > max_flops || ffs.size() > 32) return false;     // -- (states are 'uint' bit-masks)
+    sort(ffs);
+
+    // Transition relation as a combinational netlist (current state as inputs):
+    Netlist T;
+    Add_Pob0(T, strash);
+    WWMap xlat;
+    xlat(M.True()) = T.True();
+    Vec<GLit> order;
     {
-        Auto_Pob(N, strash);
+        WZet done;
+        for (uint i = 0; i < constrs.size(); i++) topoOrder(+constrs[i] + M, done, order);
+        for (uint i = 0; i < accs   .size(); i++) topoOrder(+accs[i]    + M, done, order);
+        for (uint k = 0; k < ffs    .size(); k++) topoOrder(+(ffs[k] + M)[0], done, order);
+    }
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + M;
+        switch (type(w)){
+        case gate_Const:
+            break;
+        case gate_PI:
+        case gate_Flop:
+            xlat(w) = T.add(PI_());
+            break;
+        case gate_And:
+            xlat(w) = s_And(xlat[w[0]] + T, xlat[w[1]] + T);
+            break;
+        case gate_PO:
+        case gate_Buf:
+            xlat(w) = xlat[w[0]];
+            break;
+        default: assert(false); }
+    }
+
+    Wire t_constr = T.True();
+    for (uint i = 0; i < constrs.size(); i++)
+        t_constr = s_And(t_constr, xlat[constrs[i] + M] + T);
+
+    SatStd           S;
+    WMap<Lit>        t2s;
+    Clausify<SatStd> C(S, T, t2s);
+    Vec<Lit> s_cur, s_next, s_acc;
+    for (uint k = 0; k < ffs.size(); k++){
+        s_cur .push(C.clausify(xlat[ffs[k] + M] + T));
+        s_next.push(C.clausify(xlat[(ffs[k] + M)[0]] + T));
+    }
+    for (uint j = 0; j < accs.size(); j++)
+        s_acc.push(C.clausify(xlat[accs[j] + M] + T));
+    Lit s_constr = C.clausify(t_constr);
+
+    // Initial states:
+    Get_Pob(M, flop_init);
+    Vec<uint>&     states = A.reach;
+    Vec<char>      is_init;
+    Map<uint,uint> state_id;
+    states.clear();
+    {
+        uint init = 0, undef = 0;
+        for (uint k = 0; k < ffs.size(); k++){
+            if      (flop_init[ffs[k] + M] == l_True ) init  |= 1u << k;
+            else if (flop_init[ffs[k] + M] == l_Undef) undef |= 1u << k;
+        }
+        for (uint sub = undef;; sub = (sub - 1) & undef){
+            state_id.set(init | sub, states.size());
+            states.push(init | sub);
+            is_init.push(true);
+            if (sub == 0) break;
+        }
+    }
+
+    // Reachable states and transitions '(successor, accept signals)':
+    Vec<Vec<Pair<uint,uint> > > succ;
+    Vec<Lit> assumps;
+    Vec<Lit> block;
+    uint n_edges = 0;
+    for (uint i = 0; i < states.size(); i++){
+        succ.push();
+        Lit act = S.addLit();
+        assumps.clear();
+        assumps.push(act);
+        assumps.push(s_constr);
+        for (uint k = 0; k < ffs.size(); k++)
+            assumps.push(s_cur[k] ^ !((states[i] >> k) & 1));
+
+        while (S.solve(assumps) == l_True){
+            uint next = 0, mask = 0;
+            for (uint k = 0; k < ffs.size(); k++) if (S.value(s_next[k]) == l_True) next |= 1u << k;
+            for (uint j = 0; j < accs.size(); j++) if (S.value(s_acc [j]) == l_True) mask |= 1u << j;
+
+            uint* id;
+            if (!state_id.get(next, id)){
+                *id = states.size();
+                states.push(next);
+                is_init.push(false);
+            }
+            succ[i].push(make_tuple(*id, mask));
+            if (++n_edges > max_edges) return false;
+
+            block.clear();
+            block.push(~act);
+            for (uint k = 0; k < ffs.size(); k++) block.push(s_next[k] ^ ((next >> k) & 1));
+            for (uint j = 0; j < accs.size(); j++) block.push(s_acc [j] ^ ((mask >> j) & 1));
+            S.addClause(block);
+        }
+        S.addClause(~act);
+    }
+
+    // Fair states (greatest fixpoint): every fair state has a transition into a fair state, and for
+    // each accept signal, a path through fair states to a fair transition where the signal holds:
+    uint n = states.size();
+    Vec<Vec<uint> > pred(n);
+    for (uint i = 0; i < n; i++)
+        for (uint e = 0; e < succ[i].size(); e++)
+            pred[succ[i][e].fst].push(i);
+
+    Vec<char>& fair = A.fair;
+    fair.reset(n, true);
+    Vec<char> keep;
+    Vec<char> r;
+    for(;;){
+        keep.reset(n, false);
+        for (uint i = 0; i < n; i++){
+            if (!fair[i]) continue;
+            for (uint e = 0; e < succ[i].size(); e++)
+                if (fair[succ[i][e].fst]){ keep[i] = true; break; }
+        }
+
+        for (uint j = 0; j < accs.size(); j++){
+            r.reset(n, false);
+            Vec<uint> R;
+            for (uint i = 0; i < n; i++){
+                if (!fair[i]) continue;
+                for (uint e = 0; e < succ[i].size(); e++){
+                    if (fair[succ[i][e].fst] && ((succ[i][e].snd >> j) & 1)){
+                        r[i] = true;
+                        R.push(i);
+                        break; }
+                }
+            }
+            while (R.size() > 0){
+                uint v = R.popC();
+                for (uint e = 0; e < pred[v].size(); e++){
+                    uint u = pred[v][e];
+                    if (fair[u] && !r[u]){
+                        r[u] = true;
+                        R.push(u); }
+                }
+            }
+            for (uint i = 0; i < n; i++)
+                keep[i] &= r[i];
+        }
+
+        bool changed = false;
+        for (uint i = 0; i < n; i++){
+            if (fair[i] && !keep[i]){
+                fair[i] = false;
+                changed = true; }
+        }
+        if (!changed) break;
+    }
+
+    A.fair_init = false;
+    for (uint i = 0; i < n; i++)
+        if (is_init[i] && fair[i]) A.fair_init = true;
+
+    // Accept signals implied on fair transitions:
+    A.implied.reset(accs.size(), true);
+    for (uint i = 0; i < n; i++){
+        if (!fair[i]) continue;
+        for (uint e = 0; e < succ[i].size(); e++){
+            if (!fair[succ[i][e].fst]) continue;
+            for (uint j = 0; j < accs.size(); j++)
+                if (!((succ[i][e].snd >> j) & 1))
+                    A.implied[j] = false;
+        }
+    }
+
+    return true;
+}
+
+
+// Build a circuit over 'vars' which is TRUE for the states in 'on' and FALSE for the states in 'off'
+// (bit 'k' of a state is the value of 'vars[k]'). Other states are don't-cares.
+static
+Wire mkStateSet(NetlistRef N, const Vec<Wire>& vars, uint k, const Vec<uint>& on, const Vec<uint>& off)
+{
+    if (on .size() == 0) return ~N.True();
+    if (off.size() == 0) return  N.True();
+    assert(k < vars.size());
+
+    Vec<uint> on0, on1, off0, off1;
+    for (uint i = 0; i < on .size(); i++) ((on [i] >> k) & 1 ? on1  : on0 ).push(on [i]);
+    for (uint i = 0; i < off.size(); i++) ((off[i] >> k) & 1 ? off1 : off0).push(off[i]);
+
+    Wire hi = mkStateSet(N, vars, k+1, on1, off1);
+    Wire lo = mkStateSet(N, vars, k+1, on0, off0);
+    if (hi == lo) return hi;
+    return s_Or(s_And(vars[k], hi), s_And(~vars[k], lo));
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main:
+
+
+// Add POs for the monitor outputs 'sigs' (translated to 'N' and negated if 'neg') of LTL nodes
+// in 'cone' to 'out'. Constant true outputs are skipped and POs are shared through 'po_of'.
+static
+void collectOutputs(const Vec<Pair<GLit,GLit> >& sigs, bool neg, const WZet& cone, NetlistRef NS, const WWMap& xlat, NetlistRef N,
+                    WMapS<GLit>& po_of, uint& poC, /*out*/Vec<Wire>& out)
+{
+    for (uint i = 0; i < sigs.size(); i++){
+        if (!cone.has(sigs[i].fst + NS)) continue;
+
+        Wire w = (xlat[sigs[i].snd] + N) ^ neg;
+        if (w == N.True()) continue;
+        if (!po_of[w])
+            po_of(w) = N.add(PO_(poC++), w);
+        out.push(po_of[w] + N);
+    }
+    sortUnique(out);
+}
+
+
+lbool ltlCheck(NetlistRef N, const Vec<Wire>& specs, const Params_LtlCheck& P, /*out*/Vec<lbool>& results)
+{
+    results.setSize(specs.size(), l_Undef);
+    if (specs.size() == 0)
+        return l_True;
 
+    // Normalize specifications (all in the same netlist, so that common subformulas are shared):
+    NetlistRef NS = netlist(specs[0]);
+    Vec<Wire> nnf;
+    {
         WMapS<GLit> memo;
         LtlStrash ltl_strash;
-        nnf = NS.add(PO_(), ltlNormalize(spec, memo, ltl_strash));
+        for (uint i = 0; i < specs.size(); i++){
+            assert(netlist(specs[i]) == NS);
+            nnf.push(NS.add(PO_(), ltlNormalize(specs[i] ^ P.inv, memo, ltl_strash)));
+        }
         removeAllUnreach(NS);
     }
 
@@ -325,14 +840,17 @@ lbool ltlCheck(NetlistRef N, Wire spec, const Params_LtlCheck& P)
         NS.write(P.spec_gig);
         WriteLn "Wrote: \a*%_\a*", P.spec_gig;
     }
-    WriteLn "Normalized spec: %_", FmtLtl(nnf);
+    for (uint i = 0; i < nnf.size(); i++){
+        if (nnf.size() == 1) WriteLn "Normalized spec: %_", FmtLtl(nnf[i]);
+        else                 WriteLn "Normalized spec %_: %_", i, FmtLtl(nnf[i]); }
 
-    // Synthesize monitor:
+    // Synthesize monitor (one circuit for all specifications; the memo shares sub-monitors):
     Netlist M;
-    Wire top;
-    Vec<GLit> pending;
-    Vec<GLit> failed;
-    Vec<GLit> accept;
+    Vec<Wire> top;
+    Vec<Pair<GLit,GLit> > pending;
+    Vec<Pair<GLit,GLit> > failed;
+    Vec<Pair<GLit,GLit> > accept;
+    WWMap memo;
     {
         Add_Pob0(M, flop_init);
         addReset(M, nextNum_Flop(0), num_ERROR);
@@ -341,43 +859,46 @@ lbool ltlCheck(NetlistRef N, Wire spec, const Params_LtlCheck& P)
             M.names().add(reset, "global_reset");
 
         WMapS<GLit> delay_memo;
-        WWMap memo;
-        top = monitorSynth(M, nnf[0], delay_memo, memo, pending, failed, accept, P.debug_names);
-        M.add(PO_(0), top);  // -- will be set by constraint to 'global_reset'
+        for (uint i = 0; i < nnf.size(); i++){
+            top.push(monitorSynth(M, nnf[i][0], delay_memo, memo, pending, failed, accept, P.debug_names));
+            M.add(PO_(i), top[i]);  // -- will be set by constraint to 'global_reset'
+        }
 
-        for (uint i = 0; i < pending.size(); i++) M.add(PO_(), pending[i] + M);
-        for (uint i = 0; i < failed .size(); i++) M.add(PO_(), failed [i] + M);
-        for (uint i = 0; i < accept .size(); i++) M.add(PO_(), accept [i] + M);
+        for (uint i = 0; i < pending.size(); i++) M.add(PO_(), pending[i].snd + M);
+        for (uint i = 0; i < failed .size(); i++) M.add(PO_(), failed [i].snd + M);
+        for (uint i = 0; i < accept .size(); i++) M.add(PO_(), accept [i].snd + M);
         removeAllUnreach(M);
 
-        //Add_Pob(M, strash);   // <<== crashes below when writing "mon.gig"
-            // <<== strash here?
+        uint n_merged = mergeMonitorFlops(M);
+        if (n_merged > 0)
+            WriteLn "Merged monitor flops: %_", n_merged;
     }
 
-    // <<== deadlock analysis; accept constraint extraction; done analysis; reach analysis
-
     if (P.monitor_gig != ""){
         M.write(P.monitor_gig);
         WriteLn "Wrote: \a*%_\a*", P.monitor_gig;
     }
 
-    // Insert monitor and run model checker:
+    // Insert monitor:
     WWMap xlat;
     xlat(M.True()) = N.True();
 
-    if (P.debug_names)
-        N.names().enableLookup();
-
+    Assure_Pob(N, constraints);
+    Assure_Pob(N, fair_properties);
+    uint fair_base = fair_properties.size();
+    Vec<Wire> tie;
+    Vec<Vec<Wire> > prop_failed(nnf.size());
+    Vec<Wire> prop_fair(nnf.size(), Wire_NULL);     // -- state constraint from monitor analysis (if any)
+    Vec<char> no_witness(nnf.size(), false);        // -- monitor analysis found no fair initial state
     {
-        Assure_Pob(N, constraints);
-        Add_Pob(N, fair_properties);
-        fair_properties.push();
+        Assure_Pob0(N, strash);
         N.names().enableLookup();
         Assure_Pob(N, flop_init);
         Get_Pob2(M, flop_init, flop_init_M);
 
         Vec<char> nam;
-        uint piC = nextNum_PI(N);
+        uint piC0 = nextNum_PI(N);
+        uint piC = piC0;
         uint poC = nextNum_PO(N);
 
         Auto_Pob(M, up_order);
@@ -435,31 +956,120 @@ lbool ltlCheck(NetlistRef N, Wire spec, const Params_LtlCheck& P)
         For_Gatetype(M, gate_Flop, w)
             (xlat[w] + N).set(0, xlat[w[0]]);
 
+        // Per-property signals (only the sub-monitors in the cone of the property are used):
         Get_Pob(M, reset);
-        constraints += N.add(PO_(poC++), s_Equiv(xlat[top] + N, xlat[reset] + N));
-        if (P.debug_names)
-            N.names().add(constraints[LAST], "z0_constraint");
-        for (uint i = 0; i < failed.size(); i++)
-            constraints += N.add(PO_(poC++), ~xlat[failed[i]]);
+        WMapS<GLit> po_of;
+        for (uint i = 0; i < nnf.size(); i++){
+            if (attr_Ltl(nnf[i][0]).op == 0)
+                // -- atomic top: 'top' is a design signal, so just assert it in the first cycle
+                tie.push(N.add(PO_(poC++), s_Or(~xlat[reset] + N, xlat[top[i]] + N)));
+            else
+                tie.push(N.add(PO_(poC++), s_Equiv(xlat[top[i]] + N, xlat[reset] + N)));
+            if (P.debug_names)
+                N.names().add(tie[i], (nnf.size() == 1) ? String("z0_constraint").c_str() : String((FMT "z0_constraint_%_", i)).c_str());
+
+            WZet cone;
+            transitiveFanin(nnf[i][0], cone);
+
+            // Analyze monitor (restrict it to its fair states; drop implied accept signals):
+            Vec<Pair<GLit,GLit> > accept_i;
+            for (uint j = 0; j < accept.size(); j++)
+                if (cone.has(accept[j].fst + NS))
+                    accept_i.push(accept[j]);
+
+            if (P.ana_flops > 0){
+                Vec<GLit> constrs;
+                Vec<GLit> accs;
+                for (uint j = 0; j < failed.size(); j++)
+                    if (cone.has(failed[j].fst + NS))
+                        constrs.push(~failed[j].snd);
+                constrs.push((attr_Ltl(nnf[i][0]).op == 0) ? mk_Or(~reset, top[i]) : ~mk_Xor(top[i], reset));
+                for (uint j = 0; j < accept_i.size(); j++)
+                    accs.push(accept_i[j].snd);
+
+                MonAnalysis A;
+                if (analyzeMonitor(M, constrs, accs, P.ana_flops, A)){
+                    Vec<uint> on, off;
+                    for (uint j = 0; j < A.reach.size(); j++)
+                        (A.fair[j] ? on : off).push(A.reach[j]);
+                    if (!A.fair_init)
+                        no_witness[i] = true;
+                    else if (off.size() > 0){
+                        Vec<Wire> vars;
+                        for (uint k = 0; k < A.ffs.size(); k++)
+                            vars.push(xlat[A.ffs[k]] + N);
+                        Wire f = mkStateSet(N, vars, 0, on, off);
+                        if (f != N.True())
+                            prop_fair[i] = N.add(PO_(poC++), f);
+                    }
+
+                    Vec<Pair<GLit,GLit> > kept;
+                    for (uint j = 0; j < accept_i.size(); j++)
+                        if (!A.implied[j]) kept.push(accept_i[j]);
+                    uint n_implied = accept_i.size() - kept.size();
+                    kept.moveTo(accept_i);
+                    WriteLn "Monitor analysis: %_ flops, %_ reachable states, %_ deadlocked, %_ of %_ accept signals implied.",
+                        A.ffs.size(), A.reach.size(), off.size(), n_implied, accs.size();
+                }
+            }
+
+            collectOutputs(failed, true, cone, NS, xlat, N, po_of, poC, prop_failed[i]);
+            fair_properties.push();
+            collectOutputs(accept_i, false, cone, NS, xlat, N, po_of, poC, fair_properties.last());
+        }
+
+        // Remove monitor logic left dangling by constant propagation (or unused pending signals);
+        // then number the remaining new PIs compactly:
+        {
+            Auto_Pob(N, fanout_count);
+            Get_Pob(N, strash);
+            Vec<GLit> Q;
+            For_Gatetype(M, gate_And, w)
+                Q.push(+xlat[w]);
+            while (Q.size() > 0){
+                Wire w = N[Q.popC()];
+                if (deleted(w) || type(w) != gate_And || fanout_count[w] != 0) continue;
+
+                For_Inputs(w, v)
+                    Q.push(+v);
+                strash.remove(w);
+                remove(w);
+            }
 
-        for (uint i = 0; i < accept.size(); i++)
-            fair_properties.last() += N.add(PO_(poC++), xlat[accept[i]]);
+            For_Gatetype(M, gate_PI, w){
+                Wire v = xlat[w] + N;
+                if (attr_PI(w).number != 0 && fanout_count[v] == 0)
+                    remove(v);
+            }
+
+            Vec<Pair<int,GLit> > pis;
+            For_Gatetype(N, gate_PI, w)
+                if (attr_PI(w).number >= (int)piC0)
+                    pis.push(make_tuple(attr_PI(w).number, w.lit()));
+            sort(pis);
+            for (uint i = 0; i < pis.size(); i++)
+                attr_PI(pis[i].snd + N).number = piC0 + i;
+        }
 
         if (P.final_gig != ""){
+            uint n_constrs = constraints.size();
+            append(constraints, prop_failed[0]);
+            constraints.push(tie[0]);
+            if (prop_fair[0]) constraints.push(prop_fair[0]);
             N.write(P.final_gig);
             WriteLn "Wrote: \a*%_\a*", P.final_gig;
+            constraints.shrinkTo(n_constrs);
         }
     }
 
     renumberFlops(N);
 
-    // Run liveness algorithm:
+    // Run liveness algorithm (once per property):
     Params_Liveness PL;
-    PL.witness_output = P.witness_output;
-
     switch (P.eng){
     case Params_LtlCheck::eng_KLive:
         PL.k = Params_Liveness::INC;
+        PL.eng = Params_Liveness::eng_Pdr2;
         break;
     case Params_LtlCheck::eng_L2sBmc:
         PL.k = Params_Liveness::L2S;
@@ -473,48 +1083,82 @@ lbool ltlCheck(NetlistRef N, Wire spec, const Params_LtlCheck& P)
         return l_Undef;     // -- EXIT
     default: assert(false); }
 
-    Cex cex;
-    uint loop_frame;
-    lbool result = liveness(N, 0, PL, &cex, &loop_frame);
-    if (result == l_False){
-        // Simulate CEX:
-        XSimulate xsim(N);
-        xsim.simulate(cex);
-
-        // Print model:
-        WriteLn "Witness projected onto specification variables:";
-        NewLine;
-        Vec<char> nam;
-        For_Gatetype(M, gate_PI, w){
-            if (attr_PI(w).number == 0){
-                // Signal from design:
-                M.names().get(w, nam);
-                if (nam[LAST] == 0) nam.pop();
-
-                bool inv  = false;
-                if (nam[0] == M.names().invert_prefix){
-                    inv = true;
-                    Write "  \a*%_\a*: ", nam.slice(1);
-                }else
-                    Write "  \a*%_\a*: ", nam;
-
-                for (uint d = 0; d < cex.size(); d++){
-                    if (d == loop_frame) Write " \a/|\a/";
-                    Write " %_", xsim[d][xlat[w] + N] ^ inv;
+    lbool ret = l_True;
+    for (uint i = 0; i < nnf.size(); i++){
+        if (nnf.size() > 1)
+            WriteLn "\a*Checking LTL property %_:\a* %_", i, FmtLtl(nnf[i]);
+
+        PL.witness_output = (P.witness_output == "" || nnf.size() == 1) ? P.witness_output : String((FMT "%_.%_", P.witness_output, i));
+
+        if (no_witness[i]){
+            WriteLn "Monitor analysis: no initial state can start a witness.";
+            WriteLn "LIVENESS: \a*No witness exists.\a*";
+            results[i] = l_True;
+            continue;
+        }
+
+        uint n_constrs = constraints.size();
+        append(constraints, prop_failed[i]);
+        constraints.push(tie[i]);
+        if (prop_fair[i]) constraints.push(prop_fair[i]);
+
+        Cex cex;
+        uint loop_frame;
+        results[i] = liveness(N, fair_base + i, PL, &cex, &loop_frame);
+
+        constraints.shrinkTo(n_constrs);
+
+        if (results[i] == l_False){
+            // Simulate CEX:
+            XSimulate xsim(N);
+            xsim.simulate(cex);
+
+            // Print model (projected onto the atoms of this property):
+            WZet cone;
+            transitiveFanin(nnf[i][0], cone);
+            Vec<GLit> atoms;
+            For_Gatetype(NS, gate_Ltl, v)
+                if (attr_Ltl(v).op == 0 && cone.has(v))
+                    atoms.push(memo[v]);
+
+            WriteLn "Witness projected onto specification variables:";
+            NewLine;
+            Vec<char> nam;
+            For_Gatetype(M, gate_PI, w){
+                if (attr_PI(w).number == 0 && has(atoms, w.lit())){
+                    M.names().get(w, nam);
+                    if (nam[LAST] == 0) nam.pop();
+
+                    bool inv  = false;
+                    if (nam[0] == M.names().invert_prefix){
+                        inv = true;
+                        Write "  \a*%_\a*: ", nam.slice(1);
+                    }else
+                        Write "  \a*%_\a*: ", nam;
+
+                    for (uint d = 0; d < cex.size(); d++){
+                        if (d == loop_frame) Write " \a/|\a/";
+                        Write " %_", xsim[d][xlat[w] + N] ^ inv;
+                    }
+                    NewLine;
                 }
-                NewLine;
             }
+            NewLine;
         }
-        NewLine;
+
+        if (results[i] == l_False) ret = l_False;
+        else if (results[i] == l_Undef && ret == l_True) ret = l_Undef;
     }
 
-    return result;
+    return ret;
 }
 
-// FAILED = (failed1 | failed2 | ...)
-// Liveness: inf_often(accept1, accept2, ...) under constr. ~FAILED
 
-// Safety: reachable(~FAILED & ~PENDING)
+lbool ltlCheck(NetlistRef N, Wire spec, const Params_LtlCheck& P)
+{
+    Vec<lbool> results;
+    return ltlCheck(N, Vec<Wire>(1, spec), P, results);
+}
 
 
 lbool ltlCheck(NetlistRef N, String spec_text, const Params_LtlCheck& P)
@@ -527,48 +1171,74 @@ lbool ltlCheck(NetlistRef N, String spec_text, const Params_LtlCheck& P)
         ShoutLn "Error parsing LTL specification:\n  -- %_", err_msg;
         exit(1); }
 
-    if (P.fuzz_output){
-        while(spec_text.size() > 0 && (spec_text.last() == ' ' || spec_text.last() == '\n' || spec_text.last() == 0)) spec_text.pop();
-        if (has(spec_text, 'W')){ ShoutLn "%_  :  ???", strip(spec_text.slice()); exit(0); }
-        if (has(spec_text, 'M')){ ShoutLn "%_  :  ???", strip(spec_text.slice()); exit(0); }
-    }
-
     N.names().enableLookup();
     lbool result = ltlCheck(N, spec, P);
 
-    if (P.fuzz_output)
+    if (P.fuzz_output){
+        while(spec_text.size() > 0 && (spec_text.last() == ' ' || spec_text.last() == '\n' || spec_text.last() == 0)) spec_text.pop();
         ShoutLn "%_  :  %_", strip(spec_text.slice()), (result == l_True) ? "unsat" : (result == l_False) ? "SAT" : "--";
+    }
 
     return result;
 }
 
 
-lbool ltlCheck(NetlistRef N, String spec_file, uint prop_no, const Params_LtlCheck& P)
+lbool ltlCheck(NetlistRef N, String spec_file, const Vec<uint>& prop_nos, const Params_LtlCheck& P, /*out*/Vec<lbool>& results)
 {
-    // Parse property:
     Array<char> text = readFile(spec_file, true);
     if (!text){
         ShoutLn "Could not open: %_", spec_file;
         exit(1); }
 
+    // Remove comments and split into properties:
+    Vec<String> segs(1);
     bool comment = false;
-    uint curr_prop = 0;
     for (uint i = 0; i < text.size() - 1; i++){
         if (text[i] == '\n')
             comment = false;
         else if (comment)
-            text[i] = ' ';
+            continue;
         else if (text[i] == '#')
-            comment = true,
-            text[i] = ' ';
+            comment = true;
         else if (text[i] == ';')
-            curr_prop++,
-            text[i] = ' ';
-        else if (curr_prop != prop_no)
-            text[i] = ' ';
+            segs.push();
+        else
+            segs.last().push(text[i]);
+    }
+
+    Vec<uint> nos;
+    if (prop_nos.size() == 0){
+        for (uint i = 0; i < segs.size(); i++)
+            if (strip(segs[i].slice()).size() > 0)
+                nos.push(i);
+    }else
+        prop_nos.copyTo(nos);
+
+    // Parse properties:
+    Netlist NS;
+    Vec<Wire> specs;
+    for (uint i = 0; i < nos.size(); i++){
+        if (nos[i] >= segs.size()){
+            ShoutLn "ERROR! Incorrect LTL property number: %_", nos[i];
+            exit(1); }
+
+        String err_msg;
+        Wire spec = parseLtl(segs[nos[i]].c_str(), NS, err_msg);
+        if (!spec){
+            ShoutLn "Error parsing LTL specification %_:\n  -- %_", nos[i], err_msg;
+            exit(1); }
+        specs.push(spec);
     }
 
-    return ltlCheck(N, text, P);
+    N.names().enableLookup();
+    return ltlCheck(N, specs, P, results);
+}
+
+
+lbool ltlCheck(NetlistRef N, String spec_file, uint prop_no, const Params_LtlCheck& P)
+{
+    Vec<lbool> results;
+    return ltlCheck(N, spec_file, Vec<uint>(1, prop_no), P, results);
 }
 
 
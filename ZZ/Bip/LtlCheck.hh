@@ -35,6 +35,7 @@ struct Params_LtlCheck {
     bool    free_vars;
     Engine  eng;
     String  witness_output;
+    uint    ana_flops;      // -- explicit monitor analysis for properties with at most this many monitor flops (0 = off, at most 32)
 
     bool    debug_names;
     String  spec_gig;
@@ -47,6 +48,7 @@ struct Params_LtlCheck {
         free_vars(false),
         eng(eng_L2sPdr),
         witness_output(""),
+        ana_flops(12),
         debug_names(false),
         spec_gig(""),
         monitor_gig(""),
@@ -56,9 +58,17 @@ struct Params_LtlCheck {
 };
 
 
+lbool ltlCheck(NetlistRef N, const Vec<Wire>& specs, const Params_LtlCheck& P, /*out*/Vec<lbool>& results);
+    // -- Check all 'specs' (which must live in the same LTL netlist) with one shared monitor.
+    // The result of each property is stored in 'results'; the returned value is 'l_False' if some
+    // property failed, else 'l_Undef' if some property was inconclusive, else 'l_True'.
+
 lbool ltlCheck(NetlistRef N, Wire spec, const Params_LtlCheck& P);
 lbool ltlCheck(NetlistRef N, String spec_text, const Params_LtlCheck& P);
 lbool ltlCheck(NetlistRef N, String spec_file, uint prop_no, const Params_LtlCheck& P);
+lbool ltlCheck(NetlistRef N, String spec_file, const Vec<uint>& prop_nos, const Params_LtlCheck& P, /*out*/Vec<lbool>& results);
+    // -- Properties in 'spec_file' are separated by ';'. An empty 'prop_nos' means all (non-empty)
+    // properties of the file.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -22,6 +22,7 @@
 #include "ZZ/Generics/Sort.hh"
 #include "Abstraction.hh"
 #include "Bmc.hh"
+#include "Kind.hh"
 #include "MultiBmc.hh"
 #include "Imc.hh"
 #include "Pdr.hh"
@@ -30,6 +31,9 @@
 #include "Pmc.hh"
 #include "SmvInterface.hh"
 #include "Reparam.hh"
+#include "Scorr.hh"
+#include "SeqSimp.hh"
+#include "Retime.hh"
 #include "Fixed.hh"
 #include "Sift.hh"
 #include "Sift2.hh"
@@ -573,12 +577,29 @@ void writeAbstr(Out& out, NetlistRef N, const IntSet<uint>& abstr)
 }
 
 
+// If '-retime' is given, engines work on a retimed copy of the input netlist. Counterexamples
+// are lifted back to (and verified on) this netlist before they are output:
+static NetlistRef   retime_orig;
+static Vec<Wire>    retime_props;
+static RetimeMap    retime_map;
+
+
 void outputVerificationResult(
     NetlistRef N, const Vec<Wire>& props,
     lbool result, Cex* cex, uint orig_num_pis, NetlistRef invar, int bug_free_depth, bool check_invar,
     String out_filename, bool quiet,
     double T0, double Tr0, int loop_len = -1)
 {
+    NetlistRef       N_cex     = N;
+    const Vec<Wire>* props_cex = &props;
+    Cex              cex_orig;
+    if (!retime_orig.null() && cex != NULL && cex->size() > 0){
+        liftCex(retime_orig, N, retime_map, *cex, cex_orig);
+        N_cex     = retime_orig;
+        props_cex = &retime_props;
+        cex       = &cex_orig;
+    }
+
     //
     // TO FILE:
     //
@@ -590,10 +611,10 @@ void outputVerificationResult(
 
         // Write counterexample:
         if (cex != NULL && cex->size() > 0)
-            writeCex(out, N, *cex, orig_num_pis);
+            writeCex(out, N_cex, *cex, orig_num_pis);
 
-        // Write invariant:
-        if (!invar.null() && !invar.empty())
+        // Write invariant (not for retimed netlists; it would refer to the wrong flops):
+        if (!invar.null() && !invar.empty() && retime_orig.null())
             writeInvar(out, invar);
 
         // Write bug-free depth:
@@ -619,11 +640,11 @@ void outputVerificationResult(
                 WriteLn "Counterexample not provided.";
             else if (loop_len == -1){
                 Vec<uint> fails_at;
-                if (verifyCex(N, props, *cex, &fails_at)){
+                if (verifyCex(N_cex, *props_cex, *cex, &fails_at)){
                     WriteLn "Counterexample VERIFIED!";
                     for (uind i = 0; i < fails_at.size(); i++)
                         if (fails_at[i] != UINT_MAX)
-                            WriteLn "Property# %_ fails at depth %_", attr_PO(props[i]).number, fails_at[i];
+                            WriteLn "Property# %_ fails at depth %_", attr_PO((*props_cex)[i]).number, fails_at[i];
                 }else
                     WriteLn "Counterexample is \a*\a/INCORRECT\a0!";
             }
@@ -857,6 +878,7 @@ int main(int argc, char** argv)
     cli.add("sort-ext", "bool", "no", "Sort external elements on name (if present).");
     cli.add("prop", "uint | [uint] | {all}", "all", "Properties to work on (by PO number).");
     cli.add("conjoin", "bool", "no", "Conjoin all properties (for save commands).");
+    cli.add("retime", "bool", "no", "Minimum-register retiming before running the command (counterexamples are lifted back).");
     cli.add("abstr", "string", "", "File containing initial abstraction (selected engines).");
     cli.add("check", "bool", "no", "Validate invariants.");
     cli.add("vt", "ufloat | {inf}", "inf", "Virtual timeout (in \"seconds\").");
@@ -909,6 +931,8 @@ int main(int argc, char** argv)
     cli_imc.add("qc", "bool", "no", "Quantification based clausification.");
     cli_imc.add("st", "bool", "no", "Simple binary Tseitin clausification.");
     cli_imc.add("spin", "bool", "no", "Spin interpolant to minimize it.");
+    cli_imc.add("compact", "bool", "no", "Compact interpolants (SAT-sweeping, support reduction, balancing).");
+    cli_imc.add("spill", "uint", "0", "If non-zero, keep proof-log in a memory-mapped temp. file ($TMPDIR) with this many MB resident.");
     // <<== experimental options here for turning off variable removal or recycling
     cli.addCommand("imc", "Interpolation based modelchecking.", &cli_imc);
 
@@ -919,9 +943,21 @@ int main(int argc, char** argv)
     cli_bmc.add("la", "int[1:]", "1", "Number of look-ahead frames.");
     cli_bmc.add("la-decay", "ufloat", "0.8", "Smaller numbers mean later frames are given less time. '1' = all frames have equal time.");
     cli_bmc.add("sat", "{zz, msc, abc, glu, glr, msr}", "msc", "SAT-solver to use.");
+    cli_bmc.add("cube", "uint", "0", "Cube-and-conquer: split hard frames into cubes solved by this many processes (0 = off).");
+    cli_bmc.add("cube-vars", "int[1:12]", "6", "Split depth for cube-and-conquer (at most 2^N cubes per frame).");
+    cli_bmc.add("cube-confl", "uint | {inf}", "10000", "Conflicts spent on a frame before splitting it ('inf' = split at once).");
 
     cli.addCommand("bmc", "Bounded model checking", &cli_bmc);
 
+    // Command line -- k-induction:
+    CLI cli_kind;
+    cli_kind.add("k", "uint | {inf}", "inf", "Maximum induction depth.");
+    cli_kind.add("unique", "bool", "yes", "Add uniqueness (simple path) constraints to the step case.");
+    cli_kind.add("sift", "bool", "yes", "Strengthen step case with sifted invariant flop literals.");
+    cli_kind.add("par", "bool", "yes", "Run base and step case in parallel (separate processes).");
+    cli_kind.add("invar", "string", "", "Strengthen step case with this invariant (clausal form, as for 'check-invar').");
+    cli.addCommand("kind", "k-induction", &cli_kind);
+
     // Command line -- Multi-BMC:
     CLI cli_multi_bmc;
     cli.addCommand("multi-bmc", "Multi-property bounded model checking", &cli_multi_bmc);
@@ -949,6 +985,8 @@ int main(int argc, char** argv)
     cli_abs.add("stable", "uint", "0", "Must be used together with '-depth'. Stopping criteria now is: \"depth\" is reached AND no counterexample has been found for \"stable\" number of steps.");
     cli_abs.add("bob", "uint | {inf}", "inf", "Go upto this depth, then stop if \"stable-steps >= current-depth / 2\".");
     cli_abs.add("sat-verbosity", "uint", "0", "[Debug]. Show progress of individual SAT runs.");
+    cli_abs.add("orders", "uint", "1", "Number of flop orders tried for each refinement (smallest refinement is used).");
+    cli_abs.add("par-orders", "bool", "yes", "Refine and BMC-check the candidate set of each order in parallel (separate processes).");
     cli_abs.add("randomize", "bool", "no", "[Experimental]. Randomize variable order after UNSAT.");
     cli_abs.add("dwr", "string", "", "Dump while running (abstract models in AIGER format). If the given string ends with a '%', it is used as a filename prefix with '%' replaced by 1, 2, 3 etc. Otherwise, the string is used directly as a filename, overwriting the same file repeatedly.");
 
@@ -962,8 +1000,27 @@ int main(int argc, char** argv)
     cli_reparam.add("gig", "string" , "", "Save result as GIG file.");
     cli.addCommand("reparam", "Remove inputs through reparametrization. (work in progress)", &cli_reparam);
 
+    CLI cli_scorr;
+    cli_scorr.add("k", "uint", "1", "Depth of induction.");
+    cli_scorr.add("flops-only", "bool", "no", "Only merge flops (register correspondence).");
+    cli_scorr.add("sim", "uint", "16", "Rounds of 64-bit parallel random simulation for candidate detection.");
+    cli_scorr.add("aig", "string" , "", "Save result as AIGER file.");
+    cli_scorr.add("gig", "string" , "", "Save result as GIG file.");
+    cli.addCommand("scorr", "Merge sequentially equivalent signals (signal correspondence).", &cli_scorr);
+
     // Command line -- simplify:
-    cli.addCommand("simp", "Simplify AIG.");
+    CLI cli_simp;
+    cli_simp.add("xsim", "bool", "yes", "Detect constant flops by ternary simulation.");
+    cli_simp.add("merge", "bool", "yes", "Merge stuck and duplicate flops.");
+    cli_simp.add("pis", "bool", "yes", "Replace uninitialized flops fed by a dedicated PI with that PI.");
+    cli_simp.add("map", "string", "", "Write map for lifting counterexamples (default: output with extension '.map').");
+    cli.addCommand("simp", "Sequential simplification (COI, constant/duplicate flops, strash) to a fixed point.", &cli_simp);
+
+    // Command line -- retime:
+    CLI cli_retime;
+    cli_retime.add("fwd", "bool", "yes", "Allow forward retiming steps.");
+    cli_retime.add("bwd", "bool", "yes", "Allow backward retiming steps (initial state computed by SAT).");
+    cli.addCommand("retime", "Minimum-register retiming (see also '-retime' for running an engine on the retimed netlist).", &cli_retime);
 
     // Command line -- static BMC:
     CLI cli_static_bmc;
@@ -1006,6 +1063,8 @@ int main(int argc, char** argv)
     cli_live.add("wit", "string", "", "Output AIGER 1.9 witness.");
     cli_live.add("eng", "{none, bmc, treb, treb-abs, pdr2, imc}", "treb", "Proof-engine to apply to conversion.");
     cli_live.add("bmc-depth", "uint | {inf}", "inf", "For '-eng=bmc' only; bound the depth.");
+    cli_live.add("max-k", "uint | {inf}", "inf", "For '-k=inc' only; give up after this value of k.");
+    cli_live.add("jobs", "uint", "1", "For '-k=inc' only; race this many processes, starting at k = 0, 1, 2, 4, 8...");
     cli.addCommand("live", "Liveness checking.", &cli_live);
 
     // Command line -- LTL:
@@ -1020,6 +1079,7 @@ int main(int argc, char** argv)
     cli_ltl.add("fuzz", "bool", "no", "Produce output for fuzzer.");
     cli_ltl.add("fv", "bool", "no", "Allow free-variables in specification (will introduce pseudo-inputs).");
     cli_ltl.add("wit", "string", "", "Output AIGER 1.9 witness.");
+    cli_ltl.add("ana", "int[0:32]", "12", "Analyze monitors of at most this many flops for deadlocks and implied accept signals (0 = off).");
     cli.addCommand("ltl", "LTL model checking.", &cli_ltl);
 
     // Command line -- constraint extraction:
@@ -1128,7 +1188,9 @@ int main(int argc, char** argv)
         quiet = true;
 
     // Read input file:
-    Netlist N;
+    Netlist    N_input;
+    NetlistRef N = N_input;     // -- redirected to 'N_retimed' by '-retime'
+    Netlist    N_retimed;
     bool    is_aiger = false;
     if (hasExtension(input, "aig")){
         try{
@@ -1325,6 +1387,36 @@ int main(int argc, char** argv)
             setupProperties(N, prop_nums, inv_prop, props, quiet || is_aiger);
         setupInitialState(N, quiet || is_aiger);
 
+        // Retime:
+        if (cli.get("retime").bool_val){
+            if (cli.cmd == "live" || cli.cmd == "ltl")
+                WriteLn "NOTE! Retiming is not applied for liveness checking.";
+            else if (cli.cmd == "check-invar" || cli.cmd == "simp-invar"){
+                ShoutLn "ERROR! '-retime' cannot be used with '%_' (the invariant refers to the original flops).", cli.cmd;
+                exit(1);
+            }else{
+                Params_Retime P;
+                P.quiet = quiet;
+                try{
+                    retime(N, N_retimed, retime_map, P);
+                }catch (Excp_Msg err){
+                    ShoutLn "ERROR! %_", err.msg;
+                    exit(1);
+                }
+
+                Vec<Wire> pos;
+                For_Gatetype(N_retimed, gate_PO, w)
+                    pos(attr_PO(w).number, Wire_NULL) = w;
+                props.copyTo(retime_props);
+                for (uind i = 0; i < props.size(); i++)
+                    props[i] = pos[attr_PO(props[i]).number] ^ sign(props[i]);
+
+                retime_orig = N;
+                N = N_retimed;
+                if (!quiet) WriteLn "Retimed: %_ -- %_", input, info(N);
+            }
+        }
+
         // Conjoin properties:
         if (cli.get("conjoin").bool_val){
             Wire w_conj = N.True();
@@ -1411,6 +1503,8 @@ int main(int argc, char** argv)
         P.quiet         = quiet;
         P.sat_verbosity = cli_abs.get("sat-verbosity").bool_val;
         P.randomize     = cli_abs.get("randomize").bool_val;
+        P.ref_orders    = max_((uint)cli_abs.get("orders").int_val, 1u);
+        P.ref_fork      = cli_abs.get("par-orders").bool_val;
         P.renumber      = cli_abs.get("renumber").bool_val;
         P.dump_prefix   = cli_abs.get("dwr").string_val;
 
@@ -1418,21 +1512,38 @@ int main(int argc, char** argv)
         int bug_free_depth;
         localAbstr(N, props, P, abstr, &cex, bug_free_depth);
 
+        // Lift counterexample back to the original netlist (if retimed):
+        NetlistRef       N_cex     = N;
+        const Vec<Wire>* props_cex = &props;
+        Cex              cex_orig;
+        Cex*             cex_out   = &cex;
+        if (!retime_orig.null() && !cex.null()){
+            liftCex(retime_orig, N, retime_map, cex, cex_orig);
+            N_cex     = retime_orig;
+            props_cex = &retime_props;
+            cex_out   = &cex_orig;
+        }
+
         // Verify counterexample:
-        if (!cex.null()){
-            if (verifyCex(N, props, cex)) WriteLn "Counterexample VERIFIED!";
-            else                          WriteLn "Counterexample is \a*\a/INCORRECT\a0!";
+        if (!cex_out->null()){
+            if (verifyCex(N_cex, *props_cex, *cex_out)) WriteLn "Counterexample VERIFIED!";
+            else                                      WriteLn "Counterexample is \a*\a/INCORRECT\a0!";
         }
 
+        // The abstraction refers to the flops of the retimed netlist and cannot be output:
+        bool write_abstr = retime_orig.null();
+        if (!write_abstr && abstr.size() > 0)
+            WriteLn "NOTE! Abstraction is of the retimed netlist and is not written.";
+
         // Write result file:
         if (output != ""){
             OutFile out(output);
             if (abstr.size() > 0){
                 FWriteLn(out) "result: %_", resultToString(l_Undef);
-                writeAbstr(out, N, abstr);
-            }else if (!cex.null()){
+                if (write_abstr) writeAbstr(out, N, abstr);
+            }else if (!cex_out->null()){
                 FWriteLn(out) "result: %_", resultToString(l_False);
-                writeCex(out, N, cex, orig_num_pis);
+                writeCex(out, N_cex, *cex_out, orig_num_pis);
             }else
                 FWriteLn(out) "result: %_", resultToString(l_Error);
             FWriteLn(out) "bug-free-depth: %_", bug_free_depth;
@@ -1440,7 +1551,7 @@ int main(int argc, char** argv)
 
         // Write AIGER file:
         String aig_output = cli_abs.get("aig").string_val;
-        if (aig_output != "" && aig_output != "-") writeAbstrAiger(N, abstr, aig_output, P.renumber, quiet);
+        if (aig_output != "" && aig_output != "-" && write_abstr) writeAbstrAiger(N, abstr, aig_output, P.renumber, quiet);
         if (!quiet) writeResourceUsage(T0, Tr0);
 
     }else if (cli.cmd == "bmc"){
@@ -1449,6 +1560,9 @@ int main(int argc, char** argv)
         P.simple_tseitin = cli_bmc.get("st").bool_val;
         P.la_steps       = cli_bmc.get("la").int_val;
         P.la_decay       = cli_bmc.get("la-decay").float_val;
+        P.cube_workers   = cli_bmc.get("cube").int_val;
+        P.cube_vars      = cli_bmc.get("cube-vars").int_val;
+        P.cube_confl     = (cli_bmc.get("cube-confl").choice == 0) ? (uint64)cli_bmc.get("cube-confl").int_val : UINT64_MAX;
         P.quiet          = cli.get("quiet").bool_val;
         P.sat_solver = (cli.get("sat").enum_val == 0) ? sat_Zz :
                        (cli.get("sat").enum_val == 1) ? sat_Msc :
@@ -1464,6 +1578,30 @@ int main(int argc, char** argv)
 
         outputVerificationResult(N, props, result, &cex, orig_num_pis, NetlistRef(), bug_free_depth, false, output, quiet, T0, Tr0);
 
+    }else if (cli.cmd == "kind"){
+        Params_Kind P;
+        P.max_k       = (cli_kind.get("k").choice == 0) ? (uint)cli_kind.get("k").int_val : UINT_MAX;
+        P.simple_path = cli_kind.get("unique").bool_val;
+        P.sift        = cli_kind.get("sift").bool_val;
+        P.par         = cli_kind.get("par").bool_val;
+        P.quiet       = cli.get("quiet").bool_val;
+
+        Netlist N_invar;
+        String  filename = cli_kind.get("invar").string_val;
+        if (filename != ""){
+            Vec<Wire> no_props;
+            if (!readInvariant(filename, no_props, N_invar)){
+                ShoutLn "ERROR! Could not read file: %_", filename;
+                exit(1); }
+        }
+
+        EffortCB_Timeout cb(vtimeout, timeout);
+        Cex   cex;
+        int   bug_free_depth;
+        lbool result = kind(N, props, P, &cex, &bug_free_depth, &cb, N_invar);
+
+        outputVerificationResult(N, props, result, &cex, orig_num_pis, NetlistRef(), bug_free_depth, false, output, quiet, T0, Tr0);
+
     }else if (cli.cmd == "multi-bmc"){
         Params_MultiBmc P;
         multiBmc(N, P);
@@ -1478,6 +1616,8 @@ int main(int argc, char** argv)
         P.quant_claus    = cli_imc.get("qc").bool_val;
         P.simple_tseitin = cli_imc.get("st").bool_val;
         P.spin           = cli_imc.get("spin").bool_val;
+        P.spill_mb       = (uint)cli_imc.get("spill").int_val;
+        P.compact_itp    = cli_imc.get("compact").bool_val;
         P.quiet          = cli.get("quiet").bool_val;
         EffortCB_Timeout cb(vtimeout, timeout);
         Cex     cex;
@@ -1558,23 +1698,70 @@ int main(int argc, char** argv)
 #endif
 
     }else if (cli.cmd == "simp"){
-        if (N.typeCount(gate_PO) != 1){
-            ShoutLn "ERROR! Can only handle netlist with exactly one PO.";
-            exit(1); }
-
-        Netlist M;
-        Add_Pob0(M, strash);
-        For_Gatetype(N, gate_PO, w_po)
-            M.add(PO_(0), copyAndSimplify(w_po[0], M));
+        Params_SeqSimp P;
+        P.xsim        = cli.get("xsim").bool_val;
+        P.merge_flops = cli.get("merge").bool_val;
+        P.remove_pis  = cli.get("pis").bool_val;
+        P.quiet       = quiet;
+
+        Netlist    M;
+        SeqSimpMap map;
+        try{
+            seqSimp(N, M, map, P);
+        }catch (Excp_Msg err){
+            ShoutLn "ERROR! %_", err.msg;
+            exit(1);
+        }
 
         if (output != ""){
-            //*aiger*/For_Gatetype(M, gate_PO, w) w.set(0, ~w[0]);    // -- invert properties
-            writeAigerFile(output, M);
+            if (!is_aiger && Has_Pob(M, properties)){
+                Get_Pob(M, properties);
+                for (uint i = 0; i < properties.size(); i++)
+                    properties[i].set(0, ~properties[i][0]);
+            }
+            writeAigerFile(output, M, Array<uchar>(), true);
             WriteLn "Wrote AIGER: \a*%_\a*", output;
         }
+
+        String map_file = cli.get("map").string_val;
+        if (map_file == "" && output != "")
+            map_file = setExtension(output, "map");
+        if (map_file != ""){
+            if (!writeSeqSimpMap(map_file, M, map)){
+                ShoutLn "ERROR! Could not write: %_", map_file;
+                exit(1); }
+            WriteLn "Wrote map:   \a*%_\a*", map_file;
+        }
         WriteLn "\a*Original:\a*    %_", info(N);
         WriteLn "\a*Simplified:\a*  %_", info(M);
 
+    }else if (cli.cmd == "retime"){
+        Params_Retime P;
+        P.fwd   = cli.get("fwd").bool_val;
+        P.bwd   = cli.get("bwd").bool_val;
+        P.quiet = quiet;
+
+        Netlist   M;
+        RetimeMap map;
+        try{
+            retime(N, M, map, P);
+        }catch (Excp_Msg err){
+            ShoutLn "ERROR! %_", err.msg;
+            exit(1);
+        }
+
+        if (output != ""){
+            if (!is_aiger && Has_Pob(M, properties)){
+                Get_Pob(M, properties);
+                for (uint i = 0; i < properties.size(); i++)
+                    properties[i].set(0, ~properties[i][0]);
+            }
+            writeAigerFile(output, M, Array<uchar>(), true);
+            WriteLn "Wrote AIGER: \a*%_\a*", output;
+        }
+        WriteLn "\a*Original:\a*  %_", info(N);
+        WriteLn "\a*Retimed:\a*   %_", info(M);
+
     }else if (cli.cmd == "static-bmc"){
         uint k0   = cli_static_bmc.get("k0").bool_val;
         uint k1   = cli_static_bmc.get("k").bool_val;
@@ -1647,6 +1834,31 @@ int main(int argc, char** argv)
         //int     bug_free_depth;
         lbool   result ___unused = semAbs(N, props);
 
+    }else if (cli.cmd == "scorr"){
+        Params_Scorr P;
+        P.k          = cli.get("k").int_val;
+        P.flops_only = cli.get("flops-only").bool_val;
+        P.sim_words  = cli.get("sim").int_val;
+        P.quiet      = quiet;
+        if (P.k == 0){ ShoutLn "Induction depth must be at least 1."; exit(1); }
+
+        if (!quiet) writeHeader("Signal Correspondence", 79);
+        scorr(N, P);
+
+        String filename = cli.get("aig").string_val;
+        if (filename != ""){
+            removeFlopInit(N);
+            writeAigerFile(filename, N);
+            WriteLn "Wrote: \a*%_\a*", filename;
+        }
+
+        filename = cli.get("gig").string_val;
+        if (filename != ""){
+            nameByCurrentId(N);
+            N.write(filename);
+            WriteLn "Wrote: \a*%_\a*", filename;
+        }
+
     }else if (cli.cmd == "reparam"){
         Params_Reparam P;
         P.cut_width = cli.get("width").int_val;
@@ -1767,6 +1979,8 @@ int main(int argc, char** argv)
         P.witness_output = cli.get("wit").string_val;
         P.eng = (Params_Liveness::Engine)cli.get("eng").enum_val;
         P.bmc_max_depth = (cli.get("bmc-depth").choice == 0) ? (uint)cli.get("bmc-depth").int_val : UINT_MAX;
+        P.max_k = (cli.get("max-k").choice == 0) ? (uint)cli.get("max-k").int_val : UINT_MAX;
+        P.jobs  = (uint)cli.get("jobs").int_val;
 
         Cex cex;
         uint loop_len;
@@ -1806,8 +2020,13 @@ int main(int argc, char** argv)
 
         P.witness_output = cli.get("wit").string_val;
         P.inv = cli.get("inv").bool_val;
+        P.ana_flops = cli.get("ana").int_val;
 
-        ltlCheck(N, spec_file, (prop_nums.size() == 0) ? 0 : prop_nums[0], P);     // -- only check one property
+        Vec<uint> prop_nos;     // -- empty means all properties of the spec file
+        for (uint i = 0; i < prop_nums.size(); i++)
+            prop_nos.push((uint)prop_nums[i]);
+        Vec<lbool> results;
+        ltlCheck(N, spec_file, prop_nos, P, results);
         if (!quiet) writeResourceUsage(T0, Tr0);
 
     }else if (cli.cmd == "constr"){
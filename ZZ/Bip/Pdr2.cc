@@ -229,7 +229,8 @@ class Pdr2 {
     TCube  solveRel  (TCube s, uint params = 0);
     TCube  generalize(TCube s);
     bool   blockCube (TCube s);
-    bool   propagate ();
+    bool   propagate (bool add_frame = true);
+    void   increaseK (Wire w_prop, Wire w_prop_in);
 
     void   extractCex(ProofObl pobl);
     uint   invariantSize();
@@ -1023,11 +1024,12 @@ void Pdr2::addCube(TCube s)
 }
 
 
-bool Pdr2::propagate()
+bool Pdr2::propagate(bool add_frame)
 {
     ZZ_PTimer_Scope(pdr2_propagate);
     //*T*/WriteLn "\a*\a/==== PROPAGATE\a0";
-    addFrame();
+    if (add_frame)
+        addFrame();
 
     for (uint k = P.prop_init ? 0 : 1; k < F.size()-1; k++){
         Vec<Cube> cubes(copy_, F[k]);
@@ -1305,6 +1307,71 @@ bool Pdr2::blockCube(TCube s0)
 }
 
 
+// k-liveness: the property failed for the current 'k'; add one more counter flop 'b' such that
+// the property 'w_prop' now only fails if 'b' is already set (which happens on the previous
+// failure). The only signals that change meaning are 'w_prop_in' and 'w_prop', and the new
+// 'w_prop' is TRUE whenever the old one was. Hence every learned cube not mentioning 'w_prop_in'
+// and not containing the literal 'w_prop' still blocks unreachable states, and as long as no cube
+// has to be dropped, each frame is still inductive relative to the previous one. If some cube is
+// dropped, the remaining cubes (which are still valid for the first frame) are moved to 'F[1]'.
+// Nothing is decided here: the caller must block '~w_prop' again before the result of any
+// 'propagate()' can be trusted (otherwise an empty frame could be mistaken for a fixed-point).
+void Pdr2::increaseK(Wire w_prop, Wire w_prop_in)
+{
+    // Add counter flop:
+    Get_Pob(N, flop_init);
+    Wire b_in = N.add(SO_());
+    Wire b = N.add(Flop_(), b_in);
+    flop_init(b) = l_False;
+    b_in     .set(0, N.add(Npn4_(npn4_cl_OR2),  b, ~w_prop_in[0], Wire_NULL, Wire_NULL));
+    w_prop_in.set(0, N.add(Npn4_(npn4_cl_OR2), ~b,  w_prop_in[0], Wire_NULL, Wire_NULL));
+
+    Get_Pob(N, fanouts);
+    fanouts.recompute();
+
+    Get_Pob(N, up_order);
+    up_order.recompute();
+
+    // Drop invalidated cubes:
+    uint n_dropped = 0;
+    for (uint d = 0; d < F.size(); d++){
+        for (uint i = 0; i < F[d].size();){
+            const Cube& c = F[d][i];
+            bool keep = true;
+            for (uint j = 0; j < c.size(); j++){
+                if (+c[j] == w_prop_in.lit() || c[j] == w_prop.lit()){
+                    keep = false;
+                    break; }
+            }
+            if (keep)
+                i++;
+            else{
+                F[d][i] = F[d].last();
+                F[d].pop();
+                n_dropped++;
+            }
+        }
+    }
+
+    if (n_dropped > 0){
+        for (uint d = 2; d < F.size(); d++){
+            append(F[1], F[d]);
+            F[d].clear();
+        }
+    }
+
+    // Initial value of counter flop:
+    F[0].push(Cube(b));
+    activity(b) += 1.0;
+
+    for (uint d = 0; d < F.size(); d++)
+        recycleSolver(d);
+
+    if (n_dropped > 0)
+        WriteLn "Dropped %_ cubes invalidated by the new counter flop.", n_dropped;
+}
+
+
 bool Pdr2::run()
 {
     // Add a flop on top of the property:
@@ -1355,41 +1422,13 @@ bool Pdr2::run()
 
         if (!blockCube(TCube(Cube(~w_prop), F.size()-1))){
             if (P.check_klive){
-                Get_Pob(N, flop_init);
-                Wire b_in = N.add(SO_());
-                Wire b = N.add(Flop_(), b_in);
-                flop_init(b) = l_False;
-//                b_in     .set(0, N.add(Npn4_(npn4_cl_OR2), Wire_NULL, Wire_NULL,  b, ~w_prop_in[0]));
-//                w_prop_in.set(0, N.add(Npn4_(npn4_cl_OR2), Wire_NULL, Wire_NULL, ~b,  w_prop_in[0]));
-                b_in     .set(0, N.add(Npn4_(npn4_cl_OR2),  b, ~w_prop_in[0], Wire_NULL, Wire_NULL));
-                w_prop_in.set(0, N.add(Npn4_(npn4_cl_OR2), ~b,  w_prop_in[0], Wire_NULL, Wire_NULL));
-
-                addCube(TCube(Cube(b), 0));
-
-                Get_Pob(N, fanouts);
-                fanouts.recompute();
-
-                Get_Pob(N, up_order);
-                up_order.recompute();
-
-#if 1
-                for (uint d = 0; d < F.size(); d++)
-                    recycleSolver(d);
-#else
-                for (uint d = 0; d < F.size(); d++){
-                    n2s[d][0](w_prop_in) = lit_Undef;
-                    n2s[d][1](w_prop) = lit_Undef;
-                    clausify(d, w_prop, 1);
-                }
-#endif
+                if (klive_depth >= P.klive_max){
+                    showProgress("final");
+                    WriteLn "K-liveness bound reached (k = %_).", klive_depth;
+                    return false; }
 
                 WriteLn "           \a*\a/==>> increasing\a/ k \a/to\a/ %_ \a/<<==\a/\a*", ++klive_depth;
-
-                    //        Wire b = N.add(Flop_());
-                    //        flop_init(b) = l_False;
-                    //        b.set(0, s_Or(b, ts[i-1]));
-                    //
-                    //        ts(i) = s_And(ts[i-1], b);
+                increaseK(w_prop, w_prop_in);
             }else{
                 showProgress("final");
                 WriteLn "Counterexample of depth %_ found.", cex.depth();
@@ -1641,7 +1680,7 @@ bool pdr2( NetlistRef          N,
     CCex ccex;
     Pdr2 pdr2(L, P, ccex, N_invar);
     bool ret = pdr2.run();
-    if (!ret && cex)
+    if (!ret && cex && !P.check_klive)
         translateCex(ccex, N, *cex);
     return ret;
 }
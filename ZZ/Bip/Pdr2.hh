@@ -44,6 +44,7 @@ struct Params_Pdr2 {
     SolverType  sat_solver;
     bool        prop_init;
     bool        check_klive;
+    uint        klive_max;              // -- with 'check_klive': max. number of counter flops to add before giving up (returning FALSE without a CEX)
     bool        par_send_result;        // -- place holder; Pdr2 doesn't support PAR yet
 
     Params_Pdr2() :
@@ -61,6 +62,7 @@ struct Params_Pdr2 {
         sat_solver   (sat_Abc),
         prop_init    (false),
         check_klive  (false),
+        klive_max    (UINT_MAX),
         par_send_result(true)
     {}
 };
@@ -0,0 +1,653 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Retime.cc
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Minimum-register retiming of a verification problem (pre-processing).
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Every step builds a node-capacitated flow network over the region registers may move over and
+//| computes a minimum cut with Dinic's algorithm. Of all minimum cuts, the one closest to the
+//| current register positions is used (least logic is moved). The netlist is then rebuilt from
+//| scratch with structural hashing, which also leaves it topologically ordered on gate IDs.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "Retime.hh"
+#include "ZZ_MiniSat.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Minimum node cut:
+
+
+// Nodes have capacity 1, everything else is unbounded. Node 'i' is split into vertices '2i'
+// (in) and '2i+1' (out); the source and sink are the last two vertices.
+class NodeCut {
+    enum { NIL = UINT_MAX, INF = UINT_MAX };
+
+    uint        n_nodes;
+    Vec<uint>   head;
+    Vec<uint>   next;
+    Vec<uint>   to;
+    Vec<uint>   cap;
+    Vec<uint>   level;
+
+    uint src() const { return 2*n_nodes; }
+    uint snk() const { return 2*n_nodes + 1; }
+
+    void addArc(uint u, uint v, uint c) {
+        to.push(v); cap.push(c); next.push(head[u]); head[u] = to.size() - 1;
+        to.push(u); cap.push(0); next.push(head[v]); head[v] = to.size() - 1; }
+
+    bool bfs();
+
+public:
+    NodeCut(uint n) : n_nodes(n) {
+        head.growTo(2*n + 2, NIL);
+        for (uint i = 0; i < n; i++)
+            addArc(2*i, 2*i + 1, 1); }
+
+    void edge  (uint i, uint j) { addArc(2*i + 1, 2*j, INF); }
+    void source(uint i)         { addArc(src(), 2*i, INF); }
+    void sink  (uint i)         { addArc(2*i + 1, snk(), INF); }
+
+    uint maxFlow();
+    void minCut(/*out*/Vec<uint>& cut, /*out*/Vec<uchar>& moved);
+        // -- After 'maxFlow()': 'cut' lists the nodes of the minimum cut closest to the source;
+        // 'moved[i]' is set for nodes strictly between the source and the cut.
+};
+
+
+// Compute levels of the residual graph from the source. Returns TRUE if the sink is reachable.
+bool NodeCut::bfs()
+{
+    level.reset(head.size(), NIL);
+    Vec<uint> Q;
+    Q.push(src());
+    level[src()] = 0;
+    for (uint q = 0; q < Q.size(); q++){
+        uint u = Q[q];
+        for (uint e = head[u]; e != NIL; e = next[e]){
+            if (cap[e] > 0 && level[to[e]] == NIL){
+                level[to[e]] = level[u] + 1;
+                Q.push(to[e]);
+            }
+        }
+    }
+    return level[snk()] != NIL;
+}
+
+
+uint NodeCut::maxFlow()
+{
+    uint      flow = 0;
+    Vec<uint> it;
+    Vec<uint> path;
+    while (bfs()){
+        head.copyTo(it);
+        for(;;){
+            // Find an augmenting path in the level graph (iteratively):
+            path.clear();
+            uint u = src();
+            while (u != snk()){
+                uint e = it[u];
+                while (e != NIL && !(cap[e] > 0 && level[to[e]] == level[u] + 1))
+                    e = next[e];
+                it[u] = e;
+
+                if (e == NIL){
+                    if (u == src()) goto PhaseDone;
+                    level[u] = NIL;     // -- dead end
+                    uint e_in = path.popC();
+                    u = to[e_in ^ 1];
+                    it[u] = next[it[u]];
+                }else{
+                    path.push(e);
+                    u = to[e];
+                }
+            }
+
+            uint delta = INF;
+            for (uint i = 0; i < path.size(); i++)
+                newMin(delta, cap[path[i]]);
+            for (uint i = 0; i < path.size(); i++){
+                if (cap[path[i]] != INF) cap[path[i]] -= delta;
+                if (cap[path[i] ^ 1] != INF) cap[path[i] ^ 1] += delta;
+            }
+            flow += delta;
+        }
+      PhaseDone:;
+    }
+    return flow;
+}
+
+
+void NodeCut::minCut(Vec<uint>& cut, Vec<uchar>& moved)
+{
+    bfs();      // -- no augmenting path left, so this computes the residual reachability from the source
+    cut.clear();
+    moved.reset(n_nodes, false);
+    for (uint i = 0; i < n_nodes; i++){
+        if (level[2*i] != NIL){
+            if (level[2*i + 1] == NIL) cut.push(i);
+            else                       moved[i] = true;
+        }
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'Retime':
+
+
+class Retime {
+    const Params_Retime& P;
+    RetimeMap&           map;       // -- during retiming, refers to flop numbers of the current netlist
+
+    NetlistRef  C;                  // -- current netlist
+    NetlistRef  D;                  // -- netlist being built
+    WMap<Wire>  c2d;                // -- 'C' gate -> its value in 'D' in the same frame
+    WMap<Wire>  alt;                // -- 'C' gate -> its value in 'D' one frame later (forward step) or earlier (backward step)
+    bool        fwd;
+    Vec<uint>   ff_map;             // -- flop number in 'C' -> flop number in 'D' (or 'UINT_MAX') for the last build
+
+    Wire copyCur(Wire w);
+    Wire copyAlt(Wire w);
+    void build(NetlistRef C, NetlistRef D, const WZet& drop, const Vec<Wire>& cut, bool fwd, /*out*/Vec<Wire>& cut_ffs);
+    void updateMap();
+    void copy(NetlistRef C, NetlistRef D);
+    bool stepFwd(NetlistRef C, NetlistRef D);
+    bool stepBwd(NetlistRef C, NetlistRef D);
+
+public:
+    Retime(const Params_Retime& P_, RetimeMap& map_) : P(P_), map(map_) {}
+
+    void run(NetlistRef N, NetlistRef M);
+};
+
+
+//=================================================================================================
+// -- Rebuild:
+
+
+// Copy the logic of 'w' in the current frame (iteratively, to handle deep netlists).
+Wire Retime::copyCur(Wire w)
+{
+    if (!c2d[w]){
+        Vec<Wire> Q(1, +w);
+        while (Q.size() > 0){
+            Wire v = Q.last();
+            if (c2d[v]){
+                Q.pop();
+                continue; }
+
+            assert(type(v) == gate_And);
+            Wire v0 = v[0], v1 = v[1];
+            if (!c2d[v0]) Q.push(+v0);
+            if (!c2d[v1]) Q.push(+v1);
+            if (c2d[v0] && c2d[v1]){
+                c2d(v) = s_And(c2d[v0] ^ sign(v0), c2d[v1] ^ sign(v1));
+                Q.pop();
+            }
+        }
+    }
+    return c2d[w] ^ sign(w);
+}
+
+
+// Copy the logic of 'w' shifted one frame. For forward steps, flops are replaced by (the
+// current frame copy of) their next-state functions; for backward steps, the leaves are the
+// new flops, which have been put into 'alt' by 'build()'.
+Wire Retime::copyAlt(Wire w)
+{
+    if (!alt[w]){
+        Vec<Wire> Q(1, +w);
+        while (Q.size() > 0){
+            Wire v = Q.last();
+            if (alt[v]){
+                Q.pop();
+                continue; }
+
+            if (type(v) == gate_Flop){ assert(fwd);
+                alt(v) = copyCur(v[0]);
+                Q.pop();
+                continue; }
+
+            assert(type(v) == gate_And);
+            Wire v0 = v[0], v1 = v[1];
+            if (!alt[v0]) Q.push(+v0);
+            if (!alt[v1]) Q.push(+v1);
+            if (alt[v0] && alt[v1]){
+                alt(v) = s_And(alt[v0] ^ sign(v0), alt[v1] ^ sign(v1));
+                Q.pop();
+            }
+        }
+    }
+    return alt[w] ^ sign(w);
+}
+
+
+// Build 'D' from 'C' with the flops of 'drop' removed and new flops (returned in 'cut_ffs')
+// placed on the outputs of the gates in 'cut'. For a forward step, 'drop' are the flops moved
+// over; for a backward step, it is the flops replaced by their next-state functions over the new
+// flops (whose initial values are left undefined). With both sets empty, this is a plain copy
+// (removing dangling logic).
+void Retime::build(NetlistRef C_, NetlistRef D_, const WZet& drop, const Vec<Wire>& cut, bool fwd_, Vec<Wire>& cut_ffs)
+{
+    C = C_;
+    D = D_;
+    fwd = fwd_;
+    c2d.clear();
+    alt.clear();
+
+    D.clear();
+    Add_Pob0(D, strash);
+    Add_Pob2(D, flop_init, d_init);     // -- always present in retimed netlists
+    c2d(C.True()) = alt(C.True()) = D.True();
+    c2d(C.False()) = alt(C.False()) = ~D.True();
+
+    For_Gatetype(C, gate_PI, w)
+        c2d(w) = D.add(PI_(attr_PI(w).number));
+
+    // Create flops (numbered compactly, preserving the relative order):
+    Vec<Wire> ffs;
+    For_Gatetype(C, gate_Flop, w)
+        ffs(attr_Flop(w).number, Wire_NULL) = w;
+
+    uint n_ffs = 0;
+    ff_map.clear();
+    for (uint i = 0; i < ffs.size(); i++){
+        ff_map.push(UINT_MAX);
+        if (ffs[i] && !drop.has(ffs[i])){
+            c2d(ffs[i]) = D.add(Flop_(n_ffs));
+            ff_map[i] = n_ffs++;
+            if (Has_Pob(C, flop_init)){
+                Get_Pob2(C, flop_init, c_init);
+                d_init(c2d[ffs[i]]) = c_init[ffs[i]];
+            }
+        }
+    }
+
+    cut_ffs.clear();
+    for (uint i = 0; i < cut.size(); i++){
+        cut_ffs.push(D.add(Flop_(n_ffs++)));
+        if (fwd) c2d(cut[i]) = cut_ffs[i];
+        else     alt(cut[i]) = cut_ffs[i];
+    }
+
+    // Replace dropped flops (backward step):
+    // (NOTE! Copying grows the maps, so references into them must not be taken before the copy)
+    if (!fwd){
+        for (uint i = 0; i < ffs.size(); i++){
+            if (ffs[i] && drop.has(ffs[i])){
+                Wire w = copyAlt(ffs[i][0]);
+                c2d(ffs[i]) = w;
+            }
+        }
+    }
+
+    // Connect flops:
+    for (uint i = 0; i < cut.size(); i++)
+        cut_ffs[i].set(0, fwd ? copyAlt(cut[i]) : copyCur(cut[i]));
+
+    for (uint i = 0; i < ffs.size(); i++){
+        if (ffs[i] && !drop.has(ffs[i])){
+            Wire w = copyCur(ffs[i][0]);
+            c2d[ffs[i]].set(0, w);
+        }
+    }
+
+    For_Gatetype(C, gate_PO, w){
+        Wire w_out = D.add(PO_(attr_PO(w).number), copyCur(w[0]));
+        c2d(w) = w_out;
+    }
+
+    // Translate Pobs:
+    if (Has_Pob(C, properties)){
+        Get_Pob2(C, properties, c_props);
+        Add_Pob2(D, properties, d_props);
+        for (uint i = 0; i < c_props.size(); i++)
+            d_props.push(c2d[c_props[i]] ^ sign(c_props[i]));
+    }
+    if (Has_Pob(C, constraints)){
+        Get_Pob2(C, constraints, c_constrs);
+        Add_Pob2(D, constraints, d_constrs);
+        for (uint i = 0; i < c_constrs.size(); i++)
+            d_constrs.push(c2d[c_constrs[i]] ^ sign(c_constrs[i]));
+    }
+    if (Has_Pob(C, fair_properties)){
+        Get_Pob2(C, fair_properties, c_fprops);
+        Add_Pob2(D, fair_properties, d_fprops);
+        for (uint i = 0; i < c_fprops.size(); i++){
+            d_fprops.push();
+            for (uint j = 0; j < c_fprops[i].size(); j++)
+                d_fprops[i].push(c2d[c_fprops[i][j]] ^ sign(c_fprops[i][j]));
+        }
+    }
+    if (Has_Pob(C, fair_constraints)){
+        Get_Pob2(C, fair_constraints, c_fconstrs);
+        Add_Pob2(D, fair_constraints, d_fconstrs);
+        for (uint i = 0; i < c_fconstrs.size(); i++)
+            d_fconstrs.push(c2d[c_fconstrs[i]] ^ sign(c_fconstrs[i]));
+    }
+}
+
+
+// Make 'map' refer to the netlist of the last build (only called once the build is accepted).
+void Retime::updateMap()
+{
+    for (uint i = 0; i < map.ff.size(); i++)
+        if (map.ff[i] != UINT_MAX)
+            map.ff[i] = ff_map[map.ff[i]];
+}
+
+
+// Copy the sequential COI of the POs of 'C' into 'D'.
+void Retime::copy(NetlistRef C, NetlistRef D)
+{
+    WZet      coi;
+    Vec<Wire> Q;
+    For_Gatetype(C, gate_PO, w)
+        Q.push(w);
+    while (Q.size() > 0){
+        Wire w = Q.popC();
+        if (coi.has(w)) continue;
+        coi.add(w);
+        For_Inputs(w, v)
+            Q.push(+v);
+    }
+
+    WZet drop;
+    For_Gatetype(C, gate_Flop, w)
+        if (!coi.has(w))
+            drop.add(w);
+
+    Vec<Wire> no_cut, no_ffs;
+    build(C, D, drop, no_cut, true, no_ffs);
+    updateMap();
+}
+
+
+//=================================================================================================
+// -- Retiming steps:
+
+
+// Move initialized flops forward over the logic they alone drive. New flops get the value
+// their gate has in the initial state.
+bool Retime::stepFwd(NetlistRef C, NetlistRef D)
+{
+    Get_Pob2(C, flop_init, c_init);
+
+    // Region (relies on gate IDs being topologically ordered):
+    Vec<Wire>  nodes;
+    WMap<uint> idx(UINT_MAX);
+    uint       n_srcs = 0;
+    For_Gates(C, w){
+        if ((type(w) == gate_Flop && c_init[w] != l_Undef)
+        ||  (type(w) == gate_And && (type(w[0]) == gate_Const || idx[w[0]] != UINT_MAX)
+                                 && (type(w[1]) == gate_Const || idx[w[1]] != UINT_MAX))
+        ){
+            idx(w) = nodes.size();
+            nodes.push(w);
+            if (type(w) == gate_Flop) n_srcs++;
+        }
+    }
+    if (n_srcs == 0) return false;
+
+    NodeCut G(nodes.size());
+    For_Gates(C, w){
+        if (type(w) == gate_Flop && idx[w] != UINT_MAX)
+            G.source(idx[w]);
+        For_Inputs(w, v){
+            if (idx[v] == UINT_MAX) continue;
+            if (type(w) == gate_And && idx[w] != UINT_MAX) G.edge(idx[v], idx[w]);
+            else                                           G.sink(idx[v]);
+        }
+    }
+
+    if (G.maxFlow() >= n_srcs) return false;
+
+    Vec<uint>  cut_idx;
+    Vec<uchar> moved;
+    G.minCut(cut_idx, moved);
+
+    // Initial values of the new flops:
+    WMap<lbool> val(l_Undef);
+    val(C.True())  = l_True;
+    val(C.False()) = l_False;
+    for (uint i = 0; i < nodes.size(); i++){
+        Wire w = nodes[i];
+        if (type(w) == gate_Flop) val(w) = c_init[w];
+        else                      val(w) = (val[w[0]] ^ sign(w[0])) & (val[w[1]] ^ sign(w[1]));
+    }
+
+    WZet      drop;
+    Vec<Wire> cut;
+    for (uint i = 0; i < nodes.size(); i++)
+        if (moved[i] && type(nodes[i]) == gate_Flop)
+            drop.add(nodes[i]);
+    for (uint i = 0; i < cut_idx.size(); i++)
+        if (type(nodes[cut_idx[i]]) != gate_Flop)
+            cut.push(nodes[cut_idx[i]]);
+
+    Vec<Wire> cut_ffs;
+    build(C, D, drop, cut, true, cut_ffs);
+
+    Get_Pob2(D, flop_init, d_init);
+    for (uint i = 0; i < cut.size(); i++){
+        assert(val[cut[i]] != l_Undef);
+        d_init(cut_ffs[i]) = val[cut[i]];
+    }
+    return true;
+}
+
+
+// Move initialized flops backward over the logic that only drives them. The initial state of
+// the new flops is computed by SAT; if the old initial state has no pre-image, nothing is done.
+bool Retime::stepBwd(NetlistRef C, NetlistRef D)
+{
+    Get_Pob2(C, flop_init, c_init);
+
+    // Flops to move:
+    WZet drop;
+    For_Gatetype(C, gate_Flop, w)
+        if (c_init[w] != l_Undef && type(w[0]) != gate_Const)
+            drop.add(w);
+    if (drop.size() == 0) return false;
+
+    // Region (gates whose fanouts all are in the region or are moved flops):
+    WMap<uint> n_fanouts(0);
+    WMap<uint> n_inside(0);
+    For_Gates(C, w)
+        For_Inputs(w, v)
+            n_fanouts(v)++;
+    For_Gatetype(C, gate_Flop, w)
+        if (drop.has(w))
+            n_inside(w[0])++;
+
+    Vec<Wire>  nodes;
+    WMap<uint> idx(UINT_MAX);
+    WZet       region;
+    for (uint i = C.size(); i > 0;){ i--;
+        Wire w = C[i];
+        if (deleted(w) || type(w) != gate_And) continue;
+        if (n_fanouts[w] > 0 && n_inside[w] == n_fanouts[w]){
+            region.add(w);
+            n_inside(w[0])++;
+            n_inside(w[1])++;
+        }
+    }
+
+    // Nodes are the region plus its non-constant fanins:
+    Vec<Wire> roots;
+    For_Gatetype(C, gate_Flop, w)
+        if (drop.has(w))
+            roots.push(w[0]);
+    For_Gates(C, w)
+        if (region.has(w))
+            roots.push(w[0]), roots.push(w[1]);
+    For_Gates(C, w)
+        if (region.has(w) && idx[w] == UINT_MAX)
+            idx(w) = nodes.size(), nodes.push(w);
+    for (uint i = 0; i < roots.size(); i++){
+        Wire w = +roots[i];
+        if (type(w) != gate_Const && idx[w] == UINT_MAX)
+            idx(w) = nodes.size(), nodes.push(w);
+    }
+
+    // Flow network is reversed (flop inputs are the sources):
+    NodeCut G(nodes.size());
+    For_Gatetype(C, gate_Flop, w)
+        if (drop.has(w) && type(w[0]) != gate_Const)
+            G.source(idx[w[0]]);
+    for (uint i = 0; i < nodes.size(); i++){
+        Wire w = nodes[i];
+        if (region.has(w)){
+            For_Inputs(w, v)
+                if (type(v) != gate_Const)
+                    G.edge(i, idx[v]);
+        }else
+            G.sink(i);
+    }
+
+    if (G.maxFlow() >= drop.size()) return false;
+
+    Vec<uint>  cut_idx;
+    Vec<uchar> moved;
+    G.minCut(cut_idx, moved);
+
+    Vec<Wire> cut;
+    for (uint i = 0; i < cut_idx.size(); i++)
+        cut.push(nodes[cut_idx[i]]);
+
+    Vec<Wire> cut_ffs;
+    build(C, D, drop, cut, false, cut_ffs);
+
+    // Find a pre-image of the old initial state ('c2d' of a dropped flop is its replacement):
+    SatStd           S;
+    WMap<Lit>        d2s;
+    Clausify<SatStd> CD(S, D, d2s);
+    For_Gatetype(C, gate_Flop, w){
+        if (drop.has(w))
+            S.addClause(CD.clausify(c2d[w]) ^ (c_init[w] == l_False));
+    }
+
+    if (S.solve() != l_True){
+        if (!P.quiet) WriteLn "Backward step discarded (initial state has no pre-image).";
+        return false; }
+
+    Get_Pob2(D, flop_init, d_init);
+    for (uint i = 0; i < cut_ffs.size(); i++){
+        Lit p = d2s[cut_ffs[i]];
+        d_init(cut_ffs[i]) = (p == Lit_NULL || S.value(p) == l_Undef) ? l_False : S.value(p);
+    }
+    return true;
+}
+
+
+//=================================================================================================
+// -- Main:
+
+
+void Retime::run(NetlistRef N, NetlistRef M)
+{
+    For_Gates(N, w){
+        if (type(w) != gate_Const && type(w) != gate_PI && type(w) != gate_PO && type(w) != gate_Flop && type(w) != gate_And)
+            Throw(Excp_Msg) "Retiming only supports AIGs (found gate type: %_)", GateType_name[type(w)];
+    }
+
+    // Track uninitialized flops:
+    map.ff.reset(nextNum_Flop(N), UINT_MAX);
+    if (Has_Pob(N, flop_init)){
+        Get_Pob2(N, flop_init, n_init);
+        For_Gatetype(N, gate_Flop, w)
+            if (n_init[w] == l_Undef)
+                map.ff[attr_Flop(w).number] = attr_Flop(w).number;
+    }else{
+        For_Gatetype(N, gate_Flop, w)
+            map.ff[attr_Flop(w).number] = attr_Flop(w).number;
+    }
+
+    // Retime:
+    double  T0 = cpuTime();
+    Netlist C, D;
+    copy(N, C);
+    if (!P.quiet) WriteLn "COI + strash:  %_", info(C);
+
+    uint n_steps = 0;
+    for(;;){
+        uint n_steps0 = n_steps;
+        for (uint dir = 0; dir < 2; dir++){
+            if (dir == 0 ? !P.fwd : !P.bwd) continue;
+            while (n_steps < P.max_steps){
+                uint n_ffs = C.typeCount(gate_Flop);
+                if (dir == 0 ? !stepFwd(C, D) : !stepBwd(C, D))
+                    break;
+                updateMap();
+                copy(D, C);
+                n_steps++;
+                if (!P.quiet) WriteLn "Step %_ (%_):  #Flop %_ -> %_   =>  %_   [%t]", n_steps, (dir == 0) ? "fwd" : "bwd", n_ffs, C.typeCount(gate_Flop), info(C), cpuTime() - T0;
+            }
+        }
+        if (n_steps == n_steps0 || n_steps >= P.max_steps)
+            break;
+    }
+
+    copy(C, M);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Wrapper functions:
+
+
+void retime(NetlistRef N, NetlistRef M, RetimeMap& map, const Params_Retime& P)
+{
+    Retime rt(P, map);
+    rt.run(N, M);
+}
+
+
+void liftCex(NetlistRef N, NetlistRef M, const RetimeMap& map, const Cex& cex_M, Cex& cex_N)
+{
+    cex_N.clear();
+    cex_N.inputs.growTo(cex_M.inputs.size());
+    cex_N.flops .growTo(max_(cex_M.flops.size(), (uind)1));
+
+    // PIs are shared (same numbers):
+    Vec<Wire> m_pis;
+    For_Gatetype(M, gate_PI, w)
+        m_pis(attr_PI(w).number, Wire_NULL) = w;
+    For_Gatetype(N, gate_PI, w){
+        uint num = attr_PI(w).number;
+        for (uint k = 0; k < cex_N.inputs.size(); k++){
+            lbool v = (num < m_pis.size() && m_pis[num]) ? cex_M.inputs[k][m_pis[num]] : l_Undef;
+            cex_N.inputs[k](w) = (v == l_Undef) ? l_False : v;
+        }
+    }
+
+    // Initialized flops start in their initial state, the others are kept as they are:
+    Vec<Wire> m_ffs;
+    For_Gatetype(M, gate_Flop, w)
+        m_ffs(attr_Flop(w).number, Wire_NULL) = w;
+    For_Gatetype(N, gate_Flop, w){
+        uint  num = map.ff[attr_Flop(w).number];
+        lbool v   = (num == UINT_MAX) ? lbool(l_Undef) : cex_M.flops[0][m_ffs[num]];
+        if (num == UINT_MAX){
+            Get_Pob(N, flop_init);
+            v = flop_init[w];
+        }
+        cex_N.flops[0](w) = (v == l_Undef) ? l_False : v;
+    }
+}
+
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,69 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Retime.hh
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Minimum-register retiming of a verification problem (pre-processing).
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Registers are moved one step at a time, forward over logic driven only by initialized flops,
+//| or backward over logic feeding only initialized flops. Each step places the registers on a
+//| minimum node cut (max-flow) of the region it may move over, and is kept only if it reduces the
+//| number of flops. Steps are repeated until no direction gives a reduction.
+//|
+//| Initial values of forward moved registers are computed by simulating the old initial state;
+//| for backward moved registers a SAT query finds a state whose image is the old initial state
+//| (if there is none, the step is discarded). Uninitialized flops are never moved, so the
+//| retimed netlist has exactly the same PO traces as the original for the same inputs, which
+//| makes counterexample lifting trivial.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__Retime_hh
+#define ZZ__Bip__Retime_hh
+
+#include "ZZ_Netlist.hh"
+#include "ZZ_Bip.Common.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Retiming:
+
+
+struct Params_Retime {
+    bool    fwd;                // -- allow forward steps
+    bool    bwd;                // -- allow backward steps (needs SAT for initial state computation)
+    uint    max_steps;          // -- upper bound on the number of accepted steps
+    bool    quiet;
+
+    Params_Retime() :
+        fwd      (true),
+        bwd      (true),
+        max_steps(UINT_MAX),
+        quiet    (false)
+    {}
+};
+
+
+struct RetimeMap {
+    Vec<uint>   ff;             // -- indexed by original flop number: flop number in retimed netlist for uninitialized flops, else 'UINT_MAX'
+};
+
+
+void retime(NetlistRef N, NetlistRef M, /*out*/RetimeMap& map, const Params_Retime& P = Params_Retime());
+    // -- Store a retimed version of 'N' in 'M' (which should be empty). 'N' may only contain gates
+    // of type Const, PI, PO, Flop and And. PIs and POs (and their numbers) are preserved, as are
+    // the Pobs 'flop_init', 'properties', 'constraints', 'fair_properties' and 'fair_constraints'.
+    // Flops of 'M' are numbered compactly. May throw 'Excp_Msg'.
+
+void liftCex(NetlistRef N, NetlistRef M, const RetimeMap& map, const Cex& cex_M, /*out*/Cex& cex_N);
+    // -- Translate a counterexample of the retimed netlist 'M' to the original netlist 'N'.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
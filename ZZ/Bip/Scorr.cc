@@ -0,0 +1,476 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Scorr.cc
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Signal correspondence through k-induction over a speculatively reduced model.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Each refinement pass builds one SAT instance over the frame window: frames '0..k-1' from the
+//| initial states for the base case, frames '0..k' from an arbitrary state for the inductive
+//| step. In the window, the fanouts of every class member read the representative (with phase),
+//| so the unrolling is no bigger than the (hypothetically) reduced design. The equivalences are
+//| asserted in all but the last frame and checked one by one in the last. Counterexamples are
+//| collected and resimulated (up to 64 at a time) on the original design; the actual values are
+//| used to split the classes. A pass without counterexamples means the classes are proved.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "Scorr.hh"
+#include "ZZ_Bip.Common.hh"
+#include "ZZ_MiniSat.hh"
+#include "ZZ/Generics/Map.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helper types:
+
+
+struct ScorrCex {
+    Vec<lbool>          ff;     // -- state of frame 0 (indexed as 'ffs')
+    Vec<Vec<lbool> >    pi;     // -- inputs of each frame (indexed as 'pis')
+    GLit                failed; // -- the member whose check produced this counterexample
+};
+
+
+static
+uint64 sigMix(uint64 sig, uint64 v)
+{
+    sig ^= v + 0x9E3779B97F4A7C15ull + (sig << 6) + (sig >> 2);
+    return sig * 0xFF51AFD7ED558CCDull;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'Scorr':
+
+
+class Scorr {
+    NetlistRef          N;
+    const Params_Scorr& P;
+    Info_Scorr&         info;
+    uint64              seed;
+
+    Vec<gate_id>        order;      // -- topological order of 'N' starting with constant 'True' (no POs)
+    Vec<GLit>           pis;
+    Vec<GLit>           ffs;
+    WMap<uint>          src_idx;    // -- index into 'pis' or 'ffs'
+    Vec<lbool>          ff_init;
+
+    Vec<Vec<GLit> >     classes;    // -- first element is the representative (unsigned); members carry their phase
+    WMap<GLit>          repr;       // -- member -> representative ^ phase ('glit_NULL' for non-members)
+
+    WMap<uint64>        val;        // -- current simulation values
+
+    bool isCand(Wire w) const {
+        return type(w) == gate_Const || type(w) == gate_Flop || (type(w) == gate_And && !P.flops_only); }
+
+    void simFrame(Vec<uint64>& ff_val, const Vec<uint64>& pi_val);
+    void initClasses();
+    void updateRepr();
+    bool splitClasses();
+    void refine(Vec<ScorrCex>& cexs);
+    bool pass(bool base);
+    void reduce();
+
+public:
+    Scorr(NetlistRef N_, const Params_Scorr& P_, Info_Scorr& info_) :
+        N(N_), P(P_), info(info_), seed(P_.seed), src_idx(UINT_MAX), repr(glit_NULL), val(0) {}
+
+    void run();
+};
+
+
+//=================================================================================================
+// -- Simulation:
+
+
+// Compute values of frame given flop values 'ff_val' and input values 'pi_val'. On return,
+// 'ff_val' contains the state of the next frame.
+void Scorr::simFrame(Vec<uint64>& ff_val, const Vec<uint64>& pi_val)
+{
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = N[order[i]];
+        switch (type(w)){
+        case gate_Const: val(w) = (+w == N.True()) ? ~(uint64)0 : 0; break;
+        case gate_PI:    val(w) = pi_val[src_idx[w]]; break;
+        case gate_Flop:  val(w) = ff_val[src_idx[w]]; break;
+        case gate_And:{
+            uint64 v0 = val[w[0]] ^ (sign(w[0]) ? ~(uint64)0 : 0);
+            uint64 v1 = val[w[1]] ^ (sign(w[1]) ? ~(uint64)0 : 0);
+            val(w) = v0 & v1;
+            break;}
+        default: assert(false); }
+    }
+
+    for (uint i = 0; i < ffs.size(); i++){
+        Wire w = N[ffs[i]][0];
+        ff_val[i] = val[w] ^ (sign(w) ? ~(uint64)0 : 0);
+    }
+}
+
+
+// Initial candidates from random sequential simulation starting in the initial states.
+void Scorr::initClasses()
+{
+    WMap<uint64> sig(0);
+    WMap<char>   phase(0);
+
+    Vec<uint64> ff_val(ffs.size());
+    Vec<uint64> pi_val(pis.size());
+    for (uint r = 0; r < P.sim_words; r++){
+        for (uint i = 0; i < ffs.size(); i++)
+            ff_val[i] = (ff_init[i] == l_True) ? ~(uint64)0 : (ff_init[i] == l_False) ? 0 : irandl(seed);
+
+        for (uint t = 0; t < P.sim_frames; t++){
+            for (uint i = 0; i < pis.size(); i++)
+                pi_val[i] = irandl(seed);
+            simFrame(ff_val, pi_val);
+
+            for (uint i = 0; i < order.size(); i++){
+                Wire w = N[order[i]];
+                if (!isCand(w)) continue;
+                if (r == 0 && t == 0) phase(w) = val[w] & 1;
+                sig(w) = sigMix(sig[w], val[w] ^ (phase[w] ? ~(uint64)0 : 0));
+            }
+        }
+    }
+
+    Map<uint64,uint> sig2class;
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = N[order[i]];
+        if (!isCand(w)) continue;
+
+        uint* idx;
+        if (!sig2class.get(sig[w], idx)){
+            *idx = classes.size();
+            classes.push();
+            classes.last().push(w.lit());
+        }else{
+            GLit rep = classes[*idx][0];
+            classes[*idx].push(w.lit() ^ (phase[w] != phase[N[rep]]));
+        }
+    }
+
+    uint j = 0;
+    for (uint i = 0; i < classes.size(); i++){
+        if (classes[i].size() > 1){
+            info.cands += classes[i].size() - 1;
+            classes[i].moveTo(classes[j++]); }
+    }
+    classes.shrinkTo(j);
+}
+
+
+void Scorr::updateRepr()
+{
+    repr.clear();
+    for (uint i = 0; i < classes.size(); i++){
+        GLit rep = classes[i][0];
+        for (uint j = 1; j < classes[i].size(); j++)
+            repr(N[classes[i][j]]) = rep ^ classes[i][j].sign;
+    }
+}
+
+
+// Split classes according to the current simulation values. Returns TRUE if anything changed.
+bool Scorr::splitClasses()
+{
+    bool changed = false;
+    Vec<Vec<GLit> > new_classes;
+    Vec<char>        head_sign;     // -- phase of new representative relative to the old one
+    Map<uint64,uint> key2class;
+    for (uint i = 0; i < classes.size(); i++){
+        const Vec<GLit>& c = classes[i];
+        key2class.clear();
+        uint first = new_classes.size();
+        for (uint j = 0; j < c.size(); j++){
+            uint64 key = val[N[c[j]]] ^ (c[j].sign ? ~(uint64)0 : 0);
+            uint* idx;
+            if (!key2class.get(key, idx)){
+                *idx = new_classes.size();
+                new_classes.push();
+                new_classes.last().push(+c[j]);     // -- first member (in topological order) becomes representative
+                head_sign.push(c[j].sign);
+            }else
+                new_classes[*idx].push(+c[j] ^ (c[j].sign ^ (bool)head_sign[*idx]));
+        }
+        if (new_classes.size() - first > 1)
+            changed = true;
+    }
+
+    // Remove singletons:
+    uint j = 0;
+    for (uint i = 0; i < new_classes.size(); i++)
+        if (new_classes[i].size() > 1)
+            new_classes[i].moveTo(new_classes[j++]);
+    new_classes.shrinkTo(j);
+
+    if (changed){
+        new_classes.moveTo(classes);
+        updateRepr();
+    }
+    return changed;
+}
+
+
+// Resimulate counterexamples (all of the same length) on the original design and refine classes.
+void Scorr::refine(Vec<ScorrCex>& cexs)
+{
+    if (cexs.size() == 0) return;
+    assert(cexs.size() <= 64);
+    info.refinements += cexs.size();
+
+    uint n = cexs.size();
+    Vec<uint64> ff_val(ffs.size(), 0);
+    Vec<uint64> pi_val(pis.size());
+    for (uint b = 0; b < 64; b++){      // -- unused bit positions replicate earlier counterexamples
+        const ScorrCex& cex = cexs[b % n];
+        for (uint i = 0; i < ffs.size(); i++)
+            if (cex.ff[i] == l_True) ff_val[i] |= (uint64)1 << b;
+    }
+
+    bool changed = false;
+    for (uint d = 0; d < cexs[0].pi.size(); d++){
+        for (uint i = 0; i < pis.size(); i++){
+            pi_val[i] = 0;
+            for (uint b = 0; b < 64; b++)
+                if (cexs[b % n].pi[d][i] == l_True) pi_val[i] |= (uint64)1 << b;
+        }
+        simFrame(ff_val, pi_val);
+        changed |= splitClasses();
+    }
+
+    if (!changed){
+        // Should not happen; as a safe fallback, drop the members whose checks failed.
+        for (uint i = 0; i < cexs.size(); i++){
+            GLit m = cexs[i].failed;
+            for (uint j = 0; j < classes.size(); j++){
+                for (uint q = 1; q < classes[j].size(); q++){
+                    if (+classes[j][q] == +m){
+                        GLit x = classes[j][q];
+                        pullOut(classes[j], x);     // -- keep topological order ('splitClasses()' relies on it)
+                        goto Found;
+                    }
+                }
+            }
+          Found:;
+        }
+        uint j = 0;
+        for (uint i = 0; i < classes.size(); i++)
+            if (classes[i].size() > 1)
+                classes[i].moveTo(classes[j++]);
+        classes.shrinkTo(j);
+        updateRepr();
+    }
+
+    cexs.clear();
+}
+
+
+//=================================================================================================
+// -- Speculatively reduced unrolling:
+
+
+// Returns TRUE if no counterexample was found (classes unchanged).
+bool Scorr::pass(bool base)
+{
+    Netlist          F;
+    SatStd           S;
+    WMap<Lit>        f2s;
+    WZet             keep_f;
+    Clausify<SatStd> C(S, F, f2s, keep_f);
+    Add_Pob0(F, strash);
+
+    uint depth = base ? P.k : P.k + 1;
+    Vec<WMap<Wire> > func(depth);     // -- value computed from (reduced) fanins
+    Vec<WMap<Wire> > spec(depth);     // -- value seen by fanouts (representative ^ phase for members)
+    Vec<ScorrCex>    cexs;
+
+    #define Spec(d, v) (spec[d][v] ^ sign(v))
+
+    for (uint d = 0; d < depth; d++){
+        // Build frame:
+        for (uint i = 0; i < order.size(); i++){
+            Wire w = N[order[i]];
+            Wire f;
+            switch (type(w)){
+            case gate_Const: f = (+w == N.True()) ? F.True() : ~F.True(); break;
+            case gate_PI:    f = F.add(PI_()); break;
+            case gate_Flop:
+                if (d == 0){
+                    lbool init = ff_init[src_idx[w]];
+                    f = (base && init != l_Undef) ? ((init == l_True) ? F.True() : ~F.True()) : F.add(PI_());
+                }else
+                    f = Spec(d-1, w[0]);
+                break;
+            case gate_And: f = s_And(Spec(d, w[0]), Spec(d, w[1])); break;
+            default: assert(false); }
+
+            func[d](w) = f;
+            GLit r = repr[w];
+            spec[d](w) = (r == glit_NULL) ? f : spec[d][N[r]] ^ r.sign;
+        }
+
+        // Check or assert equivalences:
+        bool check = base || d == P.k;
+        for (uint i = 0; i < classes.size(); i++){
+            for (uint j = 1; j < classes[i].size(); j++){
+                Wire w = N[classes[i][j]];
+                Wire x = s_Xor(func[d][w], spec[d][w]);
+                if (x == ~F.True()) continue;
+
+                Lit p = C.clausify(x);
+                if (check && cexs.size() < 64){
+                    info.sat_calls++;
+                    lbool result = S.solve(p);
+                    if (result == l_True){
+                        // Extract counterexample:
+                        cexs.push();
+                        ScorrCex& cex = cexs.last();
+                        cex.failed = w.lit();
+                        cex.ff.setSize(ffs.size());
+                        for (uint q = 0; q < ffs.size(); q++){
+                            Wire   g = func[0][N[ffs[q]]];
+                            lbool  v = (type(g) == gate_Const) ? lbool_lift(g == F.True()) :
+                                       (f2s[g] == Lit_NULL)    ? l_False : S.value(f2s[g] ^ sign(g));
+                            cex.ff[q] = (v == l_Undef) ? l_False : v;
+                        }
+                        cex.pi.setSize(d+1);
+                        for (uint e = 0; e <= d; e++){
+                            cex.pi[e].setSize(pis.size());
+                            for (uint q = 0; q < pis.size(); q++){
+                                Wire   g = func[e][N[pis[q]]];
+                                lbool  v = (f2s[g] == Lit_NULL) ? l_False : S.value(f2s[g] ^ sign(g));
+                                cex.pi[e][q] = (v == l_Undef) ? l_False : v;
+                            }
+                        }
+                    }
+                }
+                if (!check || base)
+                    S.addClause(~p);
+            }
+        }
+
+        if (cexs.size() > 0) break;     // -- (only base case can get here before last frame)
+    }
+
+    #undef Spec
+
+    if (!P.quiet){
+        uint n_memb = 0;
+        for (uint i = 0; i < classes.size(); i++) n_memb += classes[i].size() - 1;
+        WriteLn "%_:  classes=%_  members=%_  cexs=%_  (vars=%_  clauses=%_)", base ? "base" : "step",
+            classes.size(), n_memb, cexs.size(), S.nVars(), S.nClauses();
+    }
+
+    bool done = (cexs.size() == 0);
+    refine(cexs);
+    return done;
+}
+
+
+//=================================================================================================
+// -- Main:
+
+
+void Scorr::reduce()
+{
+    Remove_Pob(N, strash);
+
+    For_Gates(N, w){
+        For_Inputs(w, v){
+            GLit r = repr[v];
+            if (r != glit_NULL)
+                w.set(Input_Pin_Num(v), N[r] ^ sign(v));
+        }
+    }
+
+    // Remove merged flops (they no longer have fanouts):
+    for (uint i = 0; i < ffs.size(); i++){
+        Wire w = N[ffs[i]];
+        if (repr[w] != glit_NULL)
+            w.remove();
+    }
+    removeUnreach(N);
+    Add_Pob0(N, strash);
+}
+
+
+void Scorr::run()
+{
+    // Setup:
+    For_Gates(N, w){
+        if (type(w) != gate_Const && type(w) != gate_PI && type(w) != gate_PO && type(w) != gate_Flop && type(w) != gate_And)
+            Throw(Excp_Msg) "Signal correspondence only supports AIGs (found gate type: %_)", GateType_name[type(w)];
+    }
+
+    Vec<gate_id> tmp;
+    upOrder(N, tmp);
+    order.push(gid_True);
+    for (uint i = 0; i < tmp.size(); i++){
+        Wire w = N[tmp[i]];
+        if (type(w) == gate_Const || type(w) == gate_PO) continue;
+        order.push(tmp[i]);
+    }
+
+    bool has_init = Has_Pob(N, flop_init);
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = N[order[i]];
+        if (type(w) == gate_PI){
+            src_idx(w) = pis.size();
+            pis.push(w.lit());
+        }else if (type(w) == gate_Flop){
+            src_idx(w) = ffs.size();
+            ffs.push(w.lit());
+            if (has_init){
+                Get_Pob(N, flop_init);
+                ff_init.push(flop_init[w]);
+            }else
+                ff_init.push(l_Undef);
+        }
+    }
+
+    // Find candidates:
+    double T0 = cpuTime();
+    initClasses();
+    updateRepr();
+    if (!P.quiet) WriteLn "Candidates: %_ in %_ classes  [%t]", info.cands, classes.size(), cpuTime() - T0;
+
+    // Refine until fixed point:
+    while (!pass(true));
+    while (!pass(false));
+
+    // Merge:
+    for (uint i = 0; i < classes.size(); i++)
+        info.proved += classes[i].size() - 1;
+    uint n_ands = N.typeCount(gate_And);
+    uint n_ffs  = N.typeCount(gate_Flop);
+    reduce();
+
+    if (!P.quiet){
+        WriteLn "Proved: %_   Refinements: %_   SAT calls: %_   CPU-time: %t", info.proved, info.refinements, info.sat_calls, cpuTime() - T0;
+        WriteLn "Flops: %_ -> %_   ANDs: %_ -> %_", n_ffs, N.typeCount(gate_Flop), n_ands, N.typeCount(gate_And);
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Wrapper function:
+
+
+void scorr(NetlistRef N, const Params_Scorr& P, Info_Scorr* info)
+{
+    Info_Scorr dummy;
+    Scorr sc(N, P, info ? *info : dummy);
+    sc.run();
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
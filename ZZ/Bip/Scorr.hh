@@ -0,0 +1,68 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Scorr.hh
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Signal correspondence through k-induction over a speculatively reduced model.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Candidate equivalences (including constants) are found by random sequential simulation from
+//| the initial states. Every member of a class is then merged into its representative in the
+//| unrolling ("speculative reduction") and the equivalences are proved by k-induction. Counter-
+//| examples are resimulated on the original design to refine the classes until a fixed point is
+//| reached. The proved equivalences are finally merged in the netlist itself.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__Scorr_hh
+#define ZZ__Bip__Scorr_hh
+
+#include "ZZ_Netlist.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Signal correspondence:
+
+
+struct Params_Scorr {
+    uint    k;                  // -- depth of induction (1 = standard signal correspondence)
+    bool    flops_only;         // -- only consider flops (and constants) as candidates ("register correspondence")
+    uint    sim_words;          // -- rounds of 64-bit parallel random simulation for initial candidates
+    uint    sim_frames;         // -- frames of sequential simulation per round
+    uint64  seed;
+    bool    quiet;
+
+    Params_Scorr() :
+        k         (1),
+        flops_only(false),
+        sim_words (16),
+        sim_frames(32),
+        seed      (0),
+        quiet     (false)
+    {}
+};
+
+
+struct Info_Scorr {
+    uint    cands;              // -- initial number of non-representative candidates
+    uint    proved;             // -- number of nodes merged
+    uint    refinements;        // -- number of counterexamples used for refinement
+    uint    sat_calls;
+
+    Info_Scorr() : cands(0), proved(0), refinements(0), sat_calls(0) {}
+};
+
+
+void scorr(NetlistRef N, const Params_Scorr& P = Params_Scorr(), Info_Scorr* info = NULL);
+    // -- Modifies 'N' in place. 'N' may only contain gates of type Const, PI, PO, Flop and And. Flop
+    // initialization is read from the 'flop_init' Pob (if missing, all flops are uninitialized).
+    // POs, and their numbering, are preserved.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
@@ -0,0 +1,452 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : SeqSimp.cc
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Sequential simplification of a verification problem (pre-processing).
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Every round computes a substitution for flops (constants, other flops or PIs) on the current
+//| netlist and then rebuilds it from the POs with structural hashing. The rebuild does COI
+//| reduction and constant propagation at the same time, and leaves the netlist topologically
+//| ordered on gate IDs (which the ternary simulation relies on).
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "SeqSimp.hh"
+#include "ZZ/Generics/Sort.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helpers:
+
+
+// Value of 'p' (a source of 'M' or a constant) in frame 'd' of 'cex'.
+static
+lbool cexValue(NetlistRef M, const Cex& cex, GLit p, uint d)
+{
+    if (p == glit_NULL)
+        return l_Undef;
+    else if (+p == glit_True)
+        return lbool_lift(!sign(p));
+    else if (type(M[p]) == gate_PI)
+        return (d < cex.inputs.size()) ? cex.inputs[d][M[p]] ^ sign(p) : l_Undef;
+    else{ assert(d == 0);
+        return cex.flops[0][M[p]] ^ sign(p); }
+}
+
+
+struct SeqSimp_lt {
+    NetlistRef N;
+    SeqSimp_lt(NetlistRef N_) : N(N_) {}
+
+    bool operator()(GLit x, GLit y) const {
+        Wire wx = N[x], wy = N[y];
+        int  nx = (type(wx) == gate_PI) ? attr_PI(wx).number : attr_Flop(wx).number;
+        int  ny = (type(wy) == gate_PI) ? attr_PI(wy).number : attr_Flop(wy).number;
+        return nx < ny; }
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'SeqSimp':
+
+
+class SeqSimp {
+    const Params_SeqSimp& P;
+    SeqSimpMap&           map;      // -- during simplification, literals refer to the current netlist
+
+    WMap<GLit>  subst;              // -- flop -> replacement (constant, PI or flop that is not itself substituted)
+    WZet        shifted;            // -- PIs that replace a flop (they now lag one frame behind the original PI)
+
+    void copyCone(Wire w, NetlistRef D, WMap<Wire>& c2d);
+    void rebuild(NetlistRef C, NetlistRef D);
+    uint xsimConsts(NetlistRef C);
+    uint mergeFlops(NetlistRef C);
+    uint removePIs(NetlistRef C);
+
+public:
+    SeqSimp(const Params_SeqSimp& P_, SeqSimpMap& map_) : P(P_), map(map_), subst(glit_NULL) {}
+
+    void run(NetlistRef N, NetlistRef M);
+};
+
+
+//=================================================================================================
+// -- Rebuild:
+
+
+// Copy the combinational logic of 'w' (iteratively, to handle deep netlists).
+void SeqSimp::copyCone(Wire w, NetlistRef D, WMap<Wire>& c2d)
+{
+    if (c2d[w]) return;
+
+    Vec<Wire> Q(1, +w);
+    while (Q.size() > 0){
+        Wire v = Q.last();
+        if (c2d[v]){
+            Q.pop();
+            continue; }
+
+        assert(type(v) == gate_And);
+        Wire v0 = v[0], v1 = v[1];
+        if (!c2d[v0]) Q.push(+v0);
+        if (!c2d[v1]) Q.push(+v1);
+        if (c2d[v0] && c2d[v1]){
+            c2d(v) = s_And(c2d[v0] ^ sign(v0), c2d[v1] ^ sign(v1));
+            Q.pop();
+        }
+    }
+}
+
+
+// Copy the sequential COI of all POs of 'C' into 'D' (which is cleared first), applying 'subst'.
+// Literals of 'map' are translated from 'C' to 'D'.
+void SeqSimp::rebuild(NetlistRef C, NetlistRef D)
+{
+    D.clear();
+    Add_Pob0(D, strash);
+
+    // Compute COI:
+    WZet      coi;
+    Vec<Wire> Q;
+    For_Gatetype(C, gate_PO, w)
+        Q.push(w);
+    while (Q.size() > 0){
+        Wire w = Q.popC();
+        if (coi.has(w)) continue;
+        coi.add(w);
+
+        switch (type(w)){
+        case gate_Const: case gate_PI: break;
+        case gate_Flop:
+            if (subst[w] != glit_NULL) Q.push(+C[subst[w]]);
+            else                       Q.push(+w[0]);
+            break;
+        case gate_PO:  Q.push(+w[0]); break;
+        case gate_And: Q.push(+w[0]); Q.push(+w[1]); break;
+        default:
+            Throw(Excp_Msg) "Sequential simplification only supports AIGs (found gate type: %_)", GateType_name[type(w)];
+        }
+    }
+
+    // Create sources (numbered compactly, preserving the relative order):
+    Vec<GLit> pis, ffs;
+    For_Gatetype(C, gate_PI, w)
+        if (coi.has(w)) pis.push(w.lit());
+    For_Gatetype(C, gate_Flop, w)
+        if (coi.has(w) && subst[w] == glit_NULL) ffs.push(w.lit());
+    sobSort(sob(pis, SeqSimp_lt(C)));
+    sobSort(sob(ffs, SeqSimp_lt(C)));
+
+    WMap<Wire> c2d;
+    c2d(C.True()) = D.True();
+    for (uint i = 0; i < pis.size(); i++)
+        c2d(C[pis[i]]) = D.add(PI_(i));
+
+    for (uint i = 0; i < ffs.size(); i++)
+        c2d(C[ffs[i]]) = D.add(Flop_(i));
+
+    Add_Pob2(D, flop_init, d_init);     // -- always present in simplified netlists
+    if (Has_Pob(C, flop_init)){
+        Get_Pob2(C, flop_init, c_init);
+        for (uint i = 0; i < ffs.size(); i++)
+            d_init(c2d[C[ffs[i]]]) = c_init[C[ffs[i]]];
+    }
+
+    For_Gatetype(C, gate_Flop, w){
+        if (coi.has(w) && subst[w] != glit_NULL){
+            Wire r = C[subst[w]]; assert(type(r) != gate_Flop || subst[r] == glit_NULL);
+            c2d(w) = c2d[r] ^ sign(r);
+        }
+    }
+
+    // Copy logic:
+    for (uint i = 0; i < ffs.size(); i++){
+        Wire w = C[ffs[i]];
+        copyCone(w[0], D, c2d);
+    }
+    For_Gatetype(C, gate_PO, w)
+        copyCone(w[0], D, c2d);
+
+    for (uint i = 0; i < ffs.size(); i++){
+        Wire w = C[ffs[i]];
+        c2d[w].set(0, c2d[w[0]] ^ sign(w[0]));
+    }
+    For_Gatetype(C, gate_PO, w)
+        c2d(w) = D.add(PO_(attr_PO(w).number), c2d[w[0]] ^ sign(w[0]));
+
+    // Translate Pobs:
+    if (Has_Pob(C, properties)){
+        Get_Pob2(C, properties, c_props);
+        Add_Pob2(D, properties, d_props);
+        for (uint i = 0; i < c_props.size(); i++)
+            d_props.push(c2d[c_props[i]] ^ sign(c_props[i]));
+    }
+    if (Has_Pob(C, constraints)){
+        Get_Pob2(C, constraints, c_constrs);
+        Add_Pob2(D, constraints, d_constrs);
+        for (uint i = 0; i < c_constrs.size(); i++)
+            d_constrs.push(c2d[c_constrs[i]] ^ sign(c_constrs[i]));
+    }
+    if (Has_Pob(C, fair_properties)){
+        Get_Pob2(C, fair_properties, c_fprops);
+        Add_Pob2(D, fair_properties, d_fprops);
+        for (uint i = 0; i < c_fprops.size(); i++){
+            d_fprops.push();
+            for (uint j = 0; j < c_fprops[i].size(); j++)
+                d_fprops[i].push(c2d[c_fprops[i][j]] ^ sign(c_fprops[i][j]));
+        }
+    }
+    if (Has_Pob(C, fair_constraints)){
+        Get_Pob2(C, fair_constraints, c_fconstrs);
+        Add_Pob2(D, fair_constraints, d_fconstrs);
+        for (uint i = 0; i < c_fconstrs.size(); i++)
+            d_fconstrs.push(c2d[c_fconstrs[i]] ^ sign(c_fconstrs[i]));
+    }
+
+    // Translate source map:
+    for (uint n = 0; n < 2; n++){
+        Vec<SeqSimpSrc>& srcs = (n == 0) ? map.pi : map.ff;
+        for (uint i = 0; i < srcs.size(); i++){
+            SeqSimpSrc& s = srcs[i];
+            if (s.lit == glit_NULL) continue;
+
+            Wire w = C[s.lit];
+            if (!c2d[w])
+                s = SeqSimpSrc();
+            else{
+                if (shifted.has(w))
+                    s.delay++;
+                s.lit = (c2d[w] ^ sign(w)).lit();
+            }
+        }
+    }
+
+    subst.clear();
+    shifted.clear();
+}
+
+
+//=================================================================================================
+// -- Reductions:
+
+
+// Ternary simulation from the initial states with all PIs at X. A flop whose value differs
+// between two rounds is set to X (which makes the iteration terminate in at most '#flops + 1'
+// rounds). Flops with a non-X value at the fixed point are constant in all reachable states.
+uint SeqSimp::xsimConsts(NetlistRef C)
+{
+    if (!Has_Pob(C, flop_init)) return 0;
+    Get_Pob(C, flop_init);
+
+    WMap<lbool> val(l_Undef);
+    For_Gatetype(C, gate_Flop, w)
+        val(w) = flop_init[w];
+
+    for(;;){
+        For_Gates(C, w){
+            if (type(w) == gate_Const)
+                val(w) = (+w == C.True()) ? l_True : l_Undef;
+            else if (type(w) == gate_And)
+                val(w) = (val[w[0]] ^ sign(w[0])) & (val[w[1]] ^ sign(w[1]));
+        }
+
+        bool changed = false;
+        For_Gatetype(C, gate_Flop, w){
+            lbool next = val[w[0]] ^ sign(w[0]);
+            if (val[w] != l_Undef && val[w] != next){
+                val(w) = l_Undef;
+                changed = true;
+            }
+        }
+        if (!changed) break;
+    }
+
+    uint n_consts = 0;
+    For_Gatetype(C, gate_Flop, w){
+        if (val[w] != l_Undef){
+            subst(w) = glit_True ^ (val[w] == l_False);
+            n_consts++;
+        }
+    }
+    return n_consts;
+}
+
+
+// Stuck flops (next-state is the flop itself, or the initial value as a constant) become constants.
+// Initialized flops with the same next-state function (after strashing), possibly in opposite
+// phase, are merged.
+uint SeqSimp::mergeFlops(NetlistRef C)
+{
+    if (!Has_Pob(C, flop_init)) return 0;
+    Get_Pob(C, flop_init);
+
+    uint       n_merged = 0;
+    WMap<GLit> repr(glit_NULL);     // -- (unsigned) next-state function -> first flop with that function
+    For_Gatetype(C, gate_Flop, w){
+        if (subst[w] != glit_NULL) continue;
+        lbool init = flop_init[w];
+        if (init == l_Undef) continue;
+
+        Wire next = w[0];
+        if (next == w || (type(next) == gate_Const && (+next == C.True()) && (init == l_True) != sign(next))){
+            subst(w) = glit_True ^ (init == l_False);
+            n_merged++;
+
+        }else if (repr[next] == glit_NULL)
+            repr(next) = w.lit() ^ sign(next);
+
+        else{
+            Wire r = C[repr[next]];     // -- 'r' (with sign) has the same next-state function as 'w' has without it
+            bool neg = sign(r) ^ sign(next);
+            if ((flop_init[+r] ^ neg) == init){
+                subst(w) = (+r).lit() ^ neg;
+                n_merged++;
+            }
+        }
+    }
+    return n_merged;
+}
+
+
+// An uninitialized flop fed by a PI with no other fanouts holds an arbitrary value in each frame,
+// so it can be replaced by that PI (lagging one frame behind).
+uint SeqSimp::removePIs(NetlistRef C)
+{
+    if (!Has_Pob(C, flop_init)) return 0;
+    Get_Pob(C, flop_init);
+
+    WMap<uint> n_fanouts(0);
+    For_Gates(C, w)
+        For_Inputs(w, v)
+            n_fanouts(v)++;
+
+    uint n_removed = 0;
+    For_Gatetype(C, gate_Flop, w){
+        if (subst[w] != glit_NULL || flop_init[w] != l_Undef) continue;
+        Wire v = w[0];
+        if (type(v) == gate_PI && n_fanouts[v] == 1){
+            subst(w) = v.lit();
+            shifted.add(+v);
+            n_removed++;
+        }
+    }
+    return n_removed;
+}
+
+
+//=================================================================================================
+// -- Main:
+
+
+void SeqSimp::run(NetlistRef N, NetlistRef M)
+{
+    // Map every source to itself:
+    map.pi.reset(nextNum_PI(N));
+    map.ff.reset(nextNum_Flop(N));
+    For_Gatetype(N, gate_PI, w)
+        map.pi[attr_PI(w).number] = SeqSimpSrc(w.lit());
+    For_Gatetype(N, gate_Flop, w)
+        map.ff[attr_Flop(w).number] = SeqSimpSrc(w.lit());
+
+    // Strashing may disconnect logic that was in the COI before the rebuild, so every rebuild is
+    // followed by a plain copy (no substitution) to get a clean netlist back in 'C':
+    double T0 = cpuTime();
+    Netlist C, D;
+    rebuild(N, D);
+    rebuild(D, C);
+    if (!P.quiet) WriteLn "COI + strash:  %_", info(C);
+
+    for (uint round = 0; round < P.max_rounds; round++){
+        uint n_consts = P.xsim        ? xsimConsts(C) : 0;
+        uint n_merged = P.merge_flops ? mergeFlops(C) : 0;
+        uint n_pis    = P.remove_pis  ? removePIs(C)  : 0;
+        if (n_consts + n_merged + n_pis == 0)
+            break;
+
+        rebuild(C, D);
+        rebuild(D, C);
+        if (!P.quiet) WriteLn "Round %_:  consts=%_  merged=%_  PIs=%_   =>  %_   [%t]", round + 1, n_consts, n_merged, n_pis, info(C), cpuTime() - T0;
+    }
+
+    rebuild(C, M);      // -- 'C' is already clean; this just moves the result
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Wrapper functions:
+
+
+void seqSimp(NetlistRef N, NetlistRef M, SeqSimpMap& map, const Params_SeqSimp& P)
+{
+    SeqSimp ss(P, map);
+    ss.run(N, M);
+}
+
+
+void liftCex(NetlistRef N, NetlistRef M, const SeqSimpMap& map, const Cex& cex_M, Cex& cex_N)
+{
+    cex_N.clear();
+    cex_N.inputs.growTo(cex_M.inputs.size());
+    cex_N.flops .growTo(max_(cex_M.flops.size(), (uind)1));
+
+    For_Gatetype(N, gate_PI, w){
+        const SeqSimpSrc& s = map.pi[attr_PI(w).number];
+        for (uint k = 0; k < cex_N.inputs.size(); k++){
+            lbool v = cexValue(M, cex_M, s.lit, k + s.delay);
+            cex_N.inputs[k](w) = (v == l_Undef) ? l_False : v;
+        }
+    }
+
+    Get_Pob(N, flop_init);
+    For_Gatetype(N, gate_Flop, w){
+        const SeqSimpSrc& s = map.ff[attr_Flop(w).number];
+        lbool v = cexValue(M, cex_M, s.lit, s.delay);
+        if (v == l_Undef) v = flop_init[w];
+        cex_N.flops[0](w) = (v == l_Undef) ? l_False : v;
+    }
+}
+
+
+void writeSeqSimpMap(Out& out, NetlistRef M, const SeqSimpMap& map)
+{
+    for (uint n = 0; n < 2; n++){
+        const Vec<SeqSimpSrc>& srcs = (n == 0) ? map.pi : map.ff;
+        for (uint i = 0; i < srcs.size(); i++){
+            GLit p = srcs[i].lit;
+            out += (n == 0) ? "pi " : "ff ", i, " = ";
+            if (p == glit_NULL)
+                out += '-';
+            else if (+p == glit_True)
+                out += sign(p) ? '0' : '1';
+            else{
+                Wire w = M[p];
+                if (sign(w)) out += '!';
+                if (type(w) == gate_PI) out += "pi", attr_PI  (w).number;
+                else                    out += "ff", attr_Flop(w).number;
+                if (srcs[i].delay > 0 || n == 0)
+                    out += '@', srcs[i].delay;
+            }
+            out += '\n';
+        }
+    }
+}
+
+
+bool writeSeqSimpMap(String filename, NetlistRef M, const SeqSimpMap& map)
+{
+    OutFile out(filename);
+    if (!out) return false;
+    writeSeqSimpMap(out, M, map);
+    return true;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
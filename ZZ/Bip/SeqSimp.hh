@@ -0,0 +1,88 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : SeqSimp.hh
+//| Author(s)   : Niklas Een
+//| Module      : Bip
+//| Description : Sequential simplification of a verification problem (pre-processing).
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| The following reductions are applied until a fixed point is reached:
+//|
+//|   - Cone-of-influence reduction w.r.t. all properties, constraints and other POs.
+//|   - Ternary simulation from the initial states; flops that never become X are constant.
+//|   - Stuck flops (next-state is the flop itself) and duplicate flops (same next-state and
+//|     initial value, possibly in opposite phase) are merged.
+//|   - Structural hashing (with constant propagation).
+//|   - Uninitialized flops fed by a PI with no other fanout are replaced by that PI.
+//|
+//| Each source of the original netlist is mapped to a source of the simplified netlist (possibly
+//| delayed some frames), which is enough to lift counterexamples back.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__SeqSimp_hh
+#define ZZ__Bip__SeqSimp_hh
+
+#include "ZZ_Netlist.hh"
+#include "ZZ_Bip.Common.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Sequential simplification:
+
+
+struct Params_SeqSimp {
+    bool    xsim;               // -- detect constant flops by ternary simulation
+    bool    merge_flops;        // -- merge stuck and duplicate flops
+    bool    remove_pis;         // -- replace uninitialized flops fed by a dedicated PI with that PI
+    uint    max_rounds;         // -- upper bound on the number of fixed point iterations
+    bool    quiet;
+
+    Params_SeqSimp() :
+        xsim       (true),
+        merge_flops(true),
+        remove_pis (true),
+        max_rounds (UINT_MAX),
+        quiet      (false)
+    {}
+};
+
+
+struct SeqSimpSrc {
+    GLit    lit;                // -- PI or flop of simplified netlist (possibly negated), constant 'glit_True' (possibly negated), or 'glit_NULL' if value does not matter
+    uint    delay;              // -- 'lit' should be read this many frames later
+
+    SeqSimpSrc(GLit lit_ = glit_NULL, uint delay_ = 0) : lit(lit_), delay(delay_) {}
+};
+
+
+struct SeqSimpMap {
+    Vec<SeqSimpSrc> pi;         // -- indexed by original PI number: value in frame 'k' is that of 'lit' in frame 'k + delay'
+    Vec<SeqSimpSrc> ff;         // -- indexed by original flop number: initial value is that of 'lit' in frame 'delay'
+};
+
+
+void seqSimp(NetlistRef N, NetlistRef M, /*out*/SeqSimpMap& map, const Params_SeqSimp& P = Params_SeqSimp());
+    // -- Store a simplified version of 'N' in 'M' (which should be empty). 'N' may only contain
+    // gates of type Const, PI, PO, Flop and And. POs (and their numbers) are preserved, as are the
+    // Pobs 'flop_init', 'properties', 'constraints', 'fair_properties' and 'fair_constraints'. PIs
+    // and flops of 'M' are numbered compactly. May throw 'Excp_Msg'.
+
+void liftCex(NetlistRef N, NetlistRef M, const SeqSimpMap& map, const Cex& cex_M, /*out*/Cex& cex_N);
+    // -- Translate a counterexample of the simplified netlist 'M' to the original netlist 'N'.
+    // Inputs that do not matter are set to 'l_False'.
+
+void writeSeqSimpMap(Out& out, NetlistRef M, const SeqSimpMap& map);
+bool writeSeqSimpMap(String filename, NetlistRef M, const SeqSimpMap& map);
+    // -- Text format, one line per source of the original netlist, e.g. "pi 4 = !pi2@1" (original
+    // PI 4 in frame 'k' is the negation of PI 2 in frame 'k+1'), "ff 7 = ff3", "ff 8 = 0" or
+    // "pi 5 = -" (value does not matter). Numbers are AIGER input and latch indices.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
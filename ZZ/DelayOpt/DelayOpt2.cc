@@ -165,10 +165,10 @@ public:
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// 'DelayOpt' class:
+// 'DelayOpt2' class:
 
 
-class DelayOpt {
+class DelayOpt2 {
   //________________________________________
   //  Types:
 
@@ -268,7 +268,7 @@ public:
   //________________________________________
   //  Public interface:
 
-    DelayOpt(NetlistRef N_, const SC_Lib& L_, const Vec<float>& wire_cap_, const Params_DelayOpt& P_) :
+    DelayOpt2(NetlistRef N_, const SC_Lib& L_, const Vec<float>& wire_cap_, const Params_DelayOpt& P_) :
         N(N_), L(L_), wire_cap(wire_cap_), P(P_),
         buf_sym(UINT_MAX), buf_grp(UINT_MAX), area(-1), Q(LevQueue_lt(N, level)), R(LevQueue_lt(N, level)), seed(DEFAULT_SEED)
         {}
@@ -281,24 +281,24 @@ public:
 // Helpers:
 
 
-inline uint DelayOpt::grpNo(Wire w) const {
+inline uint DelayOpt2::grpNo(Wire w) const {
     assert_debug(type(w) == gate_Uif);
     return group_inv[attr_Uif(w).sym].fst; }
 
-inline uint DelayOpt::altNo(Wire w) const {
+inline uint DelayOpt2::altNo(Wire w) const {
     return (type(w) != gate_Uif) ? 0 : group_inv[attr_Uif(w).sym].snd; }
 
-inline void DelayOpt::setAltNo(Wire w, uint alt) {
+inline void DelayOpt2::setAltNo(Wire w, uint alt) {
     if (type(w) != gate_Uif)
         assert(alt == 0);
     else
         attr_Uif(w).sym = groups[group_inv[attr_Uif(w).sym].fst][alt]; }
 
-inline uint DelayOpt::maxAltNo(Wire w) const {
+inline uint DelayOpt2::maxAltNo(Wire w) const {
     return (type(w) != gate_Uif) ? 0 : groups[group_inv[attr_Uif(w).sym].fst].size() - 1; }
 
 
-float DelayOpt::computeCritLen(uint approx)
+float DelayOpt2::computeCritLen(uint approx)
 {
     assert(order.size() > 0);
     TMap load;
@@ -311,7 +311,7 @@ float DelayOpt::computeCritLen(uint approx)
 }
 
 
-void DelayOpt::setupOrder()
+void DelayOpt2::setupOrder()
 {
     // Topological order:
     topoOrder(N, order);
@@ -338,13 +338,13 @@ void DelayOpt::setupOrder()
 
 
 // 'w' is the node with the fanouts (Pin or Uif), 'w0' is the standard cell (always Uif).
-bool DelayOpt::capOk(Wire w, Wire w0, uint out_pin) {
+bool DelayOpt2::capOk(Wire w, Wire w0, uint out_pin) {
     const SC_Pin& pin = cell(w0, L).outPin(out_pin);
     return load[w].rise <= pin.max_out_cap && load[w].fall <= pin.max_out_cap; }
 
 
 // Clear internal names; needed if feeding result of this algorithm back to itself.
-void DelayOpt::clearInternalNames()
+void DelayOpt2::clearInternalNames()
 {
     Vec<char> tmp;
     For_Gates(N, w){
@@ -359,7 +359,7 @@ void DelayOpt::clearInternalNames()
 }
 
 
-void DelayOpt::addInternalNames()
+void DelayOpt2::addInternalNames()
 {
     // Name buffers:
     uint bufC = 0;
@@ -378,7 +378,7 @@ void DelayOpt::addInternalNames()
 }
 
 
-inline void DelayOpt::enqueue(Wire w)
+inline void DelayOpt2::enqueue(Wire w)
 {
     //**/WriteLn "## enqueued: %n", w;
     if (!in_Q.add(w))
@@ -386,7 +386,7 @@ inline void DelayOpt::enqueue(Wire w)
 }
 
 
-inline Wire DelayOpt::dequeue()
+inline Wire DelayOpt2::dequeue()
 {
     Wire w = Q.pop() + N;
     in_Q.exclude(w);
@@ -394,14 +394,14 @@ inline Wire DelayOpt::dequeue()
 }
 
 
-inline void DelayOpt::enqueueR(Wire w)
+inline void DelayOpt2::enqueueR(Wire w)
 {
     if (!in_R.add(w))
         R.add(w);
 }
 
 
-inline Wire DelayOpt::dequeueR()
+inline Wire DelayOpt2::dequeueR()
 {
     Wire w = R.pop() + N;
     in_R.exclude(w);
@@ -413,7 +413,7 @@ inline Wire DelayOpt::dequeueR()
 // Legalization:
 
 
-void DelayOpt::legalize()
+void DelayOpt2::legalize()
 {
     assert(order.size() > 0);
 
@@ -474,7 +474,7 @@ void DelayOpt::legalize()
 // Pre-buffer:
 
 
-void DelayOpt::preBuffer()
+void DelayOpt2::preBuffer()
 {
     assert(order.size() > 0);
 
@@ -631,7 +631,7 @@ void contRevTimeGate(const ContCell& cc, uint out_pin, uint in_pin,
 }
 
 
-ContCell DelayOpt::contCell(Wire w, float alt) const
+ContCell DelayOpt2::contCell(Wire w, float alt) const
 {
     const Vec<uint>& gs = groups[grpNo(w)];
     uint a = (uint)alt;
@@ -644,7 +644,7 @@ ContCell DelayOpt::contCell(Wire w, float alt) const
 }
 
 
-void DelayOpt::contComputeGateLoad(Wire w)
+void DelayOpt2::contComputeGateLoad(Wire w)
 {
     assert(!isMultiOutput(w, L));
 
@@ -668,7 +668,7 @@ void DelayOpt::contComputeGateLoad(Wire w)
 }
 
 
-void DelayOpt::contUpdateArrival(Wire w, bool update_multi)
+void DelayOpt2::contUpdateArrival(Wire w, bool update_multi)
 {
     if (!((type(w) == gate_Uif && !isMultiOutput(w, L)) || type(w) == gate_Pin)) return;
 
@@ -689,7 +689,7 @@ void DelayOpt::contUpdateArrival(Wire w, bool update_multi)
 
 // NOTE! Computes 'w's impact on the departure time of its CHILDREN, not 'w' itself. The departure
 // time of the children CAN ONLY INCREASE, and must be zeroed before calling this method.
-void DelayOpt::contUpdateDeparture(Wire w, bool update_multi, bool use_win)
+void DelayOpt2::contUpdateDeparture(Wire w, bool update_multi, bool use_win)
 {
     if (!((type(w) == gate_Uif && !isMultiOutput(w, L)) || type(w) == gate_Pin)) return;
 
@@ -710,7 +710,7 @@ void DelayOpt::contUpdateDeparture(Wire w, bool update_multi, bool use_win)
 }
 
 
-void DelayOpt::contUpdateThisDeparture(Wire w)
+void DelayOpt2::contUpdateThisDeparture(Wire w)
 {
     assert(!isMultiOutput(w, L));
 
@@ -749,7 +749,7 @@ void DelayOpt::contUpdateThisDeparture(Wire w)
 }
 
 
-void DelayOpt::contStaticTiming()
+void DelayOpt2::contStaticTiming()
 {
     load.clear();
     arr .clear();
@@ -783,7 +783,7 @@ void DelayOpt::contStaticTiming()
 }
 
 
-void DelayOpt::contIncPropagate()
+void DelayOpt2::contIncPropagate()
 {
     Get_Pob(N, dyn_fanouts);
 
@@ -864,7 +864,7 @@ void DelayOpt::contIncPropagate()
 }
 
 
-void DelayOpt::contResizeGate(Wire w0, float new_alt)
+void DelayOpt2::contResizeGate(Wire w0, float new_alt)
 {
     /*T*/ZZ_PTimer_Scope(cont_inc_update);
 
@@ -890,13 +890,13 @@ void DelayOpt::contResizeGate(Wire w0, float new_alt)
 }
 
 
-inline void DelayOpt::contNudge(float eval, Wire w, float step)
+inline void DelayOpt2::contNudge(float eval, Wire w, float step)
 {
     contResizeGate(w, alt[w] + ((eval > 0) ? -step : +step));
 }
 
 
-double DelayOpt::contEval(Wire w0, const WSeen& crit, float delta)
+double DelayOpt2::contEval(Wire w0, const WSeen& crit, float delta)
 {
     /*T*/ZZ_PTimer_Scope(cont_eval);
     assert(type(w0) == gate_Uif);
@@ -1078,7 +1078,7 @@ struct AbsFst {
 
 */
 
-void DelayOpt::continuousResizing()
+void DelayOpt2::continuousResizing()
 {
     if (P.verbosity >= 1){
         WriteLn "\a/_______________________________________________________________________________\a/";
@@ -1230,7 +1230,7 @@ void DelayOpt::continuousResizing()
 // -- Experimental:
 
 
-void DelayOpt::alternativeResizing(float req_time)
+void DelayOpt2::alternativeResizing(float req_time)
 {
     if (P.verbosity >= 1){
         WriteLn "\a/_______________________________________________________________________________\a/";
@@ -1385,7 +1385,7 @@ void DelayOpt::alternativeResizing(float req_time)
 }
 
 
-float DelayOpt::flowEvalGate(Wire w, FlowMap& flow)
+float DelayOpt2::flowEvalGate(Wire w, FlowMap& flow)
 {
     ContCell cc = contCell(w, alt[w]);
     double cost = 0;
@@ -1425,7 +1425,7 @@ float DelayOpt::flowEvalGate(Wire w, FlowMap& flow)
 }
 
 
-void DelayOpt::flowResizeGate(Wire w, FlowMap& flow)
+void DelayOpt2::flowResizeGate(Wire w, FlowMap& flow)
 {
     contComputeGateLoad(w);
 
@@ -1461,7 +1461,7 @@ void DelayOpt::flowResizeGate(Wire w, FlowMap& flow)
 // Main:
 
 
-void DelayOpt::run()
+void DelayOpt2::run()
 {
     Auto_Pob(N, dyn_fanouts);
 
@@ -1523,11 +1523,57 @@ void DelayOpt::run()
 
 void optimizeDelay2(NetlistRef N, const SC_Lib& L, const Vec<float>& wire_cap, const Params_DelayOpt& P)
 {
-    DelayOpt dopt(N, L, wire_cap, P);
+    DelayOpt2 dopt(N, L, wire_cap, P);
     dopt.run();
 }
 
 
+static
+uint worstCorner(const Vec<float>& max_arr)
+{
+    uint worst = 0;
+    for (uint c = 1; c < max_arr.size(); c++)
+        if (max_arr[c] > max_arr[worst])
+            worst = c;
+    return worst;
+}
+
+
+uint optimizeDelay2(NetlistRef N, const TimingCorners& C, const Params_DelayOpt& P)
+{
+    Vec<float> max_arr;
+    maxArrivalMC(N, C, P.approx, max_arr);
+    uint worst = worstCorner(max_arr);
+
+    for (uint iter = 0;; iter++){
+        if (P.verbosity >= 1)
+            WriteLn "Optimizing for corner \a*%_\a* (max arrival %.2f ps)", worst, C.lib[worst]->ps(max_arr[worst]);
+
+        // Optimize in that corner's library:
+        remapCells(N, C, 0, worst);
+        optimizeDelay2(N, *C.lib[worst], C.wire_cap[worst], P);
+        remapCells(N, C, worst, 0);
+
+        // Re-time all corners:
+        maxArrivalMC(N, C, P.approx, max_arr);
+        if (P.verbosity >= 1){
+            for (uint c = 0; c < C.size(); c++)
+                WriteLn "Corner %_: max arrival \a/%.2f ps\a/", c, C.lib[c]->ps(max_arr[c]);
+        }
+
+        uint new_worst = worstCorner(max_arr);
+        if (new_worst == worst)
+            break;
+        worst = new_worst;
+        if (iter + 1 >= C.size()){
+            WriteLn "WARNING! Worst corner still changing after %_ runs; corner %_ is now the worst.", iter + 1, worst;
+            break;
+        }
+    }
+    return worst;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Options:
 
@@ -17,6 +17,7 @@
 #include "ZZ_Netlist.hh"
 #include "ZZ_Liberty.hh"
 #include "ZZ_CmdLine.hh"
+#include "TimingMC.hh"
 
 namespace ZZ {
 using namespace std;
@@ -100,6 +101,11 @@ void setParams(const CLI& cli, Params_DelayOpt& P);
 
 
 void optimizeDelay2(NetlistRef N, const SC_Lib& L, const Vec<float>& wire_cap, const Params_DelayOpt& P);
+uint optimizeDelay2(NetlistRef N, const TimingCorners& C, const Params_DelayOpt& P);
+    // -- The second version optimizes against the worst of the corners in 'C', re-timing all corners
+    // after each run and re-optimizing while another corner takes over as the worst one (at most
+    // once per corner). Returns the corner that is worst at the end. Cells of 'N' refer to
+    // 'C.lib[0]' both before and after the call.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -24,6 +24,7 @@ int main(int argc, char** argv)
     cli.add("output", "string", ""           , "Output Verilog file.");
     cli.add("test"  , "bool"  , "no"         , "[INTERNAL]. Run test function.");
     cli.add("old"   , "bool"  , "no"         , "[INTERNAL]. Run old optimizer.");
+    cli.add("corners", "string | [string]", "", "Additional library files for other corners; optimize for the worst one.");
 
     addCli_DelayOpt(cli);
     cli.parseCmdLine(argc, argv);
@@ -41,6 +42,7 @@ int main(int argc, char** argv)
     // Read input:
     Vec<VerilogModule> modules;
     SC_Lib L;
+    Vec<SC_Lib*> corner_libs;
     try{
         cpuClock();
         if (hasExtension(lib_file, "lib")){
@@ -51,6 +53,8 @@ int main(int argc, char** argv)
             WriteLn "Reading SCL file: \a*%t\a*", cpuClock();
         }
 
+        readCornerLibs(cli.get("corners"), corner_libs);
+
         if (design_file != ""){
             String prelude;
             genPrelude(L, prelude, true);
@@ -120,7 +124,18 @@ int main(int argc, char** argv)
     // Run delay optimization:
     if (cli.get("old").bool_val)
         optimizeDelay(N, L, wire_cap, cli.get("prebuf").int_val, cli.get("forget").bool_val);
-    else
+    else if (corner_libs.size() > 0){
+        TimingCorners C;
+        try{
+            addCorner(N, L, C);
+            for (uint i = 0; i < corner_libs.size(); i++)
+                addCorner(N, *corner_libs[i], C);
+        }catch (Excp_Msg err){
+            ShoutLn "ERROR! %_", err;
+            exit(1);
+        }
+        optimizeDelay2(N, C, P);
+    }else
         optimizeDelay2(N, L, wire_cap, P);
 
     NewLine;
@@ -134,5 +149,8 @@ int main(int argc, char** argv)
         WriteLn "Wrote: \a*%_\a*", output_file;
     }
 
+    for (uint i = 0; i < corner_libs.size(); i++)
+        delete corner_libs[i];
+
     return 0;
 }
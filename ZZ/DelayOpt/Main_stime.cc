@@ -4,6 +4,7 @@
 #include "ZZ_Verilog.hh"
 #include "ZZ_Liberty.hh"
 #include "TimingRef.hh"
+#include "TimingMC.hh"
 /**/#include "OrgCells.hh"
 
 using namespace ZZ;
@@ -24,6 +25,7 @@ int main(int argc, char** argv)
     cli.add("wmod"  , "string"               , ""            , "Override default selection of wire-load model.");
     cli.add("slack" , "uint"                 , "0"           , "Use GNU-plot to plot the slack for all gates (1) or just POs (2).");
     cli.add("dump"  , "string"               , ""            , "[DEBUG] Write flattened netlist to file.");
+    cli.add("corners", "string | [string]"   , ""            , "Additional library files for other corners (cells are matched by name).");
     cli.addCommand("all", "Time whole design.");
 
     CLI cli_one;
@@ -41,12 +43,14 @@ int main(int argc, char** argv)
     String wire_load_model = cli.get("wmod").string_val;
     uint   plot_slack = cli.get("slack").enum_val;
     String dump_file = cli.get("dump").string_val;
+
     if (hasExtension(design_file, "lib") || hasExtension(design_file, "scl"))
         swp(design_file, lib_file);
 
     // Read input:
     Vec<VerilogModule> modules;
     SC_Lib L;
+    Vec<SC_Lib*> corner_libs;
     Netlist N;
     bool verilog;
     try{
@@ -59,6 +63,8 @@ int main(int argc, char** argv)
             WriteLn "Reading SCL file: \a*%t\a*", cpuClock();
         }
 
+        readCornerLibs(cli.get("corners"), corner_libs);
+
         if (hasExtension(design_file, "v")){
             String prelude;
             genPrelude(L, prelude, true);
@@ -106,7 +112,21 @@ int main(int argc, char** argv)
     if (dump_file != "")
         N.write(dump_file);
 
-    if (cli.cmd == "all"){
+    if (cli.cmd == "all" && corner_libs.size() > 0){
+        // Compute static timing for all corners:
+        TimingCorners C;
+        try{
+            addCorner(N, L, C, wire_load_model);
+            for (uint i = 0; i < corner_libs.size(); i++)
+                addCorner(N, *corner_libs[i], C, wire_load_model);
+        }catch (Excp_Msg err){
+            ShoutLn "ERROR! %_", err;
+            exit(1);
+        }
+        reportTimingMC(N, C, approx);
+        WriteLn "Static timing (%_ corners): \a*%t\a*", C.size(), cpuClock();
+
+    }else if (cli.cmd == "all"){
         // Compute static timing:
         reportTiming(N, L, approx, plot_slack, wire_load_model);
         WriteLn "Static timing: \a*%t\a*", cpuClock();
@@ -175,5 +195,8 @@ int main(int argc, char** argv)
     WriteLn "Real time: \a*%t\a*", realTime();
     WriteLn "Memory   : \a*%DB\a*", memUsed();
 
+    for (uint i = 0; i < corner_libs.size(); i++)
+        delete corner_libs[i];
+
     return 0;
 }
@@ -0,0 +1,333 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : TimingMC.cc
+//| Author(s)   : Niklas Een
+//| Module      : DelayOpt
+//| Description : Multi-corner static timing.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Table lookups are done corner by corner (each corner has its own tables); everything else
+//| (adding up loads, accumulating arrival times, taking maxima) is done lane-wise over all
+//| 'MC_MAX_CORNERS' lanes. Results for each corner are identical to 'staticTiming()'.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "TimingMC.hh"
+#include <cfloat>
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Corners:
+
+
+static
+void matchPins(const SC_Cell& c0, const SC_Cell& c)
+{
+    if (c0.n_inputs != c.n_inputs || c0.n_outputs != c.n_outputs || c0.pins.size() != c.pins.size())
+        Throw(Excp_Msg) "Cell '%_' has different pins in different corners.", c0.name;
+
+    for (uint i = 0; i < c0.pins.size(); i++)
+        if (!eq(c0.pins[i].name, c.pins[i].name))
+            Throw(Excp_Msg) "Cell '%_' has different pins in different corners ('%_' vs '%_').", c0.name, c0.pins[i].name, c.pins[i].name;
+}
+
+
+void readCornerLibs(const CLI_Val& v, /*out*/Vec<SC_Lib*>& libs)
+{
+    Vec<String> files;
+    if (v){
+        if (v.choice == 0){
+            if (v.string_val != "")
+                files.push(v.string_val);
+        }else{ assert(v.choice == 1);
+            for (uint i = 0; i < v.size(); i++)
+                files.push(v[i].string_val);
+        }
+    }
+
+    for (uint i = 0; i < files.size(); i++){
+        libs.push(new SC_Lib);
+        if (hasExtension(files[i], "lib"))
+            readLiberty(files[i], *libs.last());
+        else
+            readSclFile(files[i], *libs.last());
+        WriteLn "Reading corner library: \a*%t\a*", cpuClock();
+    }
+}
+
+
+void addCorner(NetlistRef N, const SC_Lib& L, /*in-out*/TimingCorners& C, String wire_load_model)
+{
+    if (C.size() == MC_MAX_CORNERS)
+        Throw(Excp_Msg) "Too many corners (at most %_ supported).", MC_MAX_CORNERS;
+
+    // Match cells by name:
+    Vec<uint> map;
+    if (C.size() == 0){
+        for (uint i = 0; i < L.cells.size(); i++)
+            map.push(i);
+
+    }else{
+        const SC_Lib& L0 = *C.lib[0];
+        if (L.unit_time != L0.unit_time || L.unit_cap.fst != L0.unit_cap.fst || L.unit_cap.snd != L0.unit_cap.snd)
+            Throw(Excp_Msg) "Corner libraries must use the same units.";
+
+        map.growTo(L0.cells.size(), UINT_MAX);
+        map[0] = 0;     // -- reserved cells ("NULL_GATE" and "PI_GATE")
+        map[1] = 1;
+        for (uint i = 2; i < L0.cells.size(); i++){
+            const SC_Cell& c0 = L0.cells[i];
+            uind j = L.cells.idx(c0.name);
+            if (j == UIND_MAX || L.cells[j].unsupp != c0.unsupp){
+                if (c0.unsupp) continue;
+                Throw(Excp_Msg) "Cell '%_' missing from corner library.", c0.name; }
+            if (!c0.unsupp)
+                matchPins(c0, L.cells[j]);
+            map[i] = j;
+        }
+
+        // Reverse direction (needed to map a netlist sized in this corner back to 'L0'):
+        for (uint j = 2; j < L.cells.size(); j++){
+            const SC_Cell& c = L.cells[j];
+            if (c.unsupp) continue;
+            uind i = L0.cells.idx(c.name);
+            if (i == UIND_MAX || L0.cells[i].unsupp)
+                Throw(Excp_Msg) "Cell '%_' of corner library missing from reference library.", c.name;
+        }
+    }
+
+    // Select wire load model based on area in this corner:
+    double area = 0;
+    For_Gatetype(N, gate_Uif, w){
+        uint sym = attr_Uif(w).sym;
+        if (sym >= map.size() || map[sym] == UINT_MAX)
+            Throw(Excp_Msg) "Cell of gate %_ missing from corner library.", w;
+        area += L.cells[map[sym]].area;
+    }
+
+    Vec<float> wire_cap;
+    String     model_chosen;
+    if (wire_load_model == ""){
+        Str model;
+        getWireLoadModel(area, L, wire_cap, &model);
+        model_chosen = model;
+    }else{
+        getWireLoadModel(L, wire_load_model.slice(), wire_cap);
+        model_chosen = wire_load_model;
+    }
+
+    // Store corner:
+    C.lib.push(&L);
+    C.wire_cap.push();
+    wire_cap.moveTo(C.wire_cap.last());
+    C.wire_load.push(model_chosen);
+    C.cell_map.push();
+    map.moveTo(C.cell_map.last());
+}
+
+
+void remapCells(NetlistRef N, const TimingCorners& C, uint from, uint to)
+{
+    if (from == to) return;
+
+    // Compose inverse of 'from' map with 'to' map:
+    Vec<uint> map(C.lib[from]->cells.size(), UINT_MAX);
+    const Vec<uint>& m_from = C.cell_map[from];
+    const Vec<uint>& m_to   = C.cell_map[to];
+    for (uint i = 0; i < m_from.size(); i++)
+        if (m_from[i] != UINT_MAX)
+            map[m_from[i]] = m_to[i];
+
+    For_Gatetype(N, gate_Uif, w){
+        uint& sym = attr_Uif(w).sym;
+        assert(map[sym] != UINT_MAX);
+        sym = map[sym];
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Static timing:
+
+
+// Lane-wise version of 'timeGate()'. 't[c]' is the timing arc of corner 'c' (or NULL if missing).
+static
+void timeGateMC(const SC_Timing* const* t, uint n_corners, const MCValues& arr_in, const MCValues& slew_in, const MCValues& load, uint approx, /*in-outs*/MCValues& arr, MCValues& slew)
+{
+    // Table lookups (per corner); missing arcs and unused lanes are left at '-FLT_MAX':
+    MCValues del_pos(-FLT_MAX), del_neg(-FLT_MAX);
+    MCValues out_pos(-FLT_MAX), out_neg(-FLT_MAX);
+    for (uint c = 0; c < n_corners; c++){
+        if (!t[c]) continue;
+        const SC_Timing& tc = *t[c];
+
+        if (tc.tsense == sc_ts_Pos || tc.tsense == sc_ts_Non){
+            del_pos.rise[c] = lookup(tc.cell_rise , slew_in.rise[c], load.rise[c], approx);
+            del_pos.fall[c] = lookup(tc.cell_fall , slew_in.fall[c], load.fall[c], approx);
+            out_pos.rise[c] = lookup(tc.rise_trans, slew_in.rise[c], load.rise[c], approx);
+            out_pos.fall[c] = lookup(tc.fall_trans, slew_in.fall[c], load.fall[c], approx);
+        }
+        if (tc.tsense == sc_ts_Neg || tc.tsense == sc_ts_Non){
+            del_neg.rise[c] = lookup(tc.cell_rise , slew_in.fall[c], load.rise[c], approx);
+            del_neg.fall[c] = lookup(tc.cell_fall , slew_in.rise[c], load.fall[c], approx);
+            out_neg.rise[c] = lookup(tc.rise_trans, slew_in.fall[c], load.rise[c], approx);
+            out_neg.fall[c] = lookup(tc.fall_trans, slew_in.rise[c], load.fall[c], approx);
+        }
+    }
+
+    // Accumulate (all lanes):
+    for (uint c = 0; c < MC_MAX_CORNERS; c++){
+        arr .rise[c] = max_(arr .rise[c], max_(arr_in.rise[c] + del_pos.rise[c], arr_in.fall[c] + del_neg.rise[c]));
+        arr .fall[c] = max_(arr .fall[c], max_(arr_in.fall[c] + del_pos.fall[c], arr_in.rise[c] + del_neg.fall[c]));
+        slew.rise[c] = max_(slew.rise[c], max_(out_pos.rise[c], out_neg.rise[c]));
+        slew.fall[c] = max_(slew.fall[c], max_(out_pos.fall[c], out_neg.fall[c]));
+    }
+}
+
+
+// Output parameter 'load' should be default constructed and unmodifed.
+void computeLoadsMC(NetlistRef N, const TimingCorners& C, /*out*/MCMap& load)
+{
+    For_Gatetype(N, gate_Uif, w){
+        For_Inputs(w, v){
+            MCValues pin_cap;
+            for (uint c = 0; c < C.size(); c++){
+                const SC_Pin& pin = C.cell(c, w).pins[Iter_Var(v)];
+                pin_cap.rise[c] = pin.rise_cap;
+                pin_cap.fall[c] = pin.fall_cap;
+            }
+            load(v) += pin_cap;
+        }
+    }
+
+    Auto_Pob(N, fanout_count);
+    MCValues wire_cap;
+    For_Gates(N, w){
+        for (uint c = 0; c < C.size(); c++){
+            const Vec<float>& wc = C.wire_cap[c];
+            float cap = (wc.size() == 0) ? 0.0f : wc[min_(fanout_count[w], wc.size() - 1)];
+            wire_cap.rise[c] = wire_cap.fall[c] = cap;
+        }
+        load(w) += wire_cap;
+    }
+}
+
+
+// Output parameters 'arr' and 'slew' should be default constructed and unmodifed.
+void staticTimingMC(NetlistRef N, const TimingCorners& C, const MCMap& load, const Vec<GLit>& order, uint approx, /*outputs:*/MCMap& arr, MCMap& slew)
+{
+    assert(C.size() <= MC_MAX_CORNERS);
+    const SC_Timing* t[MC_MAX_CORNERS];
+
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+
+        if (type(w) == gate_Uif){
+            if (C.cell(0, w).n_outputs > 1) continue;
+
+            For_Inputs(w, v){
+                for (uint c = 0; c < C.size(); c++){
+                    const SC_Cell&     cell = C.cell(c, w);
+                    const SC_Timings&  ts   = cell.pins[w.size()].rtiming[Iter_Var(v)];
+                    assert(ts.size() <= 1);
+                    t[c] = (ts.size() == 0) ? NULL : &ts[0];
+                }
+                timeGateMC(t, C.size(), arr[v], slew[v], load[w], approx, arr(w), slew(w));
+            }
+
+        }else if (type(w) == gate_Pin){
+            uint out_pin = attr_Pin(w).number;
+
+            For_Inputs(w[0], v){
+                for (uint c = 0; c < C.size(); c++){
+                    const SC_Cell&     cell = C.cell(c, w[0]);
+                    const SC_Timings&  ts   = cell.pins[w[0].size() + out_pin].rtiming[Iter_Var(v)];
+                    assert(ts.size() <= 1);
+                    t[c] = (ts.size() == 0) ? NULL : &ts[0];
+                }
+                timeGateMC(t, C.size(), arr[v], slew[v], load[w], approx, arr(w), slew(w));
+            }
+
+            MCValues&       arr_cell = arr(w[0]);
+            const MCValues& arr_pin  = arr[w];
+            for (uint c = 0; c < MC_MAX_CORNERS; c++){
+                arr_cell.rise[c] = max_(arr_cell.rise[c], arr_pin.rise[c]);
+                arr_cell.fall[c] = max_(arr_cell.fall[c], arr_pin.fall[c]);
+            }
+        }
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Reporting:
+
+
+static
+void timeAll(NetlistRef N, const TimingCorners& C, uint approx, /*outputs:*/MCMap& load, MCMap& arr, MCMap& slew, Vec<float>& max_arr)
+{
+    computeLoadsMC(N, C, load);
+
+    Vec<GLit> order;
+    topoOrder(N, order);
+    staticTimingMC(N, C, load, order, approx, arr, slew);
+
+    MCValues max_v;
+    For_Gates(N, w){
+        const MCValues& a = arr[w];
+        for (uint c = 0; c < MC_MAX_CORNERS; c++){
+            max_v.rise[c] = max_(max_v.rise[c], a.rise[c]);
+            max_v.fall[c] = max_(max_v.fall[c], a.fall[c]);
+        }
+    }
+
+    max_arr.setSize(C.size());
+    for (uint c = 0; c < C.size(); c++)
+        max_arr[c] = max_(max_v.rise[c], max_v.fall[c]);
+}
+
+
+void maxArrivalMC(NetlistRef N, const TimingCorners& C, uint approx, /*out*/Vec<float>& max_arr)
+{
+    MCMap load, arr, slew;
+    timeAll(N, C, approx, load, arr, slew, max_arr);
+}
+
+
+uint reportTimingMC(NetlistRef N, const TimingCorners& C, uint approx)
+{
+    MCMap load, arr, slew;
+    Vec<float> max_arr;
+    timeAll(N, C, approx, load, arr, slew, max_arr);
+
+    uint worst = 0;
+    for (uint c = 0; c < C.size(); c++){
+        float area = 0;
+        For_Gatetype(N, gate_Uif, w)
+            area += C.cell(c, w).area;
+        WriteLn "Corner %_: max arrival \a*%.0f ps\a*  (area %,d, wire load model %_)", c, C.lib[c]->ps(max_arr[c]), (uint64)area, C.wire_load[c];
+        if (max_arr[c] > max_arr[worst])
+            worst = c;
+    }
+    WriteLn "Worst corner: \a*%_\a*", worst;
+
+    // Extract worst corner and show its critical path (cell names and units agree between corners):
+    TMap load1, arr1, slew1;
+    For_Gates(N, w){
+        load1(w) = load[w][worst];
+        arr1 (w) = arr [w][worst];
+        slew1(w) = slew[w][worst];
+    }
+    dumpCriticalPath(N, *C.lib[0], load1, arr1, slew1);
+
+    return worst;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
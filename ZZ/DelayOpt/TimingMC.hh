@@ -0,0 +1,97 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : TimingMC.hh
+//| Author(s)   : Niklas Een
+//| Module      : DelayOpt
+//| Description : Multi-corner static timing.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Each corner is a separate library with the same cells (matched by name) and the same units.
+//| The netlist refers to cells of the first library; all corners are timed in the same
+//| topological sweep, with per-gate values stored as fixed-size vectors over the corners.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__DelayOpt__TimingMC_hh
+#define ZZ__DelayOpt__TimingMC_hh
+
+#include "ZZ_Netlist.hh"
+#include "ZZ_Liberty.hh"
+#include "ZZ_CmdLine.hh"
+#include "TimingRef.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Supporting types:
+
+
+static const uint MC_MAX_CORNERS = 8;
+
+
+// Rise/fall values for all corners. Unused corners are kept at zero. Operations are written as
+// loops over all 'MC_MAX_CORNERS' lanes so that they can be vectorized.
+struct MCValues {
+    float rise[MC_MAX_CORNERS];
+    float fall[MC_MAX_CORNERS];
+
+    MCValues(float v = 0.0f) { for (uint c = 0; c < MC_MAX_CORNERS; c++) rise[c] = fall[c] = v; }
+
+    TValues operator[](uint c) const { return TValues(rise[c], fall[c]); }
+
+    MCValues& operator+=(const MCValues& other) {
+        for (uint c = 0; c < MC_MAX_CORNERS; c++) rise[c] += other.rise[c];
+        for (uint c = 0; c < MC_MAX_CORNERS; c++) fall[c] += other.fall[c];
+        return *this; }
+};
+
+
+typedef WMap<MCValues> MCMap;
+
+
+struct TimingCorners {
+    Vec<const SC_Lib*> lib;         // -- 'lib[0]' is the library the netlist refers to ('attr_Uif(w).sym')
+    Vec<Vec<float> >   wire_cap;    // -- wire load model of each corner
+    Vec<String>        wire_load;   // -- name of chosen wire load model (for reporting)
+    Vec<Vec<uint> >    cell_map;    // -- 'cell_map[c][sym]' is the index of cell 'lib[0].cells[sym]' in 'lib[c]'
+
+    uint size() const { return lib.size(); }
+    const SC_Cell& cell(uint c, Wire w) const { return lib[c]->cells[cell_map[c][attr_Uif(w).sym]]; }
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Functions:
+
+
+void addCorner(NetlistRef N, const SC_Lib& L, /*in-out*/TimingCorners& C, String wire_load_model = "");
+    // -- Add 'L' as a new corner. The first corner added defines the cell indices used in 'N'.
+    // Cells are matched by name and must have the same pins; units must agree with the first
+    // corner. The wire load model is selected by the area of 'N' (unless 'wire_load_model' is
+    // given). NOTE! May throw 'Excp_Msg'.
+
+void readCornerLibs(const CLI_Val& v, /*out*/Vec<SC_Lib*>& libs);
+    // -- Read the libraries listed by the command line value 'v' (of type "string | [string]", where
+    // the empty string means none). Files with extension '.lib' are read as Liberty, others as SCL.
+    // The libraries are allocated by 'new' and owned by the caller. NOTE! May throw 'Excp_Msg'.
+
+void remapCells(NetlistRef N, const TimingCorners& C, uint from, uint to);
+    // -- Change the cells of 'N' from referring to library 'C.lib[from]' to 'C.lib[to]'.
+
+void computeLoadsMC(NetlistRef N, const TimingCorners& C, /*out*/MCMap& load);
+void staticTimingMC(NetlistRef N, const TimingCorners& C, const MCMap& load, const Vec<GLit>& order, uint approx, /*outputs:*/MCMap& arr, MCMap& slew);
+    // -- Multi-corner versions of 'computeLoads()' and 'staticTiming()'.
+
+void maxArrivalMC(NetlistRef N, const TimingCorners& C, uint approx, /*out*/Vec<float>& max_arr);
+    // -- Compute loads and timing, then return the maximal arrival time of each corner.
+
+uint reportTimingMC(NetlistRef N, const TimingCorners& C, uint approx);
+    // -- Time all corners and show the critical path of the worst one (which is returned).
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
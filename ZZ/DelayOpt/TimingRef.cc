@@ -155,6 +155,12 @@ void getWireLoadModel(const SC_Lib& L, Str model, /*out*/Vec<float>& wire_cap)
 
 
 bool getWireLoadModel(NetlistRef N, const SC_Lib& L, /*out*/Vec<float>& wire_cap, Str* model_chosen)
+{
+    return getWireLoadModel(getTotalArea(N, L), L, wire_cap, model_chosen);
+}
+
+
+bool getWireLoadModel(float area, const SC_Lib& L, /*out*/Vec<float>& wire_cap, Str* model_chosen)
 {
     // Get name of wire load model to use:
     Str wire_load_name;
@@ -164,7 +170,6 @@ bool getWireLoadModel(NetlistRef N, const SC_Lib& L, /*out*/Vec<float>& wire_cap
         if (n == UIND_MAX)
             Throw(Excp_Msg) "No such wire load selection: %_", L.default_wire_load_sel;
 
-        float area = getTotalArea(N, L);
 
         const Vec<Trip<float,float,Str> >& sel = L.wire_load_sel[n].sel;
         for (uint i = 0; i < sel.size(); i++){
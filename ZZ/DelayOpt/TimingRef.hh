@@ -72,8 +72,10 @@ float getTotalArea(NetlistRef N, const SC_Lib& L);
 
 void getWireLoadModel(const SC_Lib& L, Str model, /*out*/Vec<float>& wire_cap);
 bool getWireLoadModel(NetlistRef N, const SC_Lib& L, /*out*/Vec<float>& wire_cap, Str* model_chosen = NULL);
+bool getWireLoadModel(float area, const SC_Lib& L, /*out*/Vec<float>& wire_cap, Str* model_chosen = NULL);
     // -- Returns a vector that maps "#fanouts -> wire capacitance". If no model is present in
     // the liberty file, FALSE is returned and 'model_chosen' set to "(no wire load model)".
+    // The second version selects the model from a given design area rather than from 'N'.
     //
     // NOTE! May throw 'Excp_Msg'.
 
@@ -15,6 +15,7 @@
 #include "Dsd.hh"
 #include "ZZ_BFunc.hh"
 #include "ZZ_Npn4.hh"
+#include "ZZ/Generics/Map.hh"
 
 namespace ZZ {
 using namespace std;
@@ -143,6 +144,72 @@ void dsd6(uint64 ftb, Vec<uchar>& prog, Params_Dsd P)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Memoized decomposition:
+
+
+// Netlists typically contain a few thousand distinct LUT functions, but may contain millions of
+// LUTs. Programs are stored back-to-back in 'data' (length byte first); there is one table per
+// combination of the four flags of 'Params_Dsd'.
+struct DsdMemo {
+    Map<uint64,uint> index[16];
+    Vec<uchar>       data;
+};
+
+static DsdMemo* dsd_memo = NULL;
+static const uint dsd_memo_limit = 64 * 1024 * 1024;    // -- bytes of program data before table is flushed
+ZZ_Local_Lock(dsd_memo_lock);
+
+
+void dsd6Memo(uint64 ftb, Vec<uchar>& prog, Params_Dsd P)
+{
+    uint key = uint(P.use_box3) | (uint(P.only_muxes) << 1) | (uint(P.cofactor) << 2) | (uint(P.use_kary) << 3);
+    {
+        ZZ_Scoped_Lock(dsd_memo_lock);
+        if (dsd_memo){
+            const DsdMemo& M = *dsd_memo;
+            uint offset;
+            if (M.index[key].peek(ftb, offset)){
+                uint n = M.data[offset];
+                prog.setSize(n);
+                for (uint i = 0; i < n; i++)
+                    prog[i] = M.data[offset + 1 + i];
+                return;
+            }
+        }
+    }
+
+    dsd6(ftb, prog, P);     // -- outside the lock; another thread may store the same program meanwhile
+    assert(prog.size() < 256);
+
+    ZZ_Scoped_Lock(dsd_memo_lock);
+    if (!dsd_memo)
+        dsd_memo = new DsdMemo;
+    DsdMemo& M = *dsd_memo;
+
+    uint* offset;
+    if (M.index[key].get(ftb, offset))
+        return;
+    *offset = M.data.size();
+    M.data.push(prog.size());
+    for (uint i = 0; i < prog.size(); i++)
+        M.data.push(prog[i]);
+
+    if (M.data.size() > dsd_memo_limit){
+        delete dsd_memo;
+        dsd_memo = NULL;
+    }
+}
+
+
+void clearDsdMemo()
+{
+    ZZ_Scoped_Lock(dsd_memo_lock);
+    delete dsd_memo;
+    dsd_memo = NULL;
+}
+
+
 uchar DsdState::run()
 {
     // Remove inputs not in (semantic) support:
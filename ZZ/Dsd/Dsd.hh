@@ -45,6 +45,11 @@ struct Params_Dsd {
 
 void dsd6(uint64 ftb, Vec<uchar>& prog, Params_Dsd P = Params_Dsd());
 
+void dsd6Memo(uint64 ftb, Vec<uchar>& prog, Params_Dsd P = Params_Dsd());
+void clearDsdMemo();
+    // -- Same as 'dsd6()' but results are memoized in a global table (keyed on 'ftb' and 'P'),
+    // which is cleared automatically when it grows too big. Not thread-safe.
+
 
 /*
 A DSD program is a 'Vec<uchar>' where the vector is a sequence of variable-length instructions.
@@ -1194,3 +1194,110 @@ void Solver::garbageCollect()
                ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
+
+
+//=================================================================================================
+// Cloning:
+
+// Copy the solver state into the freshly constructed 'to'. Must be called at decision level 0.
+// Clauses are copied into a compact region and re-attached; learnt clauses with an LBD above
+// 'max_learnt_lbd' are dropped (binary learnt clauses are always kept).
+void Solver::cloneTo(Solver& to, unsigned max_learnt_lbd) const
+{
+    assert(decisionLevel() == 0);
+    assert(to.nVars() == 0 && to.clauses.size() == 0 && to.learnts.size() == 0);
+
+    // Parameters:
+    to.verbosity              = verbosity;
+    to.verbEveryConflicts     = verbEveryConflicts;
+    to.K                      = K;
+    to.R                      = R;
+    to.sizeLBDQueue           = sizeLBDQueue;
+    to.sizeTrailQueue         = sizeTrailQueue;
+    to.firstReduceDB          = firstReduceDB;
+    to.incReduceDB            = incReduceDB;
+    to.specialIncReduceDB     = specialIncReduceDB;
+    to.lbLBDFrozenClause      = lbLBDFrozenClause;
+    to.lbSizeMinimizingClause = lbSizeMinimizingClause;
+    to.lbLBDMinimizingClause  = lbLBDMinimizingClause;
+    to.var_decay              = var_decay;
+    to.clause_decay           = clause_decay;
+    to.random_var_freq        = random_var_freq;
+    to.random_seed            = random_seed;
+    to.ccmin_mode             = ccmin_mode;
+    to.phase_saving           = phase_saving;
+    to.rnd_pol                = rnd_pol;
+    to.rnd_init_act           = false;      // -- activities are copied below
+    to.garbage_frac           = garbage_frac;
+
+    // Variables:
+    for (Var v = 0; v < nVars(); v++)
+        to.newVar(polarity[v], decision[v]);
+    to.rnd_init_act = rnd_init_act;
+
+    activity.copyTo(to.activity);
+    assigns .copyTo(to.assigns);
+    permDiff.copyTo(to.permDiff);
+    to.MYFLAG = MYFLAG;
+    for (Var v = 0; v < nVars(); v++)
+        to.vardata[v] = mkVarData(CRef_Undef, vardata[v].level);    // -- top-level reasons are never inspected
+
+    trail.copyTo(to.trail);
+    to.trail.capacity(nVars() + 1);
+    to.qhead = qhead;
+
+    // Clauses:
+    to.ca.extra_clause_field = ca.extra_clause_field;
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark() == 1) continue;
+        CRef cr = to.ca.alloc(c, false);
+        to.clauses.push(cr);
+        to.attachClause(cr);
+    }
+    for (int i = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        if (c.mark() == 1 || (c.size() > 2 && c.lbd() > max_learnt_lbd)) continue;
+        CRef cr = to.ca.alloc(c, true);
+        Clause& d = to.ca[cr];
+        d.activity() = ((Clause&)c).activity();
+        d.setLBD(c.lbd());
+        d.setCanBeDel(((Clause&)c).canBeDel());
+        to.learnts.push(cr);
+        to.attachClause(cr);
+    }
+
+    // Search state and statistics:
+    to.ok                = ok;
+    to.cla_inc           = cla_inc;
+    to.var_inc           = var_inc;
+    to.simpDB_assigns    = simpDB_assigns;
+    to.simpDB_props      = simpDB_props;
+    to.progress_estimate = progress_estimate;
+    to.remove_satisfied  = remove_satisfied;
+    to.curRestart        = curRestart;
+    to.lastIndexRed      = lastIndexRed;
+    to.max_learnts             = max_learnts;
+    to.learntsize_adjust_confl = learntsize_adjust_confl;
+    to.learntsize_adjust_cnt   = learntsize_adjust_cnt;
+
+    to.nbRemovedClauses = nbRemovedClauses;
+    to.nbReducedClauses = nbReducedClauses;
+    to.nbDL2            = nbDL2;
+    to.nbBin            = nbBin;
+    to.nbUn             = nbUn;
+    to.nbReduceDB       = nbReduceDB;
+    to.solves           = solves;
+    to.starts           = starts;
+    to.decisions        = decisions;
+    to.rnd_decisions    = rnd_decisions;
+    to.propagations     = propagations;
+    to.conflicts        = conflicts;
+    to.max_literals     = max_literals;
+    to.tot_literals     = tot_literals;
+
+    to.conflict_budget    = conflict_budget;
+    to.propagation_budget = propagation_budget;
+
+    to.rebuildOrderHeap();
+}
@@ -116,6 +116,10 @@ public:
     void    checkGarbage(double gf);
     void    checkGarbage();
 
+    // Cloning:
+    //
+    void    cloneTo(Solver& to, unsigned max_learnt_lbd = UINT32_MAX) const; // 'to' must be freshly constructed. Drops learnt clauses with LBD above limit.
+
     // Extra results: (read-only member variable)
     //
     vec<lbool> model;             // If problem is satisfiable, this vector contains the model (if any).
@@ -0,0 +1,440 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : CecSweep.cc
+//| Author(s)   : Niklas Een
+//| Module      : EqCheck
+//| Description : Combinational equivalence checking by SAT-sweeping.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Each class keeps a list of "active representatives": already swept members that are not known
+//| to be equivalent to each other. A new member is checked against these in order, but only if
+//| the counterexamples buffered since the last refinement do not already tell them apart. When 64
+//| counterexamples have been collected, they are simulated over the whole AIG and all classes are
+//| split accordingly.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "CecSweep.hh"
+#include "ZZ_MetaSat.hh"
+#include "ZZ/Generics/Map.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helpers:
+
+
+static
+uint64 sigMix(uint64 sig, uint64 v)
+{
+    sig ^= v + 0x9E3779B97F4A7C15ull + (sig << 6) + (sig >> 2);
+    return sig * 0xFF51AFD7ED558CCDull;
+}
+
+
+macro uint64 phaseMask(bool phase) { return phase ? ~(uint64)0 : 0; }
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'CecSweep':
+
+
+class CecSweep {
+    NetlistRef              M;
+    const Params_CecSweep&  P;
+    Info_CecSweep&          info;
+    uint64                  seed;
+
+    Vec<gate_id>    order;      // -- position 0 is constant TRUE
+    WMap<uint>      pos;        // -- gate -> position in 'order'
+    uint            W;
+    Vec<uint64>     sim;        // -- 'sim[p*W + j]' is word 'j' of node at position 'p'
+    Vec<char>       phase;      // -- first simulation bit; used to normalize classes
+    Vec<uint>       cls;        // -- class of node ('UINT_MAX' if none)
+    Vec<Vec<uint> > reps;       // -- active representatives of each class (positions)
+
+    MiniSat2        S;
+    Vec<Lit>        lit;        // -- SAT literal of node (shared by merged nodes)
+    Map<uint64,Lit> strash;     // -- structural hashing on SAT literals
+
+    // Counterexample buffer:
+    Vec<uint64>     cex_pi;     // -- buffered patterns for PI positions
+    uint            n_cex;      // -- number of valid bits in buffer
+    Vec<uint64>     cval;       // -- buffered patterns simulated (lazily) for each position
+    Vec<uint>       cstamp;
+    uint            stamp;
+    Vec<uint>       stack;
+
+    Wire   node(uint p) const { return M[order[p]]; }
+    uint64 cexVal(uint p);
+    void   addCex();
+    void   flushCex();
+
+    void   simulate();
+    void   initClasses();
+    Lit    mkAnd(Lit a, Lit b);
+    void   sweepNode(uint p);
+
+public:
+    CecSweep(NetlistRef M_, const Params_CecSweep& P_, Info_CecSweep& info_) :
+        M(M_), P(P_), info(info_), seed(P_.seed), pos(UINT_MAX), W(max_(P_.sim_words, 1u)), n_cex(0), stamp(1) {}
+
+    lbool run(const Vec<Wire>& miters, Vec<lbool>& result, Vec<Vec<lbool> >* cex);
+};
+
+
+//=================================================================================================
+// -- Simulation:
+
+
+void CecSweep::simulate()
+{
+    sim.setSize(order.size() * W);
+    for (uint j = 0; j < W; j++)
+        sim[j] = ~(uint64)0;
+
+    for (uint p = 1; p < order.size(); p++){
+        Wire w = node(p);
+        uint64* out = &sim[p * W];
+        if (type(w) == gate_PI){
+            for (uint j = 0; j < W; j++)
+                out[j] = irandl(seed);
+        }else{ assert(type(w) == gate_And);
+            const uint64* in0 = &sim[pos[w[0]] * W]; uint64 m0 = phaseMask(sign(w[0]));
+            const uint64* in1 = &sim[pos[w[1]] * W]; uint64 m1 = phaseMask(sign(w[1]));
+            for (uint j = 0; j < W; j++)
+                out[j] = (in0[j] ^ m0) & (in1[j] ^ m1);
+        }
+    }
+}
+
+
+void CecSweep::initClasses()
+{
+    phase.setSize(order.size());
+    cls  .setSize(order.size(), UINT_MAX);
+
+    Map<uint64,uint> sig2cls;
+    Vec<uint>        count;
+    for (uint p = 0; p < order.size(); p++){
+        const uint64* v = &sim[p * W];
+        phase[p] = v[0] & 1;
+        uint64 sig = 0;
+        for (uint j = 0; j < W; j++)
+            sig = sigMix(sig, v[j] ^ phaseMask(phase[p]));
+
+        uint* idx;
+        if (!sig2cls.get(sig, idx)){
+            *idx = count.size();
+            count.push(0); }
+        cls[p] = *idx;
+        count[*idx]++;
+    }
+
+    // Singletons are not candidates:
+    for (uint p = 0; p < order.size(); p++)
+        if (count[cls[p]] == 1)
+            cls[p] = UINT_MAX;
+    reps.setSize(count.size());
+}
+
+
+// Evaluate buffered counterexamples for node at position 'p0' (lazily, iteratively).
+uint64 CecSweep::cexVal(uint p0)
+{
+    if (cstamp[p0] == stamp) return cval[p0];
+
+    stack.push(p0);
+    while (stack.size() > 0){
+        uint p = stack.last();
+        if (cstamp[p] == stamp){ stack.pop(); continue; }
+
+        Wire w = node(p);
+        if (p == 0 || type(w) == gate_PI){
+            cval[p] = (p == 0) ? ~(uint64)0 : cex_pi[p];
+            cstamp[p] = stamp;
+            stack.pop();
+        }else{
+            uint q0 = pos[w[0]];
+            uint q1 = pos[w[1]];
+            if (cstamp[q0] != stamp) stack.push(q0);
+            if (cstamp[q1] != stamp) stack.push(q1);
+            if (stack.last() == p){
+                cval[p] = (cval[q0] ^ phaseMask(sign(w[0]))) & (cval[q1] ^ phaseMask(sign(w[1])));
+                cstamp[p] = stamp;
+                stack.pop();
+            }
+        }
+    }
+    return cval[p0];
+}
+
+
+// Store the current SAT model as a pattern in the counterexample buffer.
+void CecSweep::addCex()
+{
+    info.cexs++;
+    for (uint p = 1; p < order.size(); p++){
+        if (type(node(p)) != gate_PI) continue;
+        lbool v = (lit[p] == Lit_NULL) ? l_Undef : S.value(lit[p]);
+        bool  b = (v == l_Undef) ? (irandl(seed) & 1) : (v == l_True);
+        if (b) cex_pi[p] |= (uint64)1 << n_cex;
+    }
+    n_cex++;
+    stamp++;
+
+    if (n_cex == 64)
+        flushCex();
+}
+
+
+// Simulate the buffered patterns over all nodes and split classes accordingly.
+void CecSweep::flushCex()
+{
+    if (n_cex == 0) return;
+
+    uint64 mask = (n_cex == 64) ? ~(uint64)0 : ((uint64)1 << n_cex) - 1;
+    Map<uint64,uint> key2cls;
+    uint n_cls = 0;
+    Vec<uint> new_cls(order.size(), UINT_MAX);
+    for (uint p = 0; p < order.size(); p++){
+        if (cls[p] == UINT_MAX) continue;
+        uint64 key = sigMix(cls[p], (cexVal(p) ^ phaseMask(phase[p])) & mask);
+        uint* idx;
+        if (!key2cls.get(key, idx))
+            *idx = n_cls++;
+        new_cls[p] = *idx;
+    }
+
+    Vec<Vec<uint> > new_reps(n_cls);
+    for (uint c = 0; c < reps.size(); c++)
+        for (uint i = 0; i < reps[c].size(); i++)
+            new_reps[new_cls[reps[c][i]]].push(reps[c][i]);
+
+    new_cls.moveTo(cls);
+    new_reps.moveTo(reps);
+
+    for (uint p = 0; p < order.size(); p++)
+        cex_pi[p] = 0;
+    n_cex = 0;
+    stamp++;
+}
+
+
+//=================================================================================================
+// -- Sweeping:
+
+
+Lit CecSweep::mkAnd(Lit a, Lit b)
+{
+    Lit t = S.True();
+    if (a == ~t || b == ~t || a == ~b) return ~t;
+    if (a == t) return b;
+    if (b == t || a == b) return a;
+
+    if (b < a) swp(a, b);
+    uint64 key = ((uint64)a.data() << 32) | b.data();
+    Lit* ret;
+    if (!strash.get(key, ret)){
+        Lit x = S.addLit();
+        S.addClause(~x, a);
+        S.addClause(~x, b);
+        S.addClause(x, ~a, ~b);
+        *ret = x;
+    }
+    return *ret;
+}
+
+
+void CecSweep::sweepNode(uint p)
+{
+    Wire w = node(p);
+    if (p == 0)
+        lit[p] = S.True();
+    else if (type(w) == gate_PI)
+        lit[p] = S.addLit();
+    else
+        lit[p] = mkAnd(lit[pos[w[0]]] ^ sign(w[0]), lit[pos[w[1]]] ^ sign(w[1]));
+
+    uint c = cls[p];
+    if (c == UINT_MAX) return;
+
+    uint64 mask = (n_cex == 64) ? ~(uint64)0 : ((uint64)1 << n_cex) - 1;
+    for (uint i = 0; i < reps[c].size(); i++){
+        uint q = reps[c][i];
+        Lit  target = lit[q] ^ (phase[p] != phase[q]);
+        if (lit[p] == target){
+            info.merged++;
+            return; }
+
+        if (n_cex > 0 && ((cexVal(p) ^ phaseMask(phase[p])) & mask) != ((cexVal(q) ^ phaseMask(phase[q])) & mask))
+            continue;
+
+        // Check 'lit[p] == target' in both directions:
+        bool undecided = false;
+        for (uint dir = 0; dir < 2; dir++){
+            info.sat_calls++;
+            S.setConflictLim(P.pair_confl);
+            lbool res = (dir == 0) ? S.solve(lit[p], ~target) : S.solve(~lit[p], target);
+            if (res == l_True){
+                addCex();
+                if (cls[p] != c){
+                    // -- class was split by the flush; continue with the new class
+                    c = cls[p];
+                    if (c == UINT_MAX) goto NoMerge;
+                    i = UINT_MAX;   // -- (restart scan)
+                }
+                goto Next;
+            }else if (res == l_Undef){
+                info.sat_undef++;
+                undecided = true;
+                break;
+            }
+        }
+        if (!undecided){
+            S.addClause(~lit[p], target);
+            S.addClause(lit[p], ~target);
+            lit[p] = target;
+            info.merged++;
+            return;
+        }
+      Next:;
+    }
+    reps[c].push(p);
+  NoMerge:;
+}
+
+
+lbool CecSweep::run(const Vec<Wire>& miters, Vec<lbool>& result, Vec<Vec<lbool> >* cex)
+{
+    double T0 = cpuTime();
+
+    // Order and simulate:
+    Vec<gate_id> tmp;
+    upOrder(miters, tmp);
+    order.push(gid_True);
+    for (uint i = 0; i < tmp.size(); i++){
+        Wire w = M[tmp[i]];
+        if (type(w) == gate_Const) continue;
+        if (type(w) != gate_PI && type(w) != gate_And)
+            Throw(Excp_Msg) "Unexpected gate type in miter: %_", GateType_name[type(w)];
+        order.push(tmp[i]);
+    }
+    for (uint p = 0; p < order.size(); p++)
+        pos(node(p)) = p;
+
+    simulate();
+    initClasses();
+
+    if (!P.quiet){
+        uint n_cands = 0;
+        for (uint p = 0; p < order.size(); p++)
+            if (cls[p] != UINT_MAX) n_cands++;
+        WriteLn "Nodes: %_   Candidates: %_   Simulation: %t", order.size(), n_cands, cpuTime() - T0;
+    }
+
+    // Sweep:
+    lit   .setSize(order.size(), Lit_NULL);
+    cex_pi.setSize(order.size(), 0);
+    cval  .setSize(order.size(), 0);
+    cstamp.setSize(order.size(), 0);
+
+    int percent = -1;
+    for (uint p = 0; p < order.size(); p++){
+        sweepNode(p);
+        if (!P.quiet){
+            int pc = (int)((uint64)p * 100 / order.size());
+            if (pc != percent){
+                percent = pc;
+                Write "\rSweeping: %_ %%   (merged %_, SAT calls %_, undecided %_)\f", pc, info.merged, info.sat_calls, info.sat_undef;
+            }
+        }
+    }
+    if (!P.quiet) WriteLn "\rSweeping: done    (merged %_, SAT calls %_, undecided %_, cexs %_)  [%t]", info.merged, info.sat_calls, info.sat_undef, info.cexs, cpuTime() - T0;
+
+    // Check outputs:
+    result.setSize(miters.size(), l_Undef);
+    if (cex){ cex->clear(); cex->setSize(miters.size()); }
+
+    uint n_pis = 0;
+    For_Gatetype(M, gate_PI, w)
+        newMax(n_pis, (uint)attr_PI(w).number + 1);
+
+    for (uint i = 0; i < miters.size(); i++){
+        Wire w = miters[i];
+        uint p = (type(w) == gate_Const) ? 0 : pos[w];
+        Lit  m = lit[p] ^ sign(w);
+
+        // Differs under simulation?
+        const uint64* v = &sim[p * W];
+        uint j = 0;
+        for (; j < W; j++)
+            if ((v[j] ^ phaseMask(sign(w))) != 0) break;
+
+        if (j < W){
+            result[i] = l_False;
+            if (cex){
+                uint b = 0;
+                while ((((v[j] ^ phaseMask(sign(w))) >> b) & 1) == 0) b++;
+                (*cex)[i].setSize(n_pis, l_Undef);
+                for (uint q = 1; q < order.size(); q++){
+                    Wire u = node(q);
+                    if (type(u) == gate_PI && attr_PI(u).number != num_NULL)
+                        (*cex)[i][attr_PI(u).number] = lbool_lift((sim[q * W + j] >> b) & 1);
+                }
+            }
+            continue;
+        }
+
+        if (m == ~S.True()){
+            result[i] = l_True;
+            continue; }
+
+        info.sat_calls++;
+        S.setConflictLim(P.output_confl);
+        lbool res = S.solve(m);
+        if (res == l_False){
+            result[i] = l_True;
+            S.addClause(~m);
+        }else if (res == l_True){
+            result[i] = l_False;
+            if (cex){
+                (*cex)[i].setSize(n_pis, l_Undef);
+                for (uint q = 1; q < order.size(); q++){
+                    Wire u = node(q);
+                    if (type(u) == gate_PI && attr_PI(u).number != num_NULL){
+                        lbool val = S.value(lit[q]);
+                        (*cex)[i][attr_PI(u).number] = (val == l_Undef) ? l_False : val;
+                    }
+                }
+            }
+        }
+    }
+
+    bool any_undef = false;
+    for (uint i = 0; i < result.size(); i++){
+        if (result[i] == l_False) return l_False;
+        if (result[i] == l_Undef) any_undef = true;
+    }
+    return any_undef ? l_Undef : l_True;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Wrapper function:
+
+
+lbool cecSweep(NetlistRef M, const Vec<Wire>& miters, const Params_CecSweep& P, Vec<lbool>& result, Vec<Vec<lbool> >* cex, Info_CecSweep* info)
+{
+    Info_CecSweep dummy;
+    CecSweep cs(M, P, info ? *info : dummy);
+    return cs.run(miters, result, cex);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,67 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : CecSweep.hh
+//| Author(s)   : Niklas Een
+//| Module      : EqCheck
+//| Description : Combinational equivalence checking by SAT-sweeping.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Candidate equivalences are formed by word-parallel random simulation. The AIG is then swept in
+//| topological order on a single incremental SAT solver; a node proved equivalent to an earlier
+//| node of its class (within the conflict budget) shares its SAT literal from then on.
+//| Counterexamples are buffered as simulation patterns and used to refine the classes.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__EqCheck__CecSweep_hh
+#define ZZ__EqCheck__CecSweep_hh
+
+#include "ZZ_Netlist.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+struct Params_CecSweep {
+    uint    sim_words;          // -- 64-bit words of random simulation per node
+    uint64  pair_confl;         // -- conflict limit for each internal equivalence check
+    uint64  output_confl;       // -- conflict limit for each output (miter) check
+    uint64  seed;
+    bool    quiet;
+
+    Params_CecSweep() :
+        sim_words   (8),
+        pair_confl  (1000),
+        output_confl(UINT64_MAX),
+        seed        (0),
+        quiet       (false)
+    {}
+};
+
+
+struct Info_CecSweep {
+    uint    merged;             // -- internal nodes merged (including constants)
+    uint    sat_calls;
+    uint    sat_undef;          // -- checks that ran out of budget
+    uint    cexs;               // -- counterexamples used for refinement
+
+    Info_CecSweep() : merged(0), sat_calls(0), sat_undef(0), cexs(0) {}
+};
+
+
+lbool cecSweep(NetlistRef M, const Vec<Wire>& miters, const Params_CecSweep& P,
+               /*out*/Vec<lbool>& result, /*out*/Vec<Vec<lbool> >* cex = NULL, /*out*/Info_CecSweep* info = NULL);
+    // -- 'M' is a combinational AIG (PIs and ANDs only) and 'miters[i]' is TRUE when output pair 'i'
+    // differs. On return, 'result[i]' is 'l_True' if the pair was proved equivalent, 'l_False' if it
+    // differs (with the input assignment, indexed by PI number, in 'cex[i]') and 'l_Undef' if
+    // undecided. The return value is 'l_False' if any pair differs, else 'l_Undef' if any pair is
+    // undecided, else 'l_True'.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
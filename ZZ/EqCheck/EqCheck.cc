@@ -3,7 +3,7 @@
 //| Name        : EqCheck.cc
 //| Author(s)   : Niklas Een
 //| Module      : EqCheck
-//| Description : Combinational equivalence checking of two design through ABC.
+//| Description : Combinational equivalence checking of two designs (SAT-sweeping or ABC).
 //| 
 //| (C) Copyright 2010-2014, The Regents of the University of California
 //|________________________________________________________________________________________________
@@ -13,6 +13,7 @@
 
 #include "Prelude.hh"
 #include "EqCheck.hh"
+#include "CecSweep.hh"
 
 namespace ZZ {
 using namespace std;
@@ -214,7 +215,7 @@ void buildAig(NetlistRef N, NetlistRef M, WWMap& n2m, const SC_Lib& L)
 // Main function:
 
 
-void eqCheck(NetlistRef N1, NetlistRef N2, const SC_Lib& L, String aiger_file)
+lbool eqCheck(NetlistRef N1, NetlistRef N2, const SC_Lib& L, String aiger_file, const Params_EqCheck& P)
 {
     Vec<Pair<GLit,GLit> > pi_pairs;
     matchInputs(N1, N2, pi_pairs);
@@ -234,18 +235,26 @@ void eqCheck(NetlistRef N1, NetlistRef N2, const SC_Lib& L, String aiger_file)
     buildAig(N2, M, xlat2, L);
 
     // Miter outputs:
+    Vec<Wire> miters;
     Wire conj = M.True();
     for (uint i = 0; i < po_pairs.size(); i++){
         Wire w1 = po_pairs[i].fst + N1; assert(type(w1) == gate_PO);
         Wire w2 = po_pairs[i].snd + N2; assert(type(w2) == gate_PO);
         Wire u  = xlat1[w1[0]] + M;
         Wire v  = xlat2[w2[0]] + M;
-        conj = mk_And(conj, mk_Equiv(u, v));
+        miters.push(~mk_Equiv(u, v));
+        conj = mk_And(conj, ~miters.last());
     }
-    M.add(PO_(0), ~conj);   // -- we need to prove that this PO is always zero.
 
-    if (aiger_file == ""){
+    if (aiger_file != ""){
+        M.add(PO_(0), ~conj);   // -- we need to prove that this PO is always zero.
+        writeAigerFile(aiger_file, M);
+        WriteLn "Wrote: \a*%_\a*", aiger_file;
+        return l_Undef;
+
+    }else if (P.use_abc){
         // Write AIGER file and run ABC:
+        M.add(PO_(0), ~conj);
         String filename;
         FWrite(filename) "__abc_cec_tmp.%_.aig", getpid();
 
@@ -257,11 +266,37 @@ void eqCheck(NetlistRef N1, NetlistRef N2, const SC_Lib& L, String aiger_file)
         int ignore ___unused = system(cmd.c_str());
 
         unlink(filename.c_str());
+        return l_Undef;
+    }
 
-    }else{
-        writeAigerFile(aiger_file, M);
-        WriteLn "Wrote: \a*%_\a*", aiger_file;
+    // Built-in SAT-sweeping:
+    Vec<lbool>        result;
+    Vec<Vec<lbool> >  cex;
+    lbool ret = cecSweep(M, miters, P.sweep, result, &cex);
+
+    uint n_eq = 0, n_diff = 0, n_undef = 0;
+    for (uint i = 0; i < result.size(); i++){
+        if (result[i] == l_True) n_eq++;
+        else if (result[i] == l_False){
+            n_diff++;
+            if (n_diff <= P.max_report){
+                Wire w1 = po_pairs[i].fst + N1;
+                String name = (N1.names().size(w1) > 0) ? String(N1.names().get(w1)) : (FMT "%_", w1);
+                WriteLn "Output \a*%_\a* differs. Input assignment:", name;
+                Write "  ";
+                for (uint j = 0; j < cex[i].size(); j++)
+                    Write "%_", (cex[i][j] == l_True) ? '1' : (cex[i][j] == l_False) ? '0' : '-';
+                NewLine;
+            }
+        }else
+            n_undef++;
     }
+    if (n_diff > P.max_report)
+        WriteLn "(%_ more differing outputs not shown)", n_diff - P.max_report;
+
+    WriteLn "Outputs: %_ equivalent, %_ different, %_ undecided", n_eq, n_diff, n_undef;
+    WriteLn "Result: \a*%_\a*", (ret == l_True) ? "EQUIVALENT" : (ret == l_False) ? "NOT EQUIVALENT" : "UNDECIDED";
+    return ret;
 }
 
 
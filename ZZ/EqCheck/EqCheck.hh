@@ -3,7 +3,7 @@
 //| Name        : EqCheck.hh
 //| Author(s)   : Niklas Een
 //| Module      : EqCheck
-//| Description : Combinational equivalence checking of two design through ABC.
+//| Description : Combinational equivalence checking of two designs (SAT-sweeping or ABC).
 //| 
 //| (C) Copyright 2010-2014, The Regents of the University of California
 //|________________________________________________________________________________________________
@@ -16,6 +16,7 @@
 
 #include "ZZ_Netlist.hh"
 #include "ZZ_Liberty.hh"
+#include "CecSweep.hh"
 
 namespace ZZ {
 using namespace std;
@@ -24,7 +25,18 @@ using namespace std;
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
-void eqCheck(NetlistRef N1, NetlistRef N2, const SC_Lib& L, String aiger_file = "");
+struct Params_EqCheck {
+    bool            use_abc;        // -- call external ABC binary instead of built-in SAT-sweeping
+    uint            max_report;     // -- show input assignments for at most this many differing outputs
+    Params_CecSweep sweep;
+
+    Params_EqCheck() : use_abc(false), max_report(10) {}
+};
+
+
+lbool eqCheck(NetlistRef N1, NetlistRef N2, const SC_Lib& L, String aiger_file = "", const Params_EqCheck& P = Params_EqCheck());
+    // -- If 'aiger_file' is given, the miter is written to that file without being checked. Returns
+    // 'l_Undef' if the result is not known in-process (AIGER output or ABC).
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -64,6 +64,10 @@ int main(int argc, char** argv)
     cli.add("design2", "string", arg_REQUIRED, "Second input: Verilog, AIGER or GIG file.", 1);
     cli.add("lib"    , "string", "", "Input Liberty library file (if design contains UIFs/standard cells).", 2);
     cli.add("aig"    , "string", "", "Write single-output AIGER file containing mitered circuits.");
+    cli.add("abc"    , "bool"  , "no", "Use external ABC binary instead of built-in SAT-sweeping.");
+    cli.add("confl"  , "uint"  , "1000", "Conflict limit for each internal equivalence check.");
+    cli.add("out-confl", "uint | {inf}", "inf", "Conflict limit for each output check.");
+    cli.add("sim"    , "uint"  , "8", "Number of 64-bit words of random simulation.");
     cli.parseCmdLine(argc, argv);
 
     String design1 = cli.get("design1").string_val;
@@ -124,7 +128,17 @@ int main(int argc, char** argv)
     WriteLn "Design 1: %_", info(N1);
     WriteLn "Design 2: %_", info(N2);
 
-    eqCheck(N1, N2, L, aig_file);
+    Params_EqCheck P;
+    P.use_abc            = cli.get("abc").bool_val;
+    P.sweep.pair_confl   = cli.get("confl").int_val;
+    P.sweep.output_confl = (cli.get("out-confl").choice == 0) ? cli.get("out-confl").int_val : UINT64_MAX;
+    P.sweep.sim_words    = cli.get("sim").int_val;
 
-    return 0;
+    lbool result = eqCheck(N1, N2, L, aig_file, P);
+
+    // Exit code: 0 = equivalent, 1 = not equivalent, 2 = undecided. If the miter was only written
+    // (or handed to ABC), nothing was checked in-process and 0 is returned (as before).
+    if (aig_file != "" || P.use_abc)
+        return 0;
+    return (result == l_True) ? 0 : (result == l_False) ? 1 : 2;
 }
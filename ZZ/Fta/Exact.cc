@@ -0,0 +1,188 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Exact.cc
+//| Author(s)   : Niklas Een
+//| Module      : Fta
+//| Description : Exact top-event probability through BDDs.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| The BDD of the top-event is built bottom-up over the AIG version of the tree, releasing each
+//| intermediate BDD at its last fanout. Because the paths of a BDD are disjoint, the probability
+//| follows from a single (memoized) Shannon expansion; no MCSs or cutoffs are involved.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "Exact.hh"
+#include "Common.hh"
+#include "ZZ/Generics/Map.hh"
+
+#ifdef ZZ_USE_EXTERNAL_LIBABC
+#  include "base/abc/abc.h"
+#  include "base/main/mainInt.h"
+#  include "base/main/main.h"
+#else
+#  include "ZZ/Abc/abc.h"
+#  include "ZZ/Abc/mainInt.h"
+#  include "ZZ/Abc/main.h"
+#endif
+
+namespace ZZ {
+using namespace std;
+
+ABC_NAMESPACE_USING_NAMESPACE
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helpers:
+
+
+// Rank basic events by their first visit in a depth-first, left-to-right traversal from the
+// top-event. Events of the same sub-tree end up adjacent in the order, which keeps the BDD of
+// tree-like structures small. Events not reachable from the top go last.
+static
+void dfsOrder(Gig& N, /*out*/Vec<uint>& rank)
+{
+    uint n_vars = N.enumSize(gate_PI);
+    rank.reset(n_vars, UINT_MAX);
+    uint n_ranked = 0;
+
+    WZet seen;
+    Vec<Wire> Q;
+    Q.push(+N(gate_PO, 0)[0]);
+    while (Q.size() > 0){
+        Wire w = Q.popC();
+        if (seen.has(w)) continue;
+        seen.add(w);
+
+        if (w == gate_PI)
+            rank[w.num()] = n_ranked++;
+        else{
+            for (uint i = w.size(); i > 0;){ i--;
+                if (w[i] && !seen.has(+w[i]))
+                    Q.push(+w[i]);
+            }
+        }
+    }
+
+    for (uint i = 0; i < n_vars; i++)
+        if (rank[i] == UINT_MAX)
+            rank[i] = n_ranked++;
+}
+
+
+// Returns the pair '(P(f), P(~f))'. Both polarities are propagated, rather than taking '1 - P(f)'
+// for complemented edges, to avoid cancellation when probabilities are close to 1.
+static
+Pair<double,double> bddProb(DdNode* f, const Vec<double>& probs, Map<uint64, Pair<double,double> >& memo)
+{
+    DdNode* r = Cudd_Regular(f);
+    Pair<double,double> ret;
+    if (Cudd_IsConstant(r))
+        ret = make_tuple(1.0, 0.0);
+    else if (!memo.peek(uint64(uintp(r)), ret)){
+        Pair<double,double> t = bddProb(Cudd_T(r), probs, memo);
+        Pair<double,double> e = bddProb(Cudd_E(r), probs, memo);
+        double q = probs[Cudd_NodeReadIndex(r)];
+        ret = make_tuple(q * t.fst + (1 - q) * e.fst, q * t.snd + (1 - q) * e.snd);
+        memo.set(uint64(uintp(r)), ret);
+    }
+
+    if (Cudd_IsComplement(f))
+        swp(ret.fst, ret.snd);
+    return ret;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main:
+
+
+double ftaExact(Gig& N, const Vec<double>& ev_probs, const Params_FtaExact& P)
+{
+    assert(N.enumSize(gate_PO) == 1);
+    uint n_vars = N.enumSize(gate_PI);
+
+    // Variable order is taken from the tree before it is turned into ANDs:
+    Vec<uint> rank;
+    dfsOrder(N, rank);
+
+    convertToAig(N);
+    if (!P.quiet) WriteLn "AIG: %_", info(N);
+
+    Vec<double> probs(n_vars);      // -- indexed by BDD variable
+    for (uint i = 0; i < n_vars; i++)
+        probs[rank[i]] = ev_probs[i];
+
+    DdManager* dd = Cudd_Init(n_vars, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+    if (P.reorder)
+        Cudd_AutodynEnable(dd, CUDD_REORDER_SIFT);
+
+    // Count fanouts so intermediate BDDs can be released as soon as possible:
+    Vec<GLit> order;
+    upOrder(N, order);
+    Vec<uint> n_refs(N.size(), 0);
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+        For_Inputs(w, v)
+            n_refs[v.id]++;
+    }
+
+    Vec<DdNode*> bdd(N.size(), NULL);
+    bdd[gid_True ] = Cudd_ReadOne(dd);           Cudd_Ref(bdd[gid_True ]);
+    bdd[gid_False] = Cudd_Not(Cudd_ReadOne(dd)); Cudd_Ref(bdd[gid_False]);
+
+    DdNode* top = NULL;
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+        switch (w.type()){
+        case gate_Const:
+            break;
+
+        case gate_PI:
+            bdd[w.id] = Cudd_bddIthVar(dd, rank[w.num()]);
+            Cudd_Ref(bdd[w.id]);
+            break;
+
+        case gate_And:
+            bdd[w.id] = Cudd_bddAnd(dd, Cudd_NotCond(bdd[w[0].id], w[0].sign), Cudd_NotCond(bdd[w[1].id], w[1].sign));
+            Cudd_Ref(bdd[w.id]);
+            break;
+
+        case gate_PO:
+            top = Cudd_NotCond(bdd[w[0].id], w[0].sign);
+            Cudd_Ref(top);
+            break;
+
+        default:
+            ShoutLn "INTERNAL ERROR! Unexpected gate type: %_", w;
+            assert(false);
+        }
+
+        For_Inputs(w, v){
+            if (--n_refs[v.id] == 0){
+                Cudd_RecursiveDeref(dd, bdd[v.id]);
+                bdd[v.id] = NULL;
+            }
+        }
+    }
+    assert(top != NULL);
+
+    if (!P.quiet) WriteLn "BDD: %_ nodes  (peak %_)   [%t]", Cudd_DagSize(top), (uint64)Cudd_ReadPeakNodeCount(dd), cpuTime();
+
+    // Compute probability:
+    Map<uint64, Pair<double,double> > memo;
+    double prob = bddProb(top, probs, memo).fst;
+
+    Cudd_RecursiveDeref(dd, top);
+    for (uint i = 0; i < bdd.size(); i++)
+        if (bdd[i]) Cudd_RecursiveDeref(dd, bdd[i]);
+    Cudd_Quit(dd);
+
+    return prob;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
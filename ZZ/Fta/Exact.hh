@@ -0,0 +1,44 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Exact.hh
+//| Author(s)   : Niklas Een
+//| Module      : Fta
+//| Description : Exact top-event probability through BDDs.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Fta__Exact_hh
+#define ZZ__Fta__Exact_hh
+
+#include "ZZ_Gig.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+struct Params_FtaExact {
+    bool    reorder;            // -- apply dynamic variable reordering (sifting) on top of the structural order.
+    bool    quiet;
+
+    Params_FtaExact() :
+        reorder(false),
+        quiet(false)
+    {}
+};
+
+
+double ftaExact(Gig& N, const Vec<double>& ev_probs, const Params_FtaExact& P = Params_FtaExact());
+    // -- Build a BDD for the top-event of fault-tree 'N' (which will be converted to an AIG) and
+    // return its exact probability. Basic events are ordered by a depth-first traversal of the tree.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
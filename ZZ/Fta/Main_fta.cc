@@ -4,6 +4,7 @@
 #include "Parser.hh"
 #include "Solver.hh"
 #include "Solver2.hh"
+#include "Exact.hh"
 #include "Common.hh"
 #include "Export.hh"
 
@@ -33,8 +34,14 @@ int main(int argc, char** argv)
     cli_enum.add("cutoff", "float", "1e-12", "Enumerate MCSs downto this probability.");
     cli_enum.add("quant" , "float", "1",     "Quanta to approximate cutoff. Should be a negative power of 2.");
     cli_enum.add("hprob" , "float", "0.75",  "Threshold for \"high probability\" literals to be excluded from MCSs.");
+    cli_enum.add("par"   , "uint" , "1",     "Number of worker processes. If more than one, the event space is partitioned on high probability events.");
+    cli_enum.add("split" , "uint" , "0",     "Number of events to partition on (0 = choose from '-par').");
     cli.addCommand("enum", "Enumerate cubes and sum up their probability [experimental].", &cli_enum);
 
+    CLI cli_exact;
+    cli_exact.add("reorder", "bool", "no", "Use dynamic variable reordering (sifting) on top of the structural order.");
+    cli.addCommand("exact", "Compute the exact probability of the top-node using BDDs.", &cli_exact);
+
     cli.addCommand("save-xml", "Save fault-tree in OpenPSA XML format.");
     cli.addCommand("save-dot", "Save fault-tree in 'dotty' format (no probabilities).");
 
@@ -96,8 +103,20 @@ int main(int argc, char** argv)
         P.mcs_cutoff      = cli_enum.get("cutoff").float_val;
         P.cutoff_quant    = cli_enum.get("quant").float_val;
         P.high_prob_thres = cli_enum.get("hprob").float_val;
+        P.n_procs         = cli_enum.get("par").int_val;
+        P.split_events    = cli_enum.get("split").int_val;
         enumerateModels(N, ev_probs, ev_names, P);
 
+    }else if (cli.cmd == "exact"){
+        Params_FtaExact P;
+        P.reorder = cli_exact.get("reorder").bool_val;
+        double prob = ftaExact(N, ev_probs, P);
+
+        char pr[128];
+        sprintf(pr, "%.15g", prob);
+        WriteLn "Exact probability: %_", pr;
+        WriteLn "CPU-time: %t", cpuTime();
+
     }else
         assert(false);
 
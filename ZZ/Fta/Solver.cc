@@ -17,6 +17,12 @@
 #include "ZZ_Gip.CnfMap.hh"
 #include "ZZ_Gip.Common.hh"
 #include "ZZ_Npn4.hh"
+#include "ZZ/Generics/IntSet.hh"
+
+#if !defined(_MSC_VER)
+  #include <unistd.h>
+  #include <sys/wait.h>
+#endif
 
 namespace ZZ {
 using namespace std;
@@ -73,15 +79,14 @@ lbool sim(Wire w, const Vec<GLit>& prime, const Gig& N_prime)
 
 void shrink(Vec<Lit>& zcube, MiniSat2& Z, const IntMap<uint, double>& zprob, const Params_FtaEnum& P)
 {
-#if 1
     lbool result = Z.solve(zcube);
     assert(result == l_False);
 
     Z.getConflict(zcube);
 
-  #if 0
-    // Temporary selection sort:
-    for (uint i = 0; i < zcube.size()-1; i++){
+    // Minimize (the final conflict need not be minimal; a non-minimal cut would make the result
+    // depend on enumeration order). Try removing the least probable events first:
+    for (uint i = 0; i+1 < zcube.size(); i++){
         double best_prob = zprob[zcube[i].id];
         uint best_idx = i;
         for (uint j = i+1; j < zcube.size(); j++){
@@ -97,8 +102,6 @@ void shrink(Vec<Lit>& zcube, MiniSat2& Z, const IntMap<uint, double>& zprob, con
         if (Z.solve(zcube) == l_True)
             zcube[i] = p;
     }
-  #endif
-#endif
 
     for (uint i = 0; i < zcube.size(); i++)
         if (zcube[i] == Z.True() || zprob[zcube[i].id] > P.high_prob_thres)
@@ -108,6 +111,234 @@ void shrink(Vec<Lit>& zcube, MiniSat2& Z, const IntMap<uint, double>& zprob, con
 }
 
 
+// Enumeration state shared by the sequential and the parallel version.
+struct McsEnum {
+    Gig&                        N;
+    MiniSat2&                   S;
+    MiniSat2&                   Z;
+    WMapX<Lit>&                 n2s;
+    WMapX<Lit>&                 n2z;
+    const IntMap<uint, GLit>&   z2n;
+    const IntMap<uint, double>& zprob;
+    const Vec<double>&          ev_probs;
+    uint                        n_vars;
+    const Params_FtaEnum&       P;
+
+    uint64  n_cubes;
+    double  total_prob;
+
+    McsEnum(Gig& N_, MiniSat2& S_, MiniSat2& Z_, WMapX<Lit>& n2s_, WMapX<Lit>& n2z_, const IntMap<uint, GLit>& z2n_,
+            const IntMap<uint, double>& zprob_, const Vec<double>& ev_probs_, uint n_vars_, const Params_FtaEnum& P_) :
+        N(N_), S(S_), Z(Z_), n2s(n2s_), n2z(n2z_), z2n(z2n_), zprob(zprob_), ev_probs(ev_probs_), n_vars(n_vars_), P(P_),
+        n_cubes(0), total_prob(0) {}
+
+    void run(const Vec<Lit>& assumps, bool verbose);
+};
+
+
+// Enumerate MCSs of the part of the event space given by 'assumps' (over 'S'). Blocking clauses
+// are guarded by the negation of 'assumps', so parts never interfere with each other. An MCS is
+// only counted (in 'n_cubes' and 'total_prob') if it contains every event that 'assumps' sets to
+// TRUE in positive polarity. Every MCS has exactly one such part (its "canonical" part), so summing over a
+// partition of the event space gives the same result as enumerating without assumptions.
+void McsEnum::run(const Vec<Lit>& assumps, bool verbose)
+{
+    IntSet<uint> required;  // -- variable IDs in 'Z' of events set to TRUE (positive polarity) by 'assumps'
+    For_Gatetype(N, gate_PI, w)
+        if (w.num() < n_vars && has(assumps, n2s[w]))
+            required.add(n2z[w].id);
+
+    uint  iter = 0;
+    double lim = 10;
+    for(;;){
+
+        lbool result = S.solve(assumps);
+
+        if (verbose && (iter > lim || result == l_False)){
+            iter = 0;
+            lim *= 1.3;
+
+            char pr[128];
+            sprintf(pr, "%g", total_prob);
+            WriteLn "#MCS: %_    Prob: %<12%_   [%t]", n_cubes, pr, cpuTime();
+        }
+
+        if (result == l_True){
+            // Extract cube:
+            Vec<GLit> zcube;
+            For_Gatetype(N, gate_PI, w){
+                lbool v = S.value(n2s[w]);
+                if (v == l_True)
+                    zcube.push(n2z[w]);
+            }
+
+            // Shrink it to a prime:
+            shrink(zcube, Z, zprob, P);
+
+            Vec<GLit> prime;
+            for (uint i = 0; i < zcube.size(); i++)
+                prime.push(z2n[zcube[i].id]);
+
+            // Compute probability (if canonical):
+            uint n_req = 0;
+            for (uint i = 0; i < zcube.size(); i++)
+                if (required.has(zcube[i].id)) n_req++;
+
+            if (n_req == required.size()){
+                double prob = 1;
+                for (uint i = 0; i < zcube.size(); i++){
+                    Wire w = prime[i] + N;
+                    prob *= ev_probs[w.num()];
+                }
+                total_prob += prob;     // -- this is not numerically sound, nor is it a proper lower bound since primes may overlap
+                n_cubes++;
+            }
+
+            // Add clause:
+            Vec<Lit> tmp;
+            for (uint i = 0; i < prime.size(); i++){
+                Wire w = prime[i] + N;
+                uint num = (w.num() < n_vars) ? w.num() + n_vars : w.num() - n_vars;
+                tmp.push(n2s[N(gate_PI, num)]);
+            }
+            for (uint i = 0; i < assumps.size(); i++)
+                tmp.push(~assumps[i]);
+            S.addClause(tmp);
+
+            iter++;
+
+        }else
+            break;
+    }
+}
+
+
+#if !defined(_MSC_VER)
+// Worker process: enumerate the parts read from 'job_fd' and write one 'PartResult' per part.
+struct PartResult {
+    uint    part;
+    uint64  n_cubes;
+    double  prob;
+};
+
+
+static
+void partWorker(McsEnum& E, const Vec<uint>& split, int job_fd, int out_fd)
+{
+    uint part;
+    while (read(job_fd, &part, sizeof(uint)) == sizeof(uint)){
+        Vec<Lit> assumps;
+        for (uint j = 0; j < split.size(); j++){
+            Lit pos = E.n2s[E.N(gate_PI, split[j])];
+            Lit neg = E.n2s[E.N(gate_PI, split[j] + E.n_vars)];
+            if (part & (1u << j))
+                assumps.push(pos), assumps.push(~neg);
+            else
+                assumps.push(~pos), assumps.push(neg);
+        }
+
+        E.n_cubes = 0;
+        E.total_prob = 0;
+        E.run(assumps, false);
+
+        PartResult r;
+        r.part    = part;
+        r.n_cubes = E.n_cubes;
+        r.prob    = E.total_prob;
+        if (write(out_fd, &r, sizeof(r)) != sizeof(r)) _exit(1);
+    }
+    _exit(0);
+}
+#endif
+
+
+// Partition the event space on the 'P.split_events' basic events of highest probability and
+// enumerate the parts in 'P.n_procs' worker processes. Each MCS is counted only in its canonical
+// part (split events it contains positively are TRUE, all others FALSE), so the parts are disjoint
+// and the totals are those of the sequential enumeration.
+static
+void enumerateParallel(McsEnum& E, const Vec<double>& ev_probs0, const Params_FtaEnum& P)
+{
+  #if defined(_MSC_VER)
+    WriteLn "WARNING! Parallel enumeration not supported on this platform.";
+    Vec<Lit> no_assumps;
+    E.run(no_assumps, true);
+    WriteLn "#MCS: %_    Prob: %_", E.n_cubes, E.total_prob;
+  #else
+    // Pick events to split on:
+    Vec<Pair<double,uint> > cands;
+    for (uint i = 0; i < E.n_vars; i++)
+        if (ev_probs0[i] <= P.high_prob_thres)     // -- (high probability events are never part of an MCS)
+            cands.push(make_tuple(-ev_probs0[i], i));
+    sort(cands);
+
+    uint n_split = P.split_events;
+    if (n_split == 0)
+        while ((1u << n_split) < 4 * P.n_procs) n_split++;
+    newMin(n_split, min_(cands.size(), 10u));  // -- (all results must fit in the pipes)
+
+    Vec<uint> split;
+    for (uint j = 0; j < n_split; j++)
+        split.push(cands[j].snd);
+    uint n_parts = 1u << n_split;
+    WriteLn "Splitting on %_ events (%_ parts, %_ processes)", n_split, n_parts, P.n_procs;
+
+    // Queue all parts in a job pipe shared by the workers:
+    int job[2];
+    if (pipe(job) != 0){
+        ShoutLn "ERROR! Could not create pipe.";
+        exit(1); }
+    for (uint i = 0; i < n_parts; i++)
+        if (write(job[1], &i, sizeof(uint)) != sizeof(uint)){
+            ShoutLn "ERROR! Could not write to pipe.";
+            exit(1); }
+    close(job[1]);
+
+    Vec<int>   fds;
+    Vec<pid_t> pids;
+    std_out.flush();
+    for (uint k = 0; k < P.n_procs; k++){
+        int fd[2];
+        if (pipe(fd) != 0) break;
+        pid_t pid = fork();
+        if (pid == 0){
+            close(fd[0]);
+            partWorker(E, split, job[0], fd[1]);
+        }
+        close(fd[1]);
+        if (pid < 0){ close(fd[0]); break; }
+        fds.push(fd[0]);
+        pids.push(pid);
+    }
+    close(job[0]);
+
+    // Collect results:
+    uint64 n_cubes = 0;
+    double total_prob = 0;
+    uint   n_done = 0;
+    for (uint k = 0; k < fds.size(); k++){
+        PartResult r;
+        while (read(fds[k], &r, sizeof(r)) == sizeof(r)){
+            n_cubes += r.n_cubes;
+            total_prob += r.prob;
+            n_done++;
+            char pr[128];
+            sprintf(pr, "%g", r.prob);
+            WriteLn "  part %>4%_:  #MCS: %<10%_  Prob: %<12%_   [%_/%_ done]", r.part, r.n_cubes, pr, n_done, n_parts;
+        }
+        close(fds[k]);
+        waitpid(pids[k], NULL, 0);
+    }
+
+    if (n_done < n_parts)
+        WriteLn "WARNING! Only %_ of %_ parts completed.", n_done, n_parts;
+    char pr[128];
+    sprintf(pr, "%g", total_prob);
+    WriteLn "#MCS: %_    Prob: %_", n_cubes, pr;
+  #endif
+}
+
+
 // Takes a fault-tree 'N' (which will be massaged into a more optimized form) and computes
 // all satisfying assignments.
 void enumerateModels(Gig& N, const Vec<double>& ev_probs0, const Vec<String>& ev_names, const Params_FtaEnum& P)
@@ -191,72 +422,13 @@ void enumerateModels(Gig& N, const Vec<double>& ev_probs0, const Vec<String>& ev
     WriteLn "Mapped unate netlist: %_   (#clauses: %_)", info(N), S.nClauses();
 
     // Enumerate primes:
-    double total_prob = 0;
-    uint n_cubes = 0;
-
-    uint  iter = 0;
-    double lim = 10;
-    for(;;){
-
-        lbool result = S.solve();
-
-        if (iter > lim || result == l_False){
-            iter = 0;
-            lim *= 1.3;
-
-            char pr[128];
-            sprintf(pr, "%g", total_prob);
-            WriteLn "#MCS: %_    Prob: %<12%_   [%t]", n_cubes, pr, cpuTime();
-        }
-
-        if (result == l_True){
-            // Extract cube:
-            Vec<GLit> zcube;
-            //**/Vec<GLit> scube;
-            For_Gatetype(N, gate_PI, w){
-                lbool v = S.value(n2s[w]);
-                if (v == l_True)
-                    //**/scube.push(n2s[w]),
-                    zcube.push(n2z[w]);
-            }
-
-            // Shrink it to a prime:
-            shrink(zcube, Z, zprob, P);
-
-            Vec<GLit> prime;
-            for (uint i = 0; i < zcube.size(); i++)
-                prime.push(z2n[zcube[i].id]);
-
-            // Compute probability:
-            double prob = 1;
-            for (uint i = 0; i < prime.size(); i++){
-                Wire w = prime[i] + N;
-                prob *= ev_probs[w.num()];
-            }
-            //**/Dump(scube, prob);
-            total_prob += prob;     // -- this is not numerically sound, nor is it a proper lower bound since primes may overlap
-
-            // Add clause:
-            Vec<Lit> tmp;
-#if 0
-            for (uint i = 0; i < prime.size(); i++)
-                tmp.push(~n2s[prime[i]]);
-#else
-            for (uint i = 0; i < prime.size(); i++){
-                Wire w = prime[i] + N;
-                uint num = (w.num() < n_vars) ? w.num() + n_vars : w.num() - n_vars;
-                tmp.push(n2s[N(gate_PI, num)]);
-            }
-#endif
-            S.addClause(tmp);
-
-            n_cubes++;
-            iter++;
-
-        }else
-            break;
-    }
-    printf("\n"); fflush(stdout);
+    McsEnum E(N, S, Z, n2s, n2z, z2n, zprob, ev_probs, n_vars, P);
+    if (P.n_procs <= 1){
+        Vec<Lit> no_assumps;
+        E.run(no_assumps, true);
+        WriteLn "#MCS: %_    Prob: %_", E.n_cubes, E.total_prob;
+    }else
+        enumerateParallel(E, ev_probs0, P);
 
     WriteLn "CPU-time: %t", cpuTime();
 }
@@ -27,11 +27,15 @@ struct Params_FtaEnum {
     double mcs_cutoff;          // -- only enumerate MCSs down to this probability.
     double cutoff_quant;        // -- cutoff is approximately implemented using this quanta (must be a power of 2).
     double high_prob_thres;     // -- if a literal is above this probability, it is not included in the MCS.
+    uint   n_procs;             // -- if more than one, enumerate parts of the event space in parallel (using 'fork()').
+    uint   split_events;        // -- split event space on this many basic events (of highest probability); 0 = choose from 'n_procs'.
 
     Params_FtaEnum() :
         mcs_cutoff(1e-12),
         cutoff_quant(1.0),
-        high_prob_thres(0.75)
+        high_prob_thres(0.75),
+        n_procs(1),
+        split_events(0)
     {}
 };
 
@@ -24,8 +24,9 @@ using namespace std;
 // Compile-time parameters:
 
 
-#define ZZ_GIG_PAGE_SIZE_LOG2 12
+#define ZZ_GIG_PAGE_SIZE_LOG2 18                        // -- 6 MB of gates (= three 2 MB huge pages on x86-64)
 #define ZZ_GIG_PAGE_SIZE      (1 << ZZ_GIG_PAGE_SIZE_LOG2)
+#define ZZ_GIG_PAGE_LIMIT     (1u << 22)                // -- default size at which flat gate storage is paged
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -102,5 +102,55 @@ void GigObj_Fanouts::init()
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Static fanouts, CSR format:
+
+
+void GigObj_FanoutsCSR::copyTo(GigObj& dst_) const
+{
+    GigObj_FanoutsCSR& dst = static_cast<GigObj_FanoutsCSR&>(dst_);
+
+    dst.clear();
+    if (valid){
+        dst.offset = Array_copy(offset);
+        dst.conns  = Array_copy(conns);
+        dst.valid  = true;
+    }
+}
+
+
+// Gates are visited in ID order and their inputs in pin order, so a counting sort leaves each
+// fanout list sorted on '(parent, pin)' without any further sorting.
+void GigObj_FanoutsCSR::init()
+{
+    assert(N->is_frozen);
+    clear();
+
+    // Count fanouts (shifted one step so that the prefix sum below yields start offsets):
+    offset = Array_alloc<uint>(N->size() + 1, 0u);
+    For_All_Gates(*N, w)
+        For_Inputs(w, v)
+            offset[v.id + 1]++;
+
+    for (uint i = 0; i < N->size(); i++)
+        offset[i + 1] += offset[i];
+
+    // Populate (using 'offset[id]' as insertion point, then shifting back):
+    conns = Array_alloc<CConnect>(offset[N->size()]);
+    For_All_Gates(*N, w){
+        For_Inputs(w, v){
+            CConnect& c = conns[offset[v.id]++];
+            c.parent = w.lit() ^ sign(v);
+            c.pin    = Input_Pin(v);
+        }
+    }
+    for (uint i = N->size(); i > 0; i--)
+        offset[i] = offset[i - 1];
+    offset[0] = 0;
+
+    valid = true;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
@@ -135,6 +135,7 @@ class Fanouts {
     CConnect*   data;
 
     friend class GigObj_Fanouts;
+    friend class GigObj_FanoutsCSR;
     Fanouts(Gig& N_, CConnect* data_, uint sz_) : N(N_), sz(sz_), data(data_) {}
 
 public:
@@ -209,6 +210,71 @@ public:
 };
 
 
+//=================================================================================================
+// -- GigObj_FanoutsCSR:
+
+
+// Read-only fanouts in compressed sparse row format: the fanouts of gate 'id' are stored
+// contiguously in 'conns[offset[id]]' up to (but not including) 'conns[offset[id+1]]', sorted
+// on '(parent, pin)'. Built in linear time from a frozen netlist. Any change to the netlist
+// (which requires it to be unfrozen) drops the index; 'fanoutsCSR()' in 'GigExtra.hh' rebuilds
+// it on demand once the netlist is frozen again.
+//
+class GigObj_FanoutsCSR : public GigObj, public GigLis {
+    Array<uint>     offset;     // -- size is 'N->size() + 1'
+    Array<CConnect> conns;
+    bool            valid;
+
+public:
+  //________________________________________
+  //  Constructor:
+
+    GigObj_FanoutsCSR(Gig& N_) :
+        GigObj(N_),
+        valid(false)
+    {
+        N->listen(*this, msg_Update | msg_Add | msg_Remove);
+    }
+
+   ~GigObj_FanoutsCSR() {
+        N->unlisten(*this, msg_Update | msg_Add | msg_Remove);
+        clear(); }
+
+  //________________________________________
+  //  GigObj interface:
+
+    void init();
+    void load(In&) { valid = false; }
+    void save(Out&) const {}
+    void copyTo(GigObj& dst) const;
+    void compact(const GigRemap& remap) { clear(); }
+
+  //________________________________________
+  //  Listener interface:
+
+    void updating(Wire, uint, Wire, Wire) { if (valid) clear(); }
+    void adding  (Wire)                   { if (valid) clear(); }
+    void removing(Wire, bool)             { if (valid) clear(); }
+
+  //________________________________________
+  //  Methods:
+
+    void clear() {
+        dispose(offset); offset.mkNull();
+        dispose(conns); conns.mkNull();
+        valid = false; }
+
+    bool isValid() const { return valid; }
+        // -- FALSE if the netlist has changed since the index was built ('init()' rebuilds it).
+
+    Fanouts get(Wire w) const {
+        assert_debug(valid);
+        uint i = offset[id(w)];
+        return Fanouts(*N, const_cast<CConnect*>(&conns[i]), offset[id(w) + 1] - i);
+    }
+};
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Fanout count (dynamic):
 
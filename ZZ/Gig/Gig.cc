@@ -23,6 +23,10 @@
 #include "Prelude.hh"
 #include "StdLib.hh"
 
+#if defined(__linux__)
+  #include <sys/mman.h>
+#endif
+
 namespace ZZ {
 using namespace std;
 
@@ -82,14 +86,11 @@ void Gig::clear(bool reinit)
     }
     mem.clear(reinit);
 
-  #if defined(ZZ_GIG_PAGED)
-    // Free pages:
+    // Free gate storage:
     for (uint i = 0; i < pages.size(); i++)
         xfree(pages[i]);
     pages.clear(true);
-  #else
     gates.clear(true);
-  #endif
 
     // Free vectors:
     for (uint i = 0; i < numbers.size(); i++)
@@ -140,6 +141,75 @@ void Gig::clear(bool reinit)
 }
 
 
+//=================================================================================================
+// -- Gate storage:
+
+
+// A page holds 'ZZ_GIG_PAGE_SIZE' gates (a multiple of 2 MB) and is aligned on a 2 MB boundary so
+// that the kernel can back it by transparent huge pages. The first page is not advised, to keep
+// small netlists from claiming full huge pages.
+static
+Gate* allocPage(bool huge)
+{
+  #if defined(__linux__)
+    size_t bytes = sizeof(Gate) * ZZ_GIG_PAGE_SIZE;
+    void*  ptr   = NULL;
+    mem_assert(posix_memalign(&ptr, 2 * 1024 * 1024, bytes) == 0);  // -- released by 'xfree()'
+    if (huge)
+        madvise(ptr, bytes, MADV_HUGEPAGE);     // -- only a hint; failure is harmless
+    return (Gate*)ptr;
+  #else
+    return xmalloc<Gate>(ZZ_GIG_PAGE_SIZE);
+  #endif
+}
+
+
+// Make room for gate 'size_' (the next fresh ID).
+void Gig::growGates()
+{
+    if (!paged && size_ >= page_limit)
+        setPaged(true);
+
+    if (paged){
+        if ((size_ & (ZZ_GIG_PAGE_SIZE - 1)) == 0)
+            pages.push(allocPage(pages.size() > 0));
+    }else
+        gates.push();
+}
+
+
+// Converting between layouts copies the gate table once; both copies are alive at the end of the
+// conversion (but never the 3x of a doubling 'Vec<Gate>' being copied).
+void Gig::setPaged(bool on)
+{
+    if (on == paged) return;
+
+    if (on){
+        assert(pages.size() == 0);
+        for (uint i = 0; i < size_; i += ZZ_GIG_PAGE_SIZE){
+            Gate* page = allocPage(pages.size() > 0);
+            memcpy(page, &gates[i], sizeof(Gate) * min_(size_ - i, (uint)ZZ_GIG_PAGE_SIZE));
+            pages.push(page);
+        }
+        gates.clear(true);
+
+    }else{
+        assert(gates.size() == 0);
+        gates.growTo(size_);
+        for (uint i = 0; i < pages.size(); i++)
+            memcpy(&gates[i << ZZ_GIG_PAGE_SIZE_LOG2], pages[i], sizeof(Gate) * min_(size_ - (i << ZZ_GIG_PAGE_SIZE_LOG2), (uint)ZZ_GIG_PAGE_SIZE));
+        for (uint i = 0; i < pages.size(); i++)
+            xfree(pages[i]);
+        pages.clear(true);
+    }
+    paged = on;
+}
+
+
+//=================================================================================================
+// -- Adding gates:
+
+
 gate_id Gig::addInternal(GateType type, uint sz, uint attr, bool strash_normalized)
 {
     // Determine gate id:
@@ -148,13 +218,8 @@ gate_id Gig::addInternal(GateType type, uint sz, uint attr, bool strash_normaliz
         id = freelist.popC();
         type_count[gate_NULL]--;
     }else{
+        growGates();
         id = size_++;
-      #if defined(ZZ_GIG_PAGED)
-        if ((id & (ZZ_GIG_PAGE_SIZE - 1)) == 0)    // -- alloc new page
-            pages.push(xmalloc<Gate>(ZZ_GIG_PAGE_SIZE));
-      #else
-        gates.push();
-      #endif
     }
 
     // Initialize gate:
@@ -208,14 +273,9 @@ void Gig::loadGate(GateType type, uint sz)
 {
     // Determine gate id:
     gate_id id;
+    growGates();
     id = size_++;
     type_count[type]++;
-  #if defined(ZZ_GIG_PAGED)
-    if ((id & (ZZ_GIG_PAGE_SIZE - 1)) == 0)    // -- alloc new page
-        pages.push(xmalloc<Gate>(ZZ_GIG_PAGE_SIZE));
-  #else
-    gates.push();
-  #endif
 
     // If NULL gate, add to free list:
     if (type == gate_NULL && use_freelist)
@@ -354,11 +414,10 @@ void Gig::moveTo(Gig& M)
     // Migrate state:
     mem.moveTo(M.mem, false);
     mov(is_frozen   , M.is_frozen);
-  #if defined(ZZ_GIG_PAGED)
+    mov(paged       , M.paged);
+    mov(page_limit  , M.page_limit);
     mov(pages       , M.pages);
-  #else
     mov(gates       , M.gates);
-  #endif
     mov(numbers     , M.numbers);
     mov(type_list   , M.type_list);
     mov(type_count  , M.type_count);
@@ -395,15 +454,14 @@ void Gig::copyTo(Gig& M) const
     // Copy state:
     cpy(is_frozen, M.is_frozen);
 
-  #if defined(ZZ_GIG_PAGED)
+    cpy(paged     , M.paged);
+    cpy(page_limit, M.page_limit);
     M.pages.growTo(pages.size());
     for (uint i = 0; i < pages.size(); i++){
-        M.pages[i] = xmalloc<Gate>(ZZ_GIG_PAGE_SIZE);
+        M.pages[i] = allocPage(i > 0);
         memcpy(M.pages[i], pages[i], sizeof(Gate) * ZZ_GIG_PAGE_SIZE);
     }
-  #else
     cpy(gates, M.gates);
-  #endif
 
     cpy(size_, M.size_);
     for (uint id = 0; id < size_; id++){
@@ -495,16 +553,15 @@ void Gig::compact(GigRemap& remap, bool remove_unreach)
     type_count[gate_NULL] -= size_ - new_size;
     assert_debug(type_count[gate_NULL] == 3);     // -- right now we have three NULL objects (NULL/ERROR/Reserved); may change...
 
-  #if defined(ZZ_GIG_PAGED)
     size_ = new_size;
-    uint n_pages = (size_ + ZZ_GIG_PAGE_SIZE - 1) / ZZ_GIG_PAGE_SIZE;
-    while (pages.size() > n_pages)
-        xfree(pages.popC());
-  #else
-    size_ = new_size;
-    gates.shrinkTo(size_);
-    gates.trim();
-  #endif
+    if (paged){
+        uint n_pages = (size_ + ZZ_GIG_PAGE_SIZE - 1) / ZZ_GIG_PAGE_SIZE;
+        while (pages.size() > n_pages)
+            xfree(pages.popC());
+    }else{
+        gates.shrinkTo(size_);
+        gates.trim();
+    }
 
     // Empty free list:
     freelist.clear(true);
@@ -20,7 +20,7 @@
 #include "GateTypes.hh"
 #include "GigObjs.hh"
 
-//#define ZZ_GIG_PAGED
+//#define ZZ_GIG_PAGED      // -- start all netlists with paged gate storage (see 'Gig::setPaged()')
 
 
 namespace ZZ {
@@ -113,11 +113,10 @@ struct Gig_data {
 
     bool                is_frozen;      // -- no updates allowed to netlist (except netlist objects)
 
-  #if defined(ZZ_GIG_PAGED)
+    bool                paged;          // -- gates are stored in 'pages' rather than 'gates'
+    uint                page_limit;     // -- flat storage is converted to paged beyond this size
     Vec<Gate*>          pages;
-  #else
     Vec<Gate>           gates;
-  #endif
     Vec<IdRepos>        numbers;
     Vec<Vec<gate_id> >  type_list;      // -- for selected type (attribute 'enum')
     Vec<uint>           type_count;
@@ -136,11 +135,10 @@ struct Gig_data {
 
 macro Gate& getGate(const Gig_data& N, gate_id id) {
     assert_debug(id < N.size_);
-  #if defined(ZZ_GIG_PAGED)
-    return N.pages[id >> ZZ_GIG_PAGE_SIZE_LOG2][id & (ZZ_GIG_PAGE_SIZE - 1)];
-  #else
-    return const_cast<Gate&>(N.gates[id]);
-  #endif
+    if (N.paged)
+        return N.pages[id >> ZZ_GIG_PAGE_SIZE_LOG2][id & (ZZ_GIG_PAGE_SIZE - 1)];
+    else
+        return const_cast<Gate&>(N.gates[id]);
 }
 
 
@@ -377,6 +375,7 @@ inline void tell_update(Vec<GigLis*>& lis, uint pin, Wire w, Wire v)    // -- us
 struct Gig : Gig_data, NonCopyable {
     gate_id addInternal(GateType type, uint sz, uint attr, bool strash_normalized = false);
     void    loadGate(GateType type, uint sz);
+    void    growGates();
     void    flushRle(Out& out, uchar type, uint count, uint end);
 
   //________________________________________
@@ -485,6 +484,18 @@ struct Gig : Gig_data, NonCopyable {
         // -- Will topologically order the gates and remove any gaps in the gate tables
         // created by gate removal. By default, unreachable gates (from COs) are first removed.
 
+  //________________________________________
+  //  Gate storage:
+
+    bool  isPaged() const { return paged; }
+    void  setPaged(bool on = true);
+    void  setPageLimit(uint n_gates) { page_limit = n_gates; }
+        // -- Gates are stored either in one flat vector (fastest access, but growing it copies the
+        // whole table) or in pages of 'ZZ_GIG_PAGE_SIZE' gates, backed by huge pages where
+        // available. In paged mode, gate addresses are stable as the netlist grows. A flat netlist
+        // growing beyond 'page_limit' gates is converted to paged storage ('UINT_MAX' disables
+        // this). Both settings survive 'clear()'.
+
   //________________________________________
   //  Disk:
 
@@ -515,6 +526,12 @@ macro Wire operator+(GLit p    , const Gig& N) { return N[p];  }
 inline Gig::Gig()
 {
     is_frozen    = false;
+  #if defined(ZZ_GIG_PAGED)
+    paged        = true;
+  #else
+    paged        = false;
+  #endif
+    page_limit   = ZZ_GIG_PAGE_LIMIT;
     size_        = 0;
     use_freelist = true;
     objs         = NULL;
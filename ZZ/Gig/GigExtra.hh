@@ -35,6 +35,18 @@ macro Fanouts fanouts(Wire w)
 }
 
 
+// Requires Gig-object "FanoutsCSR" and a frozen netlist. The index is rebuilt here if the netlist
+// was modified since it was last built.
+macro Fanouts fanoutsCSR(Wire w)
+{
+    Gig& N = *w.gig();
+    GigObj_FanoutsCSR& obj = static_cast<GigObj_FanoutsCSR&>(N.getObj(gigobj_FanoutsCSR));
+    if (!obj.isValid())
+        obj.init();
+    return obj.get(w);
+}
+
+
 // Requires Gig-object "FanoutCount".
 macro uint nFanouts(Wire w)
 {
@@ -24,6 +24,7 @@ using namespace std;
 void GigObj_Fanouts_new    (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_Fanouts    (N); if (init) ret->init(); }
 void GigObj_FanoutCount_new(Gig& N, GigObj*& ret, bool init) { ret = new GigObj_FanoutCount(N); if (init) ret->init(); }
 void GigObj_Strash_new     (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_Strash     (N); if (init) ret->init(); }
+void GigObj_FanoutsCSR_new (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_FanoutsCSR (N); if (init) ret->init(); }
 
 GigObj_Factory gigobj_factory_funcs[GigObjType_size] = {
     NULL,
@@ -31,6 +32,7 @@ GigObj_Factory gigobj_factory_funcs[GigObjType_size] = {
     GigObj_FanoutCount_new,
     NULL,   // <<== dynamic fanouts, not done yet
     GigObj_Strash_new,
+    GigObj_FanoutsCSR_new,
 };
 
 
@@ -25,7 +25,8 @@ using namespace std;
     Macro(Fanouts)                              \
     Macro(FanoutCount)                          \
     Macro(DynamicFanouts)                       \
-    Macro(Strash)
+    Macro(Strash)                               \
+    Macro(FanoutsCSR)
 
 // NOTE! When a netlist is copied, the Gig objects are copied in the above order.
 // An enum will contain all of the above names with 'gigobj_' prefixed to them.
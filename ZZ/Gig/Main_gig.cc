@@ -7,10 +7,50 @@ using namespace ZZ;
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
+// Strash-heavy construction of a random AIG with 'n_ands' AND gates, using flat, paged or default
+// ("auto"; flat until the page limit is reached) gate storage. Run once per layout, since peak
+// memory is measured per process:
+//
+//     gig.exe bench flat  50000000
+//     gig.exe bench paged 50000000
+//     gig.exe bench auto  50000000
+//
+static
+void benchStorage(String mode, uint n_ands)
+{
+    double T0 = realTime();
+    Gig N;
+    if (mode == "paged")
+        N.setPaged();
+    else if (mode == "flat")
+        N.setPageLimit(UINT_MAX);
+    N.strash();
+
+    Vec<GLit> ws;
+    for (uint i = 0; i < 1024; i++)
+        ws.push(N.add(gate_PI));
+
+    uint64 seed = 42;
+    while (N.typeCount(gate_And) < n_ands){
+        Wire x = ws[irand(seed, ws.size())] + N;
+        Wire y = ws[irand(seed, ws.size())] + N;
+        ws.push(aig_And(x ^ irand(seed, 2), y ^ irand(seed, 2)));
+    }
+    double T1 = realTime();
+
+    WriteLn "Storage '%_' (%_ at end):  %_   [%t real, %DB peak]", mode, (N.isPaged() ? "paged" : "flat"), info(N), T1 - T0, memUsed();
+}
+
+
 int main(int argc, char** argv)
 {
     ZZ_Init;
 
+    if (argc >= 3 && strcmp(argv[1], "bench") == 0){
+        benchStorage(argv[2], (argc >= 4) ? atoi(argv[3]) : 10000000);
+        return 0;
+    }
+
     Gig N;
 
     Wire sel = N.add(gate_PI);
@@ -102,6 +102,22 @@ void extractCex(uint depth, uint prop_no, const Gig& N, const MetaSat& S, EngRep
 }
 
 
+// Same, for an unrolling produced by a 'CnfTemplate'.
+void extractCex(uint depth, uint prop_no, const Gig& N, const MetaSat& S, EngRep& R, const Vec<WMapX<Lit> >& n2s)
+{
+    Cex cex(depth, N);
+
+    For_Gatetype(N, gate_FF, w)
+        cex.ff(w) = n2s[0][w] ? S.value(n2s[0][w]) : l_Undef;
+
+    for (uint d = 0; d < depth; d++)
+        For_Gatetype(N, gate_PI, w)
+            cex.pi[d](w) = n2s[d][w] ? S.value(n2s[d][w]) : l_Undef;
+
+    R.cex(Prop(pt_Safe, prop_no), cex);
+}
+
+
 void bmc(Gig& N0, Params_Bmc& P, EngRep& R, const Vec<uint>& props)
 {
     // Create LUT-based representation for easier CNF generation:
@@ -114,6 +130,7 @@ void bmc(Gig& N0, Params_Bmc& P, EngRep& R, const Vec<uint>& props)
 
     Params_CnfMap Pc;
     Pc.quiet = true;
+    Pc.n_procs = P.cnf_procs;
     cnfMap(N, Pc);
 
 #if 0   /*DEBUG*/
@@ -144,20 +161,40 @@ void bmc(Gig& N0, Params_Bmc& P, EngRep& R, const Vec<uint>& props)
     MultiSat S(P.sat_solver);
     WMapX<Lit> f2s;
 
+    Vec<GLit> tmpl_roots;
+    if (P.cnf_template){
+        for (uint i = 0; i < props.size(); i++)
+            tmpl_roots.push(N(gate_SafeProp, props[i]));
+    }
+    CnfTemplate tmpl(N, tmpl_roots);    // -- (empty unless 'cnf_template' is set)
+    Vec<WMapX<Lit> > n2s;
+
     for (uint depth = 0;;){
-        // Add time-frame to unrolling:
-        Vec<GLit> roots;    // -- conjunction of properties at time 'depth'
-        for (uint i = 0; i < unsolved.size(); i++){
-            roots.push(insert(N(gate_SafeProp, unsolved[i]), depth, F, n2f)); }
+        Vec<Lit> tmp;       // -- disjunction of failing properties at time 'depth'
+        if (!P.cnf_template){
+            // Add time-frame to unrolling:
+            Vec<GLit> roots;    // -- conjunction of properties at time 'depth'
+            for (uint i = 0; i < unsolved.size(); i++){
+                roots.push(insert(N(gate_SafeProp, unsolved[i]), depth, F, n2f)); }
+
+            // Call solver:
+            clausify(F, roots, S, f2s);
 
-        // Call solver:
-        clausify(F, roots, S, f2s);
+            FFWriteLn(R) "Depth %_ -- Properties left: %_ -- Unrolling: #Lut=%_  #PI=%_  #vars=%_  #clauses=%_  [CPU-time: %t]", depth, unsolved.size(), F.typeCount(gate_Lut4), F.typeCount(gate_PI), S.nVars(), S.nClauses(), cpuTime();
 
-        FFWriteLn(R) "Depth %_ -- Properties left: %_ -- Unrolling: #Lut=%_  #PI=%_  #vars=%_  #clauses=%_  [CPU-time: %t]", depth, unsolved.size(), F.typeCount(gate_Lut4), F.typeCount(gate_PI), S.nVars(), S.nClauses(), cpuTime();
+            for (uint i = 0; i < roots.size(); i++)
+                tmp.push(~f2s[roots[i]]);
+
+        }else{
+            if (n2s.size() == depth)
+                tmpl.instantiate(S, n2s(depth), (depth == 0) ? NULL : &n2s[depth-1]);
+
+            FFWriteLn(R) "Depth %_ -- Properties left: %_ -- Template: #vars=%_  --  #vars=%_  #clauses=%_  [CPU-time: %t]", depth, unsolved.size(), tmpl.nVars(), S.nVars(), S.nClauses(), cpuTime();
+
+            for (uint i = 0; i < unsolved.size(); i++)
+                tmp.push(~n2s[depth][N(gate_SafeProp, unsolved[i])]);
+        }
 
-        Vec<Lit> tmp;
-        for (uint i = 0; i < roots.size(); i++)
-            tmp.push(~f2s[roots[i]]);
         tmp.push(S.addLit());
         S.addClause(tmp);
 
@@ -169,8 +206,12 @@ void bmc(Gig& N0, Params_Bmc& P, EngRep& R, const Vec<uint>& props)
             uint j = 0;
             for (uint i = 0; i < unsolved.size(); i++){
                 //**/WriteLn "  status prop %_: %_", N(gate_SafeProp, unsolved[i]).num(), S.value(tmp[i]);
-                if (S.value(tmp[i]) == l_True)
-                    extractCex(depth+1, unsolved[i], N, S, R, n2f, f2s);
+                if (S.value(tmp[i]) == l_True){
+                    if (!P.cnf_template)
+                        extractCex(depth+1, unsolved[i], N, S, R, n2f, f2s);
+                    else
+                        extractCex(depth+1, unsolved[i], N, S, R, n2s);
+                }
                 else
                     unsolved[j++] = unsolved[i];
             }
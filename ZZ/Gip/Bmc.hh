@@ -26,9 +26,13 @@ using namespace std;
 
 struct Params_Bmc {
     SolverType sat_solver;
+    bool       cnf_template;    // -- instantiate a precompiled clause template per time-frame instead of unrolling by structural hashing
+    uint       cnf_procs;       // -- processes for level-parallel cut enumeration in 'cnfMap()'
 
     Params_Bmc() :
-        sat_solver(sat_Msc)
+        sat_solver(sat_Msc),
+        cnf_template(false),
+        cnf_procs(1)
     {}
 };
 
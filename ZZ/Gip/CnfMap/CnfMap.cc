@@ -16,6 +16,11 @@
 #include "ZZ_Npn4.hh"
 #include "ZZ/Generics/Sort.hh"
 
+#if !defined(_MSC_VER)
+  #include <unistd.h>
+  #include <sys/wait.h>
+#endif
+
 #define CnfMap CnfMap_Gig       // -- avoid linker problems
 
 namespace ZZ {
@@ -86,6 +91,27 @@ bool applySubsumptionAndAddCut(const Cut& cut, Vec<Cut>& out)
 }
 
 
+// Raw (de)serialization of plain data for the pipes between parallel workers (same binary, so no
+// portability issues).
+template<class T>
+macro void putRaw(Vec<uchar>& data, const T& v)
+{
+    uind pos = data.size();
+    data.growTo(pos + sizeof(T));
+    memcpy(&data[pos], &v, sizeof(T));
+}
+
+
+template<class T>
+macro bool getRaw(const Vec<uchar>& data, uind& pos, T& v)
+{
+    if (pos + sizeof(T) > data.size()) return false;
+    memcpy(&v, &data[pos], sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // 'CnfMap' class:
 
@@ -101,6 +127,8 @@ class CnfMap {
     WMap<float>       area_est;
     WMap<float>       fanout_est;
 
+    Vec<GLit>         order;        // -- topological order (computed once, shared by all rounds)
+    Vec<uint>         level_end;    // -- if parallel, 'order' is sorted on level; level 'l' ends at 'order[level_end[l]]'
     uint              round;
     uint64            mapped_area;
     uint64            mapped_luts;
@@ -111,6 +139,10 @@ class CnfMap {
     void  generateCuts_And(Wire w, Vec<Cut>& out, bool use_xor);
     void  generateCuts_Mux(Wire w, Vec<Cut>& out);
     void  generateCuts(Wire w);
+    void  levelizeOrder();
+    bool  installCuts(Wire w, const Vec<uchar>& data, uind& pos);
+    void  generateCutsChild(int fd, uint lo, uint hi);
+    void  generateCutsPar(uint lo, uint hi);
     void  updateFanoutEst(bool instantiate);
     void  run();
 
@@ -243,6 +275,179 @@ void CnfMap::generateCuts(Wire w)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Level-parallel cut generation:
+
+
+// Minimum number of gates per process for a level to be split (smaller levels are not worth a fork).
+static const uint par_min_slice = 2048;
+
+
+// Stable sort of 'order' on logic level (0 for non-logic gates, 1 + max of fanins otherwise). The
+// result is still topological, and the cuts of gates on the same level are independent.
+void CnfMap::levelizeOrder()
+{
+    WMap<uint> level(0);
+    level.reserve(N.size());
+    uint max_level = 0;
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+        if (isLogic(w)){
+            uint lv = 0;
+            For_Inputs(w, v)
+                newMax(lv, level[+v]);
+            level(w) = lv + 1;
+            newMax(max_level, lv + 1);
+        }
+    }
+
+    level_end.reset(max_level + 1, 0);
+    for (uint i = 0; i < order.size(); i++)
+        level_end[level[order[i] + N]]++;
+    for (uint l = 1; l < level_end.size(); l++)
+        level_end[l] += level_end[l-1];
+
+    Vec<GLit> sorted(order.size());
+    for (uint i = order.size(); i > 0;){ i--;
+        Wire w = order[i] + N;
+        sorted[--level_end[level[w]]] = order[i]; }
+    for (uint l = 0; l < max_level; l++)
+        level_end[l] = level_end[l+1];
+    level_end.last() = order.size();
+    sorted.moveTo(order);
+}
+
+
+// Install cut set and area estimate of 'w' as serialized by 'generateCutsChild()' at 'data[pos]'.
+// Returns FALSE (and leaves 'w' untouched) if the data is incomplete.
+bool CnfMap::installCuts(Wire w, const Vec<uchar>& data, uind& pos)
+{
+    float area;
+    uint  n;
+    uind  pos0 = pos;
+    if (!getRaw(data, pos, area) || !getRaw(data, pos, n) || pos + (uind)n * sizeof(Cut) > data.size()){
+        pos = pos0;
+        return false; }
+
+    Vec<Cut>& cuts = tmp_cuts;
+    cuts.setSize(n);
+    memcpy(cuts.base(), &data[pos], n * sizeof(Cut));
+    pos += n * sizeof(Cut);
+
+    if (!cutmap[w])
+        cutmap(w) = Array_copy(cuts, mem);
+    else{
+        // Later rounds only re-sort the existing cuts:
+        Array<Cut> cs = cutmap[w];
+        assert(cs.size() == n);
+        for (uint i = 0; i < n; i++)
+            cs[i] = cuts[i];
+    }
+    area_est(w) = area;
+    return true;
+}
+
+
+#if !defined(_MSC_VER)
+// Worker for level-parallel cut generation (runs in a forked child): generates the cuts of the
+// gates 'order[lo..hi[' and writes, for each gate, its area estimate and sorted cut set to 'fd',
+// followed by the number of cuts enumerated. The child never returns.
+void CnfMap::generateCutsChild(int fd, uint lo, uint hi)
+{
+    Vec<uchar> data;
+    cuts_enumerated = 0;
+    for (uint i = lo; i < hi; i++){
+        Wire w = order[i] + N;
+        generateCuts(w);
+        Array<Cut> cuts = cutmap[w];
+        putRaw(data, area_est[w]);
+        putRaw(data, (uint)cuts.size());
+        for (uint j = 0; j < cuts.size(); j++)
+            putRaw(data, cuts[j]);
+    }
+    putRaw(data, cuts_enumerated);
+
+    const uchar* p = data.base();
+    size_t       n = data.size();
+    while (n > 0){
+        ssize_t m = write(fd, p, n);
+        if (m <= 0) break;
+        p += m; n -= m;
+    }
+    _exit(0);
+}
+#endif
+
+
+// Generate cuts for the gates 'order[lo..hi[' (all on the same level). The range is split evenly
+// between the parent and 'P.n_procs - 1' forked children. A slice whose child fails to report is
+// finished by the parent, so the result is always the same as for 'generateCuts()' in order.
+void CnfMap::generateCutsPar(uint lo, uint hi)
+{
+  #if defined(_MSC_VER)
+    for (uint i = lo; i < hi; i++)
+        generateCuts(order[i] + N);
+  #else
+    uint n_procs = P.n_procs;
+    Vec<uint> slice(n_procs + 1);
+    for (uint k = 0; k <= n_procs; k++)
+        slice[k] = lo + uint((uint64(hi - lo) * k) / n_procs);
+
+    // Fork workers for all slices but the first:
+    Vec<int>   fds  (n_procs, -1);
+    Vec<pid_t> pids (n_procs, -1);
+    std_out.flush();
+    for (uint k = 1; k < n_procs; k++){
+        int fd[2];
+        if (pipe(fd) != 0) break;
+        pid_t pid = fork();
+        if (pid == 0){
+            close(fd[0]);
+            generateCutsChild(fd[1], slice[k], slice[k+1]);
+        }
+        close(fd[1]);
+        if (pid < 0){ close(fd[0]); break; }
+        fds[k]  = fd[0];
+        pids[k] = pid;
+    }
+
+    // Do the first slice locally, then collect results (finishing incomplete slices locally):
+    for (uint i = slice[0]; i < slice[1]; i++)
+        generateCuts(order[i] + N);
+
+    Vec<uchar> data;
+    char       buf[65536];
+    for (uint k = 1; k < n_procs; k++){
+        data.clear();
+        if (fds[k] != -1){
+            for(;;){
+                ssize_t m = read(fds[k], buf, sizeof(buf));
+                if (m <= 0) break;
+                uind pos = data.size();
+                data.growTo(pos + m);
+                memcpy(&data[pos], buf, m);
+            }
+            close(fds[k]);
+            waitpid(pids[k], NULL, 0);
+        }
+
+        uind pos = 0;
+        uint i = slice[k];
+        for (; i < slice[k+1]; i++)
+            if (!installCuts(order[i] + N, data, pos)) break;
+
+        uint64 n_enum;
+        if (i == slice[k+1] && getRaw(data, pos, n_enum))
+            cuts_enumerated += n_enum;
+        else{
+            for (; i < slice[k+1]; i++)
+                generateCuts(order[i] + N);
+        }
+    }
+  #endif
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Fanout estimation:
 
@@ -348,21 +553,40 @@ void CnfMap::run()
     }
 
     // Techmap:
+    upOrder(N, order);
+    if (P.n_procs > 1)
+        levelizeOrder();
+    else
+        level_end.push(order.size());
+
     for (round = 0; round < P.n_rounds; round++){
         double T0 = cpuTime();
+        double R0 = realTime();
         cuts_enumerated = 0;
-        For_UpOrder(N, w)
-            generateCuts(w);
+        for (uint l = 0, i = 0; l < level_end.size(); l++){
+            uint end = level_end[l];
+            if (l > 0 && P.n_procs > 1 && end - i >= P.n_procs * par_min_slice)
+                generateCutsPar(i, end);
+            else{
+                for (; i < end; i++)
+                    generateCuts(order[i] + N);
+            }
+            i = end;
+        }
         double T1 = cpuTime();
+        double R1 = realTime();
 
         bool instantiate = (round == P.n_rounds - 1);
+        if (instantiate){           // -- 'N' is compacted by the last round
+            order.clear(true);
+            level_end.clear(true); }
         updateFanoutEst(instantiate);
         double T2 = cpuTime();
 
         if (!P.quiet){
             if (round == 0)
                 WriteLn "cuts_enumerated=%,d", cuts_enumerated;
-            WriteLn "round=%d   mapped_area=%,d   mapped_luts=%,d   [enum: %t, blend: %t]", round, mapped_area, mapped_luts, T1-T0, T2-T1;
+            WriteLn "round=%d   mapped_area=%,d   mapped_luts=%,d   [enum: %t (real %t), blend: %t]", round, mapped_area, mapped_luts, T1-T0, R1-R0, T2-T1;
         }
     }
 }
@@ -30,6 +30,7 @@ struct Params_CnfMap {
     uint    cuts_per_node;      // How many cuts should we store at most per node?
     uint    n_rounds;           // #iterations in techmapper. First iteration will always be depth optimal, later phases will use area recovery.
     bool    intro_muxes;        // Introduces MUXes first (faster, and often better quality)
+    uint    n_procs;            // Processes for cut enumeration; wide topological levels are split between forked children (1 = serial). Result is independent of this value.
     bool    quiet;
 
     Params_CnfMap() :
@@ -37,6 +38,7 @@ struct Params_CnfMap {
         cuts_per_node(8),
         n_rounds(4),
         intro_muxes(true),
+        n_procs(1),
         quiet(false)
     {}
 };
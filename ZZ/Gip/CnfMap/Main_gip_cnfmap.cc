@@ -32,12 +32,14 @@ int main(int argc, char** argv)
     cli.add("output", "string", ""                         , "Output GNL file (optional).", 1);
     cli.add("N"     , "uint"  , (FMT"%_", P.cuts_per_node) , "Cuts to keep per node.");
     cli.add("iters" , "uint"  , (FMT"%_", P.n_rounds)      , "Number of mapping phases.");
+    cli.add("procs" , "uint"  , (FMT"%_", P.n_procs)       , "Processes for level-parallel cut enumeration.");
     cli.parseCmdLine(argc, argv);
 
     String input  = cli.get("input").string_val;
     String output = cli.get("output").string_val;
     P.cuts_per_node = cli.get("N").int_val;
     P.n_rounds      = cli.get("iters").int_val;
+    P.n_procs       = max_(1u, (uint)cli.get("procs").int_val);
 
     // Read input file:
     double  T0 = cpuTime();
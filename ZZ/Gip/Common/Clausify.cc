@@ -22,7 +22,10 @@ using namespace std;
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
-void clausify(const Gig& F, const Vec<GLit>& roots, MetaSat& S, WMapX<Lit>& f2s, bool init_ffs, Vec<GLit>* new_ffs)
+// 'SAT' is either a 'MetaSat' or a 'TmplRec' (recording clauses for a 'CnfTemplate').
+template<class SAT>
+static
+void clausify_(const Gig& F, const Vec<GLit>& roots, SAT& S, WMapX<Lit>& f2s, bool init_ffs, Vec<GLit>* new_ffs)
 {
     Vec<GLit> Q(copy_, roots);
     Vec<Lit> tmp;
@@ -204,6 +207,12 @@ void clausify(const Gig& F, const Vec<GLit>& roots, MetaSat& S, WMapX<Lit>& f2s,
 }
 
 
+void clausify(const Gig& F, const Vec<GLit>& roots, MetaSat& S, WMapX<Lit>& f2s, bool init_ffs, Vec<GLit>* new_ffs)
+{
+    clausify_(F, roots, S, f2s, init_ffs, new_ffs);
+}
+
+
 Lit clausify(Wire root, MetaSat& S, WMapX<Lit>& f2s, bool init_ffs, Vec<GLit>* new_ffs)
 {
     Vec<GLit> roots(1, root);
@@ -247,5 +256,98 @@ Lit clausify(Wire root, MetaSat& S, Vec<WMapX<Lit> >& f2s, uint depth)
 
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Clause templates:
+
+
+// Stands in for the SAT solver while a template is compiled. Variable 1 is the constant TRUE.
+struct TmplRec {
+    Vec<Lit>& clauses;
+    uint&     n_vars;
+
+    TmplRec(Vec<Lit>& clauses_, uint& n_vars_) : clauses(clauses_), n_vars(n_vars_) {}
+
+    Lit  True() const                    { return Lit(1); }
+    Lit  addLit()                        { return Lit(n_vars++); }
+    void addClause(const Vec<Lit>& ps)   { for (uint i = 0; i < ps.size(); i++) clauses.push(ps[i]); clauses.push(Lit_NULL); }
+    void addClause(Lit p, Lit q)         { clauses.push(p); clauses.push(q); clauses.push(Lit_NULL); }
+    void addClause(Lit p, Lit q, Lit r)  { clauses.push(p); clauses.push(q); clauses.push(r); clauses.push(Lit_NULL); }
+};
+
+
+CnfTemplate::CnfTemplate(const Gig& N_, const Vec<GLit>& roots) :
+    N(N_),
+    n_vars(2)
+{
+    TmplRec R(clauses, n_vars);
+    Vec<GLit> rs(copy_, roots);
+    Vec<GLit> new_ffs;
+    while (rs.size() > 0){
+        new_ffs.clear();
+        clausify_(N, rs, R, n2t, false, &new_ffs);
+
+        // Close the cone over the next-state functions of the flops reached:
+        rs.clear();
+        for (uint i = 0; i < new_ffs.size(); i++){
+            Wire w = new_ffs[i] + N;
+            ffs.push(w);
+            rs.push(w[0]);
+        }
+    }
+
+    For_Gates(N, w){
+        if (n2t[w]){
+            assert(w != gate_Reset);    // -- not supported (would be TRUE in the first frame only)
+            gates.push(w);
+        }
+    }
+}
+
+
+void CnfTemplate::instantiate(MetaSat& S, WMapX<Lit>& n2s, const WMapX<Lit>* prev)
+{
+    vmap.reset(n_vars, Lit_NULL);
+    vmap[1] = S.True();
+    if (!prev) n2i.clear();
+
+    // Bind flops to the previous frame (or their initial values):
+    for (uint i = 0; i < ffs.size(); i++){
+        Wire w = ffs[i] + N;
+        Lit  p;
+        if (prev)
+            p = (*prev)[w[0]];
+        else if (!w[1] || w[1] == GLit_Unbound)
+            p = S.addLit();
+        else
+            p = clausify(w[1], S, n2i, true);
+        assert(p);
+        vmap[n2t[w].id] = p;
+    }
+
+    // Fresh variables for inputs and logic:
+    for (uint x = 2; x < n_vars; x++)
+        if (!vmap[x])
+            vmap[x] = S.addLit();
+
+    // Copy clauses:
+    Vec<Lit>& tmp = tmp_clause;
+    tmp.clear();
+    for (uint i = 0; i < clauses.size(); i++){
+        Lit p = clauses[i];
+        if (p == Lit_NULL){
+            S.addClause(tmp);
+            tmp.clear();
+        }else
+            tmp.push(vmap[p.id] ^ p.sign);
+    }
+
+    for (uint i = 0; i < gates.size(); i++){
+        Lit t = n2t[gates[i]];
+        n2s(gates[i]) = vmap[t.id] ^ t.sign;
+    }
+}
+
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
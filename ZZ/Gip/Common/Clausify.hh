@@ -32,6 +32,40 @@ void clausify(const Gig& N, const Vec<GLit>& roots, MetaSat& S, Vec<WMapX<Lit> >
 Lit  clausify(Wire root                           , MetaSat& S, Vec<WMapX<Lit> >& n2s, uint depth);
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Clause templates for unrolling:
+
+
+// The sequential cone of 'roots' is clausified once into a template over local variables. Each
+// call to 'instantiate()' adds one time-frame by copying the template clauses into the solver,
+// substituting fresh variables for inputs and logic, and the previous frame's literals for flops.
+// This is much cheaper than the multi-frame 'clausify()' above, which re-derives every gate's
+// clauses in every frame (but only for the part of the cone that is needed at that depth).
+//
+// NOTE! 'Reset' and 'PPI' gates are not supported. 'N' must not change while the template is used.
+class CnfTemplate {
+    const Gig&  N;
+    Vec<GLit>   ffs;        // -- flops in the cone
+    Vec<GLit>   gates;      // -- all gates with a template literal
+    WMapX<Lit>  n2t;        // -- gate -> template literal (variable 1 is TRUE)
+    uint        n_vars;
+    Vec<Lit>    clauses;    // -- template clauses, each terminated by 'Lit_NULL'
+
+    WMapX<Lit>  n2i;        // -- solver literals of the logic computing complex initial values
+    Vec<Lit>    vmap;       // }- temporaries for 'instantiate()'
+    Vec<Lit>    tmp_clause; // }
+
+public:
+    CnfTemplate(const Gig& N, const Vec<GLit>& roots);
+
+    void instantiate(MetaSat& S, WMapX<Lit>& n2s, const WMapX<Lit>* prev);
+        // -- Adds one time-frame to 'S', storing its literals in 'n2s'. If 'prev' is NULL, flops
+        // are bound to their initial values, otherwise to their next-state literals in 'prev'.
+
+    uint nVars() const { return n_vars - 2; }   // -- template variables (including flops)
+};
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
 #endif
@@ -3,704 +3,844 @@
 //| Name        : IncPdr.cc
 //| Author(s)   : Niklas Een
 //| Module      : Gip
-//| Description :
+//| Description : Incremental PDR, keeping its proof across runs and netlist modifications.
 //|
 //| (C) Copyright 2010-2014, The Regents of the University of California
 //|________________________________________________________________________________________________
 //|                                                                                  -- COMMENTS --
 //|
+//| Frame 'd' ('R[d]') is the conjunction of the negated cubes of 'F[d]', 'F[d+1]', ... and 'F_inf'.
+//| It over-approximates the states reachable in 'd' steps or less. Frame 0 is the initial states,
+//| which are kept in a separate solver 'SI' (so 'F[0]' is always empty).
+//|
+//| Every cube is a semantic fact about the part of the design in its sequential cone-of-influence
+//| (COI), which is why cubes can survive a netlist change that doesn't touch that COI. A surviving
+//| cube may however have been derived with the help of a cube that was dropped, so after a netlist
+//| change a fixed-point 'R[d] == R[d+1]' is only trusted after checking consecution of every cube
+//| in 'R[d+1]' explicitly.
 //|________________________________________________________________________________________________
 
 #include "Prelude.hh"
-#include "ZZ_Gip.Common.hh"
-#include "ZZ_MetaSat.hh"
-#include "ZZ/Generics/RefC.hh"
-#include "ZZ/Generics/Heap.hh"
-
-/**/#include "ZZ_Gig.IO.hh"
+#include "IncPdr.hh"
 
 namespace ZZ {
 using namespace std;
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// Proof Obligation:
-
-
-static const uint frame_INF  = UINT_MAX - 1;
-static const uint frame_NULL = UINT_MAX - 2;
-static const uint frame_CEX  = UINT_MAX - 3;
-
-
-// A proof obligation (Pobl) is a timed cube 'tcube = (cube, frame)' which has to be blocked,
-// together with a priority 'prio'. Pobls are handled from the smallest frame number to the largest,
-// and for ties, from the smallest priority to the the largest. Each PO stores a reference-counted
-// pointer to the 'next' Pobl that gave rise to it. If property fails, following this chain
-// produces a counterexample.
-//
-struct Pobl_Data {
-    Cube    cube;
-    uint    frame;
-    uint    prio;
-
-    RefC<Pobl_Data> next;
-    uint            refC;
-};
-
+// Helpers:
 
-struct Pobl : RefC<Pobl_Data> {
-    Pobl() : RefC<Pobl_Data>() {}
-        // -- create null object
 
-    Pobl(Cube cube, uint frame, uint prio, Pobl next = Pobl()) :
-        RefC<Pobl_Data>(empty_)
-    {
-        (*this)->cube  = cube;
-        (*this)->frame = frame;
-        (*this)->prio  = prio;
-        (*this)->next  = next;
+static void removeSubsumed(Vec<FCube>& cubes, Cube c)
+{
+    for (uint i = 0; i < cubes.size();){
+        if (c.subsumes(cubes[i].unreach)){
+            cubes[i] = cubes.last();
+            cubes.pop();
+        }else
+            i++;
     }
+}
 
-    Pobl(const RefC<Pobl_Data> p) : RefC<Pobl_Data>(p) {}
-        // -- downcast from parent to child
-};
-
-
-macro bool operator<(const Pobl& x, const Pobl& y) {
-    assert(x); assert(y);
-    return x->frame < y->frame || (x->frame == y->frame && x->prio < y->prio); }
-
-
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// Frame Cube -- 'FCube':
-
-
-struct FCube {
-    Cube    unreach;
-    Cube    trigger;
-    uint    frame;
-    FCube(Cube unreach_ = Cube_NULL, Cube trigger_ = Cube_NULL, uint frame_ = frame_NULL) :
-        unreach(unreach_), trigger(trigger_), frame(frame_) {}
-};
-
-
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// Debug:
-
-
-struct Fmt_Cube {
-    const Gig&  N;
-    const Cube& c;
-    Fmt_Cube(const Gig& N_, const Cube& c_) : N(N_), c(c_) {}
-};
 
-Fmt_Cube fmt(const Gig& N, const Cube& c) { return Fmt_Cube(N, c); }
+static uint findCube(const Vec<FCube>& cubes, Cube c)
+{
+    for (uint i = 0; i < cubes.size(); i++)
+        if (cubes[i].unreach == c)
+            return i;
+    return UINT_MAX;
+}
 
 
-template<> fts_macro void write_(Out& out, const Fmt_Cube& f)
+// Remove cubes containing a flop marked in 'taint'. Triggers of the remaining cubes are reset,
+// since predecessor states may have changed. Returns the number of cubes removed.
+static uint dropTainted(Vec<FCube>& cubes, const Vec<uchar>& taint)
 {
-    if (!f.c)
-        FWrite(out) "<<null>>";
-    else{
-        out += '<';
-        for (uind i = 0; i < f.c.size(); i++){
-            Wire w = f.N[f.c[i]];
-            if (i > 0) out += ' ';
-            if (w == gate_FF)
-                FWrite(out) "%Cs%_", sign(w)?'~':0, w.num();
-            else if (w == gate_PI)
-                FWrite(out) "%Ci%_", sign(w)?'~':0, w.num();
-            else
-                FWrite(out) "%s", w;
+    uint j = 0;
+    for (uint i = 0; i < cubes.size(); i++){
+        Cube c = cubes[i].unreach;
+        bool keep = true;
+        for (uint k = 0; k < c.size(); k++){
+            if (c[k].id >= taint.size() || taint[c[k].id]){
+                keep = false;
+                break; }
+        }
+        if (keep){
+            cubes[j] = cubes[i];
+            cubes[j].trigger = Cube_NULL;
+            cubes[j].recheck = true;
+            j++;
         }
-        out += '>';
     }
+    uint n_dropped = cubes.size() - j;
+    cubes.shrinkTo(j);
+    return n_dropped;
 }
 
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-
-struct Fmt_Frame {
-    uint frame;
-    Fmt_Frame(uint frame_) : frame(frame_) {}
-};
-
-template<> fts_macro void write_(Out& out, const Fmt_Frame& v)
+static void remapCubes(const GigRemap& remap, Vec<FCube>& cubes)
 {
-    if      (v.frame == frame_INF)  FWrite(out) "frame_INF";
-    else if (v.frame == frame_NULL) FWrite(out) "frame_NULL";
-    else if (v.frame == frame_CEX)  FWrite(out) "frame_CEX";
-    else                            FWrite(out) "%_", v.frame;
+    uint j = 0;
+    for (uint i = 0; i < cubes.size(); i++){
+        Vec<GLit> c(copy_, cubes[i].unreach);
+        for (uint k = 0; k < c.size(); k++)
+            c[k] = remap(c[k]);
+
+        bool keep = true;
+        for (uint k = 0; k < c.size(); k++)
+            if (c[k].id == gid_NULL) keep = false;
+        if (keep)
+            cubes[j++] = FCube(Cube(c), Cube_NULL, cubes[i].frame, cubes[i].recheck);
+    }
+    cubes.shrinkTo(j);
 }
 
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Construction and netlist changes:
 
 
-struct Fmt_FCube {
-    const Gig&   N;
-    const FCube& f;
-    Fmt_FCube(const Gig& N_, const FCube& f_) : N(N_), f(f_) {}
-};
+IncPdr::IncPdr(Gig& N_, const Params_IncPdr& P_, Out* out_) :
+    confl0(0),
+    prioC(UINT_MAX),
+    tmp_act(Lit_NULL),
+    prop_depth(0),
+    verify_fix(false),
+    remapped(false),
+    markC(0),
+    N(N_),
+    P(P_),
+    out(out_)
+{
+    if (!out) out = &std_out;
+    N.listen(*this, msg_Update | msg_Remove | msg_Compact);
+}
 
-Fmt_FCube fmt(const Gig& N, const FCube& f) { return Fmt_FCube(N, f); }
 
-template<> fts_macro void write_(Out& out, const Fmt_FCube& v) {
-    FWrite(out) "fcube:{unreach=%_; trigger=%_; frame=%_}", fmt(v.N, v.f.unreach), fmt(v.N, v.f.trigger), Fmt_Frame(v.f.frame); }
+IncPdr::~IncPdr()
+{
+    N.unlisten(*this, msg_Update | msg_Remove | msg_Compact);
+}
 
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void IncPdr::updating(Wire w, uint pin, Wire w_old, Wire w_new)
+{
+    changed.push(+w.lit());
+}
 
 
-struct Fmt_Pobl {
-    const Gig& N;
-    const Pobl& pobl;
-    Fmt_Pobl(const Gig& N_, const Pobl& pobl_) : N(N_), pobl(pobl_) {}
-};
+void IncPdr::removing(Wire w, bool recreated)
+{
+    changed.push(+w.lit());
+}
 
-Fmt_Pobl fmt(const Gig& N, const Pobl& pobl) { return Fmt_Pobl(N, pobl); }
 
-template<> fts_macro void write_(Out& out, const Fmt_Pobl& v) {
-    FWrite(out) "pobl:{cube=%_; frame=%_; prio=%_}", fmt(v.N, v.pobl->cube), v.pobl->frame, v.pobl->prio; }
+void IncPdr::compacting(const GigRemap& remap)
+{
+    for (uint d = 0; d < F.size(); d++)
+        remapCubes(remap, F[d]);
+    remapCubes(remap, F_inf);
+
+    uint j = 0;
+    for (uint i = 0; i < changed.size(); i++){
+        GLit p = remap(changed[i]);
+        if (p) changed[j++] = p;
+    }
+    changed.shrinkTo(j);
 
+    Q.clear();
+    remapped = true;
+}
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+// Bring the SAT solvers and the cubes up to date with the netlist. Cubes over flops whose sequential
+// COI contains a modified gate are dropped; a solver is only rebuilt if it has clausified a
+// modified gate (or if cubes were dropped, which only concerns 'S').
+void IncPdr::sync()
+{
+    if (changed.size() > 0 || remapped){
+        // Compute transitive fanout of modified gates (through flops):
+        Vec<uint> start(N.size() + 1, 0);
+        For_Gates(N, w)
+            For_Inputs(w, v)
+                start[v.id + 1]++;
+        for (uint i = 0; i < N.size(); i++)
+            start[i + 1] += start[i];
+
+        Vec<gate_id> fanouts(start.last());
+        Vec<uint>    pos(copy_, start);
+        For_Gates(N, w)
+            For_Inputs(w, v)
+                fanouts[pos[v.id]++] = w.id;
+
+        Vec<uchar>   taint(N.size(), 0);
+        Vec<gate_id> Q;
+        for (uint i = 0; i < changed.size(); i++){
+            gate_id id = changed[i].id;
+            if (id < N.size() && !taint[id]){
+                taint[id] = 1;
+                Q.push(id); }
+        }
+        while (Q.size() > 0){
+            gate_id id = Q.popC();
+            for (uint j = start[id]; j < start[id + 1]; j++){
+                if (!taint[fanouts[j]]){
+                    taint[fanouts[j]] = 1;
+                    Q.push(fanouts[j]); }
+            }
+        }
 
-struct Fmt_Lit {
-    const Gig& N;
-    const Vec<Lit>& act;
-    const WMapX<Lit>& n2s;
-    Lit p;
-    Fmt_Lit(const Gig& N_, const Vec<Lit>& act_, const WMapX<Lit>& n2s_, Lit p_) : N(N_), act(act_), n2s(n2s_), p(p_) {}
-};
+        // Drop affected cubes:
+        uint n_cubes = nCubes();
+        uint n_dropped = 0;
+        for (uint d = 0; d < F.size(); d++)
+            n_dropped += dropTainted(F[d], taint);
+        n_dropped += dropTainted(F_inf, taint);
+
+        // Flush solvers with outdated CNF:
+        bool flush_S  = remapped || n_dropped > 0;
+        bool flush_SI = remapped;
+        if (!remapped){
+            for (uint i = 0; i < changed.size(); i++){
+                if (n2s [changed[i]]) flush_S  = true;
+                if (n2si[changed[i]]) flush_SI = true;
+            }
+        }
+        if (flush_S)  rebuildS();
+        if (flush_SI) rebuildSI();
 
+        if (n_cubes > n_dropped)
+            verify_fix = true;
+        prop_depth = 0;
+        changed.clear();
+        remapped = false;
 
-template<> fts_macro void write_(Out& out, const Fmt_Lit& v)
-{
-    Lit p = v.p;
-    for (uint j = 0; j < v.act.size(); j++){
-        if (+p == +v.act[j]){
-            FWrite(out) "%Cframe%_", (p.sign == v.act[j].sign) ? 0 : '~', j;
-            return; }
+        if (!P.quiet)
+            FWriteLn(*out) "IncPdr: netlist changed -- kept %_ of %_ cubes%_%_", n_cubes - n_dropped, n_cubes, flush_S ? " -- rebuilt S" : "", flush_SI ? " -- rebuilt SI" : "";
     }
 
-    For_Gatetype(v.N, gate_FF, w){
-        if (v.n2s[w] && +p == +v.n2s[w]){
-            FWrite(out) "%Cs%_", (p.sign == v.n2s[w].sign) ? 0 : '~', w.num();
-            return; }
-
-        if (v.n2s[w[0]] && +p == +v.n2s[w[0]]){
-            FWrite(out) "%Cs%_'", (p.sign == v.n2s[w[0]].sign) ? 0 : '~', w.num();
-            return; }
+    // Bind flops to their initial values in 'SI' (includes flops added since last call):
+    For_Gatetype(N, gate_FF, w){
+        if (n2si[w]) continue;
+        Wire w_init = w[1];
+        if (!w_init || +w_init == GLit_Unbound)
+            n2si(w) = SI.addLit();
+        else
+            n2si(w) = clausify(w_init, SI, n2si, true);
     }
+}
 
-    FWrite(out) "%_", p;
+
+void IncPdr::rebuildS()
+{
+    confl0 += S.nConflicts();
+    S  .clear();
+    n2s.clear();
+    act.clear();
+    tmp_act = Lit_NULL;
+
+    for (uint d = 0; d < F.size(); d++)
+        for (uint i = 0; i < F[d].size(); i++)
+            addCubeToSat(F[d][i]);
+    for (uint i = 0; i < F_inf.size(); i++)
+        addCubeToSat(F_inf[i]);
 }
 
 
-struct Fmt_Lits {
-    const Gig& N;
-    const Vec<Lit>& act;
-    const WMapX<Lit>& n2s;
-    const Vec<Lit>& lits;
-    Fmt_Lits(const Gig& N_, const Vec<Lit>& act_, const WMapX<Lit>& n2s_, const Vec<Lit>& lits_) : N(N_), act(act_), n2s(n2s_), lits(lits_) {}
-};
+void IncPdr::rebuildSI()
+{
+    confl0 += SI.nConflicts();
+    SI  .clear();
+    n2si.clear();
+}
 
 
-template<> fts_macro void write_(Out& out, const Fmt_Lits& v)
+Lit IncPdr::actLit(uint frame)
 {
-    out += '{';
-    for (uint i = 0; i < v.lits.size(); i++){
-        if (i > 0) out += ", ";
-        out += Fmt_Lit(v.N, v.act, v.n2s, v.lits[i]);
-    }
-    out += '}';
+    while (frame >= act.size())
+        act.push(S.addLit());
+    return act[frame];
 }
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// Class 'IncPdr':
+// Frames:
 
 
-class IncPdr {
-    MiniSat2    S;
-    MiniSat2    SI;
-    WMapX<Lit>  n2s;
-    WMapX<Lit>  n2si;
-
-    Vec<lbool>  model;      // -- last model from a SAT call
+uint IncPdr::nCubes() const
+{
+    uint n = F_inf.size();
+    for (uint d = 0; d < F.size(); d++)
+        n += F[d].size();
+    return n;
+}
 
-    uint        prioC;      // -- priority of proof-obligation (lower goes first)
-    Vec<Lit>    act;        // -- activation literals (for 'S' only)
 
-  //________________________________________
-  //  Helper methods:
+uint IncPdr::subsumed(Cube target, uint frame)
+{
+    for (uint i = 0; i < F_inf.size(); i++)
+        if (F_inf[i].unreach.subsumes(target))
+            return frame_INF;
 
-    void  clearSat();
-    Lit   actLit(uint frame);
+    for (uint d = F.size(); d > frame;){ d--;
+        for (uint i = 0; i < F[d].size(); i++)
+            if (F[d][i].unreach.subsumes(target))
+                return d;
+    }
 
-    Cube  extractCore (MiniSat2& S, Cube target, Array<Lit> target_lits);
-    Cube  extractModel(MiniSat2& S, WMapX<Lit>& n2s);
+    return frame_NULL;
+}
 
-    void  addCube      (FCube f);
-    void  checkTriggers(FCube f);
 
-    template<class V>
-    bool  isInit(const V& target, GLit except = GLit_NULL);
+// Add cube, remove subsumed cubes.
+void IncPdr::addCube(FCube f)
+{
+    assert(f.frame > 0);
 
-    FCube solveRel(Cube target, uint frame);
-    FCube pushFwd (Cube target, uint frame, Cube sub_cube, Lit ind_act_lit);
+    uint lim = (f.frame == frame_INF) ? (uint)F.size() : min_(f.frame + 1, (uint)F.size());
+    for (uint d = 0; d < lim; d++)
+        removeSubsumed(F[d], f.unreach);
+    if (f.frame == frame_INF)
+        removeSubsumed(F_inf, f.unreach);
 
-    FCube generalize(FCube f);
-    Cube  weaken(Cube cube, Cube target);
+    if (f.frame != frame_INF){
+        F.growTo(f.frame + 1);
+        F[f.frame].push(f);
+    }else
+        F_inf.push(f);
 
-  //________________________________________
-  //  Debug:
+    addCubeToSat(f);
+}
 
-    Fmt_Pobl  fmt(const Pobl& pobl) const { return Fmt_Pobl(N, pobl); }
-    Fmt_FCube fmt(const FCube& f)   const { return Fmt_FCube(N, f); }
-    Fmt_Cube  fmt(const Cube& c)    const { return Fmt_Cube(N, c); }
 
-    Fmt_Lit   fmt(Lit p)                const { return Fmt_Lit (N, act, n2s, p); }
-    Fmt_Lits  fmt(const Vec<Lit>& lits) const { return Fmt_Lits(N, act, n2s, lits); }
+void IncPdr::addCubeToSat(const FCube& f)
+{
+    Vec<Lit> tmp;
+    if (f.frame != frame_INF)
+        tmp.push(~actLit(f.frame));
+    for (uint i = 0; i < f.unreach.size(); i++)
+        tmp.push(~clausify(f.unreach[i] + N, S, n2s));
+    S.addClause(tmp);
+}
 
-public:
-  //________________________________________
-  //  Public state: [read-only]
 
-    Gig&                N;
-    Out*                out;
+// A new cube 'f' may block the trigger of a cube that previously failed to be pushed; if so, retry
+// the push. Successful pushes may in turn wake up other cubes.
+void IncPdr::checkTriggers(FCube f)
+{
+    Vec<FCube> work(1, f);
+    while (work.size() > 0){
+        FCube g = work.popC();
+
+        Vec<FCube> cands;
+        uint lim = (g.frame == frame_INF) ? (uint)F.size() : min_(g.frame + 1, (uint)F.size());
+        for (uint d = 1; d < lim; d++)
+            for (uint i = 0; i < F[d].size(); i++)
+                if (F[d][i].trigger && g.unreach.subsumes(F[d][i].trigger))
+                    cands.push(F[d][i]);
+
+        for (uint i = 0; i < cands.size(); i++){
+            FCube h = cands[i];
+            uint  idx = findCube(F[h.frame], h.unreach);
+            if (idx == UINT_MAX) continue;      // -- subsumed by a cube added since
+
+            FCube r = pushFwd(h);
+            if (r.frame == h.frame)
+                F[h.frame][idx].trigger = r.trigger;
+            else{
+                addCube(r);
+                work.push(r);
+            }
+        }
+    }
+}
 
-    Vec<Vec<FCube> >    F;
-    Vec<FCube>          F_inf;
-    KeyHeap<Pobl>       Q;
 
-    Pobl                cex;    // -- set when 'solve()' returns 'ip_Cex'
+// Check if 'target' intersects the initial states. If so, 'SI' holds such a state.
+bool IncPdr::isInit(Cube target)
+{
+    Vec<Lit> assumps;
+    for (uint i = 0; i < target.size(); i++)
+        assumps.push(n2si[target[i]]);
 
-  //________________________________________
-  //  Public methods:
+    lbool result = SI.solve(assumps); assert(result != l_Undef);
+    return result == l_True;
+}
 
-    IncPdr(Gig& N_, Out* out_ = NULL);
 
-    uint solve(Cube target, uint frame, double effort = DBL_MAX, bool clear_Q = true);
-        // -- returns the last frame in which 'target' was proved unreachable (most likely 'frame'
-        // itself). 'target' must be expressed in state-variables only. 'frame_INF' means 'target'
-        // is forever unreachable; 'frame_CEX' means counterexample was found (stored in class
-        // global 'cex'); 'frame_NULL' means effort level was exceeded (where a positive effort
-        // means '#conflicts'; negative CPU-time).
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// SAT queries:
 
-    uint subsumed(Cube target, uint frame);
-        // -- returns the latest time-frame where 'target.cube' is syntactically subsumed or
-        // 'frame_NULL' if not subsumed at the frame given by the 'target.frame'.
 
-    // clearQ()
-    // semanticCoi()
+// Can a state of 'target' be reached in one step from 'R[frame]' (the initial states if 'frame' is
+// 0)? If 'ind' is set, the starting state must lie outside 'target' (ignored for 'frame == 0').
+// 'target_lits[i]' is set to the next-state literal of 'target[i]'.
+lbool IncPdr::query(Cube target, uint frame, bool ind, Vec<Lit>& target_lits)
+{
+    bool        init = (frame == 0);
+    MiniSat2&   Z    = init ? SI : S;
+    WMapX<Lit>& n2z  = init ? n2si : n2s;
+    Vec<Lit>    assumps;
 
-    void extractCex(Cex& out_cex);
-};
+    if (tmp_act){
+        S.addClause(~tmp_act);
+        tmp_act = Lit_NULL; }
 
+    if (!init){
+        if (ind){
+            tmp_act = S.addLit();
+            Vec<Lit> cl;
+            cl.push(~tmp_act);
+            for (uint i = 0; i < target.size(); i++)
+                cl.push(~clausify(target[i] + N, S, n2s));
+            S.addClause(cl);
+            assumps.push(tmp_act);
+        }
 
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// Implementation:
+        for (uint d = frame; d < F.size(); d++)
+            assumps.push(actLit(d));
+    }
 
+    target_lits.clear();
+    for (uint i = 0; i < target.size(); i++){
+        Wire w = target[i] + N;
+        target_lits.push(clausify(w[0] ^ w.sign, Z, n2z, init));
+    }
+    append(assumps, target_lits);
 
-IncPdr::IncPdr(Gig& N_, Out* out_) :
-    prioC(UINT_MAX),
-    N(N_),
-    out(out_)
-{
-    if (!out) out = &std_out;
-    clearSat();
-    // <<== perhaps set up a listener for gate deletion and remove cubes when state-variables are deleted
+    lbool result = Z.solve(assumps); assert(result != l_Undef);
+    return result;
 }
 
 
-void IncPdr::clearSat()
+// Extract the subset of 'target' used in the final conflict of 'Z'. Literals are added back
+// until the result no longer intersects the initial states.
+Cube IncPdr::extractCore(MiniSat2& Z, Cube target, const Vec<Lit>& target_lits)
 {
-    S   .clear();
-    SI  .clear();
-    n2s .clear();
-    n2si.clear();
-    act .clear();
-}
+    Vec<Lit> confl;
+    Z.getConflict(confl);
 
+    Vec<GLit> core, rest;
+    for (uint i = 0; i < target.size(); i++)
+        (has(confl, target_lits[i]) ? core : rest).push(target[i]);
 
-Lit IncPdr::actLit(uint frame)
-{
-    while (frame >= act.size()){
-        act.push(S.addLit());
-        /**/WriteLn "@@  activation literal from frame %_ is %_", act.size() - 1, act.last();
+    for(;;){
+        Cube c(core);
+        if (!isInit(c))
+            return c;
+
+        // Add a literal violated by the initial state found (there must be one, since 'target' doesn't intersect 'I'):
+        uint j = 0;
+        while (j < rest.size() && SI.value(n2si[rest[j]]) != l_False) j++;
+        assert(j < rest.size());
+        core.push(rest[j]);
+        rest[j] = rest.last();
+        rest.pop();
     }
-    return act[frame];
 }
 
 
-uint IncPdr::subsumed(Cube target, uint frame)
+// Given a satisfying assignment of 'S', return a subset of the flop values sufficient to justify
+// the values of 'targets'. The corresponding input values are stored in 'pred_inputs'.
+Cube IncPdr::lift(const Vec<GLit>& targets)
 {
-    for (uint i = 0; i < F_inf.size(); i++)
-        if (F_inf[i].unreach.subsumes(target))
-            return frame_INF;
+    markC++;
+    if (markC == 0){
+        mark.clear();
+        markC = 1; }
+    mark.growTo(N.size(), 0);
+
+    Vec<GLit> Q, state, inputs;
+    for (uint i = 0; i < targets.size(); i++)
+        Q.push(+targets[i]);
+
+    while (Q.size() > 0){
+        Wire w = Q.popC() + N;
+        if (mark[w.id] == markC) continue;
+        mark[w.id] = markC;
+
+        switch (w.type()){
+        case gate_Const:
+            break;
+
+        case gate_PI:
+            inputs.push(w.lit() ^ (S.value(n2s[w]) == l_False));
+            break;
+
+        case gate_FF:
+            state.push(w.lit() ^ (S.value(n2s[w]) == l_False));
+            break;
+
+        case gate_And:
+            if (S.value(n2s[w]) == l_True){
+                For_Inputs(w, v)
+                    Q.push(+v);
+            }else{
+                // Pick one controlling input, preferring one already justified:
+                Wire pick = Wire_NULL;
+                For_Inputs(w, v){
+                    if (S.value(n2s[v]) == l_False && (!pick || mark[v.id] == markC))
+                        pick = v; }
+                assert(pick);
+                Q.push(+pick);
+            }
+            break;
 
-    for (uint d = F.size(); d > frame;){ d--;
-        for (uint i = 0; i < F[d].size(); i++)
-            if (F[d][i].unreach.subsumes(target))
-                return d;
+        case gate_Mux:
+            Q.push(+w[0]);
+            Q.push(+((S.value(n2s[w[0]]) == l_True) ? w[1] : w[2]));
+            break;
+
+        default:
+            For_Inputs(w, v)
+                Q.push(+v);
+        }
     }
 
-    return frame_NULL;
+    pred_inputs = Cube(inputs);
+    return Cube(state);
 }
 
 
-// <<== needs to also extract frame (execpt for S = SI)
-Cube IncPdr::extractCore(MiniSat2& S, Cube target, Array<Lit> target_lits)
+// Is 'target' reachable in frame 'frame' from 'R[frame-1]' (assuming 'target' is unreachable in
+// the previous frames)? If UNSAT, returns '(subset-of-target, Cube_NULL, frame)'. If SAT, returns
+// '(predecessor, Cube_NULL, frame_NULL)' with the inputs in 'pred_inputs' -- unless 'frame == 1'
+// where the predecessor is an initial state, in which case the model of 'SI' is left for the
+// caller and a null cube returned.
+FCube IncPdr::solveRel(Cube target, uint frame)
 {
-    Vec<Lit> confl;
-    S.getConflict(confl);
-
-    Vec<GLit> z(copy_, target);
-    for (uint i = 0; i < z.size(); i++){
-        if (!has(confl, target_lits[i])){
-            GLit tmp = z[i];
-            z[i] = GLit_NULL;
-            if (isInit(z))
-                z[i] = tmp;
-        }
+    assert(frame != 0);
+    Vec<Lit> target_lits;
+    lbool result = query(target, frame - 1, true, target_lits);
+
+    if (result == l_False)
+        return FCube(extractCore((frame == 1) ? SI : S, target, target_lits), Cube_NULL, frame);
+    else if (frame == 1)
+        return FCube();
+    else{
+        Vec<GLit> next;
+        for (uint i = 0; i < target.size(); i++)
+            next.push((target[i] + N)[0]);
+        return FCube(lift(next));
     }
-    filterOut(z, isNull<GLit>);
-    /**/WriteLn "..............extractCore: %_ -> %_   (confl=%_)", fmt(target), fmt(Cube(z)), fmt(confl);
-    return Cube(z);
 }
 
 
-Cube IncPdr::extractModel(MiniSat2& S, WMapX<Lit>& n2s)
+// Given 'f.unreach' is unreachable in frame 'f.frame', return the latest frame where it is
+// unreachable, together with the trigger (predecessor) that stopped it from being pushed further.
+// Cubes are not pushed beyond the last frame 'F.size() - 1' unless they go to 'F_inf'.
+FCube IncPdr::pushFwd(FCube f)
 {
-    Vec<GLit> model(reserve_, N.enumSize(gate_FF));
-    For_Gatetype(N, gate_FF, w){
-        lbool v = S.value(n2s[w]); assert(v != l_Undef);
-        model.push(w ^ (v == l_False));
+    Vec<Lit> target_lits;
+    for (uint d = f.frame;; d++){
+        bool last = true;      // -- all frames from 'd' are empty, so 'R[d]' is 'F_inf'
+        for (uint e = d; e < F.size(); e++)
+            if (F[e].size() > 0){ last = false; break; }
+
+        if (query(f.unreach, d, true, target_lits) == l_True){
+            Vec<GLit> next;
+            for (uint i = 0; i < f.unreach.size(); i++)
+                next.push((f.unreach[i] + N)[0]);
+            return FCube(f.unreach, lift(next), d);
+        }
+        if (last)
+            return FCube(f.unreach, Cube_NULL, frame_INF);
+        if (d + 2 >= F.size())
+            return FCube(f.unreach, Cube_NULL, d + 1);
     }
-    return Cube(model);
 }
 
 
-// <<== add support for pobls at frame infinity
-uint IncPdr::solve(Cube target, uint frame, double effort, bool clear_Q)
+// Try to remove literals one by one, keeping the cube relatively inductive.
+FCube IncPdr::generalize(FCube f)
 {
-    for (uint i = 0; i < target.size(); i++)
-        assert(target[i] + N == gate_FF);
-    assert(!isInit(target));
+    Cube c = f.unreach;
+    Vec<GLit> lits(copy_, c);
+    for (uint i = 0; i < lits.size() && c.size() > 1; i++){
+        if (!has(c.base(), lits[i])) continue;
 
-    // <<== if anything was deleted, flush SAT solvers so than CNF generation will be up to date.
+        Cube d = c - lits[i];
+        if (isInit(d)) continue;
 
-    uint d0 = subsumed(target, 1);
-    /**/Dump(d0);
-    if (d0 == frame_NULL)
-        d0 = 0;
-    else if (d0 >= frame)
-        return d0;
-
-    // <<== move target to first non-subsumed position
+        FCube r = solveRel(d, f.frame);
+        if (r.frame != frame_NULL)
+            c = r.unreach;
+    }
+    return FCube(c, Cube_NULL, f.frame);
+}
 
-    if (clear_Q){
-        Q.clear();
-        prioC = UINT_MAX; }
-    Q.add(Pobl(target, d0 + 1, prioC--));
 
-    for(;;){
-        Pobl po = Q.pop();
-        /**/WriteLn "-----------------------------------------------------------------------------";
-        /**/WriteLn "-- Popped pobl: \a/%_\a/", fmt(po);
-
-        assert(po->frame > 0);
-        uint d = subsumed(po->cube, po->frame);
-        if (d == frame_NULL){
-            // Pobl was not proved yet:
-            FCube f = solveRel(po->cube, po->frame);
-            /**/WriteLn "solveRel(\a/%_\a/, \a/%_\a/) -> \a/%_\a/", fmt(po->cube), po->frame, fmt(f);
-            if (f.frame == frame_NULL){
-                if (isInit(f.unreach)){
-                    // Found CEX:
-                    cex = Pobl(f.unreach, po->frame - 1, prioC--, po);
-                    return frame_CEX;
-                }else{
-                    // SAT -- extract model and create new pobl:
-                    Cube c = weaken(f.unreach, po->cube);
-                    /**/WriteLn "Added pobl: %_", fmt(Pobl(c, po->frame - 1, prioC, po));
-                    Q.add(Pobl(c, po->frame - 1, prioC--, po));
-                }
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main procedures:
 
-            }else{
-                // UNSAT -- generalize cube, check triggers, check termination:
-                f = generalize(f);
-                /**/WriteLn "Adding fcube: \a/%_\a/", fmt(f);
-                addCube(f);
-                checkTriggers(f);   // <<== problematic if this cube is affected? probably not
-                po->frame = f.frame;
-                d         = f.frame;
-            }
 
-        }else{
-            /**/WriteLn "subsumed at depth: %_", Fmt_Frame(d);
-            po->frame = d; }
-
-        if (d != frame_NULL){
-            if (!po->next){
-                // Pobl equals target and was proved:
-                /**/WriteLn "TERMINATION: po->cube=%_  target=%_", fmt(po->cube), fmt(target);
-                assert(po->cube == target && d >= frame);
-                    // <<== rather, if 'd < frame', continue...
-                return d;
-            }
+// 'F[frame]' is empty, so 'R[frame] == R[frame+1]'. Unless cubes have survived a netlist change,
+// this makes 'R[frame]' inductive. Otherwise consecution is checked for every surviving cube of
+// 'R[frame+1]' (all other cubes were derived relative to the current netlist, and frames only get
+// stronger); failing cubes are moved down to 'F[frame]' (where they are still valid). A passing
+// cube is not checked again if it ends up in the invariant, or if it was checked relative to the
+// frame right below it. 'verify_fix' is cleared once no surviving cube remains.
+bool IncPdr::verifyFixpoint(uint frame)
+{
+    if (!verify_fix) return true;
 
-            if (po->frame != frame_INF)
-                po->frame++;
+    Vec<FCube> failed;
+    Vec<Lit>   target_lits;
+    for (uint d = frame + 1; d <= F.size(); d++){
+        Vec<FCube>& Fd = (d < F.size()) ? F[d] : F_inf;
+        uint j = 0;
+        for (uint i = 0; i < Fd.size(); i++){
+            if (Fd[i].recheck && query(Fd[i].unreach, frame, false, target_lits) == l_True)
+                failed.push(FCube(Fd[i].unreach, Cube_NULL, frame, true));
+            else
+                Fd[j++] = Fd[i];
         }
-
-        // Re-insert pobl at the right time-frame:
-        if (po->frame < frame_INF){
-            /**/WriteLn "Re-enqueuing pobl: %_", fmt(po);
-            Q.add(po); }
-
-#if 0
-        // Check effort:    <<==
-        if (<resources exhausted>)
-            return frame_NULL;
-#endif
+        Fd.shrinkTo(j);
     }
-}
-
-
-// Add cube, remove subsumed cubes.
-void IncPdr::addCube(FCube f)
-{
-    assert(f.frame > 0);
 
-    // Remove (some) subsumed cubes:
-    uint lim = min_(f.frame, (uint)F.size());
-    if (f.frame == frame_INF)
-        lim++;
-    for (uint d = 0; d <= lim; d++){
-        Vec<FCube>& Fd = (d < F.size()) ? F[d] : F_inf;
-        for (uint i = 0; i < Fd.size();){
-            if (subsumes(f.unreach, Fd[i].unreach)){
-                /**/if (!(f.unreach != Fd[i].unreach || f.frame > d)) WriteLn "WARNING! Derived existing cube!!!";
-//                assert(f.unreach != Fd[i].unreach || f.frame > d);   // -- should never derive existing cube
-                Fd[i] = Fd.last();
-                Fd.pop();
-            }else
-                i++;
+    if (failed.size() == 0){
+        // All cubes above 'frame' will form the invariant (which is now known to be inductive):
+        verify_fix = false;
+        for (uint d = 0; d <= F.size(); d++){
+            Vec<FCube>& Fd = (d < F.size()) ? F[d] : F_inf;
+            for (uint i = 0; i < Fd.size(); i++){
+                if (d > frame) Fd[i].recheck = false;
+                else if (Fd[i].recheck) verify_fix = true;
+            }
         }
+        return true;
     }
 
-    // Add cube to trace:
-    ((f.frame != frame_INF) ? F[f.frame] : F_inf).push(f);
+    if (frame + 1 < F.size()){
+        for (uint i = 0; i < F[frame + 1].size(); i++)
+            F[frame + 1][i].recheck = false;
+    }
 
-    // Add cube to SAT solvers:
-    Vec<Lit> tmp;
-    if (f.frame != frame_INF)
-        tmp.push(~actLit(f.frame));
-    for (uint i = 0; i < f.unreach.size(); i++)
-        tmp.push(~clausify(f.unreach[i] + N, S, n2s));
-    /**/WriteLn "\a^~~ adding to solver:\a^ %_ = clause %_", fmt(f), fmt(tmp);
-    S.addClause(tmp);
+    if (!P.quiet)
+        FWriteLn(*out) "IncPdr: %_ cubes failed consecution after netlist change", failed.size();
+    append(F[frame], failed);
+    rebuildS();
+    return false;
 }
 
 
-// Check triggers and push cubes forward.
-void IncPdr::checkTriggers(FCube f)
+// Push cubes of frames '1..depth' forward, then look for a fixed-point.
+bool IncPdr::propagate(uint depth)
 {
-    /**/WriteLn "== checkTriggers(%_)", fmt(f);
-    for (uint d = 1; d < min_(F.size(), f.frame); d++){
-        for (uint i = 0; i < F[d].size(); i++){
-            if (f.unreach.subsumes(F[d][i].trigger)){
-                /**/WriteLn "==:: woke up: %_", fmt(F[d][i]);
-                FCube g = solveRel(F[d][i].unreach, d + 1);
-                /**/WriteLn "==:: return: %_", fmt(g);
-                if (g.frame == frame_NULL){
-                    F[d][i].trigger = weaken(g.unreach, F[d][i].trigger);
-                }else{
-                    g = generalize(g);
-                    addCube(g);
-                    checkTriggers(g);   // <<== use queue instead of recursion?
-                }
+    F.growTo(depth + 2);
+    for (uint d = 1; d <= depth; d++){
+        Vec<FCube> cands(copy_, F[d]);
+        for (uint i = 0; i < cands.size(); i++){
+            uint idx = findCube(F[d], cands[i].unreach);
+            if (idx == UINT_MAX) continue;
+
+            FCube r = pushFwd(F[d][idx]);
+            if (r.frame == d)
+                F[d][idx].trigger = r.trigger;
+            else{
+                addCube(r);
+                checkTriggers(r);
             }
         }
     }
+    return fixpoint(depth);
 }
 
 
-// Checks if 'target' is consistent with the initial states. If not, it optionally returns a subset
-// a subset of 'target' enough to cause a contradiction.
-template<class V>
-bool IncPdr::isInit(const V& target, GLit except)
+// Look for an empty frame among '1..depth'. If found, the frames above it are moved to 'F_inf'
+// and TRUE is returned.
+bool IncPdr::fixpoint(uint depth)
 {
-    // <<== improve this for 0/1/X initialization?
-
-    // Check for containment:
-    Vec<Lit> assumps;
-    for (uint i = 0; i < target.size(); i++){
-        if (!target[i] || target[i] == except) continue;
-        assumps.push(clausify(target[i] + N, SI, n2si, true));
+    for (uint d = 1; d <= depth; d++){
+        if (F[d].size() == 0 && verifyFixpoint(d)){
+            for (uint e = d + 1; e < F.size(); e++){
+                for (uint i = 0; i < F[e].size(); i++){
+                    FCube f(F[e][i].unreach, Cube_NULL, frame_INF);
+                    F_inf.push(f);
+                    addCubeToSat(f);
+                }
+                F[e].clear();
+            }
+            return true;
+        }
     }
-
-    lbool result = SI.solve(assumps); assert(result != l_Undef);
-    /**/Write "isInit({"; /**/for (uint i = 0; i < target.size(); i++) if (target[i]) Write " %_", (target[i] + N); WriteLn " } = %_", result;
-    return result == l_True;
+    return false;
 }
 
 
-// Assuming 'cube' is unreachable in frame 'frame', return the latest frame where it is
-// unreachable. If SAT solver gives information for free, a subset of 'cube' may be returned.
-// This information may optionally be seeded by using 'sub_cube' (the default null-value
-// will be replace by 'cube' itself).
-FCube IncPdr::pushFwd(Cube target, uint frame, Cube sub_cube, Lit ind_act_lit)
+// Process proof-obligations until the queue is empty. Returns 'frame_CEX' if a counterexample was
+// found, 'frame_NULL' if resources ran out, otherwise 0.
+uint IncPdr::block(uint depth, uint64 confl_lim, double cpu_lim)
 {
-/**/WriteLn "pushFwd(target=%_, frame=%_, sub_cube=%_, ind_act_lit=%_)\t+\t+", fmt(target), Fmt_Frame(frame), fmt(sub_cube), ind_act_lit;
-
-    if (!sub_cube)
-        sub_cube = target;
-
-    Vec<Lit> assumps(reserve_, target.size() + 1 + F.size());
-    for (uint i = 0; i < target.size(); i++)
-        assumps.push(~clausify((target[i] + N)[0], S, n2s));
-    Array<Lit> target_lits = assumps.slice();   // <<== memory error!!!
-    /**/WriteLn "\a/\a*pre-assumps:\a0 %_", fmt(assumps);
+    while (Q.size() > 0){
+        if (nConflicts() >= confl_lim || cpuTime() >= cpu_lim)
+            return frame_NULL;
 
-    if (ind_act_lit)
-        assumps.push(ind_act_lit);
+        Pobl po = Q.pop();
+        if (subsumed(po->cube, po->frame) != frame_NULL)
+            continue;
 
-    /**/F(frame + 1);   // <<== temporary (vad skall vara här egentligen??)
+        if (isInit(po->cube)){
+            buildCex(po, false);
+            return frame_CEX; }
 
-    uint first_act = assumps.size();
-    for (uind i = F.size(); i > frame;){ i--;
-        assumps.push(actLit(i)); }
+        FCube f = solveRel(po->cube, po->frame);
+        if (f.frame == frame_NULL){
+            if (po->frame == 1){
+                buildCex(po, true);
+                return frame_CEX; }
 
-    for (uint d = frame; assumps.size() >= first_act; d++, assumps.pop()){
-        lbool result = S.solve(assumps); assert(result != l_Undef);
-        /**/WriteLn "\a/\a*assumps:\a0 %_  ~~> solve=%_", fmt(assumps), result;
-        if (result == l_True){
-            /**/Write "\t-\t-";
-            return FCube(sub_cube, extractModel(S, n2s), d); }
+            Q.add(Pobl(f.unreach, pred_inputs, po->frame - 1, prioC--, po));
+            Q.add(po);
 
-        //<<== fix!!   sub_cube = extractCore(S, target, target_lits);
+        }else{
+            f = generalize(f);
+            f = pushFwd(f);
+            addCube(f);
+            checkTriggers(f);
+
+            if (f.frame < depth){
+                po->frame = f.frame + 1;
+                Q.add(po); }
+        }
     }
-    /**/Write "\t-\t-";
-
-    return FCube(sub_cube, Cube_NULL, frame_INF);    // -- cube belongs to 'F_inf'
+    return 0;
 }
 
 
-// See if cube 'target' can be reached in frame 'frame' using what we know about
-// previous time frame (+ inductive assumption, using 'target' itself).
-// If SAT: returns '(predecessor-minterm, Cube_NULL, frame_NULL)'
-// If UNSAT: returns '(subset-of-target, trigger-cube, last-frame-target-is-unreach)'
-FCube IncPdr::solveRel(Cube target, uint frame)
+// Build counterexample from the initial state in the last model of 'SI' followed by the inputs
+// stored in the chain of proof-obligations starting at 'po'. If 'si_inputs' is set, the model of
+// 'SI' also contains the inputs of the first transition.
+void IncPdr::buildCex(Pobl po, bool si_inputs)
 {
-    assert(frame != 0);
-    bool        init = (frame == 1);
-    MiniSat2&   Z    = init ? SI : S;
-    WMapX<Lit>& n2z  = init ? n2si : n2s;
-    Vec<Lit>    assumps;
-
-    /**/WriteLn "solveRel(target=%_, frame=%_): init = %_", fmt(target), Fmt_Frame(frame), init;
-
-    // Inductive assumption:
-    Lit tmp_act = S.addLit();       // <<== bör göras senare om 'init'
-    /**/WriteLn "temporary activator: %_", tmp_act;
-    Vec<Lit> cl;
-    cl.push(~tmp_act);
-    for (uint i = 0; i < target.size(); i++)
-        cl.push(clausify(~target[i] + N, Z, n2z, init));
-    S.addClause(cl);
-    if (!init)
-        assumps.push(tmp_act);
-
-    // Activate cubes of 'F[frame]' and later:
-    if (!init){
-        for (uint i = frame-1; i < F.size(); i++){
-            /**/WriteLn "~~ assuming: act[%_] = %_", i, actLit(i);
-            assumps.push(actLit(i)); }
+    uint len = si_inputs ? 1 : 0;
+    for (Pobl p = po; p; p = p->next)
+        len++;
+
+    cex.pi .clear();
+    cex.ff .clear();
+    cex.ppi.clear();
+    cex.init(len, N.enumSize(gate_PI), N.enumSize(gate_FF), N.enumSize(gate_PPI));
+
+    For_Gatetype(N, gate_FF, w)
+        cex.ff(w) = SI.value(n2si[w]);
+
+    uint d = 0;
+    if (si_inputs){
+        For_Gatetype(N, gate_PI, w)
+            if (n2si[w])
+                cex.pi[0](w) = SI.value(n2si[w]);
+        d++;
     }
 
-    // Assume 's' at state outputs:
-    /**/WriteLn "Adding target to assumps: %_\t+\t+", fmt(target);
-    uint first_target = assumps.size();
-    for (uint i = 0; i < target.size(); i++){
-        Wire w = target[i] + N;
-        assumps.push(clausify(w[0] ^ w.sign, Z, n2z, init));
-        /**/WriteLn "%f -> LIT: %_", w[0] ^ w.sign, fmt(assumps.last());
+    for (Pobl p = po; p; p = p->next, d++){
+        for (uint i = 0; i < p->inputs.size(); i++){
+            Wire w = p->inputs[i] + N;
+            cex.pi[d](+w) = lbool_lift(!w.sign);
+        }
     }
-    /**/Write "\t-\t-";
-    Array<Lit> target_lits = assumps.slice(first_target);
-
-    // Solve:
-    lbool result = Z.solve(assumps); assert(result != l_Undef);
-    /**/WriteLn "\a/SOLVER:\a/ returned %_", result;
-
-    FCube ret = (result == l_True) ? FCube(extractModel(Z, n2z)) :
-                /*otherwise*/        pushFwd(target, frame, extractCore(Z, target, target_lits), tmp_act);
-
-        // <<== är det ett propblem att Lit_NULL används om init? Borde inte inductive assumptions göras i S först?
-
-    // Cleanup:
-//    Z.addClause(~tmp_act);        // <<== skicka med till addCube ist.
-    return ret;
 }
 
 
-FCube IncPdr::generalize(FCube cube)
+uint IncPdr::solve(Wire bad, uint frame, double effort)
 {
-    // <<== later!
-    return cube;
-}
+    sync();
+    Q.clear();
+
+    uint64 confl_lim = (effort >= 0 && effort != DBL_MAX) ? nConflicts() + uint64(effort) : UINT64_MAX;
+    double cpu_lim   = (effort < 0) ? cpuTime() - effort : DBL_MAX;
+
+    // Initial states:
+    if (SI.solve(clausify(bad, SI, n2si, true)) == l_True){
+        buildCex(Pobl(), true);
+        return frame_CEX; }
+
+    for (uint k = 1; k <= frame; k++){
+        F.growTo(k + 2);
+
+        // Block all bad states of frame 'k':
+        for(;;){
+            if (nConflicts() >= confl_lim || cpuTime() >= cpu_lim)
+                return frame_NULL;
+
+            Vec<Lit> assumps;
+            assumps.push(clausify(bad, S, n2s));
+            for (uint d = k; d < F.size(); d++)
+                assumps.push(actLit(d));
+
+            lbool result = S.solve(assumps); assert(result != l_Undef);
+            if (result == l_False)
+                break;
+
+            Cube c = lift(Vec<GLit>(1, bad.lit()));
+            Q.add(Pobl(c, pred_inputs, k, prioC--));
+            uint ret = block(k, confl_lim, cpu_lim);
+            if (ret != 0)
+                return ret;
+        }
 
+        // Propagate (only once per frame unless netlist changed):
+        if (k > prop_depth){
+            prop_depth = k;
+            if (propagate(k)) return frame_INF;
 
-Cube IncPdr::weaken(Cube cube, Cube target)
-{
-    assert(!isInit(cube));
-    // <<== later!
-    return cube;
+            if (!P.quiet)
+                FWriteLn(*out) "IncPdr: frame %_ -- cubes %_  (invariant %_)  [%t]", k, nCubes(), F_inf.size(), cpuTime();
+
+        }else if (fixpoint(k))
+            return frame_INF;
+    }
+
+    return frame;
 }
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Engine:
 
 
-void testPdr(Gig& N0)
+void incPdr(Gig& N, const Params_IncPdr& P, EngRep& R, const Vec<uint>& props)
 {
-#if 1   /*DEBUG*/
-    WriteLn "Original netlist:";
-    For_Gates(N0, w)
-        WriteLn "  %f", w;
-#endif  /*END DEBUG*/
-
-    Vec<GLit> sinks(1, N0.enumGate(gate_SafeProp, 0));
-
-    Gig N;
-    prepareNetlist(N0, sinks, N);
+    IncPdr    pdr(N, P, R.out);
+    Vec<uint> solved;
+
+    for (uint i = 0; i < props.size(); i++){
+        Prop prop(pt_Safe, props[i]);
+        Wire bad = ~N(gate_SafeProp, props[i])[0];
+
+        for (uint k = 0; !has(solved, props[i]); k++){
+            uint d = pdr.solve(bad, k);
+            if (d == frame_INF){
+                R.proved(prop);
+                break;
+            }else if (d == frame_CEX){
+                pdr.cex.prop = prop;
+                R.cex(prop, pdr.cex);
+                break;
+            }
+            R.bugFreeDepth(prop, d);
+
+            // Check for externally solved properties:
+            Prop p;
+            bool status;
+            while (R.wasSolved(p, status))
+                if (p.type == pt_Safe)
+                    solved.push(p.num);
+        }
+    }
 
-    IncPdr pdr(N);
-    Wire w_prop = N.enumGate(gate_SafeProp, 0);
-    Wire w_bad = ~w_prop[0] ^ w_prop.sign;;
-    w_bad = N.add(gate_FF).init(N.add(gate_Seq).init(w_bad), ~GLit_True);
+    if (!P.quiet)
+        FFWriteLn(R) "CPU-time: %t", cpuTime();
+}
 
-#if 1   /*DEBUG*/
-    WriteLn "Prepared netlist:";
-    For_Gates(N, w)
-        WriteLn "  %f", w;
 
-    writeDot("prepared.dot", N);
-    WriteLn "Wrote: prepared.dot";
-#endif  /*END DEBUG*/
+void incPdr(Gig& N, const Params_IncPdr& P, EngRep& R)
+{
+    Vec<uint> props;
+    For_Gatetype(N, gate_SafeProp, w)
+        props.push(w.num());
 
-#if 1   /*DEBUG*/
-    for (uint d = 1; d < 7; d++){
-        uint k = pdr.solve(Cube(w_bad), d);
-        WriteLn "\a*RETURN: depth=%_  result=%_\a*", d, Fmt_Frame(k);
-    }
-#endif  /*END DEBUG*/
+    incPdr(N, P, R, props);
 }
 
 
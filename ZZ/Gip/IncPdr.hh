@@ -3,24 +3,205 @@
 //| Name        : IncPdr.hh
 //| Author(s)   : Niklas Een
 //| Module      : Gip
-//| Description :
+//| Description : Incremental PDR, keeping its proof across runs and netlist modifications.
 //|
 //| (C) Copyright 2010-2014, The Regents of the University of California
 //|________________________________________________________________________________________________
 //|                                                                                  -- COMMENTS --
-//|
+//| 'IncPdr' works directly on the user's netlist and listens to its modifications. Frames and the
+//| invariant ('F_inf') are properties of the design, not of the property being checked, so they
+//| are kept between calls to 'solve()'. When the netlist changes, only cubes over flops whose
+//| sequential cone-of-influence contains a modified gate are dropped, and the SAT solvers are
+//| only rebuilt if a modified gate had been clausified.
 //|________________________________________________________________________________________________
 
 #ifndef ZZ__Gip__IncPdr_hh
 #define ZZ__Gip__IncPdr_hh
+
+#include "ZZ_Gip.Common.hh"
+#include "ZZ_MetaSat.hh"
+#include "ZZ/Generics/RefC.hh"
+#include "ZZ/Generics/Heap.hh"
+
 namespace ZZ {
 using namespace std;
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Proof Obligation:
+
+
+static const uint frame_INF  = UINT_MAX - 1;
+static const uint frame_NULL = UINT_MAX - 2;
+static const uint frame_CEX  = UINT_MAX - 3;
+
+
+// A proof obligation (Pobl) is a timed cube 'tcube = (cube, frame)' which has to be blocked,
+// together with a priority 'prio'. Pobls are handled from the smallest frame number to the largest,
+// and for ties, from the smallest priority to the the largest. Each PO stores a reference-counted
+// pointer to the 'next' Pobl that gave rise to it, and the input values 'inputs' that take a state
+// of 'cube' into 'next' (or make the property fail if 'next' is null). If property fails,
+// following this chain produces a counterexample.
+//
+struct Pobl_Data {
+    Cube    cube;
+    Cube    inputs;
+    uint    frame;
+    uint    prio;
+
+    RefC<Pobl_Data> next;
+    uint            refC;
+};
+
+
+struct Pobl : RefC<Pobl_Data> {
+    Pobl() : RefC<Pobl_Data>() {}
+        // -- create null object
+
+    Pobl(Cube cube, Cube inputs, uint frame, uint prio, Pobl next = Pobl()) :
+        RefC<Pobl_Data>(empty_)
+    {
+        (*this)->cube   = cube;
+        (*this)->inputs = inputs;
+        (*this)->frame  = frame;
+        (*this)->prio   = prio;
+        (*this)->next   = next;
+    }
+
+    Pobl(const RefC<Pobl_Data> p) : RefC<Pobl_Data>(p) {}
+        // -- downcast from parent to child
+};
+
+
+macro bool operator<(const Pobl& x, const Pobl& y) {
+    assert(x); assert(y);
+    return x->frame < y->frame || (x->frame == y->frame && x->prio < y->prio); }
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Frame Cube -- 'FCube':
+
+
+// 'unreach' is unreachable in all frames upto and including 'frame'. If an attempt to push it
+// further failed, 'trigger' is the predecessor state that prevented it; the push is retried when
+// a new cube blocks 'trigger'.
+struct FCube {
+    Cube    unreach;
+    Cube    trigger;
+    uint    frame;
+    bool    recheck;    // -- survived a netlist change; consecution not yet re-established
+    FCube(Cube unreach_ = Cube_NULL, Cube trigger_ = Cube_NULL, uint frame_ = frame_NULL, bool recheck_ = false) :
+        unreach(unreach_), trigger(trigger_), frame(frame_), recheck(recheck_) {}
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'IncPdr':
+
+
+struct Params_IncPdr {
+    bool    quiet;
+
+    Params_IncPdr() :
+        quiet(false)
+    {}
+};
+
+
+class IncPdr : public GigLis {
+    MiniSat2    S;          // -- flops are free variables (current state), their 'Seq' inputs next state
+    MiniSat2    SI;         // -- flops are bound to their initial values
+    WMapX<Lit>  n2s;
+    WMapX<Lit>  n2si;
+    uint64      confl0;     // -- conflicts spent in solvers that have since been rebuilt
+
+    uint        prioC;      // -- priority of proof-obligation (lower goes first)
+    Vec<Lit>    act;        // -- activation literals (for 'S' only)
+    Lit         tmp_act;    // -- activation literal of the last inductive assumption (retired lazily)
+    uint        prop_depth; // -- 'propagate()' has been run for all frames upto this one
+    bool        verify_fix; // -- some cubes have 'recheck' set; fixed-points must be verified
+
+    Vec<GLit>   changed;    // -- gates modified or removed since last 'sync()'
+    bool        remapped;   // -- netlist was compacted since last 'sync()'
+    Cube        pred_inputs;// -- input values of the last lifted predecessor
+
+    Vec<uint>   mark;       // -- used by 'lift()'
+    uint        markC;
+
+  //________________________________________
+  //  Helper methods:
+
+    void   sync();
+    void   rebuildS();
+    void   rebuildSI();
+    Lit    actLit(uint frame);
+    uint64 nConflicts() const { return confl0 + S.nConflicts() + SI.nConflicts(); }
+
+    lbool  query(Cube target, uint frame, bool ind, Vec<Lit>& target_lits);
+    Cube   extractCore(MiniSat2& Z, Cube target, const Vec<Lit>& target_lits);
+    Cube   lift(const Vec<GLit>& targets);
+    bool   isInit(Cube target);
+
+    void   addCube      (FCube f);
+    void   addCubeToSat (const FCube& f);
+    void   checkTriggers(FCube f);
+
+    FCube  solveRel  (Cube target, uint frame);
+    FCube  pushFwd   (FCube f);
+    FCube  generalize(FCube f);
+    bool   verifyFixpoint(uint frame);
+    bool   propagate (uint depth);
+    bool   fixpoint  (uint depth);
+    uint   block     (uint depth, uint64 confl_lim, double cpu_lim);
+    void   buildCex  (Pobl po, bool si_inputs);
+
+public:
+  //________________________________________
+  //  Public state: [read-only]
+
+    Gig&                    N;
+    Params_IncPdr           P;
+    Out*                    out;
+
+    Vec<Vec<FCube> >    F;
+    Vec<FCube>          F_inf;
+    KeyHeap<Pobl>       Q;
+
+    Cex                 cex;    // -- set when 'solve()' returns 'frame_CEX'
+
+  //________________________________________
+  //  Public methods:
+
+    IncPdr(Gig& N_, const Params_IncPdr& P_ = Params_IncPdr(), Out* out_ = NULL);
+   ~IncPdr();
+
+    uint solve(Wire bad, uint frame = frame_INF, double effort = DBL_MAX);
+        // -- returns the last frame in which 'bad' was proved unreachable (most likely 'frame'
+        // itself). 'frame_INF' means 'bad' is forever unreachable; 'frame_CEX' means counterexample
+        // was found (stored in 'cex'); 'frame_NULL' means effort level was exceeded (where a
+        // positive effort means '#conflicts'; negative CPU-time).
+
+    uint subsumed(Cube target, uint frame);
+        // -- returns the latest time-frame where 'target' is syntactically subsumed or
+        // 'frame_NULL' if not subsumed at the frame given by 'frame'.
+
+    uint nCubes() const;
+
+    // Netlist listener:
+    void updating  (Wire w, uint pin, Wire w_old, Wire w_new);
+    void removing  (Wire w, bool recreated);
+    void compacting(const GigRemap& remap);
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Engine:
 
 
-void testPdr(Gig& N0);
+void incPdr(Gig& N, const Params_IncPdr& P, EngRep& R, const Vec<uint>& props);
+void incPdr(Gig& N, const Params_IncPdr& P, EngRep& R);
+    // -- Properties are solved one by one on the same 'IncPdr' object, so invariants found for
+    // earlier properties are reused for later ones.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -191,6 +191,10 @@ int main(int argc, char** argv)
 
     // Commandline:
     cli.add("input", "string", arg_REQUIRED, "Input AIGER.", 0);
+    cli.add("eng"  , "{bmc, pdr}", "bmc", "Verification engine.");
+    cli.add("quiet", "bool", "no", "Suppress progress output.");
+    cli.add("tmpl" , "bool", "no", "BMC: unroll by instantiating a precompiled clause template per time-frame.");
+    cli.add("cnf-procs", "uint", "1", "BMC: processes for level-parallel cut enumeration in the CNF mapper.");
     cli.parseCmdLine(argc, argv);
     String input  = cli.get("input").string_val;
 
@@ -210,11 +214,18 @@ int main(int argc, char** argv)
         exit(1);
     }
 
-    Params_Bmc P;
     DefaultRep rep(N);
-    P.sat_solver = sat_Msc;
-    bmc(N, P, rep);
-//    testPdr(N);
+    if (cli.get("eng").enum_val == 0){
+        Params_Bmc P;
+        P.sat_solver = sat_Msc;
+        P.cnf_template = cli.get("tmpl").bool_val;
+        P.cnf_procs    = max_(1u, (uint)cli.get("cnf-procs").int_val);
+        bmc(N, P, rep);
+    }else{
+        Params_IncPdr P;
+        P.quiet = cli.get("quiet").bool_val;
+        incPdr(N, P, rep);
+    }
 
 
     return 0;
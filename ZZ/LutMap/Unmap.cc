@@ -213,7 +213,7 @@ void unmap(Gig& N, WMapX<GLit>* remap)
     For_Gates(N, w){
         if (w == gate_Lut6 || w == gate_F7Mux || w == gate_F8Mux){      // <<== or just simply replace F7/F8 with Mux?
             uint64 ftb_ = (w == gate_Lut6) ? ftb(w) : 0xD8D8D8D8D8D8D8D8ull;
-            dsd6(ftb_, prog, P);
+            dsd6Memo(ftb_, prog, P);
 
             // Replace LUT with 'prog':
             nodes.setSize(DSD6_FIRST_INTERNAL);
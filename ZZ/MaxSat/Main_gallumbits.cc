@@ -14,7 +14,11 @@ int main(int argc, char** argv)
     ZZ_Init;
 
     cli.add("input", "string", arg_REQUIRED, "Input CNF.", 0);
+    cli.add("strat", "bool", "yes", "Stratify on weights ('oll' only).");
+    cli.add("wce", "bool", "yes", "Exhaust cores before relaxing them ('oll' only).");
+    cli.add("harden", "bool", "yes", "Harden soft clauses heavier than the optimality gap ('oll' only).");
     cli.addCommand("core", "Core based solver.");
+    cli.addCommand("oll", "Weighted core based solver (OLL with incremental totalizers).");
     cli.addCommand("sort", "Sorter based solver.");
     cli.addCommand("sort-down", "Sorter based solver, starting with SAT solution [still buggy!].");
     cli.parseCmdLine(argc, argv);
@@ -30,7 +34,13 @@ int main(int argc, char** argv)
     WriteLn "#vars: %_", P.n_vars;
     WriteLn "#clauses: %_", P.size();
 
-    if (cli.cmd == "core")
+    if (cli.cmd == "oll"){
+        Params_MaxSat Q;
+        Q.stratify = cli.get("strat").bool_val;
+        Q.wce      = cli.get("wce").bool_val;
+        Q.harden   = cli.get("harden").bool_val;
+        ollMaxSat(P, Q);
+    }else if (cli.cmd == "core")
         coreMaxSat(P);
     else if (cli.cmd == "sort")
         sorterMaxSat(P, false);
@@ -13,11 +13,13 @@
 
 #include "Prelude.hh"
 #include "Parser.hh"
+#include "Solver.hh"
 #include "ZZ_MetaSat.hh"
 #include "ZZ_Gig.hh"
 #include "ZZ_Gip.CnfMap.hh"
 #include "ZZ_Gip.Common.hh"
 #include "Sorters.hh"
+#include "ZZ/Generics/Map.hh"
 
 namespace ZZ {
 using namespace std;
@@ -184,8 +186,9 @@ void sorterMaxSat(MaxSatProb& P, bool down)
             S.addClause(tmp);
 
         }else{
-            WriteLn "Weighted MaxSat not supported yet.";
-            exit(1);
+            WriteLn "Weighted instance; switching to OLL solver.";
+            ollMaxSat(P);
+            return;
         }
     }
 
@@ -335,8 +338,9 @@ void coreMaxSat(MaxSatProb& P)
             S.addClause(tmp);
 
         }else{
-            WriteLn "Weighted MaxSat not supported yet.";
-            exit(1);
+            WriteLn "Weighted instance; switching to OLL solver.";
+            ollMaxSat(P);
+            return;
         }
     }
 
@@ -444,6 +448,320 @@ void coreMaxSat(MaxSatProb& P)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Third attempt -- weighted OLL:
+
+
+// Totalizer node. Only the upward direction is encoded: 'outs[j]' is implied when at least 'j+1'
+// inputs are true. Outputs are created lazily (see 'extendTot()').
+struct TotNode {
+    Vec<Lit> outs;
+    uint     size;      // -- number of inputs under this node
+    uint     left;      // -- 'UINT_MAX' for leaves (whose only output is the input literal)
+    uint     right;
+};
+
+
+// An objective term: assumption literal 'lit' has residual weight 'w'. For a totalizer output,
+// 'lit == ~outs[k]' of node 'tot'.
+struct OllItem {
+    Lit     lit;
+    uint64  w;
+    uint    tot;
+    uint    k;
+};
+
+
+class OllSolver {
+    MaxSatProb&           P;
+    const Params_MaxSat&  Q;
+
+    MiniSat2        S;
+    Vec<TotNode>    tots;
+    Vec<OllItem>    items;
+    Map<uint,uint>  lit2item;   // -- 'lit.data()' to index in 'items'
+
+    uint64          LB;
+    uint64          UB;
+    Vec<lbool>      best;       // -- best model so far (indexed by problem variable)
+    uint            n_cores;
+
+    Vec<Vec<uint> > pending;    // -- cores found but not yet relaxed (WCE)...
+    Vec<uint64>     pending_w;  // -- ...and their weights
+
+    Lit  varLit(Lit p) const { return Lit(p.id + 1, p.sign); }  // -- problem literal -> solver literal
+    void addItem(Lit lit, uint64 w, uint tot, uint k);
+    uint buildTot(const Vec<Lit>& inputs, uint lo, uint hi);
+    void extendTot(uint n, uint k);
+    void relax(const Vec<uint>& core, uint64 w);
+    void harden();
+    uint64 nextThreshold(uint64 curr) const;
+    uint64 modelCost();
+
+public:
+    OllSolver(MaxSatProb& P_, const Params_MaxSat& Q_) : P(P_), Q(Q_), LB(0), UB(UINT64_MAX), n_cores(0) {}
+    uint64 solve(Vec<lbool>* model);
+};
+
+
+void OllSolver::addItem(Lit lit, uint64 w, uint tot, uint k)
+{
+    uint* idx;
+    if (lit2item.get(lit.data(), idx)){
+        items[*idx].w += w;     // -- (same literal as an existing term)
+        return; }
+    *idx = items.size();
+    OllItem it;
+    it.lit = lit; it.w = w; it.tot = tot; it.k = k;
+    items.push(it);
+}
+
+
+uint OllSolver::buildTot(const Vec<Lit>& inputs, uint lo, uint hi)
+{
+    uint n = tots.size();
+    tots.push();
+    tots[n].size = hi - lo;
+    if (hi - lo == 1){
+        tots[n].outs.push(inputs[lo]);
+        tots[n].left = tots[n].right = UINT_MAX;
+    }else{
+        uint mid = lo + (hi - lo) / 2;
+        uint l = buildTot(inputs, lo, mid);
+        uint r = buildTot(inputs, mid, hi);
+        tots[n].left  = l;
+        tots[n].right = r;
+    }
+    return n;
+}
+
+
+// Make sure node 'n' has outputs for "at least 1" .. "at least k" (as far as its size permits).
+void OllSolver::extendTot(uint n, uint k)
+{
+    newMin(k, tots[n].size);
+    uint cur = tots[n].outs.size();
+    if (cur >= k || tots[n].left == UINT_MAX) return;
+
+    uint l = tots[n].left, r = tots[n].right;
+    extendTot(l, k);
+    extendTot(r, k);
+    for (uint j = cur; j < k; j++)
+        tots[n].outs.push(S.addLit());
+
+    // Add 'L[a-1] & R[b-1] -> outs[a+b-1]' for all sums not encoded before:
+    const Vec<Lit>& L = tots[l].outs;
+    const Vec<Lit>& R = tots[r].outs;
+    Vec<Lit> tmp;
+    for (uint a = 0; a <= L.size(); a++){
+        for (uint b = 0; b <= R.size(); b++){
+            uint s = a + b;
+            if (s <= cur || s > k) continue;
+            tmp.clear();
+            if (a > 0) tmp.push(~L[a-1]);
+            if (b > 0) tmp.push(~R[b-1]);
+            tmp.push(tots[n].outs[s-1]);
+            S.addClause(tmp);
+        }
+    }
+}
+
+
+// OLL relaxation of a core of weight 'w' (residual weights have already been reduced).
+void OllSolver::relax(const Vec<uint>& core, uint64 w)
+{
+    // Totalizer outputs in the core are replaced by the next output:
+    for (uint i = 0; i < core.size(); i++){
+        OllItem it = items[core[i]];
+        if (it.tot == UINT_MAX) continue;
+        uint k = it.k + 1;
+        if (k < tots[it.tot].size){
+            extendTot(it.tot, k + 1);
+            addItem(~tots[it.tot].outs[k], w, it.tot, k);
+        }
+    }
+
+    if (core.size() == 1){
+        S.addClause(~items[core[0]].lit);
+        return; }
+
+    // New totalizer over the violations; one is always violated, so "at least 2" becomes a new term:
+    Vec<Lit> viol;
+    for (uint i = 0; i < core.size(); i++)
+        viol.push(~items[core[i]].lit);
+    uint n = buildTot(viol, 0, viol.size());
+    extendTot(n, 2);
+    S.addClause(tots[n].outs[0]);
+    addItem(~tots[n].outs[1], w, n, 1);
+}
+
+
+// Terms whose residual weight exceeds the gap 'UB - LB' must be satisfied by any improving solution.
+void OllSolver::harden()
+{
+    if (!Q.harden || UB == UINT64_MAX) return;
+    uint64 gap = UB - LB;
+    for (uint i = 0; i < items.size(); i++){
+        if (items[i].w > gap){
+            S.addClause(items[i].lit);
+            items[i].w = 0;
+        }
+    }
+}
+
+
+// Diversity based stratification: the next weight level below 'curr' is the first one where the
+// terms outnumber the distinct weights by a factor 'Q.div_ratio' (otherwise include all terms).
+uint64 OllSolver::nextThreshold(uint64 curr) const
+{
+    Vec<uint64> ws;
+    for (uint i = 0; i < items.size(); i++)
+        if (items[i].w > 0) ws.push(items[i].w);
+    if (ws.size() == 0) return 1;
+    sort(ws);
+    if (!Q.stratify) return ws[0];
+
+    uint n_distinct = 0;
+    for (uint i = ws.size(); i > 0;){
+        i--;
+        uint64 w = ws[i];
+        n_distinct++;
+        while (i > 0 && ws[i-1] == w) i--;
+        if (w >= curr) continue;
+        uint n_terms = ws.size() - i;
+        if (n_terms > Q.div_ratio * n_distinct)
+            return w;
+    }
+    return ws[0];
+}
+
+
+uint64 OllSolver::modelCost()
+{
+    uint64 cost = 0;
+    for (uint i = 0; i < P.size(); i++){
+        if (P.weight[i] == UINT64_MAX) continue;
+        bool sat = false;
+        for (uint j = 0; j < P[i].size(); j++)
+            if (S.value(varLit(P[i][j])) == l_True){ sat = true; break; }
+        if (!sat) cost += P.weight[i];
+    }
+    return cost;
+}
+
+
+uint64 OllSolver::solve(Vec<lbool>* model)
+{
+    // Insert clauses:
+    while (S.nVars() < P.n_vars + 2)
+        S.addLit();
+
+    Vec<Lit> tmp;
+    for (uint i = 0; i < P.size(); i++){
+        tmp.clear();
+        for (uint j = 0; j < P[i].size(); j++)
+            tmp.push(varLit(P[i][j]));
+
+        if (P.weight[i] == UINT64_MAX)
+            S.addClause(tmp);
+        else if (P.weight[i] > 0){
+            Lit a = S.addLit();
+            tmp.push(~a);
+            S.addClause(tmp);
+            addItem(a, P.weight[i], UINT_MAX, 0);
+        }
+    }
+
+    // Optimization loop:
+    uint64 threshold = nextThreshold(UINT64_MAX);
+    Vec<Lit> assumps, confl;
+    Vec<uint> core;
+    for(;;){
+        assumps.clear();
+        for (uint i = 0; i < items.size(); i++)
+            if (items[i].w > 0 && items[i].w >= threshold)
+                assumps.push(items[i].lit);
+
+        lbool result = S.solve(assumps);
+        if (result == l_True){
+            uint64 cost = modelCost();
+            if (cost < UB){
+                UB = cost;
+                best.setSize(P.n_vars + 1, l_Undef);
+                for (uint x = 1; x <= P.n_vars; x++)
+                    best[x] = S.value(Lit(x + 1));
+                if (!Q.quiet) WriteLn "o %_   (LB %_, cores %_)  [%t]", UB, LB, n_cores, cpuTime();
+            }
+            if (LB >= UB) break;
+
+            if (pending.size() > 0){
+                for (uint i = 0; i < pending.size(); i++)
+                    relax(pending[i], pending_w[i]);
+                pending.clear();
+                pending_w.clear();
+                harden();
+                continue;
+            }
+
+            uint64 next = nextThreshold(threshold);
+            if (next < threshold){
+                threshold = next;
+                harden();
+                continue;
+            }
+            break;      // -- all terms assumed and satisfied; model is optimal
+
+        }else{
+            assert(result == l_False);
+            S.getConflict(confl);
+            if (confl.size() == 0){
+                if (UB == UINT64_MAX){
+                    if (!Q.quiet) WriteLn "Hard clauses are UNSAT.";
+                    return UINT64_MAX; }
+                break;  // -- hardening proved 'UB' optimal
+            }
+
+            n_cores++;
+            core.clear();
+            uint64 w = UINT64_MAX;
+            for (uint i = 0; i < confl.size(); i++){
+                uint idx = UINT_MAX;
+                lit2item.peek(confl[i].data(), idx); assert(idx != UINT_MAX);
+                core.push(idx);
+                newMin(w, items[idx].w);
+            }
+            for (uint i = 0; i < core.size(); i++)
+                items[core[i]].w -= w;
+            LB += w;
+
+            if (Q.wce){
+                pending.push();
+                core.copyTo(pending.last());
+                pending_w.push(w);
+            }else{
+                relax(core, w);
+                harden();
+            }
+            if (LB >= UB) break;
+        }
+    }
+
+    if (!Q.quiet){
+        WriteLn "Optimal solution found. Cost: %_  (cores: %_)", UB, n_cores;
+        WriteLn "CPU-time: %t", cpuTime();
+    }
+    if (model) best.copyTo(*model);
+    return UB;
+}
+
+
+uint64 ollMaxSat(MaxSatProb& P, const Params_MaxSat& Q, Vec<lbool>* model)
+{
+    OllSolver oll(P, Q);
+    return oll.solve(model);
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
 
@@ -23,8 +23,22 @@ using namespace std;
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
-void sorterMaxSat(MaxSatProb& P, bool down);
-void coreMaxSat(MaxSatProb& P);
+struct Params_MaxSat {
+    bool    stratify;       // -- solve for heavy terms first (diversity based weight levels)
+    double  div_ratio;      // -- a weight level is used if it has this many terms per distinct weight
+    bool    wce;            // -- exhaust cores before relaxing them ("weight aware core extraction")
+    bool    harden;         // -- harden terms heavier than 'UB - LB'
+    bool    quiet;
+
+    Params_MaxSat() : stratify(true), div_ratio(1.25), wce(true), harden(true), quiet(false) {}
+};
+
+
+void   sorterMaxSat(MaxSatProb& P, bool down);
+void   coreMaxSat(MaxSatProb& P);
+uint64 ollMaxSat(MaxSatProb& P, const Params_MaxSat& Q = Params_MaxSat(), Vec<lbool>* model = NULL);
+    // -- Weighted (partial) MaxSat using OLL with incremental totalizers. Returns the cost of an
+    // optimal solution ('UINT64_MAX' if hard clauses are UNSAT). 'model' is indexed by variable.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -150,19 +150,19 @@ uint ZzSat::nVars() const
 
 void ZzSat::freeze(uint x)
 {
-    /*nothing*/
+    S->freeze(x);
 }
 
 
 void ZzSat::thaw(uint x)
 {
-    /*nothing*/
+    S->thaw(x);
 }
 
 
 void ZzSat::preprocess(bool /*final_call*/)
 {
-    S->simplifyDB();
+    S->inprocess(true);
 }
 
 
@@ -172,6 +172,16 @@ void ZzSat::getCnf(Vec<Lit>& out_cnf)
 }
 
 
+MetaSat* ZzSat::clone(uint learnt_lim) const
+{
+    ZzSat* ret = new ZzSat;
+    S->copyTo(*ret->S);     // -- copies the clause memory in one go
+    if (learnt_lim != UINT_MAX)
+        ret->S->clearLearnts(learnt_lim);
+    return ret;
+}
+
+
 void ZzSat::setVerbosity(int verb_level)
 {
     S->verbosity = verb_level;
@@ -365,6 +375,17 @@ void MiniSat2::getCnf(Vec<Lit>& out_cnf)
 }
 
 
+MetaSat* MiniSat2::clone(uint learnt_lim) const
+{
+    MiniSat2* ret = new MiniSat2;
+    ret->S->~Solver();
+    new (ret->S) MS::Solver;    // -- 'cloneTo()' requires an empty solver
+    S->cloneTo(*ret->S, (learnt_lim > (uint)INT_MAX) ? INT_MAX : (int)learnt_lim);
+    ret->true_lit = true_lit;
+    return ret;
+}
+
+
 void MiniSat2::setVerbosity(int verb_level)
 {
     S->verbosity = verb_level;
@@ -549,6 +570,12 @@ void MiniSat2s::getCnf(Vec<Lit>& out_cnf)
 }
 
 
+MetaSat* MiniSat2s::clone(uint learnt_lim) const
+{
+    return NULL;    // -- variable elimination state is not cloned
+}
+
+
 void MiniSat2s::setVerbosity(int verb_level)
 {
     S->verbosity = verb_level;
@@ -755,6 +782,12 @@ void AbcSat::getCnf(Vec<Lit>& out_cnf)
 }
 
 
+MetaSat* AbcSat::clone(uint learnt_lim) const
+{
+    return NULL;    // -- not supported
+}
+
+
 void AbcSat::setVerbosity(int verb_level)
 {
     AS::sat_solver_set_verbosity(S, verb_level);
@@ -947,6 +980,17 @@ void GluSat::getCnf(Vec<Lit>& out_cnf)
 }
 
 
+MetaSat* GluSat::clone(uint learnt_lim) const
+{
+    GluSat* ret = new GluSat;
+    ret->S->~Solver();
+    new (ret->S) GL::Solver;    // -- 'cloneTo()' requires an empty solver
+    S->cloneTo(*ret->S, learnt_lim);
+    ret->true_lit = true_lit;
+    return ret;
+}
+
+
 void GluSat::setVerbosity(int verb_level)
 {
     S->verbosity = verb_level;
@@ -1139,6 +1183,12 @@ void GlrSat::getCnf(Vec<Lit>& out_cnf)
 }
 
 
+MetaSat* GlrSat::clone(uint learnt_lim) const
+{
+    return NULL;    // -- not supported (reducer runs in a separate thread)
+}
+
+
 void GlrSat::setVerbosity(int verb_level)
 {
     S->verbosity = verb_level;
@@ -1332,6 +1382,12 @@ void MiniRedSat::getCnf(Vec<Lit>& out_cnf)
 }
 
 
+MetaSat* MiniRedSat::clone(uint learnt_lim) const
+{
+    return NULL;    // -- not supported (reducer runs in a separate thread)
+}
+
+
 void MiniRedSat::setVerbosity(int verb_level)
 {
     S->verbosity = verb_level;
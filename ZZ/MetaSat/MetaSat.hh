@@ -103,6 +103,17 @@ struct MetaSat {
     virtual void  preprocess(bool final_call) = 0;          // -- If 'final_call' is TRUE, internal data will be freed to save memory, but no more preprocessing is possible.
     virtual void  getCnf(Vec<Lit>& out_cnf) = 0;            // -- Read back CNF as a sequence of clauses separated by 'lit_Undef's.
 
+  //________________________________________
+  //  Snapshots:
+
+    virtual MetaSat* clone(uint learnt_lim = UINT_MAX) const = 0;
+        // -- Returns an independent copy of the solver, including learned clauses, variable activities
+        // and phases. Must not be called during 'solve()'. Learned clauses longer than 'learnt_lim'
+        // literals (Glucose: with an LBD above 'learnt_lim') are left out of the copy.
+        // NOTE! Returns NULL if the solver cannot be cloned: 'sat_Mss' (variable elimination state),
+        // 'sat_Abc', 'sat_Glr' and 'sat_Msr' (reducer thread). Callers must check and fall back,
+        // e.g. to forking the process, which copies any solver.
+
   //________________________________________
   //  Debug:
 
@@ -153,6 +164,7 @@ protected:
     virtual void  thaw(uint x);                                         \
     virtual void  preprocess(bool final_call);                          \
     virtual void  getCnf(Vec<Lit>& out_cnf);                            \
+    virtual MetaSat* clone(uint learnt_lim = UINT_MAX) const;          \
     virtual void  setVerbosity(int verb_level);                         \
     virtual bool  exportCnf(const String& filename);
 
@@ -327,6 +339,7 @@ struct MultiSat : MetaSat {
     virtual void   thaw(uint x)                        { S->thaw(x); }
     virtual void   preprocess(bool final_call)         { S->preprocess(final_call); }
     virtual void   getCnf(Vec<Lit>& out_cnf)           { S->getCnf(out_cnf); }
+    virtual MetaSat* clone(uint learnt_lim = UINT_MAX) const;
     virtual void   setVerbosity(int verb_level)        { S->setVerbosity(verb_level); }
     virtual bool   exportCnf(const String& filename)   { return S->exportCnf(filename); }
 };
@@ -346,6 +359,19 @@ inline void MultiSat::selectSolver(SolverType type)
     case sat_Glr:  S = new GlrSat()    ; break;
     case sat_Msr:  S = new MiniRedSat(); break;
     default: assert(false); }
+    this->type = type;
+}
+
+
+inline MetaSat* MultiSat::clone(uint learnt_lim) const
+{
+    MetaSat* copy = S->clone(learnt_lim);
+    if (!copy) return NULL;     // -- solver type not supported (see 'MetaSat::clone()')
+
+    MultiSat* ret = new MultiSat();
+    ret->S    = copy;
+    ret->type = type;
+    return ret;
 }
 
 
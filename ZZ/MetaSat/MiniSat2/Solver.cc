@@ -1174,3 +1174,98 @@ void Solver::getCnf(vec<Lit>& cnf)
       Skip:;
     }
 }
+
+
+//=================================================================================================
+// Extension -- cloning:
+
+
+// Copy the complete solver state into the freshly constructed solver 'to'. Must be called at
+// decision level 0 (i.e. between calls to 'solve()'). Clauses are copied into a compact region of
+// the new clause allocator (no wasted space) and re-attached; learnt clauses longer than
+// 'max_learnt_size' are dropped. Activities, phases and top-level assignments are kept.
+void Solver::cloneTo(Solver& to, int max_learnt_size) const
+{
+    assert(decisionLevel() == 0);
+    assert(to.nVars() == 0 && to.clauses.size() == 0 && to.learnts.size() == 0);
+
+    // Mode of operation:
+    to.verbosity          = verbosity;
+    to.var_decay          = var_decay;
+    to.clause_decay       = clause_decay;
+    to.random_var_freq    = random_var_freq;
+    to.random_seed        = random_seed;
+    to.luby_restart       = luby_restart;
+    to.ccmin_mode         = ccmin_mode;
+    to.phase_saving       = phase_saving;
+    to.rnd_pol            = rnd_pol;
+    to.rnd_init_act       = false;      // -- activities are copied below
+    to.garbage_frac       = garbage_frac;
+    to.min_learnts_lim    = min_learnts_lim;
+    to.restart_first      = restart_first;
+    to.restart_inc        = restart_inc;
+    to.learntsize_factor  = learntsize_factor;
+    to.learntsize_inc     = learntsize_inc;
+    to.learntsize_adjust_start_confl = learntsize_adjust_start_confl;
+    to.learntsize_adjust_inc         = learntsize_adjust_inc;
+
+    // Variables:
+    for (Var v = 0; v < next_var; v++)
+        to.newVar(user_pol[v], decision[v]);
+    to.rnd_init_act = rnd_init_act;
+
+    activity.copyTo(to.activity);
+    assigns .copyTo(to.assigns);
+    polarity.copyTo(to.polarity);
+    for (Var v = 0; v < next_var; v++)
+        to.vardata[v] = mkVarData(CRef_Undef, vardata[v].level);    // -- reasons of top-level facts are never inspected
+
+    trail.copyTo(to.trail);
+    to.trail.capacity(next_var + 1);
+    to.qhead = qhead;
+    released_vars.copyTo(to.released_vars);
+    free_vars    .copyTo(to.free_vars);
+
+    // Clauses:
+    to.ca.extra_clause_field = ca.extra_clause_field;
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.mark() == 1) continue;
+        CRef cr = to.ca.alloc(c);
+        to.clauses.push(cr);
+        to.attachClause(cr);
+    }
+    for (int i = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        if (c.mark() == 1 || c.size() > max_learnt_size) continue;
+        CRef cr = to.ca.alloc(c);
+        to.learnts.push(cr);
+        to.attachClause(cr);
+    }
+
+    // Search state and statistics:
+    to.ok                      = ok;
+    to.cla_inc                 = cla_inc;
+    to.var_inc                 = var_inc;
+    to.simpDB_assigns          = simpDB_assigns;
+    to.simpDB_props            = simpDB_props;
+    to.progress_estimate       = progress_estimate;
+    to.remove_satisfied        = remove_satisfied;
+    to.max_learnts             = max_learnts;
+    to.learntsize_adjust_confl = learntsize_adjust_confl;
+    to.learntsize_adjust_cnt   = learntsize_adjust_cnt;
+
+    to.solves        = solves;
+    to.starts        = starts;
+    to.decisions     = decisions;
+    to.rnd_decisions = rnd_decisions;
+    to.propagations  = propagations;
+    to.conflicts     = conflicts;
+    to.max_literals  = max_literals;
+    to.tot_literals  = tot_literals;
+
+    to.conflict_budget    = conflict_budget;
+    to.propagation_budget = propagation_budget;
+
+    to.rebuildOrderHeap();
+}
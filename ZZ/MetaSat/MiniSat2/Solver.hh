@@ -82,6 +82,8 @@ public:
     bool    exportCnf(const char* filename, bool exclude_units = true);    // -- returns FALSE if file could not be created
     void    getCnf(vec<Lit>& cnf);
 
+    void    cloneTo(Solver& to, int max_learnt_size = INT32_MAX) const;    // -- 'to' must be freshly constructed; learnt clauses above the size limit are dropped
+
     // Convenience versions of 'toDimacs()':
     void    toDimacs     (const char* file);
     void    toDimacs     (const char* file, Lit p);
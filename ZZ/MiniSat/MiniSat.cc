@@ -62,6 +62,8 @@ void MiniSat<pfl>::init()
     simpDB_assigns    = 0;
     simpDB_props      = 0;
     n_literals        = 0;
+    model_ext_lv      = UINT_MAX;
+    inproc_next       = 0;
     vt                = 0;
     cpu_time0         = cpuTime();
 
@@ -76,6 +78,8 @@ void MiniSat<pfl>::init()
     timeout_cb_data   = NULL;
     cc_cb             = NULL;
     cc_cb_data        = NULL;
+    inproc_interval   = 0;
+    inproc_elim       = false;
     debug_cnf_out     = NULL;
     conflict_id       = clause_id_NULL;
     // -- 'debug_api_out' intentionally not cleared here
@@ -110,6 +114,9 @@ void MiniSat<pfl>::clear(bool dealloc, bool clear_stats)
     vdata    .clear(dealloc);
     assumps  .clear(dealloc);
     free_vars.clear(dealloc);
+    var_frozen  .clear(dealloc);
+    var_elim    .clear(dealloc);
+    elim_clauses.clear(dealloc);
 
     wlDisposeAll();
     watches.clear(dealloc);
@@ -464,7 +471,7 @@ void MiniSat<pfl>::newClause(const Vec<Lit>& ps_, clause_id id)
 
 #if defined(ZZ_DEBUG)
     for (uind i = 0; i < ps_.size(); i++)
-        assert(hasVar(var(ps_[i])));
+        assert(hasVar(var(ps_[i])) && !var_elim[var(ps_[i])]);
 #endif
 
     bool learnt = (id != clause_id_NULL);
@@ -746,6 +753,8 @@ Var MiniSat<pfl>::newVar()
 //    activity    .push(var_inc * (1 - 1.0/0x10000000 * x));
     activity    .push(0);
     polarity    .push(1);
+    var_frozen  .push(0);
+    var_elim    .push(0);
     if (pfl) unit_id.push(clause_id_NULL);
     /*HEUR*/order.add(x);
 #if defined(BUMP_EXPERIMENT)
@@ -1180,13 +1189,13 @@ bool MiniSat<pfl>::makeDecision()
             // Model found:
             return false; }
         cand = order.pop();
-    }while (assign(cand) != l_Undef);
+    }while (assign(cand) != l_Undef || var_elim[cand]);
 
     Var next;
     double act = activity[cand] / var_inc;
     if (/*HEUR*/act < 0.25 && random_var_freq > 0 && drand(random_seed) < random_var_freq){
         next = irand(random_seed, nVars());
-        if (assign(next) != l_Undef)
+        if (assign(next) != l_Undef || var_elim[next])
             next = cand;
         else{
             stats.random_decis++;
@@ -1279,10 +1288,22 @@ lbool MiniSat<pfl>::search(int nof_conflicts, int nof_learnts)
                 undo(0);
                 return l_Error; }
 
-            if (dl() == 0)
+            if (dl() == 0){
                 // Simplify the set of problem clauses:
                 simplifyDB_intern(), assert(ok);
 
+                if (inproc_interval > 0){
+                    if (inproc_next == 0)
+                        inproc_next = stats.conflicts + inproc_interval;
+                    else if (stats.conflicts >= inproc_next){
+                        inprocess_intern(inproc_elim);
+                        if (!ok){
+                            conflict.clear();
+                            return l_False; }
+                    }
+                }
+            }
+
             if (nof_learnts >= 0 && int(learnts.size()-nAssigns() - (pfl ? n_bin_clauses : 0)) >= nof_learnts)
                 // Reduce the set of learnt clauses:
                 reduceDB();
@@ -1320,8 +1341,12 @@ lbool MiniSat<pfl>::search(int nof_conflicts, int nof_learnts)
                     return l_False;
                 }
             }else{
-                if (!makeDecision())
-                    return l_True;  // -- model found
+                if (!makeDecision()){
+                    // Model found:
+                    if (elim_clauses.size() > 0)
+                        extendModel();
+                    return l_True;
+                }
             }
             stats.decisions++;
         }
@@ -1637,6 +1662,22 @@ void MiniSat<pfl>::removeVars(IntZet<Var>& xs, Vec<Var>& kept)
         cs.shrinkTo(j);
     }
 
+    // Forget clauses of eliminated variables that mention removed variables:
+    if (elim_clauses.size() > 0){
+        Vec<Lit> kept;
+        for (uint i = elim_clauses.size(); i > 0;){
+            uint sz = elim_clauses[--i].data();
+            i -= sz;
+            bool keep = true;
+            for (uint k = 0; k < sz; k++)
+                if (xs.has(elim_clauses[i + k].id)){ keep = false; break; }
+            if (keep){
+                for (uint k = sz + 1; k > 0;) kept.push(elim_clauses[i + --k]); }
+        }
+        elim_clauses.clear();
+        for (uint i = kept.size(); i > 0;) elim_clauses.push(kept[--i]);
+    }
+
     // Clear and recycle variables:
     xs.compact();
     for (uint i = 0; i < xs.list().size(); i++){
@@ -1649,6 +1690,8 @@ void MiniSat<pfl>::removeVars(IntZet<Var>& xs, Vec<Var>& kept)
         vdata[x] = MSVarData();
         activity[x] = 0;
         polarity[x] = 1;
+        var_frozen[x] = 0;
+        var_elim[x] = 0;
         if (order.has(x))
             order.remove(x);
 
@@ -1725,15 +1768,16 @@ void MiniSat<pfl>::randomizeVarOrder(uint64& seed, bool rnd_polarity)
 
 
 template<bool pfl>
-void MiniSat<pfl>::clearLearnts()
+void MiniSat<pfl>::clearLearnts(uint keep_size)
 {
     if (debug_api_out)
-        *debug_api_out |= "clearLearnts()";
+        *debug_api_out |= "clearLearnts(%_)", keep_size;
 
+    newMax(keep_size, 2u);
     undo(0);
     uint j = 0;
     for (uint i = 0; i < learnts.size(); i++){
-        if (learnts[i].clause(MEM)->size() > 2 && !locked(learnts[i])){
+        if (learnts[i].clause(MEM)->size() > keep_size && !locked(learnts[i])){
             removeClause(learnts[i]);
             stats.deleted_clauses--;
         }else
@@ -1755,6 +1799,11 @@ lbool MiniSat<pfl>::solve_(const Vec<Lit>& assumps0)
         *debug_api_out |= "solve(%_)", assumps0;
 
     if (!ok){ return l_False; }
+
+    if (model_ext_lv != UINT_MAX){
+        undo(model_ext_lv);     // -- retract values of eliminated variables from last model
+        model_ext_lv = UINT_MAX; }
+
 #if defined(KEEP_TOPLEVEL_LITERALS)
     if (propagate() != NULL){
         conflict.clear();
@@ -1803,6 +1852,7 @@ lbool MiniSat<pfl>::solve_(const Vec<Lit>& assumps0)
     for (uint i = 0; i < assumps.size(); i++){
         Var x = assumps[i].id;
         while (x >= nVars()) newVar();
+        assert(!var_elim[x]);
     }
 
     // Do initial simplification:
@@ -1872,6 +1922,13 @@ lbool MiniSat<pfl>::solve(const Vec<Lit>& assumps)
     return result;
 }
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Inprocessing:
+
+
+#include "MiniSat_Inproc.icc"
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Text interface (essentially for debugging):
 
@@ -2123,6 +2180,11 @@ void MiniSat<pfl>::copyTo(MiniSat<pfl>& other) const
     cpy(assumps, other.assumps);
     cpy(vdata, other.vdata);
     cpy(free_vars, other.free_vars);
+    cpy(var_frozen, other.var_frozen);
+    cpy(var_elim, other.var_elim);
+    cpy(elim_clauses, other.elim_clauses);
+    cpy(model_ext_lv, other.model_ext_lv);
+    cpy(inproc_next, other.inproc_next);
     cpy(watches, other.watches);
     cpy(trail, other.trail);
     cpy(trail_lim, other.trail_lim);
@@ -2142,6 +2204,8 @@ void MiniSat<pfl>::copyTo(MiniSat<pfl>& other) const
     cpy(timeout_cb_data, other.timeout_cb_data);
     cpy(cc_cb, other.cc_cb);
     cpy(cc_cb_data, other.cc_cb_data);
+    cpy(inproc_interval, other.inproc_interval);
+    cpy(inproc_elim, other.inproc_elim);
 
     // Copy all external watcher lists:
     for (uind i = 0; i < other.watches.size(); i++){
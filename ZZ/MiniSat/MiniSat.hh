@@ -87,6 +87,13 @@ protected:
 
     IntZet<Var>     free_vars;
 
+    // Inprocessing:
+    Vec<uchar>      var_frozen;     // Frozen variables are never eliminated (see 'freeze()').
+    Vec<uchar>      var_elim;       // Variables removed by variable elimination (not decision variables).
+    Vec<Lit>        elim_clauses;   // Clauses of eliminated variables (pivot first), each followed by its size (stored as a literal). Used to extend models.
+    uint            model_ext_lv;   // Decision level below the model extension of the eliminated variables ('UINT_MAX' if none).
+    uint64          inproc_next;    // Value of 'stats.conflicts' at which to do the next automatic inprocessing (0 = not yet scheduled).
+
     // BCP:
     Vec<WHead>      watches;        // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
     Vec<Lit>        trail;          // Assignment stack; stores all assigments made in the order they were made.
@@ -122,6 +129,11 @@ protected:
     GClause         analyze_tmpbin;
     GClause         solve_tmpunit;
     Vec<Lit>        cl_tmp;
+    Vec<Vec<GClause> > occs;        // -- occurrence lists of the problem clauses during inprocessing (indexed by 'Lit::data()')
+    Vec<uchar>      inproc_mark;
+    Vec<Lit>        inproc_tmp;
+    Vec<Lit>        inproc_units;   // }- units derived during inprocessing (added once the problem clauses are watched again)
+    Vec<clause_id>  inproc_ids;     // }
 
   //________________________________________
   //  INTERNAL HELPERS:
@@ -181,6 +193,19 @@ protected:
     bool simplifyClause   (GClause c) const;
     void simplifyDB_intern();
 
+    // Inprocessing:
+    //
+    void attachClause     (GClause c);
+    void detachProblem    ();
+    void reattachProblem  ();
+    bool inprocAdd        (const Vec<Lit>& ps, clause_id id);
+    bool resolveOn        (GClause cp, GClause cn, Var x, Vec<Lit>& out);
+    bool inprocSubsume    (uint64 budget);
+    void inprocElim       (uint64 budget);
+    void vivifyLearnts    (uint64 budget);
+    void inprocess_intern (bool elim);
+    void extendModel      ();
+
     uint dl() const { return trail_lim.size(); }    // -- decision level
 
 public:
@@ -275,6 +300,23 @@ public:
 
     double getActivity(uint x) { return activity[x] / var_inc; }
 
+    // Inprocessing:
+    //
+    void freeze(Var x);
+    void thaw  (Var x);
+    bool frozen    (Var x) const { return var_frozen[x]; }
+    bool eliminated(Var x) const { return var_elim[x]; }
+
+    void inprocess(bool elim = false);
+        // -- Vivify learned clauses, remove subsumed problem clauses and strengthen problem clauses
+        // by self-subsuming resolution. If 'elim' is TRUE, also do bounded variable elimination on
+        // the non-frozen variables. NOTE! Once variables have been eliminated, every variable used
+        // later in 'addClause()', as an assumption or read from the model must be frozen
+        // beforehand. In proof-logging mode, all derivations are logged as resolution chains.
+
+    uint  inproc_interval;  // -- If non-zero, 'inprocess()' is called at restarts every this many conflicts.
+    bool  inproc_elim;      // -- Pass 'elim' to those automatic calls (same caveat as above).
+
     lbool topValue(Var x) const { return (level(x) == 0) ? assign(x) : l_Undef; }
     lbool topValue(Lit p) const { return (level(p) == 0) ? assign(p) : l_Undef; }
         // If 'x' has been proven (at the top-level) to be constant, return that value.
@@ -284,9 +326,11 @@ public:
 
     void  proofTraverse    () { proof.iterate(conflict_id); }
     void  proofClearVisited() { proof.clearVisited(); }
+    bool  proofSpill(uint resident_chunks = 16) { return proof.spill(resident_chunks); }
+        // -- Keep the proof-log in a memory-mapped temporary file (see 'Proof::spill()').
 
     void  randomizeVarOrder(uint64& seed, bool rnd_polarity = true);
-    void  clearLearnts();
+    void  clearLearnts(uint keep_size = 2);     // -- remove learned clauses longer than 'keep_size'
 
     // Snapshots:
     //
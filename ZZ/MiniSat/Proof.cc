@@ -16,6 +16,11 @@
 #include "Proof.hh"
 #include "ZZ/Generics/Sort.hh"
 
+#if !defined(_MSC_VER)
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
 //#define DEBUG_OUTPUT
 //#define DEBUG_CHECK_PROOF
 
@@ -24,6 +29,191 @@ namespace ZZ {
 using namespace std;
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Proof store:
+
+
+uind PfStore::alloc(uind n)
+{
+    if (!disk){
+        uind off = mem.size();
+        mem.growTo(off + n);
+        return off;
+    }
+
+    // Don't let a record straddle a chunk boundary:
+    uind pos = sz & PfStore_ChunkMask;
+    if (pos != 0 && pos + n > PfStore_ChunkSize){
+        pad += PfStore_ChunkSize - pos;
+        sz  += PfStore_ChunkSize - pos;
+    }
+
+    uind end  = sz + n;
+    uind need = (end + PfStore_ChunkMask) >> PfStore_ChunkBits;
+    if (need > chunk.size())
+        mapChunks(need - chunk.size());
+
+    uind off = sz;
+    sz = end;
+    return off;
+}
+
+
+void PfStore::shrinkTo(uind size)
+{
+    if (!disk){
+        mem.shrinkTo(size);
+        return; }
+
+    assert(size <= sz);
+    sz = size;
+    if (size == 0) pad = 0;
+    unmapFrom((size + PfStore_ChunkMask) >> PfStore_ChunkBits);
+    if (trimmed > chunk.size()) trimmed = chunk.size();
+}
+
+
+void PfStore::clear()
+{
+    mem.clear(true);
+    unmapFrom(0);
+    chunk.clear(true);
+    span .clear(true);
+  #if !defined(_MSC_VER)
+    if (fd != -1) ::close(fd);
+  #endif
+    fd = -1;
+    sz = 0;
+    pad = 0;
+    trimmed = 0;
+}
+
+
+bool PfStore::spill(uint resident_chunks)
+{
+  #if defined(_MSC_VER)
+    return false;
+  #else
+    clear();
+    disk = true;
+    resident = max_(resident_chunks, 1u);
+    return true;
+  #endif
+}
+
+
+void PfStore::trim(bool full)
+{
+  #if !defined(_MSC_VER)
+    if (!disk || chunk.size() <= resident) return;
+    if (full) trimmed = 0;
+
+    uind lim = chunk.size() - resident;
+    for (uind i = trimmed; i < lim; i++){
+        if (span[i] == 0) continue;     // -- continuation chunks are released together with their head
+        if (i + span[i] > lim) break;
+        madvise(chunk[i], span[i] * PfStore_ChunkSize, MADV_DONTNEED);
+            // -- shared file mapping; dirty pages are written back and re-read on demand
+    }
+    trimmed = lim;
+  #endif
+}
+
+
+void PfStore::openFile()
+{
+  #if !defined(_MSC_VER)
+    cchar* dir = getenv("TMPDIR");
+    String filename = (FMT "%_/zz_proof.XXXXXX", (dir && dir[0]) ? dir : "/tmp");
+    fd = mkstemp(filename.c_str());
+    if (fd == -1)
+        Throw(Excp_Msg) "Could not create proof spill file: %_", filename;
+    unlink(filename.c_str());   // -- file disappears when descriptor is closed
+  #endif
+}
+
+
+void PfStore::mapChunks(uint n)
+{
+  #if !defined(_MSC_VER)
+    if (fd == -1) openFile();
+
+    uind off = chunk.size() * PfStore_ChunkSize;
+    uind len = n * PfStore_ChunkSize;
+    if (ftruncate(fd, off + len) != 0)
+        Throw(Excp_Msg) "Could not grow proof spill file to %DB.", off + len;
+    void* base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, off);
+    if (base == MAP_FAILED)
+        Throw(Excp_Msg) "Could not map proof spill file.";
+
+    for (uint i = 0; i < n; i++){
+        chunk.push((uchar*)base + i * PfStore_ChunkSize);
+        span .push(i == 0 ? n : 0);
+    }
+    trim();
+  #else
+    assert(false);
+  #endif
+}
+
+
+// Unmap all chunks from index 'n_chunks' and onwards (a multi-chunk mapping starting below
+// 'n_chunks' is kept in full).
+void PfStore::unmapFrom(uind n_chunks)
+{
+  #if !defined(_MSC_VER)
+    while (chunk.size() > n_chunks){
+        uind i = chunk.size() - 1;
+        while (span[i] == 0) i--;
+        if (i < n_chunks) break;
+
+        munmap(chunk[i], span[i] * PfStore_ChunkSize);
+        chunk.shrinkTo(i);
+        span .shrinkTo(i);
+    }
+    if (fd != -1 && ftruncate(fd, chunk.size() * PfStore_ChunkSize) != 0)
+        /*failing to give back disk space is harmless*/;
+  #endif
+}
+
+
+void PfStore::copyTo(PfStore& dst) const
+{
+    dst.clear();
+    dst.disk     = disk;
+    dst.resident = resident;
+    if (!disk){
+        mem.copyTo(dst.mem);
+        return; }
+
+    for (uind i = 0; i < chunk.size(); i++){
+        if (span[i] == 0) continue;
+        dst.mapChunks(span[i]);
+        memcpy(dst.chunk[i], chunk[i], span[i] * PfStore_ChunkSize);
+    }
+    dst.sz      = sz;
+    dst.pad     = pad;
+    dst.trim(true);
+}
+
+
+void PfStore::moveTo(PfStore& dst)
+{
+    dst.clear();
+    mem  .moveTo(dst.mem);
+    chunk.moveTo(dst.chunk);
+    span .moveTo(dst.span);
+    dst.sz       = sz;
+    dst.pad      = pad;
+    dst.trimmed  = trimmed;
+    dst.fd       = fd;
+    dst.resident = resident;
+    dst.disk     = disk;
+    sz = pad = trimmed = 0;
+    fd = -1;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Proof checking: 
 
@@ -222,7 +412,7 @@ void Proof::deleted(clause_id gone)
             head[id] = PfHead();
         }
 
-        if ((uint64)freed_bytes * 4 > ext_data.size() + head.size() * sizeof(PfHead)){
+        if ((uint64)(freed_bytes + ext_data.padding()) * 4 > ext_data.size() + head.size() * sizeof(PfHead)){
             //**/WriteLn "Compacting %D bytes with %D unused (mem: %DB)", ext_data.size(), freed_bytes, memUsed();
             compact(); }
     }
@@ -242,7 +432,21 @@ struct ExtOffset_lt {
 };
 
 
-void Proof::compact()
+// Size in bytes of the external data block of clause 'id'.
+uint Proof::extSize(clause_id id) const
+{
+    const uchar* data0 = head[id].data(ext_data);
+    const uchar* data  = data0;
+    uint n = getu(data);
+    if (!head[id].isRoot()) n = 2*n + 1;
+    for (uint i = 0; i < n; i++) getu(data);
+    return data - data0;
+}
+
+
+// Move all live external data blocks, in offset order, into 'dst'. If 'dst' is 'ext_data'
+// itself, this is a compaction (blocks only ever move towards lower offsets).
+void Proof::relocate(PfStore& dst)
 {
     Vec<clause_id> ids;
     for (uind id = 0; id < head.size(); id++){
@@ -252,96 +456,129 @@ void Proof::compact()
     ExtOffset_lt lt(head);
     sobSort(sob(ids, lt));
 
-    uind prev_offset = 1;
+    bool in_place = (&dst == &ext_data);
+    uind end = 1;
+    uind pad = 0;
+    if (!in_place){
+        assert(dst.size() == 0);
+        dst.alloc(1); }         // -- must not use offset 0
+
     for (uind k = 0; k < ids.size(); k++){
-        clause_id id     = ids[k];
-        uind      offset = uind(head[id].data_offset >> 2);
-        assert(offset >= prev_offset);
-
-        // Get size of block:
-        const uchar* data0 = &ext_data[offset]; assert_debug(data0 == head[id].data(ext_data));
-        const uchar* data  = data0;
-        uint n = getu(data);
-        if (!head[id].isRoot()) n = 2*n + 1;
-        for (uint i = 0; i < n; i++) getu(data);
-        uint block_sz = data - data0;
+        clause_id id       = ids[k];
+        uind      offset   = head[id].offset();
+        uint      block_sz = extSize(id);
+
+        // Find new offset:
+        uind new_offset;
+        if (in_place){
+            new_offset = end;
+            if (ext_data.spilled() && (new_offset & PfStore_ChunkMask) + block_sz > PfStore_ChunkSize){
+                new_offset = (new_offset + PfStore_ChunkMask) & ~PfStore_ChunkMask;
+                pad += new_offset - end; }
+            assert(new_offset <= offset);
+            end = new_offset + block_sz;
+        }else
+            new_offset = dst.alloc(block_sz);
 
         // Move block:
-        if (offset != prev_offset){
+        if (!in_place || new_offset != offset){
+            const uchar* src = ext_data.ptr(offset);
+            uchar*       tgt = dst.ptr(new_offset);
             for (uint i = 0; i < block_sz; i++)
-                ext_data[prev_offset + i] = ext_data[offset + i];
-            head[id].data_offset = ((uint64)prev_offset << 2) | (head[id].data_offset & 3);
+                tgt[i] = src[i];
+            head[id].data_offset = ((uint64)new_offset << 2) | (head[id].data_offset & 3);
         }
-        prev_offset += block_sz;
     }
 
-    assert(freed_bytes == ext_data.size() - prev_offset);
-    ext_data.shrinkTo(prev_offset);
+    if (in_place){
+        assert(ext_data.spilled() || freed_bytes == ext_data.size() - end);
+        ext_data.shrinkTo(end);
+        ext_data.pad = pad;
+        ext_data.trim(true);
+    }
     freed_bytes = 0;
 }
 
 
+bool Proof::spill(uint resident_chunks)
+{
+    if (ext_data.spilled()) return true;
+
+    PfStore disk;
+    if (!disk.spill(resident_chunks)) return false;
+    relocate(disk);
+    disk.moveTo(ext_data);
+    return true;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Read-back methods:
 
 
-void Proof::iterateRec(clause_id goal)
+// Replays the proof for 'goal' in topological order. Uses an explicit stack rather than recursion
+// so that deep proofs don't overflow the C-stack; on a spilled proof, this is also what streams
+// the chunks back in from disk.
+void Proof::iterateTopo(clause_id goal)
 {
   #if defined(DEBUG_OUTPUT)
-    Write "iterateRec(%_)", goal;
-    if (goal != clause_id_NULL){
-        if (isProcessed(goal))
-            Write " -- processed";
-        else{
-            if (head[goal].isRoot()) Write " [root] ";
-            else                     Write " [chain]";
-            if (head[goal].isExt()) Write " <ext>";
-            else                    Write " <inl>";
-            Write "  %p  (offset %_)", (void*)head[goal].data(ext_data), head[goal].data_offset>>2;
-        }
-        NewLine;
-    }
+    WriteLn "iterateTopo(%_)", goal;
   #endif
 
     if (goal == clause_id_NULL) return;     // -- empty proofs can exist if assumptions contain both x and ~x
     if (isProcessed(goal)) return;
 
-    /*static*/ Vec<clause_id> chain;
-    /*static*/ Vec<Lit>       lits;
+    Vec<clause_id> chain;
+    Vec<Lit>       lits;
+    Vec<Pair<clause_id,bool> > Q;      // -- (clause, children pushed?)
 
-    const uchar* data = head[goal].data(ext_data);
-    uint sz = getu(data);
-    if (head[goal].isRoot()){
-        // Root clause:
-        if (sz > 0){
-            lits.push(Lit(packed_, getu(data)));
-            for (uint i = 1; i < sz; i++)
-                lits.push(Lit(packed_, lits.last().data() + getu(data)));
-        }
-        proof_iter->root(goal, lits);
-        lits.clear();
-        markProcessed(goal);
+    Q.push(make_tuple(goal, false));
+    while (Q.size() > 0){
+        clause_id id = Q.last().fst;
+        if (isProcessed(id)){
+            Q.pop();
+            continue; }
 
-    }else{
-        // Chain -- recurse:
-        iterateRec(getu(data));
-        for (uint i = 0; i < sz; i++){
-            getu(data);
-            iterateRec(getu(data));
-        }
+        const uchar* data = head[id].data(ext_data);
+        uint sz = getu(data);
+        if (head[id].isRoot()){
+            // Root clause:
+            if (sz > 0){
+                lits.push(Lit(packed_, getu(data)));
+                for (uint i = 1; i < sz; i++)
+                    lits.push(Lit(packed_, lits.last().data() + getu(data)));
+            }
+            proof_iter->root(id, lits);
+            lits.clear();
+            markProcessed(id);
+            Q.pop();
 
-        // Chain -- output:
-        data = head[goal].data(ext_data);
-        sz = getu(data);
-        chain.push(getu(data));
-        for (uint i = 0; i < sz; i++){
-            lits .push(Lit(packed_, getu(data)));
+        }else if (!Q.last().snd){
+            // Chain -- push antecedents (in reverse, so they are emitted left to right):
+            Q.last().snd = true;
             chain.push(getu(data));
+            for (uint i = 0; i < sz; i++){
+                getu(data);
+                chain.push(getu(data));
+            }
+            for (uint i = chain.size(); i > 0; i--)
+                if (chain[i-1] != clause_id_NULL && !isProcessed(chain[i-1]))
+                    Q.push(make_tuple(chain[i-1], false));
+            chain.clear();
+
+        }else{
+            // Chain -- all antecedents processed; output:
+            chain.push(getu(data));
+            for (uint i = 0; i < sz; i++){
+                lits .push(Lit(packed_, getu(data)));
+                chain.push(getu(data));
+            }
+            proof_iter->chain(id, chain, lits);
+            chain.clear();
+            lits .clear();
+            markProcessed(id);
+            Q.pop();
         }
-        proof_iter->chain(goal, chain, lits);
-        chain.clear();
-        lits .clear();
-        markProcessed(goal);
     }
 }
 
@@ -350,8 +587,9 @@ void Proof::iterate(clause_id goal)
 {
     assert(proof_iter != NULL);
     proof_iter->begin();
-    iterateRec(goal);
+    iterateTopo(goal);
     proof_iter->end(goal);
+    ext_data.trim(true);
 }
 
 
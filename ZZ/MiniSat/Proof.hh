@@ -176,29 +176,81 @@ struct ProofCheck : public ProofIter {
 // -- Helper class:
 
 
+// Byte store for the external part of the proof-log. By default a plain growing vector in
+// memory. After 'spill()', the bytes live in an unlinked temporary file (under '$TMPDIR') which
+// is memory-mapped in chunks of 'PfStore_ChunkSize' bytes. Only the last 'resident' chunks are
+// kept in the working set; older chunks are handed back to the OS (and paged in again on demand
+// when the proof is traversed). A single record never straddles a chunk boundary, so pointers
+// returned by 'ptr()' can be read sequentially.
+//
+static const uint PfStore_ChunkBits = 24;
+static const uind PfStore_ChunkSize = uind(1) << PfStore_ChunkBits;
+static const uind PfStore_ChunkMask = PfStore_ChunkSize - 1;
+
+class PfStore : public NonCopyable {
+    Vec<uchar>  mem;        // -- in-memory mode
+    Vec<uchar*> chunk;      // -- spilled mode: mapped chunks
+    Vec<uint>   span;       // -- number of chunks in the mapping starting at 'chunk[i]' (0 = continuation of previous mapping)
+    uind        sz;         // -- spilled mode: current size (including padding)
+    uind        pad;        // -- bytes wasted at the end of chunks
+    uind        trimmed;    // -- chunks below this index have been released from the working set
+    int         fd;
+    uint        resident;
+    bool        disk;
+
+    void openFile();
+    void mapChunks(uint n);
+    void unmapFrom(uind n_chunks);
+
+    friend class Proof;
+
+public:
+    PfStore() : sz(0), pad(0), trimmed(0), fd(-1), resident(0), disk(false) {}
+   ~PfStore() { clear(); }
+
+    bool   spilled() const { return disk; }
+    uind   size   () const { return disk ? sz : mem.size(); }
+    uind   padding() const { return pad; }
+
+    uind   alloc(uind n);                   // -- Reserve 'n' contiguous bytes; returns offset.
+    void   shrinkTo(uind size);
+    void   clear();                         // -- Frees all data, but stays in spilled mode if set.
+    void   trim(bool full = false);         // -- Release all but the last 'resident' chunks from the working set.
+    bool   spill(uint resident_chunks);     // -- Clear and switch to spilled mode. Returns FALSE if not supported.
+
+    uchar*       ptr(uind off)       { return disk ? chunk[off >> PfStore_ChunkBits] + (off & PfStore_ChunkMask) : &mem[off]; }
+    const uchar* ptr(uind off) const { return disk ? chunk[off >> PfStore_ChunkBits] + (off & PfStore_ChunkMask) : &mem[off]; }
+
+    void copyTo(PfStore& dst) const;
+    void moveTo(PfStore& dst);
+};
+
+
 struct PfHead {
     uint64 data_offset;     // -- bit0 = is root,  bit1 = is external,  bit2..63 = offset or data
-                            // -- NOTE! Method 'compact()' in 'Proof' hacks directly on this representation
+                            // -- NOTE! Method 'relocate()' in 'Proof' hacks directly on this representation
     bool isRoot() const {
         return uchar(data_offset) & 1; }
 
     bool isExt() const {
         return (uchar(data_offset) & 2); }
 
-    const uchar* data(const Vec<uchar>& ext_data) const {
+    uind offset() const {
+        return uind(data_offset >> 2); }
+
+    const uchar* data(const PfStore& ext_data) const {
         if (isExt())
-            return &ext_data[uind(data_offset >> 2)];
+            return ext_data.ptr(offset());
         else
             return (uchar*)&data_offset + 1;
     }
 
-    void storeData(Vec<uchar>& ext_data, bool is_root, const Vec<uchar>& data) {
+    void storeData(PfStore& ext_data, bool is_root, const Vec<uchar>& data) {
         data_offset = uind(is_root);
         if (data.size() > 7){
-            data_offset |= 2 | ((uint64)ext_data.size() << 2);
-            //**/if (data_offset < ext_data.size()) Dump(data_offset, ext_data.size());
-            for (uind i = 0; i < data.size(); i++)
-                ext_data.push(data[i]);
+            uind off = ext_data.alloc(data.size());
+            data_offset |= 2 | ((uint64)off << 2);
+            memcpy(ext_data.ptr(off), data.base(), data.size());
         }else{
             uchar* inl_data = (uchar*)&data_offset + 1;
             for (uind i = 0; i < data.size(); i++)
@@ -227,7 +279,7 @@ class Proof : public NonCopyable {
 
     // Proof log:
     Vec<PfHead>      head;
-    Vec<uchar>       ext_data;
+    PfStore          ext_data;
     Vec<ushort>      refC;          // -- reference counting with saturation on 65535
     uind             freed_bytes;
     Queue<clause_id> free_list;     // -- recycled clause IDs
@@ -238,7 +290,7 @@ class Proof : public NonCopyable {
 
     void dump(clause_id id);        // -- debug
 
-    void iterateRec(clause_id goal);
+    void iterateTopo(clause_id goal);
     void ref  (clause_id id) { if (refC[id] != 65535) refC[id]++; }
     void deref(clause_id id) { if (refC[id] != 65535){ assert(refC[id] != 0); refC[id]--; } }
     void deref(clause_id id, Vec<clause_id>& Q) { deref(id); if (refC[id] == 0) Q.push(id); }
@@ -289,7 +341,9 @@ class Proof : public NonCopyable {
         return last_id;
     }
 
-    void compact();
+    uint extSize(clause_id id) const;
+    void relocate(PfStore& dst);
+    void compact() { relocate(ext_data); }
 
 public:
   //________________________________________
@@ -303,13 +357,13 @@ public:
         PfHead dummy;
         dummy.data_offset = 1;
         assert( ((uchar*)&dummy.data_offset)[0] == 1 );  // -- verify layout of 'data_offset'
-        ext_data.push(0);   // -- must not use offset 0
+        ext_data.alloc(1);  // -- must not use offset 0
     }
 
     void clear() {          // -- 'proof_iter' is NOT reset!
         proc_mask.clear(true);
         head     .clear(true);
-        ext_data .clear(true);
+        ext_data .clear();
         refC     .clear(true);
         free_list.clear(true);
         chain_id .clear(true);
@@ -317,6 +371,7 @@ public:
         buf      .clear(true);
         last_id     = clause_id_NULL;
         freed_bytes = 0;
+        ext_data.alloc(1);
     }
 
     void moveTo(Proof& dst) {
@@ -333,6 +388,7 @@ public:
         dst.freed_bytes = freed_bytes;
         last_id     = clause_id_NULL;
         freed_bytes = 0;
+        ext_data.alloc(1);
     }
 
     void copyTo(Proof& dst) const {
@@ -352,6 +408,13 @@ public:
 
     ProofIter* iterator() const { return proof_iter; }  // -- used internally in 'MiniSat.cc'; don't use directly.
 
+    bool spill(uint resident_chunks = 16);
+        // -- Move the external part of the proof-log to a memory-mapped temporary file, keeping
+        // only the last 'resident_chunks' chunks (16 MB each) in the working set. May be called
+        // at any time; the mode is kept through 'clear()'. Returns FALSE if not supported on
+        // this platform (proof stays in memory).
+    bool spilled() const { return ext_data.spilled(); }
+
   //________________________________________
   //  Proof Logging:
 
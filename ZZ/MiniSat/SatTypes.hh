@@ -40,6 +40,8 @@ struct SatStats {
     uint64  starts, decisions, propagations, conflicts, inspections, random_decis;
     uint64  clauses_literals, learnts_literals, max_literals, tot_literals, deleted_clauses;
     uint64  stuck_vars, stuck_clauses;
+    // Inprocessing statistics:
+    uint64  inproc_calls, subsumed_clauses, strengthened_clauses, eliminated_vars, vivified_clauses;
     // Incremental SAT statistics:
     uint64  solves, solves_sat, solves_unsat;
     uint64  inspections_sat, inspections_unsat;
@@ -49,6 +51,7 @@ struct SatStats {
         starts = decisions = propagations = conflicts = inspections = 0, random_decis = 0;
         clauses_literals = learnts_literals = max_literals = tot_literals = deleted_clauses = 0;
         stuck_vars = stuck_clauses = 0;
+        inproc_calls = subsumed_clauses = strengthened_clauses = eliminated_vars = vivified_clauses = 0;
         solves = solves_sat = solves_unsat = 0;
         inspections_sat = inspections_unsat = 0;
         time = time_sat = time_unsat = 0.0;
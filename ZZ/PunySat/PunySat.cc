@@ -16,6 +16,8 @@
 #include "ZZ/Generics/Lit.hh"
 #include "ZZ/Generics/IdHeap.hh"
 #include "ZZ/Generics/Sort.hh"
+#include "ZZ_MiniSat.hh"
+#include "PunySat.hh"
 
 namespace ZZ {
 using namespace std;
@@ -75,7 +77,7 @@ class PunySat {
     var_t       trail_sz;
     var_t       qhead;
 
-    var_t       tr_lim[BV::max_vars];
+    var_t       tr_lim[BV::max_vars * 2];  // -- (assumptions already implied get an empty decision level)
     var_t       dlev;
 
     uchar       seen  [BV::max_vars];
@@ -86,6 +88,7 @@ class PunySat {
     double      var_incr;
 
     BV          tmp;
+    Vec<lit_t>  assumps;
 
     void    bumpVar(var_t x);
     void    bumpCla(cla_id id);
@@ -100,6 +103,7 @@ class PunySat {
     bool    makeDecision();
     cla_id  propagate();                 // -- returns 0 if no conflict
     void    analyzeConflict(cla_id confl);
+    void    analyzeFinal(lit_t p);
     bool    analyzeRemovable(lit_t p0, uint64 levels);
     void    reduceDB();
 
@@ -107,14 +111,23 @@ class PunySat {
     void    dumpState();       // -- for debugging
 
 public:
-    PunySat() { clear(); }
+    PunySat() : verbose(false) { clear(); }
     void    clear();
 
     void    clAddPos(var_t var) { tmp.add(BV::mkNeg(var)); }   // -- intentionally flipping sign
     void    clAddNeg(var_t var) { tmp.add(BV::mkLit(var)); }
     void    clDone();
 
+    void    assumePos(var_t var) { assumps.push(BV::mkLit(var)); }
+    void    assumeNeg(var_t var) { assumps.push(BV::mkNeg(var)); }
+
     lbool   solve();
+        // -- Assumptions are consumed by this call. The solver cannot be reused without 'clear()'.
+
+    lbool   value(var_t x) const { return assign.has(BV::mkLit(x)) ? l_True : assign.has(BV::mkNeg(x)) ? l_False : l_Undef; }
+    Vec<Lit> conflict;      // -- if 'solve()' returned 'l_False', the assumptions used (a cube)
+
+    bool    verbose;        // -- print progress characters (restarts, reductions, learned units)
 
     void    writeCompactCnf(String filename, String mapfile);      // -- for debugging mostly
 
@@ -194,9 +207,14 @@ PS_(void) clear()
     var_incr = 1.0;
     cla_incr = 1.0;
 
+    assign.clear();
     clauses.clear();
     clauses.push();
+    c_activ.clear();
     c_activ.push(0);
+    order.clear();
+    assumps.clear();
+    conflict.clear();
 
     for (uint p = 0; p < BV::max_lits; p++)
         occurs[p].clear();
@@ -233,7 +251,9 @@ PS_(void) clDone()
     // <<== remove false literals here?
     // <<== remove satisfied clauses here?
 
-    if (tmp.singleton())
+    if (!tmp)
+        ok = false;
+    else if (tmp.singleton())
         ok &= enqueue(BV::neg(tmp.pop()), 0);   // -- neg to undo inversion in clAdd
     else{
         cla_id id = clauses.size(); assert_debug(id == clauses.size()); // -- if fails, we ran out of clause IDs and need to use a bigger type    <<== throw exception so that problem can be rerun on bigger solver?
@@ -294,7 +314,7 @@ PS_(void) clDoneLearned()
     if (tmp.singleton()){
         undo(0);
         p0 = tmp.pop();
-        /**/putchar('*'); fflush(stdout);
+        if (verbose){ putchar('*'); fflush(stdout); }
     }else{
         uint max_lv = 0;
         uint sec_lv = 0;
@@ -589,9 +609,38 @@ PS_(bool) analyzeRemovable(lit_t p0, uint64 levels)
 }
 
 
+// Assumption 'p' is false under the current assignment. Collect the assumptions that imply '~p'.
+PS_(void) analyzeFinal(lit_t p)
+{
+    conflict.clear();
+    conflict.push(lit(p));
+    if (level[BV::var(p)] == 0)
+        return;
+
+    seen[BV::var(p)] = 1;
+    for (uint i = trail_sz; i > tr_lim[0];){ i--;
+        var_t x = BV::var(trail[i]);
+        if (!seen[x]) continue;
+
+        if (reason[x] == 0){
+            assert(level[x] > 0);
+            conflict.push(lit(trail[i]));   // -- (all decisions so far are assumptions)
+        }else{
+            BV cl = clauses[reason[x]];
+            while (cl){
+                var_t y = BV::var(cl.pop());
+                if (level[y] > 0)
+                    seen[y] = 1;
+            }
+        }
+        seen[x] = 0;
+    }
+}
+
+
 PS_(void) reduceDB()
 {
-    /**/putchar('r'); fflush(stdout);
+    if (verbose){ putchar('r'); fflush(stdout); }
 
     // Quick and dirty way of sorting clauses with locked/high activity clauses first:
     Vec<uint>  cl_map(reserve_, clauses.size() - first_learned);
@@ -640,6 +689,11 @@ PS_(void) reduceDB()
 
 PS_(lbool) solve()
 {
+    conflict.clear();
+    if (!ok){
+        assumps.clear();
+        return l_False; }
+    assert(assumps.size() <= BV::max_vars);
     first_learned = clauses.size();
 
     for (uint n = 0;; n++){
@@ -652,6 +706,7 @@ PS_(lbool) solve()
             if (confl != 0){
                 if (dlev == 0){
                     ok = false;
+                    assumps.clear();
                     clauses.shrinkTo(first_learned);
                     return l_False; }
 
@@ -662,7 +717,7 @@ PS_(lbool) solve()
 
             }else{
                 if (conflC >= conflict_lim){
-                    /**/putchar('R'); fflush(stdout);
+                    if (verbose){ putchar('R'); fflush(stdout); }
                     n_restarts++;
                     undo(0);
                     // <<== simplify DB
@@ -671,7 +726,30 @@ PS_(lbool) solve()
                 if (clauses.size() - first_learned >= learned_lim + trail_sz)
                     reduceDB();
 
-                if (!makeDecision()){
+                // Assumptions are the first decisions:
+                lit_t p = lit_NULL;
+                while (dlev < assumps.size()){
+                    lit_t a = assumps[dlev];
+                    if (assign.has(BV::neg(a))){
+                        analyzeFinal(a);
+                        assumps.clear();
+                        clauses.shrinkTo(first_learned);
+                        return l_False;
+                    }else if (assign.has(a)){
+                        tr_lim[dlev] = trail_sz;
+                        dlev++;
+                    }else{
+                        p = a;
+                        break;
+                    }
+                }
+
+                if (p != lit_NULL){
+                    tr_lim[dlev] = trail_sz;
+                    dlev++;
+                    enqueueQ(p, 0);
+                }else if (!makeDecision()){
+                    assumps.clear();
                     clauses.shrinkTo(first_learned);
                     return l_True; }
             }
@@ -717,6 +795,173 @@ PS_(void) writeCompactCnf(String filename, String mapfile)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Batch interface:
+
+
+typedef PunySat<BV64x<2>, uint> PunySat64;     // -- 64 variables
+
+
+void PunyBatch::clear()
+{
+    cnf.clear();
+    assumps.clear();
+    models.clear();
+    confls.clear();
+    queries.clear();
+    n_solved = 0;
+    n_puny = 0;
+    n_minisat = 0;
+}
+
+
+uint PunyBatch::newQuery()
+{
+    queries.push();
+    Query& Q = queries.last();
+    Q.cnf0 = Q.cnf1 = cnf.size();
+    Q.assump0 = Q.assump1 = assumps.size();
+    Q.confl0 = Q.confl1 = 0;
+    Q.model = 0;
+    Q.n_vars = 0;
+    Q.result = l_Undef;
+    return queries.size() - 1;
+}
+
+
+void PunyBatch::addClause(const Vec<Lit>& c)
+{
+    assert(queries.size() > n_solved);
+    Query& Q = queries.last();
+    for (uint i = 0; i < c.size(); i++){
+        cnf.push(c[i]);
+        newMax(Q.n_vars, c[i].id + 1);
+    }
+    cnf.push(Lit_MAX);
+    Q.cnf1 = cnf.size();
+}
+
+
+void PunyBatch::addAssump(Lit p)
+{
+    assert(queries.size() > n_solved);
+    Query& Q = queries.last();
+    assumps.push(p);
+    newMax(Q.n_vars, p.id + 1);
+    Q.assump1 = assumps.size();
+}
+
+
+void PunyBatch::solvePuny(uint q)
+{
+    static PunySat64* S_ = NULL;    // -- kept between calls; 'clear()' does not free memory
+    if (!S_) S_ = new PunySat64;
+    PunySat64& S = *S_;
+    Query& Q = queries[q];
+
+    S.clear();
+    for (uint i = Q.cnf0; i < Q.cnf1; i++){
+        Lit p = cnf[i];
+        if (p == Lit_MAX)
+            S.clDone();
+        else if (p.sign)
+            S.clAddNeg(p.id);
+        else
+            S.clAddPos(p.id);
+    }
+    for (uint i = Q.assump0; i < Q.assump1; i++){
+        if (assumps[i].sign) S.assumeNeg(assumps[i].id);
+        else                 S.assumePos(assumps[i].id);
+    }
+
+    Q.result = S.solve();
+    if (Q.result == l_True){
+        for (uint x = 0; x < Q.n_vars; x++)
+            models[Q.model + x] = S.value(x);
+    }else{
+        for (uint i = 0; i < S.conflict.size(); i++)
+            confls.push(S.conflict[i]);
+    }
+    n_puny++;
+}
+
+
+void PunyBatch::solveMiniSat(uint q)
+{
+    SatStd S;
+    Query& Q = queries[q];
+
+    Vec<Lit>  vmap;
+    Vec<uint> vrev;     // -- solver variable -> query variable
+    for (uint x = 0; x < Q.n_vars; x++){
+        vmap.push(S.addLit());
+        vrev(vmap[x].id, UINT_MAX) = x;
+    }
+
+    Vec<Lit> tmp;
+    for (uint i = Q.cnf0; i < Q.cnf1; i++){
+        Lit p = cnf[i];
+        if (p == Lit_MAX){
+            S.addClause(tmp);
+            tmp.clear();
+        }else
+            tmp.push(vmap[p.id] ^ p.sign);
+    }
+
+    Vec<Lit> as;
+    for (uint i = Q.assump0; i < Q.assump1; i++)
+        as.push(vmap[assumps[i].id] ^ assumps[i].sign);
+
+    Q.result = S.solve(as);
+    if (Q.result == l_True){
+        for (uint x = 0; x < Q.n_vars; x++)
+            models[Q.model + x] = S.value(vmap[x]);
+    }else{
+        Vec<Lit> confl;
+        S.getConflict(confl);
+        for (uint i = 0; i < confl.size(); i++)
+            confls.push(Lit(vrev[confl[i].id], confl[i].sign));
+    }
+    n_minisat++;
+}
+
+
+void PunyBatch::solve()
+{
+    for (uint q = n_solved; q < queries.size(); q++){
+        Query& Q = queries[q];
+        Q.model = models.size();
+        models.growTo(models.size() + Q.n_vars, l_Undef);
+        Q.confl0 = confls.size();
+
+        if (Q.n_vars <= (uint)max_vars && Q.assump1 - Q.assump0 <= (uint)max_vars)
+            solvePuny(q);
+        else
+            solveMiniSat(q);
+        Q.confl1 = confls.size();
+    }
+    n_solved = queries.size();
+}
+
+
+lbool PunyBatch::value(uint q, uint x) const
+{
+    const Query& Q = queries[q];
+    assert(Q.result == l_True);
+    return (x < Q.n_vars) ? models[Q.model + x] : l_Undef;
+}
+
+
+void PunyBatch::getConflict(uint q, Vec<Lit>& assump_confl) const
+{
+    const Query& Q = queries[q];
+    assert(Q.result == l_False);
+    assump_confl.clear();
+    for (uint i = Q.confl0; i < Q.confl1; i++)
+        assump_confl.push(confls[i]);
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // DIMACS Parser:
 
@@ -761,6 +1006,7 @@ void punySatTest(int argc, char** argv)
   #else
     PunySat<BV32x<16>, uint> S;
   #endif
+    S.verbose = true;
     InFile in(cli.get("input").string_val);
     parse_DIMACS(in, S);
 
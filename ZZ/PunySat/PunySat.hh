@@ -13,10 +13,80 @@
 
 #ifndef ZZ__PunySat__PunySat_hh
 #define ZZ__PunySat__PunySat_hh
+
+#include "ZZ/Generics/Lit.hh"
+
 namespace ZZ {
 using namespace std;
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Batch solving of tiny SAT problems:
+
+
+// Collects many small, independent SAT queries and solves them in one go, reusing the same solver
+// object. Variables are numbered from 0. Queries over at most 'PunyBatch::max_vars' variables are
+// solved by PunySat (clauses as bit-vectors, no allocation per query), larger ones by MiniSat.
+// Each query may have assumptions; if it is UNSAT under them, 'getConflict()' returns the subset
+// used (a cube). Example:
+//
+//      PunyBatch B;
+//      uint q = B.newQuery();
+//      B.addClause(Lit(0), Lit(1));
+//      B.addAssump(~Lit(0));
+//      B.solve();
+//      if (B.result(q) == l_True) ... B.value(q, 1) ...
+//
+class PunyBatch {
+    Vec<Lit>    cnf;        // -- clauses of all queries, each terminated by 'Lit_MAX'
+    Vec<Lit>    assumps;
+    Vec<lbool>  models;
+    Vec<Lit>    confls;
+
+    struct Query {
+        uint    cnf0, cnf1;         // }- ranges in the vectors above
+        uint    assump0, assump1;   // }
+        uint    confl0, confl1;     // }
+        uint    model;              // -- 'n_vars' values starting here
+        uint    n_vars;             // -- 1 + largest variable ID
+        lbool   result;
+    };
+    Vec<Query>  queries;
+    uint        n_solved;           // -- queries '[0, n_solved)' have been solved
+
+    void solvePuny   (uint q);
+    void solveMiniSat(uint q);
+
+public:
+    enum { max_vars = 64 };
+
+    PunyBatch() { clear(); }
+    void clear();
+
+    // Specify queries:
+    uint newQuery();                    // -- returns the index of the new (current) query
+    void addClause(const Vec<Lit>& c);  // -- add clause to current query
+    void addClause(Lit p)               { tmp.setSize(1); tmp[0] = p; addClause(tmp); }
+    void addClause(Lit p, Lit q)        { tmp.setSize(2); tmp[0] = p; tmp[1] = q; addClause(tmp); }
+    void addClause(Lit p, Lit q, Lit r) { tmp.setSize(3); tmp[0] = p; tmp[1] = q; tmp[2] = r; addClause(tmp); }
+    void addAssump(Lit p);              // -- add assumption to current query
+
+    // Solve and extract results:
+    void  solve();                      // -- solve all queries added since last call
+    uint  size() const { return queries.size(); }
+    lbool result(uint q) const { return queries[q].result; }
+    lbool value (uint q, uint x) const; // -- 'l_Undef' if 'x' does not occur in the query
+    void  getConflict(uint q, Vec<Lit>& assump_confl) const;
+
+    // Statistics:
+    uint64 n_puny;
+    uint64 n_minisat;
+
+private:
+    Vec<Lit> tmp;
+};
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
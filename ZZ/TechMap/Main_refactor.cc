@@ -18,10 +18,12 @@ int main(int argc, char** argv)
     // Parse commandline:
     cli.add("input", "string", arg_REQUIRED, "Input AIGER, GIG or GNL.", 0);
     cli.add("coarsen", "bool", "no", "Detect XORs/MUXes before running.");
+    cli.add("timing", "bool", "no", "Build conjunctions on arrival times rather than for size alone.");
     cli.add("cec", "bool", "no", "Write AIGER files for equivalence checking.");
     cli.parseCmdLine(argc, argv);
 
     Params_Refactor P;
+    P.timing_aware = cli.get("timing").bool_val;
 
     // Read netlist:
     Gig N;
@@ -0,0 +1,89 @@
+#include "Prelude.hh"
+#include "ZZ_CmdLine.hh"
+#include "ZZ_Gig.IO.hh"
+#include "GigReader.hh"
+#include "Rewrite.hh"
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    // Parse commandline:
+    cli.add("input", "string", arg_REQUIRED, "Input AIGER, GIG or GNL.", 0);
+    cli.add("output", "string", "", "Output AIGER or GNL (optional).", 1);
+    cli.add("rounds", "uint", "2", "Number of rewriting passes.");
+    cli.add("cuts", "uint", "12", "Maximum number of cuts stored per node.");
+    cli.add("zero", "bool", "no", "Also apply zero-gain replacements.");
+    cli.add("balance", "bool", "yes", "Balance before and after rewriting.");
+    cli.add("cec", "bool", "no", "Write AIGER files for equivalence checking.");
+    cli.parseCmdLine(argc, argv);
+
+    Params_Rewrite P;
+    P.n_rounds  = cli.get("rounds").int_val;
+    P.cut_limit = cli.get("cuts").int_val;
+    P.zero_gain = cli.get("zero").bool_val;
+    bool bal    = cli.get("balance").bool_val;
+
+    // Read netlist:
+    Gig N;
+    try{
+        String input = cli.get("input").string_val;
+        if (hasExtension(input, "aig"))
+            readAigerFile(input, N, false);
+        else if (hasExtension(input, "gnl"))
+            N.load(input);
+        else if (hasExtension(input, "gig"))
+            readGigForTechmap(input, N);
+        else{
+            ShoutLn "ERROR! Unknown file extension: %_", input;
+            exit(1);
+        }
+    }catch (const Excp_Msg& err){
+        ShoutLn "PARSE ERROR! %_", err.msg;
+        exit(1);
+    }
+
+    // Cec?
+    if (cli.get("cec").bool_val){
+        expandXigGates(N);
+        writeAigerFile("before.aig", N);
+        WriteLn "Wrote: \a*before.aig\a*";
+    }
+
+    // Optimize:
+    double T0 = cpuTime();
+    if (bal) balance(N);
+    rewrite(N, P);
+    if (bal) balance(N);
+    double T1 = cpuTime();
+
+    // Cec?
+    if (cli.get("cec").bool_val){
+        expandXigGates(N);
+        writeAigerFile("after.aig", N);
+        WriteLn "Wrote: \a*after.aig\a*";
+    }
+
+    // Write output:
+    String output = cli.get("output").string_val;
+    if (output != ""){
+        if (hasExtension(output, "aig")){
+            expandXigGates(N);
+            writeAigerFile(output, N);
+        }else
+            N.save(output);
+        WriteLn "Wrote: \a*%_\a*", output;
+    }
+
+    // Print stats:
+    WriteLn "CPU Time: %t", T1 - T0;
+    WriteLn "Mem used: %DB", memUsed();
+
+    return 0;
+}
@@ -371,6 +371,7 @@ int main(int argc, char** argv)
     cli.add("slack"   , "{max} | float", "max", "Slack utilization. Smaller values means better average slack (but worse area).");
     cli.add("ela"     , "bool"  , "yes"       , "Exact local area.");
     cli.add("refact"  , "bool"  , "yes"       , "Refactoring (applied after unmapping)..");
+    cli.add("refact-timing", "bool", "no"     , "Make refactoring timing aware (build conjunctions on arrival times).");
     cli.add("unmap"   , "int[0:15]", "14"     , "Unmap options; see 'Unmap.hh'.");
     cli.add("batch"   , "bool"  , "no"        , "Output summary line at the end (for tabulation).");
     cli.add("tune"    , "bool"  , "no"        , "Override settings with \"tuned\" parameters.");
@@ -391,6 +392,7 @@ int main(int argc, char** argv)
     P.fmux_feeds_seq   = cli.get("fmux-ff").bool_val;
     P.exact_local_area = cli.get("ela").bool_val;
     P.refactor         = cli.get("refact").bool_val;
+    P.refactor_timing  = cli.get("refact-timing").bool_val;
     P.unmap.setOptions(cli.get("unmap").int_val);
     P.batch_output     = cli.get("batch").bool_val;
     if (cli.get("slack").choice == 1)
@@ -190,6 +190,8 @@ void printOptions(Params_TechMap& P, uint round, Out& out)
         FWriteLn(out) "unmap           : %_", P.unmap.getOptions();
     if (P.refactor != P0.refactor)
         FWriteLn(out) "refactor        : %_", P.refactor;
+    if (P.refactor_timing != P0.refactor_timing)
+        FWriteLn(out) "refactor_timing : %_", P.refactor_timing;
     if (P.cut_size != P0.cut_size)
         FWriteLn(out) "cut_size        : %_", P.cut_size;
     if (P.n_iters != P0.n_iters)
@@ -237,6 +239,7 @@ void randomizeParams(Params_TechMap& P, uint64 seed)
     P.slack_util       = FLIP ? RND(0, 3) : FLT_MAX;
     P.exact_local_area = FLIP;
     P.refactor         = FLIP;
+    P.refactor_timing  = FLIP;
     P.unmap.setOptions(RND(0, 15));
     P.est_power        = float(RND(0, 10)) / 2.0f;
     P.est_const        = float(RND(0,100)) / 10.0f;
@@ -272,7 +275,7 @@ void randomizeParams(Params_TechMap& P, uint64 seed)
 
 void mutateParams(Params_TechMap& P, uint64 seed)
 {
-    uint choice = RND(0, 17);
+    uint choice = RND(0, 18);
     switch (choice){
     case 0:  P.n_iters          = RND(1, 6); break;
     case 1:  P.recycle_iter     = RND(1, P.n_iters); break;
@@ -286,8 +289,9 @@ void mutateParams(Params_TechMap& P, uint64 seed)
     case 9:  P.unmap.setOptions(RND(0, 15)); break;
     case 10: P.est_power        = float(RND(0, 10)) / 2.0f; break;
     case 11: P.est_const        = float(RND(0,100)) / 10.0f; break;
+    case 12: P.refactor_timing  = !P.refactor_timing; break;
     default:
-        choice -= 12;
+        choice -= 13;
         if (choice <= 6)
             P.lut_cost[choice + 2] = float((int)RND(0, 100) - 20) / 10;
         else
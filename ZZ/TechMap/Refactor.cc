@@ -205,6 +205,7 @@ class Refactor {
     Gig&                   N;
     const WMap<uchar>&     fanout_count;    // -- saturated at 255.
     const WMap<uint>&      sec_prio;        // -- secondary priority (after pair occurance)
+    WMap<uint>&            arrival;         // -- only used if 'P.timing_aware'; extended with the gates created here
     const GateType         combinator;      // -- either 'gate_And' or 'gate_Xor'.
 
     typedef uint conj_id;
@@ -228,13 +229,15 @@ class Refactor {
 
     void addPairs();
     void combine(pair_id pid);
+    void buildTimingTree(Wire w, Vec<GLit>& leaves);
 
 public:
-    Refactor(Gig& N_, const WMap<uchar>& fanout_count_, const WMap<uint>& sec_prio_, GateType combinator_, const Params_Refactor& P_) :
+    Refactor(Gig& N_, const WMap<uchar>& fanout_count_, const WMap<uint>& sec_prio_, WMap<uint>& arrival_, GateType combinator_, const Params_Refactor& P_) :
         P(P_),
         N(N_),
         fanout_count(fanout_count_),
         sec_prio(sec_prio_),
+        arrival(arrival_),
         combinator(combinator_),
         Q(prio)
     {}
@@ -276,6 +279,33 @@ void Refactor::addConj(GLit w_top, const Vec<GLit>& elems)
 }
 
 
+// Huffman style construction: repeatedly combine the two earliest arriving signals, so that late
+// signals end up close to the root ('leaves' is destroyed).
+void Refactor::buildTimingTree(Wire w, Vec<GLit>& leaves)
+{
+    assert(leaves.size() >= 2);
+    sobSort(ordReverse(sob(leaves, proj_lt(brack<uint,GLit>(arrival)))));
+
+    while (leaves.size() > 2){
+        GLit x = leaves.popC();
+        GLit y = leaves.popC();
+        Wire u = N.add(combinator).init(x, y);
+        uint t = max_(arrival[x], arrival[y]) + 1;
+        arrival(u) = t;
+
+        // Insert 'u' keeping 'leaves' sorted on decreasing arrival time:
+        uint i = leaves.size();
+        leaves.push(u);
+        while (i > 0 && arrival[leaves[i-1]] < t){
+            leaves[i] = leaves[i-1];
+            i--; }
+        leaves[i] = u;
+    }
+    w.set(0, leaves[0]);
+    w.set(1, leaves[1]);
+}
+
+
 // Operates on member variable 'pairs'.
 void Refactor::addPairs()
 {
@@ -312,6 +342,8 @@ void Refactor::combine(pair_id pid)
     x[0] = id2pair[pid].fst;
     x[1] = id2pair[pid].snd;
     Wire w = N.add(combinator).init(x[0], x[1]);
+    if (P.timing_aware)
+        arrival(w) = max_(arrival[x[0]], arrival[x[1]]) + 1;
 
     for (uint n = 0; n < pair_occur_sz[pid]; n++){
         conj_id cid = pair_occur[pid][n];
@@ -404,8 +436,10 @@ void Refactor::run()
         assert(c.size() > 0);
         if (c.size() == 1){
             change(w, gate_Buf).init(c[0]);
+        }else if (P.timing_aware){
+            vecCopy(c, leaves);
+            buildTimingTree(w, leaves);
         }else{
-            // <<== do this timing aware
             vecCopy(c, leaves);
             for (uint i = 0; i < leaves.size() - 2; i += 2){
                 leaves.push(N.add(combinator).init(leaves[i], leaves[i+1]));
@@ -503,9 +537,14 @@ void refactor(Gig& N, WMapX<GLit>& remap, const Params_Refactor& P)
             }
         }
 
+        // Arrival times for timing aware reconstruction (recomputed since the previous phase changed the netlist):
+        WMap<uint> arrival;
+        if (P.timing_aware)
+            computeArrival(N, arrival);
+
         // Extract sets
         For_Gates(N, w) arr(w) = ~arr[w];   // -- 'arr' is secondary priority, with preference to large numbers (so invert them to prioritize short delays when combining nodes)
-        Refactor R(N, gtype_fanout_count, arr, gtype, P);
+        Refactor R(N, gtype_fanout_count, arr, arrival, gtype, P);
 
         WSeenS seen;
         WSeen  aux;
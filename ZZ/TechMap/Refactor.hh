@@ -25,12 +25,14 @@ using namespace std;
 
 struct Params_Refactor {
     uint max_conj_size;
-    bool timing_aware;      // <<== ignored for now
+    bool timing_aware;      // -- build conjunctions as Huffman trees on arrival times (late inputs close to the root)
+                            // NOTE! Arrival times use unit delay per logic gate plus the value of 'Delay' gates;
+                            // no cell library is consulted (refactoring runs before mapping).
     bool quiet;
 
     Params_Refactor() :
         max_conj_size(100),
-        timing_aware(true),
+        timing_aware(false),
         quiet(false)
     {}
 };
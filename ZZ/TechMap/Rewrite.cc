@@ -0,0 +1,1162 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Rewrite.cc
+//| Author(s)   : Niklas Een
+//| Module      : TechMap
+//| Description : DAG-aware rewriting of 4-input cuts and AND/XOR balancing.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Rewriting follows the classic scheme: for every AND gate, enumerate its 4-input cuts, compute
+//| the NPN class of the cut function and try the implementations stored for that class. The gain
+//| of a replacement is the size of the maximum fanout-free cone (MFFC) of the gate (w.r.t. the cut)
+//| minus the number of AND gates that do not already exist (outside the MFFC).
+//|
+//| The implementations are synthesized once, on first use, by recursive decomposition (cofactoring,
+//| unate Shannon expansion, disjoint support AND/OR/XOR decomposition) and kept in a small program
+//| format. Rewriting is done on a local AIG with reference counts and fanouts, which is written
+//| back to the 'Gig' after each pass.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "Rewrite.hh"
+#include "ZZ_Npn4.hh"
+#include "ZZ/Generics/Map.hh"
+#include "ZZ/Generics/Sort.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Synthesis of 4-input functions:
+
+
+macro ftb4_t cofactor4(ftb4_t f, uint x, bool val)
+{
+    ftb4_t mask  = ftb4_proj[0][x];
+    uint   shift = 1u << x;
+    if (val){
+        ftb4_t t = f & mask;
+        return t | (t >> shift);
+    }else{
+        ftb4_t t = f & ~mask;
+        return t | (t << shift);
+    }
+}
+
+
+// Existential or universal quantification of the variables in 'vars' (a bit-mask).
+macro ftb4_t quant4(ftb4_t f, uint vars, bool exist)
+{
+    for (uint x = 0; x < 4; x++){
+        if (vars & (1u << x)){
+            if (exist) f = cofactor4(f, x, 0) | cofactor4(f, x, 1);
+            else       f = cofactor4(f, x, 0) & cofactor4(f, x, 1);
+        }
+    }
+    return f;
+}
+
+
+macro ftb4_t setZero4(ftb4_t f, uint vars)
+{
+    for (uint x = 0; x < 4; x++)
+        if (vars & (1u << x))
+            f = cofactor4(f, x, 0);
+    return f;
+}
+
+
+enum RwDecType {
+    rdt_Const,      // f = 0 or 1
+    rdt_Lit,        // f = lit
+    rdt_And,        // f = g & h
+    rdt_Or,         // f = g | h
+    rdt_Xor,        // f = g ^ h
+    rdt_Mux,        // f = lit ? g : h
+    rdt_OrAnd,      // f = g | (lit & h)
+};
+
+
+struct RwDec {
+    uchar   type;
+    uchar   lit;    // -- '(var << 1) | sign'
+    ftb4_t  g;
+    ftb4_t  h;
+};
+
+
+macro RwDec mkRwDec(RwDecType type, uchar lit, ftb4_t g, ftb4_t h) {
+    RwDec d; d.type = type; d.lit = lit; d.g = g; d.h = h; return d; }
+
+
+// Decompositions only refer to functions of strictly smaller support, so the recursion terminates.
+// Costs count AND gates of the tree implementation (sharing is not considered).
+class RwSynth {
+    Vec<uchar> cost_;       // -- 255 means "not computed"
+    Vec<RwDec> best;
+
+public:
+    RwSynth() { cost_.growTo(65536, 255); best.growTo(65536); }
+
+    uint         cost(ftb4_t f);
+    const RwDec& dec (ftb4_t f) { cost(f); return best[f]; }
+    void         candidates(ftb4_t f, Vec<Pair<uint,RwDec> >& out);
+};
+
+
+void RwSynth::candidates(ftb4_t f, Vec<Pair<uint,RwDec> >& out)
+{
+    if (f == 0 || f == 0xFFFF){
+        out.push(make_tuple(0u, mkRwDec(rdt_Const, 0, f, 0)));
+        return; }
+
+    for (uint x = 0; x < 4; x++){
+        for (uint s = 0; s < 2; s++){
+            if (f == ftb4_proj[s][x]){
+                out.push(make_tuple(0u, mkRwDec(rdt_Lit, (x << 1) | s, 0, 0)));
+                return; }
+        }
+    }
+
+    uint sup = 0;
+    for (uint x = 0; x < 4; x++)
+        if (ftb4_inSup(f, x)) sup |= 1u << x;
+
+    // Cofactoring:
+    for (uint x = 0; x < 4; x++){
+        if (!(sup & (1u << x))) continue;
+        ftb4_t f1 = cofactor4(f, x, 1);
+        ftb4_t f0 = cofactor4(f, x, 0);
+        ftb4_t p  = ftb4_proj[0][x];
+        ftb4_t n  = ftb4_proj[1][x];
+        uchar  lp = x << 1;
+        uchar  ln = (x << 1) | 1;
+
+        if (f0 == 0)                 out.push(make_tuple(1 + cost(f1), mkRwDec(rdt_And, 0, p, f1)));
+        if (f1 == 0)                 out.push(make_tuple(1 + cost(f0), mkRwDec(rdt_And, 0, n, f0)));
+        if (f0 == 0xFFFF)            out.push(make_tuple(1 + cost(f1), mkRwDec(rdt_Or , 0, n, f1)));
+        if (f1 == 0xFFFF)            out.push(make_tuple(1 + cost(f0), mkRwDec(rdt_Or , 0, p, f0)));
+        if (f0 == ftb4_t(~f1))       out.push(make_tuple(3 + cost(f0), mkRwDec(rdt_Xor, 0, p, f0)));
+        if ((f0 & ~f1 & 0xFFFF) == 0) out.push(make_tuple(2 + cost(f0) + cost(f1), mkRwDec(rdt_OrAnd, lp, f0, f1)));
+        if ((f1 & ~f0 & 0xFFFF) == 0) out.push(make_tuple(2 + cost(f1) + cost(f0), mkRwDec(rdt_OrAnd, ln, f1, f0)));
+        out.push(make_tuple(3 + cost(f1) + cost(f0), mkRwDec(rdt_Mux, lp, f1, f0)));
+    }
+
+    // Disjoint support decomposition (the lowest variable always goes to 'a'):
+    uint low = sup & -sup;
+    for (uint a = 1; a < 16; a++){
+        if ((a & sup) != a || a == sup || !(a & low)) continue;
+        uint b = sup & ~a;
+
+        ftb4_t g = quant4(f, b, true), h = quant4(f, a, true);
+        if ((g & h) == f)
+            out.push(make_tuple(1 + cost(g) + cost(h), mkRwDec(rdt_And, 0, g, h)));
+
+        g = quant4(f, b, false), h = quant4(f, a, false);
+        if ((g | h) == f)
+            out.push(make_tuple(1 + cost(g) + cost(h), mkRwDec(rdt_Or, 0, g, h)));
+
+        g = setZero4(f, b), h = setZero4(f, a);
+        if (f & 1) h = ~h;
+        if (ftb4_t(g ^ h) == f)
+            out.push(make_tuple(3 + cost(g) + cost(h), mkRwDec(rdt_Xor, 0, g, h)));
+    }
+}
+
+
+uint RwSynth::cost(ftb4_t f)
+{
+    if (cost_[f] != 255)
+        return cost_[f];
+
+    Vec<Pair<uint,RwDec> > cands;
+    candidates(f, cands);
+    assert(cands.size() > 0);
+
+    uint j = 0;
+    for (uint i = 1; i < cands.size(); i++)
+        if (cands[i].fst < cands[j].fst)
+            j = i;
+
+    assert(cands[j].fst < 255);
+    cost_[f] = cands[j].fst;
+    best [f] = cands[j].snd;
+    return cost_[f];
+}
+
+
+//=================================================================================================
+// -- Implementation programs:
+
+
+// Program literals are '(idx << 1) | sign' where 'idx' is 0 for constant FALSE, 1..4 for the pins
+// and '5 + i' for step 'i'. Layout: '[#steps, output, depth, a0, b0, a1, b1, ...]'.
+static const uint rw_FirstStep = 5;
+
+
+class RwProgBuilder {
+    RwSynth&          S;
+    Map<uint,uchar>   strash;
+    Map<uint,uchar>   memo;         // -- FTB -> literal
+    Vec<uchar>        steps;
+    Vec<uchar>        level;
+
+    uchar mkAnd(uchar a, uchar b);
+    uchar lit(uchar dec_lit) { return (((dec_lit >> 1) + 1) << 1) | (dec_lit & 1); }
+
+public:
+    RwProgBuilder(RwSynth& S_) : S(S_) {}
+
+    uchar build   (ftb4_t f);
+    uchar buildDec(const RwDec& d);
+    void  finish  (uchar out, Vec<uchar>& prog);
+};
+
+
+uchar RwProgBuilder::mkAnd(uchar a, uchar b)
+{
+    if (a > b) swp(a, b);
+    if (a == 0)       return 0;
+    if (a == 1)       return b;
+    if (a == b)       return a;
+    if (a == (b ^ 1)) return 0;
+
+    uchar* r;
+    if (!strash.get((uint(a) << 8) | b, r)){
+        uint idx = rw_FirstStep + steps.size() / 2;
+        assert(idx < 128);
+        steps.push(a);
+        steps.push(b);
+        level(idx, 0) = max_(level(a >> 1, 0), level(b >> 1, 0)) + 1;
+        *r = idx << 1;
+    }
+    return *r;
+}
+
+
+uchar RwProgBuilder::build(ftb4_t f)
+{
+    uchar r;
+    if (memo.peek(f, r))             return r;
+    if (memo.peek(ftb4_t(~f), r))    return r ^ 1;
+
+    r = buildDec(S.dec(f));
+    memo.set(f, r);
+    return r;
+}
+
+
+uchar RwProgBuilder::buildDec(const RwDec& d)
+{
+    switch (d.type){
+    case rdt_Const: return (d.g == 0) ? 0 : 1;
+    case rdt_Lit:   return lit(d.lit);
+    case rdt_And:   return mkAnd(build(d.g), build(d.h));
+    case rdt_Or:    return mkAnd(build(d.g) ^ 1, build(d.h) ^ 1) ^ 1;
+    case rdt_Xor:{
+        uchar a = build(d.g), b = build(d.h);
+        return mkAnd(mkAnd(a, b ^ 1) ^ 1, mkAnd(a ^ 1, b) ^ 1) ^ 1; }
+    case rdt_Mux:{
+        uchar s = lit(d.lit);
+        return mkAnd(mkAnd(s, build(d.g)) ^ 1, mkAnd(s ^ 1, build(d.h)) ^ 1) ^ 1; }
+    case rdt_OrAnd:{
+        uchar s = lit(d.lit);
+        return mkAnd(build(d.g) ^ 1, mkAnd(s, build(d.h)) ^ 1) ^ 1; }
+    default: assert(false); return 0; }
+}
+
+
+// Only steps reachable from 'out' are kept.
+void RwProgBuilder::finish(uchar out, Vec<uchar>& prog)
+{
+    uint n_steps = steps.size() / 2;
+    Vec<uchar> used(n_steps, 0);
+    if ((out >> 1) >= rw_FirstStep) used[(out >> 1) - rw_FirstStep] = 1;
+    for (uint i = n_steps; i > 0;){ i--;
+        if (!used[i]) continue;
+        for (uint j = 0; j < 2; j++){
+            uint idx = steps[2*i + j] >> 1;
+            if (idx >= rw_FirstStep) used[idx - rw_FirstStep] = 1;
+        }
+    }
+
+    Vec<uchar> xlat(rw_FirstStep + n_steps);
+    for (uint i = 0; i < rw_FirstStep; i++) xlat[i] = i;
+    prog.setSize(3);
+    for (uint i = 0; i < n_steps; i++){
+        if (!used[i]) continue;
+        xlat[rw_FirstStep + i] = rw_FirstStep + (prog.size() - 3) / 2;
+        for (uint j = 0; j < 2; j++){
+            uchar p = steps[2*i + j];
+            prog.push((xlat[p >> 1] << 1) | (p & 1));
+        }
+    }
+    prog[0] = (prog.size() - 3) / 2;
+    prog[1] = (xlat[out >> 1] << 1) | (out & 1);
+    prog[2] = level(out >> 1, 0);
+}
+
+
+static
+ftb4_t simulateProg(const Vec<uchar>& prog)
+{
+    Vec<ftb4_t> val(rw_FirstStep + prog[0]);
+    val[0] = 0;
+    for (uint i = 0; i < 4; i++) val[i+1] = ftb4_proj[0][i];
+    for (uint i = 0; i < prog[0]; i++){
+        uchar a = prog[3 + 2*i], b = prog[4 + 2*i];
+        val[rw_FirstStep + i] = (val[a >> 1] ^ ((a & 1) ? 0xFFFF : 0)) & (val[b >> 1] ^ ((b & 1) ? 0xFFFF : 0));
+    }
+    return val[prog[1] >> 1] ^ ((prog[1] & 1) ? 0xFFFF : 0);
+}
+
+
+//=================================================================================================
+// -- Library:
+
+
+// A few implementations per NPN class: the best decomposition at the top followed by the
+// runner-ups. Different top-level choices expose different subfunctions for sharing.
+struct RwLib {
+    enum { MAX_ALTS = 4 };
+
+    Vec<Vec<uchar> > progs[222];
+    uchar            perm_map[24][4];   // -- pin 'k' of the representative becomes input 'perm_map[perm][k]'
+
+    RwLib();
+};
+
+
+RwLib::RwLib()
+{
+    for (uint perm = 0; perm < 24; perm++){
+        for (uint k = 0; k < 4; k++){
+            ftb4_t g = apply_perm4[perm][ftb4_proj[0][k]];
+            perm_map[perm][k] = 255;
+            for (uint j = 0; j < 4; j++)
+                if (g == ftb4_proj[0][j]) perm_map[perm][k] = j;
+            assert(perm_map[perm][k] != 255);
+        }
+    }
+
+    RwSynth S;
+    Vec<Pair<uint,RwDec> > cands;
+    Vec<Pair<uint,uint> > order;
+    Vec<uchar> prog;
+    for (uint cl = 0; cl < 222; cl++){
+        ftb4_t f = npn4_repr[cl];
+        cands.clear();
+        S.candidates(f, cands);
+
+        order.clear();
+        for (uint i = 0; i < cands.size(); i++)
+            order.push(make_tuple(cands[i].fst, i));
+        sort(order);
+
+        for (uint i = 0; i < order.size() && progs[cl].size() < MAX_ALTS; i++){
+            if (order[i].fst > order[0].fst + 2) break;
+            RwProgBuilder B(S);
+            uchar out = B.buildDec(cands[order[i].snd].snd);
+            B.finish(out, prog);
+            assert(simulateProg(prog) == f);
+
+            bool dup = false;
+            for (uint j = 0; j < progs[cl].size(); j++)
+                if (vecEqual(progs[cl][j], prog)){ dup = true; break; }
+            if (!dup){
+                progs[cl].push();
+                prog.copyTo(progs[cl].last());
+            }
+        }
+    }
+}
+
+
+static
+const RwLib& rwLib()
+{
+    static RwLib* lib = NULL;
+    if (!lib) lib = new RwLib;
+    return *lib;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Local AIG for rewriting:
+
+
+typedef uint alit;      // -- '(node << 1) | sign'
+
+static const alit alit_False = 0;
+static const alit alit_True  = 1;
+static const alit alit_NULL  = UINT_MAX;
+
+macro uint aVar (alit p)              { return p >> 1; }
+macro bool aSign(alit p)              { return p & 1; }
+macro alit mkALit(uint n, bool s = 0) { return (n << 1) | uint(s); }
+
+static const uint fo_Out = 0x80000000;     // -- fanout to external output (index in 'outs')
+
+
+struct RwCut {
+    uint sz;
+    uint leaf[4];       // -- sorted
+};
+
+
+struct RwCut_lt {
+    bool operator()(const RwCut& x, const RwCut& y) const { return x.sz < y.sz; }
+};
+
+
+static
+bool mergeCuts(const RwCut& c0, const RwCut& c1, RwCut& out)
+{
+    uint i = 0, j = 0;
+    out.sz = 0;
+    while (i < c0.sz || j < c1.sz){
+        uint x;
+        if      (j == c1.sz)               x = c0.leaf[i++];
+        else if (i == c0.sz)               x = c1.leaf[j++];
+        else if (c0.leaf[i] < c1.leaf[j])  x = c0.leaf[i++];
+        else if (c0.leaf[i] > c1.leaf[j])  x = c1.leaf[j++];
+        else                               x = c0.leaf[i++], j++;
+        if (out.sz == 4) return false;
+        out.leaf[out.sz++] = x;
+    }
+    return true;
+}
+
+
+static
+bool subsumes(const RwCut& small, const RwCut& big)
+{
+    if (small.sz > big.sz) return false;
+    uint j = 0;
+    for (uint i = 0; i < small.sz; i++){
+        while (j < big.sz && big.leaf[j] < small.leaf[i]) j++;
+        if (j == big.sz || big.leaf[j] != small.leaf[i]) return false;
+    }
+    return true;
+}
+
+
+class Rewriter {
+    Gig&                  N;
+    const Params_Rewrite& P;
+    const RwLib&          L;
+
+    // Local AIG (node 0 is constant FALSE; CIs and the constant have null fanins):
+    Vec<alit>           fan0;
+    Vec<alit>           fan1;
+    Vec<uint>           ref;
+    Vec<uchar>          dead;
+    Vec<Vec<uint> >     fanouts;    // -- may contain stale entries
+    Map<uint64,uint>    strash;
+    Vec<GLit>           ci_gate;
+    Vec<alit>           outs;
+    Vec<Pair<GLit,uint> > out_pins;
+
+    Vec<Vec<RwCut> >    cuts;       // -- computed lazily; leaves may go stale when the netlist changes
+    Vec<uint>           mark;
+    uint                stamp;
+
+    Vec<uint>           sim_stamp;
+    Vec<ftb4_t>         sim_val;
+    Vec<alit>           tmp_lits;
+    Vec<uint>           created;
+
+    bool   isAnd(uint n) const { return fan0[n] != alit_NULL; }
+    uint64 key(alit a, alit b) const { return (uint64(a) << 32) | b; }
+
+    uint  newNode(alit a, alit b);
+    bool  trivialAnd(alit& a, alit& b, alit& result) const;
+    alit  lookupAnd(alit a, alit b) const;
+    alit  mkAnd(alit a, alit b);
+    void  unhash(uint n);
+    void  deleteNode(uint n);
+    void  replace(uint n, alit r);
+
+    void  computeCuts(uint n);
+    bool  simCut(uint n, const RwCut& cut, ftb4_t& ftb);
+    bool  simRec(uint n, uint& budget, ftb4_t& ftb);
+    uint  deref(uint n);
+    void  reref(uint n);
+    uint  countAdded(const Vec<uchar>& prog, const alit pins[4], uint limit);
+    alit  buildProg(const Vec<uchar>& prog, const alit pins[4]);
+    bool  tryRewrite(uint n);
+
+public:
+    uint  n_rewrites;
+
+    Rewriter(Gig& N_, const Params_Rewrite& P_) : N(N_), P(P_), L(rwLib()), stamp(0), n_rewrites(0) {}
+
+    void load();
+    void run();
+    void store();
+};
+
+
+//=================================================================================================
+// -- Netlist operations:
+
+
+uint Rewriter::newNode(alit a, alit b)
+{
+    uint n = fan0.size();
+    fan0.push(a);
+    fan1.push(b);
+    ref.push(0);
+    dead.push(0);
+    fanouts.push();
+    cuts.push();
+    if (a != alit_NULL){
+        ref[aVar(a)]++; fanouts[aVar(a)].push(n);
+        ref[aVar(b)]++; fanouts[aVar(b)].push(n);
+        strash.set(key(a, b), n);
+    }
+    return n;
+}
+
+
+// Normalizes the order of 'a' and 'b'. Returns TRUE if 'a & b' is a constant or a literal.
+bool Rewriter::trivialAnd(alit& a, alit& b, alit& result) const
+{
+    if (a > b) swp(a, b);
+    if      (a == alit_False) result = alit_False;
+    else if (a == alit_True)  result = b;
+    else if (a == b)          result = a;
+    else if (a == (b ^ 1))    result = alit_False;
+    else                      return false;
+    return true;
+}
+
+
+alit Rewriter::lookupAnd(alit a, alit b) const
+{
+    alit r;
+    if (trivialAnd(a, b, r)) return r;
+    uint n;
+    if (strash.peek(key(a, b), n) && !dead[n]) return mkALit(n);
+    return alit_NULL;
+}
+
+
+alit Rewriter::mkAnd(alit a, alit b)
+{
+    alit r = lookupAnd(a, b);
+    if (r != alit_NULL) return r;
+    if (a > b) swp(a, b);
+    uint n = newNode(a, b);
+    created.push(n);
+    return mkALit(n);
+}
+
+
+void Rewriter::unhash(uint n)
+{
+    uint m;
+    if (strash.peek(key(fan0[n], fan1[n]), m) && m == n)
+        strash.exclude(key(fan0[n], fan1[n]));
+}
+
+
+void Rewriter::deleteNode(uint n)
+{
+    Vec<uint> Q;
+    Q.push(n);
+    while (Q.size() > 0){
+        uint x = Q.popC();
+        if (dead[x]) continue;
+        assert(ref[x] == 0);
+        dead[x] = 1;
+        unhash(x);
+        cuts[x].clear(true);
+        fanouts[x].clear(true);
+        for (uint i = 0; i < 2; i++){
+            uint y = aVar(i == 0 ? fan0[x] : fan1[x]);
+            ref[y]--;
+            if (ref[y] == 0 && isAnd(y) && !dead[y])
+                Q.push(y);
+        }
+    }
+}
+
+
+// Move all fanouts of 'n' to 'r' and delete 'n'. Fanouts that become trivial or structurally
+// equivalent to an existing node are replaced in turn.
+void Rewriter::replace(uint n, alit r)
+{
+    assert(aVar(r) != n);
+    Vec<uint> fos;
+    fanouts[n].moveTo(fos);
+
+    for (uint i = 0; i < fos.size(); i++){
+        uint f = fos[i];
+        if (f & fo_Out){
+            uint k = f & ~fo_Out;
+            if (aVar(outs[k]) != n) continue;
+            outs[k] = r ^ aSign(outs[k]);
+            ref[n]--; ref[aVar(r)]++;
+            fanouts[aVar(r)].push(f);
+            continue;
+        }
+        if (dead[f] || (aVar(fan0[f]) != n && aVar(fan1[f]) != n)) continue;
+
+        unhash(f);
+        alit a = fan0[f], b = fan1[f];
+        if (aVar(a) == n){ a = r ^ aSign(a); ref[n]--; ref[aVar(r)]++; }
+        if (aVar(b) == n){ b = r ^ aSign(b); ref[n]--; ref[aVar(r)]++; }
+        fanouts[aVar(r)].push(f);
+        cuts[f].clear();
+
+        alit s;
+        bool triv = trivialAnd(a, b, s);
+        fan0[f] = a;
+        fan1[f] = b;
+        if (!triv){
+            uint g;
+            if (strash.peek(key(a, b), g) && g != f && !dead[g]){
+                s = mkALit(g);
+                triv = true;
+            }else
+                strash.set(key(a, b), f);
+        }
+
+        if (triv){
+            if (ref[f] == 0) deleteNode(f);
+            else             replace(f, s);
+        }
+    }
+
+    assert(ref[n] == 0);
+    deleteNode(n);
+}
+
+
+//=================================================================================================
+// -- Cuts and simulation:
+
+
+void Rewriter::computeCuts(uint n0)
+{
+    Vec<uint> Q;
+    Q.push(n0);
+    while (Q.size() > 0){
+        uint n = Q.last();
+        if (cuts[n].size() > 0){ Q.pop(); continue; }
+
+        RwCut triv;
+        triv.sz = 1;
+        triv.leaf[0] = n;
+        if (!isAnd(n)){
+            cuts[n].push(triv);
+            Q.pop();
+            continue; }
+
+        uint a = aVar(fan0[n]), b = aVar(fan1[n]);
+        if (cuts[a].size() == 0 || cuts[b].size() == 0){
+            if (cuts[a].size() == 0) Q.push(a);
+            if (cuts[b].size() == 0) Q.push(b);
+            continue; }
+        Q.pop();
+
+        Vec<RwCut>& out = cuts[n];
+        for (uint i = 0; i < cuts[a].size(); i++){
+            for (uint j = 0; j < cuts[b].size(); j++){
+                RwCut c;
+                if (!mergeCuts(cuts[a][i], cuts[b][j], c)) continue;
+                for (uint k = 0; k < c.sz; k++)
+                    if (dead[c.leaf[k]]) goto Skip;
+
+                for (uint k = 0; k < out.size();){
+                    if (subsumes(out[k], c)) goto Skip;
+                    if (subsumes(c, out[k])) out[k] = out.popC();
+                    else k++;
+                }
+                out.push(c);
+              Skip:;
+            }
+        }
+        sobSort(sob(out, RwCut_lt()));
+        out.shrinkTo(min_(out.size(), P.cut_limit));
+        out.push(triv);
+    }
+}
+
+
+// Compute the function of 'n' in terms of the leaves of 'cut'. Returns FALSE if the cut is no
+// longer a cut of 'n' (or is unreasonably deep).
+bool Rewriter::simCut(uint n, const RwCut& cut, ftb4_t& ftb)
+{
+    stamp++;
+    for (uint i = 0; i < cut.sz; i++){
+        sim_stamp(cut.leaf[i], 0) = stamp;
+        sim_val(cut.leaf[i], 0) = ftb4_proj[0][i];
+    }
+    sim_stamp(0, 0) = stamp;
+    sim_val(0, 0) = 0;
+
+    uint budget = 32;
+    return simRec(n, budget, ftb);
+}
+
+
+bool Rewriter::simRec(uint n, uint& budget, ftb4_t& ftb)
+{
+    if (sim_stamp(n, 0) == stamp){
+        ftb = sim_val[n];
+        return true; }
+    if (!isAnd(n) || budget == 0)
+        return false;
+    budget--;
+
+    ftb4_t f0, f1;
+    if (!simRec(aVar(fan0[n]), budget, f0)) return false;
+    if (!simRec(aVar(fan1[n]), budget, f1)) return false;
+    if (aSign(fan0[n])) f0 = ~f0;
+    if (aSign(fan1[n])) f1 = ~f1;
+
+    ftb = f0 & f1;
+    sim_stamp[n] = stamp;
+    sim_val(n, 0) = ftb;
+    return true;
+}
+
+
+//=================================================================================================
+// -- Rewriting:
+
+
+// Dereference the cone of 'n' and mark its MFFC (with 'stamp'). Returns the size of the MFFC.
+uint Rewriter::deref(uint n)
+{
+    uint count = 1;
+    mark(n, 0) = stamp;
+    for (uint i = 0; i < 2; i++){
+        uint x = aVar(i == 0 ? fan0[n] : fan1[n]);
+        ref[x]--;
+        if (ref[x] == 0 && isAnd(x))
+            count += deref(x);
+    }
+    return count;
+}
+
+
+void Rewriter::reref(uint n)
+{
+    for (uint i = 0; i < 2; i++){
+        uint x = aVar(i == 0 ? fan0[n] : fan1[n]);
+        if (ref[x] == 0 && isAnd(x))
+            reref(x);
+        ref[x]++;
+    }
+}
+
+
+// Number of AND gates needed for 'prog' that are not already present outside the MFFC. Stops
+// counting after 'limit' is exceeded.
+uint Rewriter::countAdded(const Vec<uchar>& prog, const alit pins[4], uint limit)
+{
+    Vec<alit>& lits = tmp_lits;
+    lits.setSize(rw_FirstStep);
+    lits[0] = alit_False;
+    for (uint i = 0; i < 4; i++) lits[i+1] = pins[i];
+
+    uint added = 0;
+    for (uint i = 0; i < prog[0]; i++){
+        uchar pa = prog[3 + 2*i], pb = prog[4 + 2*i];
+        alit a = lits[pa >> 1];
+        alit b = lits[pb >> 1];
+        alit r = alit_NULL;
+        if (a != alit_NULL && b != alit_NULL){
+            r = lookupAnd(a ^ (pa & 1), b ^ (pb & 1));
+            if (r != alit_NULL && mark(aVar(r), 0) == stamp)
+                added++;
+        }
+        if (r == alit_NULL)
+            added++;
+        if (added > limit)
+            return added;
+        lits.push(r);
+    }
+    return added;
+}
+
+
+alit Rewriter::buildProg(const Vec<uchar>& prog, const alit pins[4])
+{
+    Vec<alit>& lits = tmp_lits;
+    lits.setSize(rw_FirstStep);
+    lits[0] = alit_False;
+    for (uint i = 0; i < 4; i++) lits[i+1] = pins[i];
+
+    for (uint i = 0; i < prog[0]; i++){
+        uchar pa = prog[3 + 2*i], pb = prog[4 + 2*i];
+        lits.push(mkAnd(lits[pa >> 1] ^ (pa & 1), lits[pb >> 1] ^ (pb & 1)));
+    }
+    return lits[prog[1] >> 1] ^ (prog[1] & 1);
+}
+
+
+bool Rewriter::tryRewrite(uint n)
+{
+    computeCuts(n);
+    Vec<RwCut> cs;
+    cuts[n].copyTo(cs);
+
+    uint  best_gain = P.zero_gain ? 0 : 1;
+    bool  found = false;
+    alit  best_pins[4];
+    bool  best_neg = false;
+    const Vec<uchar>* best_prog = NULL;
+
+    for (uint i = 0; i < cs.size(); i++){
+        const RwCut& c = cs[i];
+        if (c.sz == 1 && c.leaf[0] == n) continue;     // -- trivial cut
+
+        ftb4_t ftb;
+        if (!simCut(n, c, ftb)) continue;
+
+        const Npn4Norm& norm = npn4_norm[ftb];
+        alit pins[4];
+        for (uint k = 0; k < 4; k++){
+            uint j = L.perm_map[norm.perm][k];
+            pins[k] = (j < c.sz) ? mkALit(c.leaf[j], (norm.negs >> j) & 1) : alit_False;
+        }
+        bool neg = (norm.negs >> 4) & 1;
+
+        for (uint k = 0; k < c.sz; k++) ref[c.leaf[k]]++;
+        stamp++;
+        uint saved = deref(n);
+
+        const Vec<Vec<uchar> >& progs = L.progs[norm.eq_class];
+        for (uint j = 0; j < progs.size(); j++){
+            uint added = countAdded(progs[j], pins, saved);
+            if (added > saved) continue;
+            uint gain = saved - added;
+            if (found ? gain > best_gain : gain >= best_gain){
+                found = true;
+                best_gain = gain;
+                best_prog = &progs[j];
+                for (uint k = 0; k < 4; k++) best_pins[k] = pins[k];
+                best_neg = neg;
+            }
+        }
+
+        reref(n);
+        for (uint k = 0; k < c.sz; k++) ref[c.leaf[k]]--;
+    }
+
+    if (!found) return false;
+
+    // Apply best replacement:
+    created.clear();
+    alit r = buildProg(*best_prog, best_pins) ^ best_neg;
+    bool changed = (aVar(r) != n);
+    if (changed){
+        ref[aVar(r)]++;
+        replace(n, r);
+        ref[aVar(r)]--;
+        n_rewrites++;
+    }
+    for (uint i = created.size(); i > 0;){ i--;
+        uint x = created[i];
+        if (!dead[x] && ref[x] == 0)
+            deleteNode(x);
+    }
+    return changed;
+}
+
+
+//=================================================================================================
+// -- Interface to 'Gig':
+
+
+void Rewriter::load()
+{
+    newNode(alit_NULL, alit_NULL);      // -- constant FALSE
+
+    WMap<alit> g2a(N, 0);
+    For_UpOrder(N, w){
+        if (w != gate_And) continue;
+        alit a[2];
+        for (uint i = 0; i < 2; i++){
+            Wire v = w[i];
+            if      (+v == GLit_True)  a[i] = alit_True  ^ v.sign;
+            else if (+v == GLit_False) a[i] = alit_False ^ v.sign;
+            else if (v == gate_And)    a[i] = g2a[+v] ^ v.sign;
+            else{
+                alit& p = g2a(+v);
+                if (p == 0){
+                    p = mkALit(newNode(alit_NULL, alit_NULL));
+                    ci_gate.push(+v);
+                }else
+                    assert(!isAnd(aVar(p)));
+                a[i] = p ^ v.sign;
+            }
+        }
+        g2a(w) = mkAnd(a[0], a[1]);
+    }
+    created.clear();
+
+    For_Gates(N, w){
+        if (w == gate_And) continue;
+        For_Inputs(w, v){
+            if (v != gate_And) continue;
+            uint k = outs.size();
+            alit p = g2a[+v] ^ v.sign;
+            outs.push(p);
+            out_pins.push(make_tuple(w.lit(), (uint)Input_Pin(v)));
+            ref[aVar(p)]++;
+            fanouts[aVar(p)].push(k | fo_Out);
+        }
+    }
+}
+
+
+void Rewriter::run()
+{
+    uint n_orig = fan0.size();
+    for (uint n = 1; n < n_orig; n++)
+        if (isAnd(n) && !dead[n] && ref[n] > 0)
+            tryRewrite(n);
+}
+
+
+void Rewriter::store()
+{
+    Vec<GLit> xl(fan0.size(), GLit_NULL);
+    xl[0] = ~GLit_True;
+    uint ci = 0;
+    for (uint n = 1; n < fan0.size(); n++)
+        if (!isAnd(n)) xl[n] = ci_gate[ci++];
+
+    Vec<uint> Q;
+    for (uint k = 0; k < outs.size(); k++){
+        Q.push(aVar(outs[k]));
+        while (Q.size() > 0){
+            uint n = Q.last();
+            if (xl[n] != GLit_NULL){ Q.pop(); continue; }
+            uint a = aVar(fan0[n]), b = aVar(fan1[n]);
+            if (xl[a] == GLit_NULL || xl[b] == GLit_NULL){
+                if (xl[a] == GLit_NULL) Q.push(a);
+                if (xl[b] == GLit_NULL) Q.push(b);
+                continue; }
+            Q.pop();
+            xl[n] = N.add(gate_And).init(xl[a] ^ aSign(fan0[n]), xl[b] ^ aSign(fan1[n])).lit();
+        }
+
+        Wire w = out_pins[k].fst + N;
+        w.set(out_pins[k].snd, xl[aVar(outs[k])] ^ aSign(outs[k]));
+    }
+
+    removeUnreach(N);
+    N.compact();
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Rewrite -- main:
+
+
+// Logic depth, counting every logic gate as one level.
+static
+uint logicDepth(const Gig& N)
+{
+    WMap<uint> arr(N, 0);
+    uint depth = 0;
+    For_UpOrder(N, w){
+        if (!isCI(w)){
+            uint del = isLogicGate(w) ? 1 : 0;
+            For_Inputs(w, v)
+                newMax(arr(w), arr[v] + del);
+            newMax(depth, arr[w]);
+        }
+    }
+    return depth;
+}
+
+
+void rewrite(Gig& N, const Params_Rewrite& P)
+{
+    N.unstrash();
+    if (!P.quiet)
+        WriteLn "Rewrite input : %_   (depth %_)", info(N), logicDepth(N);
+
+    for (uint round = 0; round < P.n_rounds; round++){
+        uint n_ands = N.typeCount(gate_And);
+        Rewriter R(N, P);
+        R.load();
+        R.run();
+        R.store();
+
+        if (!P.quiet)
+            WriteLn "  round %_:  #And %,d -> %,d   (%,d replacements)   [%t]", round + 1, n_ands, N.typeCount(gate_And), R.n_rewrites, cpuTime();
+        if (R.n_rewrites == 0)
+            break;
+    }
+
+    if (!P.quiet)
+        WriteLn "Rewrite output: %_   (depth %_)", info(N), logicDepth(N);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Balance:
+
+
+// Collect the leaves of the fanout-free tree of gates of the same type as 'w'. For XORs, signs of
+// leaves and internal edges are accumulated in 'parity'.
+static
+void collectTree(Wire w, const WMap<uchar>& internal, /*out*/Vec<GLit>& leaves, bool& parity)
+{
+    GateType type = w.type();
+    Vec<Wire> Q;
+    Q.push(w[0]);
+    Q.push(w[1]);
+    while (Q.size() > 0){
+        Wire v = Q.popC();
+        if (type == gate_And){
+            if (!v.sign && v == gate_And && internal[v]){
+                Q.push(v[0]);
+                Q.push(v[1]);
+            }else
+                leaves.push(v.lit());
+        }else{
+            if (v.sign) parity = !parity;
+            if (v == gate_Xor && internal[v]){
+                Q.push(v[0]);
+                Q.push(v[1]);
+            }else
+                leaves.push(+v.lit());
+        }
+    }
+}
+
+
+struct LevelLt {
+    const WMap<uint>& lev;
+    LevelLt(const WMap<uint>& lev_) : lev(lev_) {}
+    bool operator()(GLit x, GLit y) const { return lev[x] < lev[y]; }
+};
+
+
+// Combine the two shallowest inputs until one remains ('leaves' is destroyed).
+static
+Wire buildBalanced(Gig& N, GateType type, Vec<GLit>& leaves, WMap<uint>& lev)
+{
+    if (type == gate_And){
+        sortUnique(leaves);
+        for (uint i = 0; i+1 < leaves.size(); i++)
+            if (leaves[i+1] == ~leaves[i])
+                return ~N.True();
+        if (leaves.size() == 0)
+            return N.True();
+    }else{
+        sort(leaves);
+        uint j = 0;
+        for (uint i = 0; i < leaves.size();){
+            if (i+1 < leaves.size() && leaves[i] == leaves[i+1])
+                i += 2;
+            else
+                leaves[j++] = leaves[i++];
+        }
+        leaves.shrinkTo(j);
+        if (leaves.size() == 0)
+            return ~N.True();
+    }
+
+    // Keep 'leaves' sorted on decreasing level:
+    sobSort(ordReverse(sob(leaves, LevelLt(lev))));
+    while (leaves.size() > 1){
+        Wire x = leaves.popC() + N;
+        Wire y = leaves.popC() + N;
+        Wire w = N.add(type).init(x, y);
+        lev(w) = max_(lev[x], lev[y]) + 1;
+
+        uint i = leaves.size();
+        leaves.push(w);
+        while (i > 0 && lev[leaves[i-1]] < lev(w)){
+            leaves[i] = leaves[i-1];
+            i--;
+        }
+        leaves[i] = w;
+    }
+    return leaves[0] + N;
+}
+
+
+void balance(Gig& N, const Params_Balance& P)
+{
+    if (!N.isStrashed())
+        N.strash();     // -- remove redundant gates before counting fanouts
+    N.unstrash();
+    if (!P.quiet)
+        WriteLn "Balance input : %_   (depth %_)", info(N), logicDepth(N);
+
+    // Gates whose only fanout is a positive edge into a gate of the same type are internal:
+    WMap<uint>  n_fanouts(N, 0);
+    WMap<uchar> n_same(N, 0);
+    For_Gates(N, w){
+        For_Inputs(w, v){
+            n_fanouts(v)++;
+            if ((w == gate_And && v == gate_And && !v.sign) || (w == gate_Xor && v == gate_Xor))
+                n_same(v) = 1;
+        }
+    }
+    WMap<uchar> internal(N, 0);
+    For_Gates(N, w)
+        if (n_fanouts[w] == 1 && n_same[w])
+            internal(w) = 1;
+
+    // Rebuild trees bottom-up:
+    WMapX<GLit> xlat;
+    xlat.initBuiltins();
+    WMap<uint> lev(N, 0);
+    Vec<GLit> leaves;
+    For_UpOrder(N, w){
+        if (!isSeqElem(w)){
+            For_Inputs(w, v)
+                if (v != xlat[v])
+                    w.set(Input_Pin(v), xlat[v]);
+        }
+
+        if ((w == gate_And || w == gate_Xor) && !internal[w]){
+            bool parity = false;
+            leaves.clear();
+            collectTree(w, internal, leaves, parity);
+            xlat(w) = buildBalanced(N, w.type(), leaves, lev) ^ parity;
+        }else{
+            xlat(w) = w;
+            if (!isCI(w)){
+                uint del = isLogicGate(w) ? 1 : 0;
+                For_Inputs(w, v)
+                    newMax(lev(w), lev[v] + del);
+            }
+        }
+    }
+
+    For_Gates(N, w){
+        if (isSeqElem(w)){
+            For_Inputs(w, v)
+                if (v != xlat[v])
+                    w.set(Input_Pin(v), xlat[v]);
+        }
+    }
+
+    removeUnreach(N);
+    N.strash();
+    N.unstrash();
+    N.compact();
+
+    if (!P.quiet)
+        WriteLn "Balance output: %_   (depth %_)", info(N), logicDepth(N);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,63 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Rewrite.hh
+//| Author(s)   : Niklas Een
+//| Module      : TechMap
+//| Description : DAG-aware rewriting of 4-input cuts and AND/XOR balancing.
+//|
+//| (C) Copyright 2010-2014, The Regents of the University of California
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__TechMap__Rewrite_hh
+#define ZZ__TechMap__Rewrite_hh
+
+#include "ZZ_Gig.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+struct Params_Rewrite {
+    uint n_rounds;          // -- number of passes over the netlist.
+    uint cut_limit;         // -- maximum number of cuts kept per node (in addition to the trivial cut).
+    bool zero_gain;         // -- also apply replacements that keep the size (reshapes logic for later passes).
+    bool quiet;
+
+    Params_Rewrite() :
+        n_rounds(1),
+        cut_limit(12),
+        zero_gain(false),
+        quiet(false)
+    {}
+};
+
+
+struct Params_Balance {
+    bool quiet;
+
+    Params_Balance() :
+        quiet(false)
+    {}
+};
+
+
+void rewrite(Gig& N, const Params_Rewrite& P = Params_Rewrite());
+    // -- Replace the logic of 4-input cuts of AND gates by precomputed implementations (looked up
+    // through the NPN class of the cut function) whenever the number of AND gates decreases. Logic
+    // shared with the rest of the netlist is accounted for. Other gate types are left untouched.
+    // The netlist is compacted.
+
+void balance(Gig& N, const Params_Balance& P = Params_Balance());
+    // -- Rebuild maximal fanout-free trees of AND gates (and XOR gates, if present) so that inputs
+    // arriving first are combined first. Redundant gates are merged and the netlist is compacted.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
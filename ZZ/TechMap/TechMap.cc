@@ -73,7 +73,7 @@ void upOrderBfs(Gig& N, Vec<gate_id>& result)
 
     bool was_frozen = N.is_frozen;
     N.is_frozen = true;
-    Auto_Gob(N, Fanouts);
+    Auto_Gob(N, FanoutsCSR);
 
     WMap<uint> ready(N, 0);
     For_All_Gates(N, w){
@@ -90,7 +90,7 @@ void upOrderBfs(Gig& N, Vec<gate_id>& result)
 
     for (uint q = 0; q < result.size(); q++){
         Wire w = result[q] + N;
-        Fanouts fs = fanouts(w);
+        Fanouts fs = fanoutsCSR(w);
         for (uint i = 0; i < fs.size(); i++){
             Wire v = fs[i];
             if (isCI(v)) continue;  // -- don't continue through flops
@@ -1452,6 +1452,7 @@ void techMap(Gig& N, const Vec<Params_TechMap>& Ps, WMapX<GLit>* remap)
 
             if (Ps[round].refactor){                            // -- apply refactoring only in round 0 and 1
                 Params_Refactor PR;
+                PR.timing_aware = Ps[round].refactor_timing;
                 PR.quiet = true;
                 assert(Ps[round].delay_fraction == 1.0f);       // -- you cannot use refactoring code with a delay fraction different from 1 (due to its simplified timing model)
                 refactor(N, xlat, PR);
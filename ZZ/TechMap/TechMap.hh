@@ -50,6 +50,7 @@ struct Params_TechMap {
     float       slack_util;         // -- How much slack to utilize in non-critical regions (small number means better average slack but worse area)
     bool        exact_local_area;   // -- Post-optimize induced mapping by peep-hole optimization. [no F7Mux support yet]
     bool        refactor;           // -- refactor big-ANDs and big-XORs.
+    bool        refactor_timing;    // -- ...in a timing aware manner (see 'Params_Refactor::timing_aware').
     Params_Unmap unmap;             // -- options for unmapping
     float       est_power;          // -- Exponent to use for fanout estimate blending.
     float       est_const;          // -- Constant to use for fanout estimate blending.
@@ -71,6 +72,7 @@ struct Params_TechMap {
         slack_util      (FLT_MAX),
         exact_local_area(true),
         refactor        (true),
+        refactor_timing (false),
         est_power       (2.0f),
         est_const       (1.0f),
         batch_output    (false),
@@ -239,7 +239,7 @@ void unmap(Gig& N, WMapX<GLit>* remap, const Params_Unmap& PU)
             uint64 ftb_ = (w == gate_Lut6) ? ftb(w) :
                           (w == gate_Lut4) ? (uint64)w.arg() | ((uint64)w.arg() << 16)  | ((uint64)w.arg() << 32)  | ((uint64)w.arg() << 48) :
                           /*otherwise*/      0xD8D8D8D8D8D8D8D8ull;
-            dsd6(ftb_, prog, P);
+            dsd6Memo(ftb_, prog, P);
 
             // Replace LUT with 'prog':
             nodes.setSize(DSD6_FIRST_INTERNAL);